@@ -0,0 +1,106 @@
+/**
+ * @file bench_csv.c
+ * @brief CSV read and write throughput benchmark for Tablr library
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Generates a mixed-type CSV file and times tablr_read_csv and tablr_to_csv
+ * with an increasing number of threads.
+ */
+
+#include <tablr/tablr.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_FILE "bench_input.csv"  /**< Temporary input file */
+#define BENCH_OUTPUT "bench_output.csv" /**< Temporary output file */
+#define BENCH_ROWS 2000000            /**< Rows written to the input file */
+
+/**
+ * @brief Current time in seconds
+ */
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Write the benchmark input file
+ * @return File size in bytes
+ */
+static long write_input(void) {
+    FILE* f = fopen(BENCH_FILE, "w");
+    if (!f) return -1;
+
+    fputs("id,price,qty,flag,label\n", f);
+    for (long i = 0; i < BENCH_ROWS; i++) {
+        fprintf(f, "%ld,%.2f,%d,%s,\"item %d, grade %c\"\n", i, (double)rand() / RAND_MAX * 1000.0,
+                rand() % 500, rand() % 2 ? "true" : "false", rand() % 10000, 'A' + rand() % 5);
+    }
+
+    long size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+/**
+ * @brief Main function running the CSV read benchmark
+ * @return Exit code (0 for success)
+ */
+int main(void) {
+    srand(42);
+    long size = write_input();
+    if (size <= 0) {
+        printf("Failed to write %s\n", BENCH_FILE);
+        return 1;
+    }
+
+    int max_threads = tablr_get_num_threads();
+    printf("Tablr CSV read benchmark (%d rows, %.1f MB, SIMD: %s)\n\n", BENCH_ROWS,
+           (double)size / 1e6, tablr_simd_level_name(tablr_cpu_simd_level()));
+
+    double base = 0.0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        tablr_set_num_threads(threads);
+
+        double best = 1e30;
+        for (int round = 0; round < 3; round++) {
+            double t0 = now_seconds();
+            TablrDataFrame* df = tablr_read_csv(BENCH_FILE, ',', true);
+            double t1 = now_seconds();
+            tablr_dataframe_free(df);
+            if (t1 - t0 < best) best = t1 - t0;
+        }
+        if (threads == 1) base = best;
+
+        printf("  %3d threads: %8.1f ms %8.1f MB/s  speedup %.2fx\n", threads, best * 1e3,
+               (double)size / best / 1e6, base / best);
+    }
+
+    printf("\nTablr CSV write benchmark\n\n");
+    tablr_set_num_threads(0);
+    TablrDataFrame* df = tablr_read_csv(BENCH_FILE, ',', true);
+    for (int threads = 1; df && threads <= max_threads; threads *= 2) {
+        tablr_set_num_threads(threads);
+
+        double best = 1e30;
+        for (int round = 0; round < 3; round++) {
+            double t0 = now_seconds();
+            tablr_to_csv(df, BENCH_OUTPUT, ',', true);
+            double t1 = now_seconds();
+            if (t1 - t0 < best) best = t1 - t0;
+        }
+        if (threads == 1) base = best;
+
+        printf("  %3d threads: %8.1f ms %8.1f MB/s  speedup %.2fx\n", threads, best * 1e3,
+               (double)size / best / 1e6, base / best);
+    }
+    tablr_dataframe_free(df);
+
+    tablr_set_num_threads(0);
+    remove(BENCH_OUTPUT);
+    remove(BENCH_FILE);
+    return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file bench_parse.c
+ * @brief Numeric parsing microbenchmarks for Tablr library
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Compares tablr_parse_double/tablr_parse_int64 against strtod/strtoll on
+ * generated CSV-like fields and reports throughput.
+ */
+
+#include <tablr/tablr.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FIELD_COUNT 1000000  /**< Number of fields per benchmark */
+#define FIELD_WIDTH 32       /**< Bytes reserved per field */
+#define ROUNDS 5             /**< Repetitions, best time is reported */
+
+/**
+ * @brief Current time in seconds
+ */
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Generated input fields
+ */
+typedef struct {
+    char* text;    /**< FIELD_COUNT NUL-terminated fields of FIELD_WIDTH bytes */
+    size_t* lens;  /**< Field lengths */
+    size_t bytes;  /**< Total payload bytes */
+} Fields;
+
+/**
+ * @brief Fill fields using a printf format applied to random values
+ */
+static void generate(Fields* f, int kind) {
+    f->text = (char*)malloc((size_t)FIELD_COUNT * FIELD_WIDTH);
+    f->lens = (size_t*)malloc((size_t)FIELD_COUNT * sizeof(size_t));
+    f->bytes = 0;
+
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        char* dst = f->text + i * FIELD_WIDTH;
+        double r = (double)rand() / RAND_MAX;
+        int n;
+        if (kind == 0) {
+            n = snprintf(dst, FIELD_WIDTH, "%.2f", r * 10000.0);          /* prices */
+        } else if (kind == 1) {
+            n = snprintf(dst, FIELD_WIDTH, "%.17g", r * 1e6 - 5e5);       /* full precision */
+        } else {
+            n = snprintf(dst, FIELD_WIDTH, "%d", rand() - RAND_MAX / 2);  /* integers */
+        }
+        f->lens[i] = (size_t)n;
+        f->bytes += (size_t)n;
+    }
+}
+
+/**
+ * @brief Report a timing line
+ */
+static void report(const char* name, double seconds, const Fields* f, double checksum) {
+    printf("  %-22s %8.2f ns/field %8.1f MB/s   (checksum %.6g)\n", name,
+           seconds * 1e9 / FIELD_COUNT, (double)f->bytes / seconds / 1e6, checksum);
+}
+
+/**
+ * @brief Benchmark double parsing on one data set
+ */
+static void bench_double(const char* label, int kind) {
+    Fields f;
+    generate(&f, kind);
+    printf("%s\n", label);
+
+    double best_std = 1e30, best_tablr = 1e30, sum_std = 0.0, sum_tablr = 0.0;
+    for (int round = 0; round < ROUNDS; round++) {
+        double t0 = now_seconds();
+        sum_std = 0.0;
+        for (size_t i = 0; i < FIELD_COUNT; i++) {
+            sum_std += strtod(f.text + i * FIELD_WIDTH, NULL);
+        }
+        double t1 = now_seconds();
+        sum_tablr = 0.0;
+        for (size_t i = 0; i < FIELD_COUNT; i++) {
+            double v = 0.0;
+            tablr_parse_double(f.text + i * FIELD_WIDTH, f.lens[i], &v);
+            sum_tablr += v;
+        }
+        double t2 = now_seconds();
+        if (t1 - t0 < best_std) best_std = t1 - t0;
+        if (t2 - t1 < best_tablr) best_tablr = t2 - t1;
+    }
+
+    report("strtod", best_std, &f, sum_std);
+    report("tablr_parse_double", best_tablr, &f, sum_tablr);
+    printf("  speedup: %.2fx\n\n", best_std / best_tablr);
+
+    free(f.text);
+    free(f.lens);
+}
+
+/**
+ * @brief Benchmark integer parsing
+ */
+static void bench_int(void) {
+    Fields f;
+    generate(&f, 2);
+    printf("Integers\n");
+
+    double best_std = 1e30, best_tablr = 1e30, sum_std = 0.0, sum_tablr = 0.0;
+    for (int round = 0; round < ROUNDS; round++) {
+        double t0 = now_seconds();
+        sum_std = 0.0;
+        for (size_t i = 0; i < FIELD_COUNT; i++) {
+            sum_std += (double)strtoll(f.text + i * FIELD_WIDTH, NULL, 10);
+        }
+        double t1 = now_seconds();
+        sum_tablr = 0.0;
+        for (size_t i = 0; i < FIELD_COUNT; i++) {
+            int64_t v = 0;
+            tablr_parse_int64(f.text + i * FIELD_WIDTH, f.lens[i], &v);
+            sum_tablr += (double)v;
+        }
+        double t2 = now_seconds();
+        if (t1 - t0 < best_std) best_std = t1 - t0;
+        if (t2 - t1 < best_tablr) best_tablr = t2 - t1;
+    }
+
+    report("strtoll", best_std, &f, sum_std);
+    report("tablr_parse_int64", best_tablr, &f, sum_tablr);
+    printf("  speedup: %.2fx\n\n", best_std / best_tablr);
+
+    free(f.text);
+    free(f.lens);
+}
+
+/**
+ * @brief Main function running all parsing benchmarks
+ * @return Exit code (0 for success)
+ */
+int main(void) {
+    printf("Tablr numeric parsing benchmark (%d fields, best of %d)\n\n", FIELD_COUNT, ROUNDS);
+    srand(42);
+
+    bench_double("Doubles, 2 decimals", 0);
+    bench_double("Doubles, 17 significant digits", 1);
+    bench_int();
+
+    return 0;
+}
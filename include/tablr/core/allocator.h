@@ -0,0 +1,131 @@
+/**
+ * @file allocator.h
+ * @brief Pluggable memory allocators for series data
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_CORE_ALLOCATOR_H
+#define TABLR_CORE_ALLOCATOR_H
+
+#include "tablr/core/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TABLR_ALIGNMENT 64  /**< Alignment of every series buffer, in bytes */
+
+/**
+ * @brief Memory allocator for series data
+ *
+ * alloc must return memory aligned to TABLR_ALIGNMENT, or NULL. free
+ * receives the size that was passed to alloc. The functions may be called
+ * from any thread. A series copies the allocator when its buffer is
+ * allocated, so the struct itself need not outlive the series, but ctx must.
+ */
+typedef struct {
+    void* (*alloc)(void* ctx, size_t size);            /**< Allocate size bytes */
+    void (*free)(void* ctx, void* ptr, size_t size);   /**< Release a block from alloc */
+    void* ctx;                                         /**< Passed to both functions */
+} TablrAllocator;
+
+/**
+ * @brief Opaque arena allocator
+ */
+typedef struct TablrArena TablrArena;
+
+/**
+ * @brief Get the default allocator (aligned system malloc)
+ * @return Allocator pointer (never NULL)
+ */
+const TablrAllocator* tablr_default_allocator(void);
+
+/**
+ * @brief Get the pool allocator
+ *
+ * Rounds sizes up to power-of-two classes and keeps freed blocks in a
+ * per-thread cache for reuse, so repeated operations on similar sizes stop
+ * returning memory to the system and faulting it back in. Each thread
+ * caches at most 32 MB; blocks larger than 32 MB bypass the pool.
+ *
+ * @return Allocator pointer (never NULL)
+ */
+const TablrAllocator* tablr_pool_allocator(void);
+
+/**
+ * @brief Return the calling thread's cached pool blocks to the system
+ *
+ * Caches are also released automatically when a thread exits.
+ */
+void tablr_pool_trim(void);
+
+/**
+ * @brief Set the allocator used for new series data
+ *
+ * Applies to all threads that have no allocator of their own. Set it
+ * before creating series from other threads.
+ *
+ * @param allocator Allocator to use, or NULL for the default allocator
+ */
+void tablr_set_allocator(const TablrAllocator* allocator);
+
+/**
+ * @brief Set the allocator for new series data on the calling thread only
+ *
+ * Every operation run on this thread until the allocator is restored
+ * allocates its result columns from it, which scopes an allocator to a
+ * call or a pipeline.
+ *
+ * @param allocator Allocator to use, or NULL to fall back to the global one
+ * @return The thread's previous allocator (NULL if none), for restoring it
+ */
+const TablrAllocator* tablr_set_thread_allocator(const TablrAllocator* allocator);
+
+/**
+ * @brief Get the allocator new series data comes from on this thread
+ * @return Thread allocator if set, otherwise the global allocator
+ */
+const TablrAllocator* tablr_get_allocator(void);
+
+/**
+ * @brief Create an arena
+ *
+ * An arena hands out memory from large blocks by bumping a pointer, and
+ * releases all of it at once in tablr_arena_free(). Freeing an individual
+ * allocation does nothing.
+ *
+ * @param block_size Bytes per block (0 for 1 MB); larger requests get their own block
+ * @return Pointer to arena or NULL on failure
+ */
+TablrArena* tablr_arena_create(size_t block_size);
+
+/**
+ * @brief Get the allocator that allocates from an arena
+ * @param arena Arena
+ * @return Allocator pointer, valid until the arena is freed
+ */
+const TablrAllocator* tablr_arena_allocator(TablrArena* arena);
+
+/**
+ * @brief Get the number of bytes an arena has reserved from the system
+ * @param arena Arena
+ * @return Total size of its blocks
+ */
+size_t tablr_arena_reserved(const TablrArena* arena);
+
+/**
+ * @brief Release an arena and everything allocated from it
+ *
+ * Series whose data came from the arena may still be freed afterwards,
+ * but must not be read or written.
+ *
+ * @param arena Arena to free (can be NULL)
+ */
+void tablr_arena_free(TablrArena* arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TABLR_CORE_ALLOCATOR_H */
@@ -0,0 +1,103 @@
+/**
+ * @file arrow.h
+ * @brief Apache Arrow C Data Interface import and export
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_CORE_ARROW_H
+#define TABLR_CORE_ARROW_H
+
+#include "tablr/core/dataframe.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+/**
+ * @brief Arrow C Data Interface type description
+ */
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+/**
+ * @brief Arrow C Data Interface array data
+ */
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif /* ARROW_C_DATA_INTERFACE */
+
+/**
+ * @brief Export a dataframe as an Arrow struct array
+ *
+ * Numeric and string columns are shared without copying and stay valid
+ * until the exported array is released, even if the dataframe is freed
+ * first; string columns are exported as large utf8 ("U"), dates as date32
+ * ("tdD") and timestamps as zone-less timestamps of their unit ("tss:",
+ * "tsm:", "tsu:" or "tsn:"). Bool columns are
+ * converted to bitmaps and bitmask columns shared as they are, both as "b". Categorical columns are exported as dictionary
+ * arrays: int32 indices ("i") whose dictionary holds the categories as large
+ * utf8. Null elements get an Arrow validity bitmap.
+ *
+ * @param df DataFrame to export
+ * @param array Output array; the caller must call array->release
+ * @param schema Output schema; the caller must call schema->release
+ * @return true on success, false on failure (nothing to release)
+ */
+bool tablr_dataframe_export_arrow(const TablrDataFrame* df, struct ArrowArray* array, struct ArrowSchema* schema);
+
+/**
+ * @brief Import an Arrow struct array as a dataframe
+ *
+ * Both structs are consumed and marked released, whether or not the import
+ * succeeds. Numeric children without nulls and large utf8 children become
+ * series over the Arrow buffers without copying; they keep the producer's
+ * memory alive until the series is freed and are copied on first write,
+ * since Arrow buffers are immutable. Other children are converted. Nulls are
+ * marked null in the series and stored as NaN in float columns and 0/false
+ * in other numeric columns.
+ *
+ * Supported child formats: c, s, i, l, C, S, I, L, f, g, b, u, U, tdD and
+ * timestamps of any unit and time zone. Dictionary-encoded children
+ * with int32 indices and a u or U dictionary without nulls become
+ * categorical series.
+ *
+ * @param array Struct array to import
+ * @param schema Schema describing array (format "+s")
+ * @return Pointer to dataframe or NULL on failure or unsupported types
+ */
+TablrDataFrame* tablr_dataframe_import_arrow(struct ArrowArray* array, struct ArrowSchema* schema);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TABLR_CORE_ARROW_H */
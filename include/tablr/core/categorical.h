@@ -0,0 +1,112 @@
+/**
+ * @file categorical.h
+ * @brief Dictionary encoding of string columns
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_CORE_CATEGORICAL_H
+#define TABLR_CORE_CATEGORICAL_H
+
+#include "tablr/core/series.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opaque hash index of distinct strings
+ *
+ * Assigns codes 0, 1, 2, ... to strings in the order they are first added,
+ * which is how categorical dictionaries are built.
+ */
+typedef struct TablrCategoryIndex TablrCategoryIndex;
+
+/**
+ * @brief Create an empty category index
+ * @return Pointer to index or NULL on failure
+ */
+TablrCategoryIndex* tablr_category_index_create(void);
+
+/**
+ * @brief Create an empty category index with room for a number of strings
+ *
+ * Sizing the table up front avoids rehashing while it fills.
+ *
+ * @param expected Number of distinct strings expected
+ * @return Pointer to index or NULL on failure
+ */
+TablrCategoryIndex* tablr_category_index_create_sized(size_t expected);
+
+/**
+ * @brief Get the code of a string, adding it if it is new
+ * @param index Category index
+ * @param value Characters of the string (need not be NUL-terminated)
+ * @param length Length in bytes
+ * @return Code of the string, or -1 on failure
+ */
+int32_t tablr_category_index_add(TablrCategoryIndex* index, const char* value, size_t length);
+
+/**
+ * @brief Look up the code of a string
+ * @param index Category index
+ * @param value Characters of the string
+ * @param length Length in bytes
+ * @return Code of the string, or -1 if it has not been added
+ */
+int32_t tablr_category_index_find(const TablrCategoryIndex* index, const char* value, size_t length);
+
+/**
+ * @brief Get the number of distinct strings in an index
+ * @param index Category index
+ * @return Number of codes assigned
+ */
+size_t tablr_category_index_size(const TablrCategoryIndex* index);
+
+/**
+ * @brief Get the string with a code
+ * @param index Category index
+ * @param code Code returned by tablr_category_index_add()
+ * @param length Output length in bytes (may be NULL)
+ * @return Pointer to the characters (not NUL-terminated), or NULL if code is out of range
+ */
+const char* tablr_category_index_value(const TablrCategoryIndex* index, int32_t code, size_t* length);
+
+/**
+ * @brief Copy the strings of an index into a dictionary for categorical series
+ * @param index Category index
+ * @param device Target compute device
+ * @return String series with element i holding code i, or NULL on failure or if the index is empty
+ */
+TablrSeries* tablr_category_index_categories(const TablrCategoryIndex* index, TablrDevice device);
+
+/**
+ * @brief Free a category index
+ * @param index Index to free (can be NULL)
+ */
+void tablr_category_index_free(TablrCategoryIndex* index);
+
+/**
+ * @brief Dictionary-encode a string series
+ *
+ * Categories are numbered in order of first appearance. Nulls stay null.
+ * A categorical series is returned as a view of itself.
+ *
+ * @param series String or categorical series
+ * @return New categorical series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_series_to_categorical(const TablrSeries* series);
+
+/**
+ * @brief Decode a categorical series into a string series
+ * @param series Categorical series
+ * @return New string series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_series_from_categorical(const TablrSeries* series);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TABLR_CORE_CATEGORICAL_H */
@@ -0,0 +1,73 @@
+/**
+ * @file chunked.h
+ * @brief Chunked series for append-heavy ingestion
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_CORE_CHUNKED_H
+#define TABLR_CORE_CHUNKED_H
+
+#include "tablr/core/series.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Append the elements of one series to another
+ *
+ * The first append turns series into a chunked series: a list of
+ * immutable chunks, the first being a view of its current elements.
+ * Each append then adds a view of chunk, so no element is copied and the
+ * cost is O(1) in the size of series, apart from its validity bitmap,
+ * which grows geometrically. Categorical chunks with a different
+ * dictionary are recoded into series' dictionary, which gains their new
+ * categories.
+ *
+ * A chunked series is read-only: tablr_series_data() and
+ * tablr_series_set_valid() give it a plain copy first.
+ * tablr_series_data_const() flattens the chunks into one array on first
+ * use and keeps it until the next append.
+ *
+ * @param series Series to extend
+ * @param chunk Elements to add, of the same dtype and time unit
+ * @return true on success, false on failure (series unchanged)
+ */
+bool tablr_series_append(TablrSeries* series, const TablrSeries* chunk);
+
+/**
+ * @brief Get the number of chunks of a series
+ * @param series Series to query
+ * @return Number of chunks; 1 for a plain series, 0 for NULL
+ */
+size_t tablr_series_num_chunks(const TablrSeries* series);
+
+/**
+ * @brief Get a view of one chunk of a series
+ *
+ * Kernels that walk a series chunk by chunk use this to read each chunk
+ * in place instead of flattening the series.
+ *
+ * @param series Series to query
+ * @param index Chunk index, below tablr_series_num_chunks()
+ * @return New view of the chunk's elements in series, or NULL on failure
+ */
+TablrSeries* tablr_series_chunk(const TablrSeries* series, size_t index);
+
+/**
+ * @brief Copy a chunked series into one contiguous buffer
+ *
+ * Frees the chunks and any flattened copy once nothing else refers to
+ * them. Plain series are left as they are.
+ *
+ * @param series Series to compact
+ * @return true on success, false on failure (series unchanged)
+ */
+bool tablr_series_rechunk(TablrSeries* series);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TABLR_CORE_CHUNKED_H */
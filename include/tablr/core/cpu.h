@@ -0,0 +1,49 @@
+/**
+ * @file cpu.h
+ * @brief CPU feature detection
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_CORE_CPU_H
+#define TABLR_CORE_CPU_H
+
+#include "tablr/core/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief SIMD instruction set level
+ *
+ * The x86 levels are ordered from least to most capable. NEON is the only
+ * level reported on ARM.
+ */
+typedef enum {
+    TABLR_SIMD_SCALAR,  /**< No usable SIMD extension */
+    TABLR_SIMD_SSE2,    /**< x86 SSE2 */
+    TABLR_SIMD_SSE42,   /**< x86 SSE4.2 */
+    TABLR_SIMD_AVX2,    /**< x86 AVX2 */
+    TABLR_SIMD_AVX512,  /**< x86 AVX-512 F, BW, DQ and VL */
+    TABLR_SIMD_NEON     /**< ARM NEON (Advanced SIMD) */
+} TablrSimdLevel;
+
+/**
+ * @brief Get best SIMD level supported by the CPU and operating system
+ * @return Detected SIMD level (cached after the first call)
+ */
+TablrSimdLevel tablr_cpu_simd_level(void);
+
+/**
+ * @brief Get string name of SIMD level
+ * @param level SIMD level
+ * @return String representation (e.g., "avx2")
+ */
+const char* tablr_simd_level_name(TablrSimdLevel level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TABLR_CORE_CPU_H */
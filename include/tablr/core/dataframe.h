@@ -44,6 +44,31 @@ bool tablr_dataframe_add_column(TablrDataFrame* df, const char* name, TablrSerie
  */
 TablrSeries* tablr_dataframe_get_column(const TablrDataFrame* df, const char* name);
 
+/**
+ * @brief Get column by position without copying its name
+ * @param df DataFrame pointer
+ * @param index Column position, from 0 to ncols - 1
+ * @return Series pointer owned by df, or NULL if out of range
+ */
+TablrSeries* tablr_dataframe_column_at(const TablrDataFrame* df, size_t index);
+
+/**
+ * @brief Get column name by position without copying it
+ * @param df DataFrame pointer
+ * @param index Column position, from 0 to ncols - 1
+ * @return Name owned by df (valid until the column is removed), or NULL if out of range
+ */
+const char* tablr_dataframe_column_name_at(const TablrDataFrame* df, size_t index);
+
+/**
+ * @brief Find the position of a column by name in O(1)
+ * @param df DataFrame pointer
+ * @param name Column name
+ * @param index Output position of the first column with this name
+ * @return true if found, false otherwise
+ */
+bool tablr_dataframe_column_index(const TablrDataFrame* df, const char* name, size_t* index);
+
 /**
  * @brief Remove column from dataframe
  * @param df DataFrame pointer
@@ -103,6 +128,28 @@ TablrDataFrame* tablr_dataframe_tail(const TablrDataFrame* df, size_t n);
  */
 TablrDataFrame* tablr_dataframe_copy(const TablrDataFrame* df);
 
+/**
+ * @brief Append the rows of one dataframe to another in place
+ *
+ * Columns are matched by name and become chunked series (see
+ * tablr_series_append()): the batch's columns are shared, not copied, so
+ * appending costs time in proportion to the batch rather than to df. An
+ * empty df takes the batch's columns. Call tablr_dataframe_rechunk() to
+ * merge the chunks once ingestion is done.
+ *
+ * @param df DataFrame to extend
+ * @param batch Rows to add, with the same column names and types
+ * @return true on success, false on failure or mismatched columns (df unchanged)
+ */
+bool tablr_dataframe_append(TablrDataFrame* df, const TablrDataFrame* batch);
+
+/**
+ * @brief Copy every chunked column of a dataframe into one contiguous buffer
+ * @param df DataFrame to compact
+ * @return true on success, false if a column could not be copied
+ */
+bool tablr_dataframe_rechunk(TablrDataFrame* df);
+
 #ifdef __cplusplus
 }
 #endif
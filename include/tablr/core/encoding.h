@@ -0,0 +1,179 @@
+/**
+ * @file encoding.h
+ * @brief Compressed and lazily generated encodings of numeric series
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_CORE_ENCODING_H
+#define TABLR_CORE_ENCODING_H
+
+#include "tablr/core/series.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief How the elements of a series are stored
+ */
+typedef enum {
+    TABLR_ENCODING_PLAIN,     /**< One fixed-width value per element */
+    TABLR_ENCODING_RLE,       /**< Runs of equal values, one value and end row per run */
+    TABLR_ENCODING_DELTA,     /**< Bit-packed differences from the previous value, per block */
+    TABLR_ENCODING_FOR,       /**< Bit-packed offsets from the block minimum (frame of reference) */
+    TABLR_ENCODING_CONSTANT,  /**< One value for every element, stored once */
+    TABLR_ENCODING_RANGE      /**< start + i * step at element i, computed when read */
+} TablrEncoding;
+
+/**
+ * @brief Compress a numeric series with the smallest encoding that fits it
+ *
+ * Tries run-length encoding for every fixed-width numeric type, and delta
+ * and frame-of-reference bit-packing for integer, date and timestamp types,
+ * in blocks of 1024 rows. The smallest encoding wins if it is smaller than
+ * the plain values; otherwise the result is a plain view of series.
+ *
+ * The result is read-only: tablr_series_data() gives it a plain copy
+ * first. tablr_series_data_const() decodes the whole series on first use
+ * and keeps the decoded values with the buffer. Sums, minimum and maximum
+ * and comparisons run on the encoded form without decoding it all.
+ *
+ * @param series Series to compress
+ * @return New series, or NULL on failure
+ */
+TablrSeries* tablr_series_compress(const TablrSeries* series);
+
+/**
+ * @brief Decode a series into plain values
+ * @param series Series to decode
+ * @return New plain series (a view if series is already plain), or NULL on failure
+ */
+TablrSeries* tablr_series_decompress(const TablrSeries* series);
+
+/**
+ * @brief Get the encoding of a series
+ * @param series Series to query
+ * @return Encoding; TABLR_ENCODING_PLAIN for NULL
+ */
+TablrEncoding tablr_series_encoding(const TablrSeries* series);
+
+/**
+ * @brief Copy a range of elements into a caller's array
+ *
+ * Compressed series are decoded for just that range, so scans can process
+ * a large series a block at a time without decoding all of it.
+ *
+ * @param series Fixed-width series (not string or bitmask)
+ * @param start Index of the first element
+ * @param count Number of elements
+ * @param out Output array of count elements
+ * @return true on success, false if the range or type is invalid
+ */
+bool tablr_series_read(const TablrSeries* series, size_t start, size_t count, void* out);
+
+/**
+ * @brief Create a series whose elements all hold one value, without storing them
+ *
+ * The series takes O(1) memory whatever its size. Like a compressed
+ * series it is read-only and materialized only when a raw pointer is
+ * requested: tablr_series_data_const() fills and keeps a plain copy, and
+ * tablr_series_data() gives the series a plain copy of its own. Sums,
+ * bounds, comparisons and statistics answer from the one value, and row
+ * selection keeps the result constant.
+ *
+ * @param size Number of elements
+ * @param dtype Integer, float, bool, date or timestamp type
+ * @param value Value, converted to dtype
+ * @param device Target compute device
+ * @return New series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_series_full(size_t size, TablrDType dtype, double value, TablrDevice device);
+
+/**
+ * @brief Create a series holding start + i * step at element i, without storing it
+ *
+ * Values are generated when read, a block at a time for scans. Float
+ * types compute each value as a double. Bounds and comparisons are
+ * decided per block from its first and last values.
+ *
+ * @param start First value
+ * @param step Difference between neighbouring values (can be 0 or negative)
+ * @param size Number of elements
+ * @param dtype Integer, float, date or timestamp type
+ * @param device Target compute device
+ * @return New series, or NULL on failure, for other types or if a value
+ *         does not fit in dtype
+ */
+TablrSeries* tablr_series_sequence(int64_t start, int64_t step, size_t size, TablrDType dtype, TablrDevice device);
+
+/**
+ * @brief Whether every element of a series stores the same value
+ *
+ * True for constant series and views of a single run-length encoded run;
+ * plain series are not scanned and report false. Nulls are not taken into
+ * account.
+ *
+ * @param series Series to query
+ * @return true if the series is known to be constant
+ */
+bool tablr_series_is_constant(const TablrSeries* series);
+
+/**
+ * @brief Create a constant series repeating the first element of a series
+ *
+ * Broadcasts a scalar against a column without allocating a column's
+ * worth of memory. If the element is null, every element of the result is
+ * null; a timestamp result keeps the time unit.
+ *
+ * @param series Integer, float, bool, date or timestamp series
+ * @param size Number of elements
+ * @return New series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_series_broadcast(const TablrSeries* series, size_t size);
+
+/**
+ * @brief Sum the valid elements of a numeric series
+ *
+ * Run-length encoded series are summed one run at a time and constant
+ * series in one step.
+ *
+ * @param series Integer, float or bool series
+ * @param sum Output sum
+ * @return true on success, false for other types
+ */
+bool tablr_series_sum(const TablrSeries* series, double* sum);
+
+/**
+ * @brief Get the smallest and largest valid elements of a numeric series
+ *
+ * Delta and frame-of-reference blocks without nulls answer from their
+ * stored bounds; runs are visited once each. NaN is ignored.
+ *
+ * @param series Integer, float or bool series
+ * @param min Output minimum
+ * @param max Output maximum
+ * @return true on success, false for other types or if no element is valid
+ */
+bool tablr_series_min_max(const TablrSeries* series, double* min, double* max);
+
+/**
+ * @brief Compare every element of a numeric series with a value
+ *
+ * Elements are compared as double. A run is compared once, and a delta
+ * or frame-of-reference block whose bounds decide the result is filled
+ * without decoding it. Null elements are null in the result.
+ *
+ * @param series Integer, float or bool series
+ * @param op Comparison
+ * @param value Value to compare with
+ * @return New TABLR_BITMASK series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_series_compare(const TablrSeries* series, TablrCompareOp op, double value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TABLR_CORE_ENCODING_H */
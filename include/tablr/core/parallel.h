@@ -0,0 +1,48 @@
+/**
+ * @file parallel.h
+ * @brief Multi-threaded execution helpers
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_CORE_PARALLEL_H
+#define TABLR_CORE_PARALLEL_H
+
+#include "tablr/core/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Parallel task callback function type
+ * @param index Task index in range [0, count)
+ * @param ctx User context pointer
+ */
+typedef void (*TablrParallelFunc)(size_t index, void* ctx);
+
+/**
+ * @brief Set number of worker threads used by parallel operations
+ * @param num_threads Thread count (0 selects the number of online CPUs)
+ */
+void tablr_set_num_threads(int num_threads);
+
+/**
+ * @brief Get number of worker threads used by parallel operations
+ * @return Thread count (always at least 1)
+ */
+int tablr_get_num_threads(void);
+
+/**
+ * @brief Run count independent tasks across worker threads
+ * @param count Number of tasks
+ * @param func Task function, called once per index
+ * @param ctx User context passed to every task
+ */
+void tablr_parallel_for(size_t count, TablrParallelFunc func, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TABLR_CORE_PARALLEL_H */
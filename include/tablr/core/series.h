@@ -9,6 +9,7 @@
 #define TABLR_CORE_SERIES_H
 
 #include "tablr/core/types.h"
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -16,6 +17,14 @@ extern "C" {
 
 /**
  * @brief Create series from array data
+ *
+ * For TABLR_STRING, data is an array of NUL-terminated char* whose
+ * characters are copied into the series' character buffer; NULL entries
+ * become nulls. For TABLR_BITMASK, data is an array of (size + 63) / 64
+ * uint64_t words with element i in bit i % 64 of word i / 64.
+ * TABLR_CATEGORICAL needs a dictionary and is created with
+ * tablr_series_categorical() instead.
+ *
  * @param data Pointer to source data
  * @param size Number of elements
  * @param dtype Data type
@@ -33,6 +42,194 @@ TablrSeries* tablr_series_create(const void* data, size_t size, TablrDType dtype
  */
 TablrSeries* tablr_series_create_default(const void* data, size_t size, TablrDType dtype);
 
+/**
+ * @brief Create series with uninitialized elements to fill in
+ *
+ * The buffer comes from tablr_get_allocator() and is aligned to
+ * TABLR_ALIGNMENT. String elements start empty. Use
+ * tablr_series_categorical_alloc() for TABLR_CATEGORICAL.
+ *
+ * @param size Number of elements
+ * @param dtype Data type of elements
+ * @param device Target compute device
+ * @return Pointer to series or NULL on failure
+ */
+TablrSeries* tablr_series_alloc(size_t size, TablrDType dtype, TablrDevice device);
+
+/**
+ * @brief Release callback for series data owned outside the series
+ * @param ctx Context pointer given when the series was created
+ */
+typedef void (*TablrReleaseFunc)(void* ctx);
+
+/**
+ * @brief Create series over existing data without copying
+ *
+ * Not available for TABLR_STRING (see tablr_series_string_wrap()) or
+ * TABLR_CATEGORICAL.
+ *
+ * @param data Pointer to data array
+ * @param size Number of elements
+ * @param dtype Data type of elements
+ * @param device Target compute device
+ * @param release Called with ctx when the series is freed (may be NULL)
+ * @param ctx Context passed to release
+ * @return Pointer to series or NULL on failure
+ */
+TablrSeries* tablr_series_external(void* data, size_t size, TablrDType dtype, TablrDevice device,
+                                   TablrReleaseFunc release, void* ctx);
+
+/**
+ * @brief Deallocator for a buffer adopted by a series
+ * @param data Buffer passed to tablr_series_adopt
+ */
+typedef void (*TablrDeallocFunc)(void* data);
+
+/**
+ * @brief Create series that takes ownership of a buffer without copying
+ *
+ * Not available for TABLR_STRING or TABLR_CATEGORICAL.
+ *
+ * @param data Heap buffer of size elements
+ * @param size Number of elements
+ * @param dtype Data type of elements
+ * @param device Target compute device
+ * @param dealloc Frees data when the series is done with it (NULL for free)
+ * @return Pointer to series or NULL on failure, in which case data still belongs to the caller
+ */
+TablrSeries* tablr_series_adopt(void* data, size_t size, TablrDType dtype, TablrDevice device,
+                                TablrDeallocFunc dealloc);
+
+/**
+ * @brief Create read-only series over existing data without copying
+ *
+ * The data is never written; tablr_series_data() gives the series a private
+ * copy first. Not available for TABLR_STRING (see tablr_series_string_wrap())
+ * or TABLR_CATEGORICAL.
+ *
+ * @param data Pointer to data array
+ * @param size Number of elements
+ * @param dtype Data type of elements
+ * @param device Target compute device
+ * @param keepalive Called with ctx once the series no longer uses data (may be NULL)
+ * @param ctx Context passed to keepalive
+ * @return Pointer to series or NULL on failure
+ */
+TablrSeries* tablr_series_wrap(const void* data, size_t size, TablrDType dtype, TablrDevice device,
+                               TablrReleaseFunc keepalive, void* ctx);
+
+/**
+ * @brief Create string series with room for chars_size bytes of characters
+ *
+ * A string series stores its elements back to back in one character
+ * buffer, with size + 1 int64 offsets: element i is the bytes from
+ * chars[offsets[i]] to chars[offsets[i + 1]], not NUL-terminated. All
+ * offsets start at 0; fill them and the characters through
+ * tablr_series_string_buffers().
+ *
+ * @param size Number of elements
+ * @param chars_size Total bytes of all elements
+ * @param device Target compute device
+ * @return Pointer to series or NULL on failure
+ */
+TablrSeries* tablr_series_string_alloc(size_t size, size_t chars_size, TablrDevice device);
+
+/**
+ * @brief Create read-only string series over existing offsets and characters
+ *
+ * Same layout as tablr_series_string_alloc(), except that offsets[0] may be
+ * non-zero. This matches an Arrow large utf8 array. Nothing is copied until
+ * the series is written.
+ *
+ * @param offsets size + 1 non-decreasing offsets into chars
+ * @param chars Character buffer
+ * @param size Number of elements
+ * @param device Target compute device
+ * @param keepalive Called with ctx once the series no longer uses the buffers (may be NULL)
+ * @param ctx Context passed to keepalive
+ * @return Pointer to series or NULL on failure
+ */
+TablrSeries* tablr_series_string_wrap(const int64_t* offsets, const char* chars, size_t size, TablrDevice device,
+                                      TablrReleaseFunc keepalive, void* ctx);
+
+/**
+ * @brief Create categorical series from codes and a dictionary
+ *
+ * A categorical series stores one int32 code per element, indexing a
+ * dictionary of distinct strings. The dictionary is shared, not copied, by
+ * the series and every slice, copy and gather of it, so equal values
+ * compare as equal codes. Negative codes become nulls.
+ *
+ * @param codes Element codes, each negative or below the number of categories
+ * @param size Number of elements
+ * @param categories String series of distinct values without nulls, or NULL
+ *                   if every code is negative
+ * @param device Target compute device
+ * @return Pointer to series or NULL on failure or if a code is out of range
+ */
+TablrSeries* tablr_series_categorical(const int32_t* codes, size_t size, const TablrSeries* categories,
+                                      TablrDevice device);
+
+/**
+ * @brief Create categorical series with uninitialized codes
+ *
+ * Fill the codes through tablr_series_data(); each must be below the
+ * number of categories, and null elements are marked with
+ * tablr_series_set_valid().
+ *
+ * @param size Number of elements
+ * @param categories String series of distinct values without nulls (may be NULL)
+ * @param device Target compute device
+ * @return Pointer to series or NULL on failure
+ */
+TablrSeries* tablr_series_categorical_alloc(size_t size, const TablrSeries* categories, TablrDevice device);
+
+/**
+ * @brief Get the dictionary of a categorical series
+ * @param series Categorical series
+ * @return String series indexed by the codes, or NULL for other types or an empty dictionary
+ */
+const TablrSeries* tablr_series_categories(const TablrSeries* series);
+
+/**
+ * @brief Get the value of one element of a categorical series
+ * @param series Categorical series
+ * @param index Element index
+ * @param length Output length in bytes (may be NULL)
+ * @return Pointer to the characters (not NUL-terminated), or NULL if out of
+ *         range or null
+ */
+const char* tablr_series_category_at(const TablrSeries* series, size_t index, size_t* length);
+
+/**
+ * @brief Take an extra reference to a series' data
+ *
+ * The data stays valid until the series is freed and release(ctx) has been
+ * called; either may happen first.
+ *
+ * @param series Series whose data to share
+ * @param release Output function to call once the reference is dropped
+ * @param ctx Output context for release
+ * @return true on success, false on failure
+ */
+bool tablr_series_share_data(TablrSeries* series, TablrReleaseFunc* release, void** ctx);
+
+/**
+ * @brief Create a view of part of a series without copying
+ *
+ * The view shares the source's reference-counted buffer and stays valid
+ * after the source is freed. Writing through tablr_series_data() copies
+ * the written series first, so neither sees the other's changes. A
+ * TABLR_BITMASK slice that does not start on a multiple of 64 elements is
+ * copied, so every bitmask series starts at bit 0 of its first word.
+ *
+ * @param series Source series
+ * @param offset Index of the first element
+ * @param length Number of elements
+ * @return Pointer to series or NULL if the range is empty or out of bounds
+ */
+TablrSeries* tablr_series_slice(const TablrSeries* series, size_t offset, size_t length);
+
 /**
  * @brief Create series filled with zeros
  * @param size Number of elements
@@ -81,6 +278,25 @@ size_t tablr_series_size(const TablrSeries* series);
  */
 TablrDType tablr_series_dtype(const TablrSeries* series);
 
+/**
+ * @brief Get the time unit of a timestamp series
+ *
+ * New timestamp series count microseconds. Slices, copies and gathered
+ * rows keep the unit of their source.
+ *
+ * @param series Series pointer
+ * @return Time unit (TABLR_TIME_MICROSECOND for other types)
+ */
+TablrTimeUnit tablr_series_time_unit(const TablrSeries* series);
+
+/**
+ * @brief Set the time unit of a timestamp series without converting values
+ * @param series Timestamp series
+ * @param unit New time unit
+ * @return true on success, false if series is not TABLR_TIMESTAMP64
+ */
+bool tablr_series_set_time_unit(TablrSeries* series, TablrTimeUnit unit);
+
 /**
  * @brief Get series device
  * @param series Series pointer
@@ -89,14 +305,160 @@ TablrDType tablr_series_dtype(const TablrSeries* series);
 TablrDevice tablr_series_device(const TablrSeries* series);
 
 /**
- * @brief Get pointer to series data
+ * @brief Get writable pointer to series data
+ *
+ * If the data is shared with other series (views, dataframe copies) or
+ * through tablr_series_share_data(), this series first gets a private copy
+ * of its elements, so writes are never visible elsewhere. Use
+ * tablr_series_data_const() to read without copying. For a string series
+ * this is the offsets array, and for a bitmask series the uint64_t words.
+ * The series' cached statistics are dropped (see tablr_series_stats()).
+ * Later writes through the pointer do not drop them again: do not keep it
+ * across a statistics call, or call tablr_series_invalidate_stats() after
+ * writing.
+ *
+ * @param series Series pointer
+ * @return Pointer to data or NULL on allocation failure
+ */
+void* tablr_series_data(TablrSeries* series);
+
+/**
+ * @brief Get read-only pointer to series data
+ *
+ * A plain series is never copied; the pointer may refer to memory shared
+ * with other series. A compressed or lazy series is decoded, and a
+ * chunked series flattened, into one array on first use. That copy is
+ * kept with the series' buffer (for a chunked series, until the next
+ * append), but making it allocates and can fail.
+ *
+ * @param series Series pointer
+ * @return Pointer to data, or NULL if series is NULL or decoding failed
+ */
+const void* tablr_series_data_const(const TablrSeries* series);
+
+/**
+ * @brief Get writable offsets and characters of a string series
+ *
+ * Copies the series first if its data is shared, like tablr_series_data().
+ *
+ * @param series String series
+ * @param offsets Output size + 1 offsets into chars
+ * @param chars Output character buffer
+ * @return true on success, false for other types or on allocation failure
+ */
+bool tablr_series_string_buffers(TablrSeries* series, int64_t** offsets, char** chars);
+
+/**
+ * @brief Get the offsets of a string series
+ *
+ * Flattens a chunked series first, like tablr_series_data_const().
+ *
+ * @param series String series
+ * @return size + 1 offsets into tablr_series_string_chars(), or NULL for
+ *         other types or if flattening failed
+ */
+const int64_t* tablr_series_string_offsets(const TablrSeries* series);
+
+/**
+ * @brief Get the character buffer of a string series
+ *
+ * Flattens a chunked series first, like tablr_series_data_const().
+ *
+ * @param series String series
+ * @return Character buffer, or NULL for other types or if flattening failed
+ */
+const char* tablr_series_string_chars(const TablrSeries* series);
+
+/**
+ * @brief Get one element of a string series
+ * @param series String series
+ * @param index Element index
+ * @param length Output length in bytes (may be NULL)
+ * @return Pointer to the characters (not NUL-terminated), or NULL if out of range
+ *         or a chunked series could not be flattened
+ */
+const char* tablr_series_string_at(const TablrSeries* series, size_t index, size_t* length);
+
+/**
+ * @brief Count null elements
+ * @param series Series pointer
+ * @return Number of elements marked null
+ */
+size_t tablr_series_null_count(const TablrSeries* series);
+
+/**
+ * @brief Check whether an element is valid (not null)
+ *
+ * Series without a validity bitmap have no nulls. Slices and other views
+ * share the bitmap along with the data.
+ *
+ * @param series Series pointer
+ * @param index Element index
+ * @return true if valid, false if null or out of range
+ */
+bool tablr_series_is_valid(const TablrSeries* series, size_t index);
+
+/**
+ * @brief Mark an element as valid or null
+ *
+ * Copies the series first if its data is shared, like tablr_series_data().
+ * The stored value is kept, so float nulls read from CSV are also NaN.
+ *
+ * @param series Series pointer
+ * @param index Element index
+ * @param valid false to mark the element null
+ * @return true on success, false if out of range or on allocation failure
+ */
+bool tablr_series_set_valid(TablrSeries* series, size_t index, bool valid);
+
+/**
+ * @brief Set the validity of a run of elements from a bitmap
+ *
+ * Element index + i becomes valid if bit bit_offset + i of bits is set.
+ * Bits are numbered from the low bit of each byte, as in an Arrow validity
+ * bitmap, and only the bytes holding those bits are read. Copies the series
+ * first if its data is shared, like tablr_series_set_valid(), but writes 64
+ * elements at a time.
+ *
+ * @param series Series pointer
+ * @param index First element to set
+ * @param bits Validity bitmap, or NULL to mark the elements valid
+ * @param bit_offset Bit of bits that holds element index
+ * @param count Number of elements
+ * @return true on success, false if out of range or on allocation failure
+ */
+bool tablr_series_set_validity(TablrSeries* series, size_t index, const uint8_t* bits, size_t bit_offset,
+                               size_t count);
+
+/**
+ * @brief Get the validity bits of elements word * 64 to word * 64 + 63
+ *
+ * Bit j is set if element word * 64 + j is valid, in the order of an Arrow
+ * validity bitmap. Bits past the end of the series are 0.
+ *
+ * @param series Series pointer
+ * @param word Index of the 64-element block
+ * @return Validity bits of the block
+ */
+uint64_t tablr_series_validity_word(const TablrSeries* series, size_t word);
+
+/**
+ * @brief Get the bytes held by the buffer behind a series
+ *
+ * Counts the elements, string characters and validity bitmap, or for a
+ * compressed series the encoded form and any decoded copy. Views count
+ * their whole buffer.
+ *
  * @param series Series pointer
- * @return Pointer to data
+ * @return Size in bytes; 0 for NULL
  */
-void* tablr_series_data(const TablrSeries* series);
+size_t tablr_series_memory_usage(const TablrSeries* series);
 
 /**
- * @brief Copy series to different device
+ * @brief View series on a different device
+ *
+ * Shares the source's buffer, like tablr_series_slice().
+ *
  * @param series Source series
  * @param device Target device
  * @return New series on target device or NULL on failure
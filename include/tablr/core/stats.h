@@ -0,0 +1,76 @@
+/**
+ * @file stats.h
+ * @brief Cached per-series statistics
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_CORE_STATS_H
+#define TABLR_CORE_STATS_H
+
+#include "tablr/core/series.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Summary of the elements of a series
+ */
+typedef struct {
+    double min;           /**< Smallest valid value of a numeric series; INFINITY if none */
+    double max;           /**< Largest valid value of a numeric series; -INFINITY if none */
+    size_t null_count;    /**< Number of null elements */
+    size_t distinct;      /**< Estimated number of distinct valid values */
+    bool sorted;          /**< Valid values never decrease and nulls come last */
+    bool reverse_sorted;  /**< Valid values never increase and nulls come last */
+} TablrSeriesStats;
+
+/**
+ * @brief Get the statistics of a series, computing them on first use
+ *
+ * One scan fills in every field; the result is kept with the series and
+ * returned without scanning until the series is written through
+ * tablr_series_data(), tablr_series_string_buffers() or
+ * tablr_series_set_valid(). Full-length slices and device views start
+ * with a copy of the source's statistics.
+ *
+ * min and max ignore NaN and are only set for numeric, bool and bitmask
+ * series. Strings order by their bytes, shorter prefixes first, and
+ * categoricals by the bytes of their categories. A series holding NaN is
+ * never marked sorted. distinct is exact up to 256 values and within a few
+ * percent beyond.
+ *
+ * @param series Series to describe
+ * @param stats Output statistics
+ * @return true on success, false if series or stats is NULL
+ */
+bool tablr_series_stats(const TablrSeries* series, TablrSeriesStats* stats);
+
+/**
+ * @brief Get the statistics of a series only if they are already cached
+ *
+ * Lets operations use statistics as a hint without paying for a scan.
+ *
+ * @param series Series to describe
+ * @param stats Output statistics
+ * @return true if statistics were cached, false otherwise
+ */
+bool tablr_series_stats_cached(const TablrSeries* series, TablrSeriesStats* stats);
+
+/**
+ * @brief Drop the cached statistics of a series
+ *
+ * Needed only after writing through a pointer obtained before the
+ * statistics were last computed, or after changing the memory of an
+ * external series.
+ *
+ * @param series Series to modify (can be NULL)
+ */
+void tablr_series_invalidate_stats(TablrSeries* series);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TABLR_CORE_STATS_H */
@@ -10,6 +10,7 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,9 +25,41 @@ typedef enum {
     TABLR_FLOAT32,  /**< 32-bit floating point */
     TABLR_FLOAT64,  /**< 64-bit floating point */
     TABLR_STRING,   /**< String type */
-    TABLR_BOOL      /**< Boolean type */
+    TABLR_BOOL,     /**< Boolean type */
+    TABLR_CATEGORICAL, /**< int32 codes into a shared dictionary of strings */
+    TABLR_INT8,     /**< 8-bit signed integer */
+    TABLR_INT16,    /**< 16-bit signed integer */
+    TABLR_UINT8,    /**< 8-bit unsigned integer */
+    TABLR_UINT16,   /**< 16-bit unsigned integer */
+    TABLR_UINT32,   /**< 32-bit unsigned integer */
+    TABLR_UINT64,   /**< 64-bit unsigned integer */
+    TABLR_DATE32,   /**< Days since 1970-01-01 as int32 */
+    TABLR_TIMESTAMP64, /**< int64 time since 1970-01-01T00:00:00 UTC in the series' time unit */
+    TABLR_BITMASK   /**< Booleans packed 64 to a uint64 word, element i in bit i % 64 of word i / 64 */
 } TablrDType;
 
+/**
+ * @brief Resolution of TABLR_TIMESTAMP64 values
+ */
+typedef enum {
+    TABLR_TIME_SECOND,       /**< Seconds */
+    TABLR_TIME_MILLISECOND,  /**< Milliseconds */
+    TABLR_TIME_MICROSECOND,  /**< Microseconds */
+    TABLR_TIME_NANOSECOND    /**< Nanoseconds */
+} TablrTimeUnit;
+
+/**
+ * @brief Element-wise comparison operators
+ */
+typedef enum {
+    TABLR_CMP_EQ,  /**< Equal */
+    TABLR_CMP_NE,  /**< Not equal */
+    TABLR_CMP_LT,  /**< Less than */
+    TABLR_CMP_LE,  /**< Less than or equal */
+    TABLR_CMP_GT,  /**< Greater than */
+    TABLR_CMP_GE   /**< Greater than or equal */
+} TablrCompareOp;
+
 /**
  * @brief Device type enumeration for compute acceleration
  */
@@ -51,7 +84,7 @@ typedef struct TablrDataFrame TablrDataFrame;
 /**
  * @brief Get size of data type in bytes
  * @param dtype Data type
- * @return Size in bytes
+ * @return Size in bytes, or 0 for TABLR_BITMASK, whose elements are single bits
  */
 size_t tablr_dtype_size(TablrDType dtype);
 
@@ -62,6 +95,41 @@ size_t tablr_dtype_size(TablrDType dtype);
  */
 const char* tablr_dtype_name(TablrDType dtype);
 
+/**
+ * @brief Check whether a data type stores integers
+ *
+ * True for the signed and unsigned integer types, DATE32 and TIMESTAMP64,
+ * whose values are all compared and hashed as integers.
+ *
+ * @param dtype Data type
+ * @return true for integer types
+ */
+bool tablr_dtype_is_integer(TablrDType dtype);
+
+/**
+ * @brief Get the number of time units in one second
+ * @param unit Time unit
+ * @return 1, 1000, 1000000 or 1000000000
+ */
+int64_t tablr_time_unit_per_second(TablrTimeUnit unit);
+
+/**
+ * @brief Get the type two numeric types combine to
+ *
+ * Integers of one signedness give the wider type. A signed and an
+ * unsigned integer give the signed type if it is wider, else the next
+ * signed type wider than the unsigned one, or float64 beside uint64. A
+ * float and a type of at most 16 bits give the float; a float and a wider
+ * integer give float64. Bool counts as uint8 beside any other type.
+ *
+ * @param a First type
+ * @param b Second type
+ * @param out Output common type
+ * @return true on success, false if either type is not an integer, float
+ *         or bool type (dates and timestamps included)
+ */
+bool tablr_dtype_promote(TablrDType a, TablrDType b, TablrDType* out);
+
 #ifdef __cplusplus
 }
 #endif
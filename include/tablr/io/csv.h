@@ -14,6 +14,94 @@
 extern "C" {
 #endif
 
+/**
+ * @brief CSV read options
+ *
+ * Obtain defaults with tablr_csv_options_default() and override fields as
+ * needed. Columns without an explicit type are inferred from a row sample.
+ * Columns not selected by usecols are skipped without being converted.
+ */
+typedef struct {
+    char delimiter;                 /**< Column delimiter character */
+    bool has_header;                /**< Whether file has header row */
+    const TablrDType* dtypes;       /**< Explicit column types, or NULL to infer all */
+    const char** dtype_columns;     /**< Column names for dtypes, or NULL to apply by position */
+    size_t num_dtypes;              /**< Number of entries in dtypes */
+    size_t infer_rows;              /**< Number of rows sampled for type inference */
+    size_t batch_rows;              /**< Streaming batch row limit (0 for no limit) */
+    size_t batch_bytes;             /**< Streaming batch text size limit (0 for no limit) */
+    const char** usecols;           /**< Names of columns to read, or NULL */
+    const size_t* usecol_indices;   /**< Positions of columns to read when usecols is NULL */
+    size_t num_usecols;             /**< Number of selected columns (0 reads all) */
+    size_t nrows;                   /**< Maximum data rows to read (0 for no limit) */
+    size_t skiprows;                /**< Lines skipped at the start of the file, before the header */
+    char comment;                   /**< Lines starting with this character are skipped ('\0' for none) */
+    TablrTimeUnit time_unit;        /**< Unit of timestamp columns (default microseconds) */
+} TablrCsvOptions;
+
+/**
+ * @brief Streaming CSV reader handle
+ *
+ * Reads a file in batches of rows so memory use stays bounded by the batch
+ * size rather than the file size.
+ */
+typedef struct TablrCsvReader TablrCsvReader;
+
+/**
+ * @brief CSV write options
+ *
+ * Obtain defaults with tablr_csv_write_options_default() and override fields
+ * as needed.
+ */
+typedef struct {
+    char delimiter;                 /**< Column delimiter character */
+    bool write_header;              /**< Whether to write a header row */
+    size_t block_rows;              /**< Rows formatted per block */
+    bool parallel;                  /**< Whether blocks are formatted on worker threads */
+} TablrCsvWriteOptions;
+
+/**
+ * @brief Get default CSV read options (comma delimiter, with header, inferred types)
+ * @return Default options
+ */
+TablrCsvOptions tablr_csv_options_default(void);
+
+/**
+ * @brief Read CSV file into dataframe with options
+ * @param filename Path to CSV file
+ * @param options Read options (NULL for defaults)
+ * @return Pointer to dataframe or NULL on failure
+ */
+TablrDataFrame* tablr_read_csv_opts(const char* filename, const TablrCsvOptions* options);
+
+/**
+ * @brief Open a streaming CSV reader
+ * @param filename Path to CSV file
+ * @param options Read options including batch limits (NULL for defaults)
+ * @return Reader handle or NULL on failure
+ */
+TablrCsvReader* tablr_csv_reader_open(const char* filename, const TablrCsvOptions* options);
+
+/**
+ * @brief Read the next batch of rows
+ * @param reader Reader handle
+ * @return Pointer to a new dataframe owned by the caller, or NULL at end of file or on failure
+ */
+TablrDataFrame* tablr_csv_reader_next(TablrCsvReader* reader);
+
+/**
+ * @brief Check whether a reader stopped because of an error
+ * @param reader Reader handle
+ * @return true if reading failed, false otherwise
+ */
+bool tablr_csv_reader_failed(const TablrCsvReader* reader);
+
+/**
+ * @brief Close a streaming CSV reader
+ * @param reader Reader handle (may be NULL)
+ */
+void tablr_csv_reader_close(TablrCsvReader* reader);
+
 /**
  * @brief Read CSV file into dataframe
  * @param filename Path to CSV file
@@ -23,6 +111,21 @@ extern "C" {
  */
 TablrDataFrame* tablr_read_csv(const char* filename, char delimiter, bool has_header);
 
+/**
+ * @brief Get default CSV write options (comma delimiter, with header, parallel)
+ * @return Default options
+ */
+TablrCsvWriteOptions tablr_csv_write_options_default(void);
+
+/**
+ * @brief Write dataframe to CSV file with options
+ * @param df DataFrame to write
+ * @param filename Output file path
+ * @param options Write options (NULL for defaults)
+ * @return true on success, false on failure
+ */
+bool tablr_to_csv_opts(const TablrDataFrame* df, const char* filename, const TablrCsvWriteOptions* options);
+
 /**
  * @brief Write dataframe to CSV file
  * @param df DataFrame to write
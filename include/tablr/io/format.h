@@ -0,0 +1,84 @@
+/**
+ * @file format.h
+ * @brief Locale-independent numeric and date text formatting
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_IO_FORMAT_H
+#define TABLR_IO_FORMAT_H
+
+#include "tablr/core/types.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Buffer size that holds any formatted number or timestamp including the NUL
+ */
+#define TABLR_FORMAT_BUFFER_SIZE 32
+
+/**
+ * @brief Format a double with the fewest digits that parse back to the same value
+ * @param value Value to format
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_format_double(double value, char* buf);
+
+/**
+ * @brief Format a float with the fewest digits that parse back to the same value
+ * @param value Value to format
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_format_float(float value, char* buf);
+
+/**
+ * @brief Format a signed decimal integer
+ * @param value Value to format
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_format_int64(int64_t value, char* buf);
+
+/**
+ * @brief Format a signed decimal integer
+ * @param value Value to format
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_format_int32(int32_t value, char* buf);
+
+/**
+ * @brief Format an unsigned decimal integer
+ * @param value Value to format
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_format_uint64(uint64_t value, char* buf);
+
+/**
+ * @brief Format a date as ISO-8601 YYYY-MM-DD
+ * @param days Days since 1970-01-01
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_format_date32(int32_t days, char* buf);
+
+/**
+ * @brief Format a timestamp as ISO-8601 YYYY-MM-DDTHH:MM:SS[.fraction]
+ * @param value Time since the Unix epoch in unit
+ * @param unit Resolution of value
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_format_timestamp(int64_t value, TablrTimeUnit unit, char* buf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TABLR_IO_FORMAT_H */
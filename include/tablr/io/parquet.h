@@ -0,0 +1,85 @@
+/**
+ * @file parquet.h
+ * @brief Apache Parquet file reading and writing
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_IO_PARQUET_H
+#define TABLR_IO_PARQUET_H
+
+#include "tablr/core/dataframe.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Page compression codec
+ */
+typedef enum {
+    TABLR_PARQUET_UNCOMPRESSED,  /**< No compression */
+    TABLR_PARQUET_SNAPPY,        /**< Snappy (built in) */
+    TABLR_PARQUET_ZSTD           /**< Zstandard (requires the zstd shared library at runtime) */
+} TablrParquetCompression;
+
+/**
+ * @brief Parquet read options
+ *
+ * Obtain defaults with tablr_parquet_read_options_default() and override
+ * fields as needed.
+ */
+typedef struct {
+    const char** columns;       /**< Names of columns to read in file order, or NULL for all */
+    size_t num_columns;         /**< Number of entries in columns */
+    const char* filter_column;  /**< Numeric column whose row-group statistics are checked, or NULL */
+    double filter_min;          /**< Skip row groups whose maximum is below this value */
+    double filter_max;          /**< Skip row groups whose minimum is above this value */
+} TablrParquetReadOptions;
+
+/**
+ * @brief Parquet write options
+ *
+ * Obtain defaults with tablr_parquet_write_options_default() and override
+ * fields as needed.
+ */
+typedef struct {
+    size_t row_group_rows;                /**< Rows per row group (0 writes one row group) */
+    TablrParquetCompression compression;  /**< Page compression codec */
+    bool dictionary;                      /**< Dictionary-encode string columns with repeated values */
+} TablrParquetWriteOptions;
+
+/**
+ * @brief Get default Parquet read options (all columns, all row groups)
+ * @return Default options
+ */
+TablrParquetReadOptions tablr_parquet_read_options_default(void);
+
+/**
+ * @brief Get default Parquet write options (1M-row groups, snappy, dictionary strings)
+ * @return Default options
+ */
+TablrParquetWriteOptions tablr_parquet_write_options_default(void);
+
+/**
+ * @brief Read a Parquet file into a dataframe
+ * @param filename Path to file
+ * @param options Read options (NULL for defaults)
+ * @return Pointer to dataframe or NULL on failure
+ */
+TablrDataFrame* tablr_read_parquet(const char* filename, const TablrParquetReadOptions* options);
+
+/**
+ * @brief Write dataframe to a Parquet file
+ * @param df DataFrame to write
+ * @param filename Output file path
+ * @param options Write options (NULL for defaults)
+ * @return true on success, false on failure
+ */
+bool tablr_write_parquet(const TablrDataFrame* df, const char* filename, const TablrParquetWriteOptions* options);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TABLR_IO_PARQUET_H */
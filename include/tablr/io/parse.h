@@ -0,0 +1,81 @@
+/**
+ * @file parse.h
+ * @brief Locale-independent numeric and date text parsing
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_IO_PARSE_H
+#define TABLR_IO_PARSE_H
+
+#include "tablr/core/types.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Parse a decimal integer
+ * @param text Field text (need not be NUL-terminated)
+ * @param len Field length in bytes
+ * @param out Output value
+ * @return true if the whole field is a valid int32, false otherwise
+ */
+bool tablr_parse_int32(const char* text, size_t len, int32_t* out);
+
+/**
+ * @brief Parse a decimal integer
+ * @param text Field text (need not be NUL-terminated)
+ * @param len Field length in bytes
+ * @param out Output value
+ * @return true if the whole field is a valid int64, false otherwise
+ */
+bool tablr_parse_int64(const char* text, size_t len, int64_t* out);
+
+/**
+ * @brief Parse a decimal floating point number, correctly rounded
+ * @param text Field text (need not be NUL-terminated), '.' is always the decimal point
+ * @param len Field length in bytes
+ * @param out Output value
+ * @return true if the whole field is a valid number, false otherwise
+ */
+bool tablr_parse_double(const char* text, size_t len, double* out);
+
+/**
+ * @brief Parse a decimal unsigned integer
+ * @param text Field text (need not be NUL-terminated)
+ * @param len Field length in bytes
+ * @param out Output value
+ * @return true if the whole field is a valid uint64, false otherwise
+ */
+bool tablr_parse_uint64(const char* text, size_t len, uint64_t* out);
+
+/**
+ * @brief Parse an ISO-8601 date (YYYY-MM-DD)
+ * @param text Field text (need not be NUL-terminated)
+ * @param len Field length in bytes
+ * @param out Output days since 1970-01-01
+ * @return true if the whole field is a valid date, false otherwise
+ */
+bool tablr_parse_date32(const char* text, size_t len, int32_t* out);
+
+/**
+ * @brief Parse an ISO-8601 timestamp
+ *
+ * Accepts a date alone or followed by 'T' or ' ' and HH:MM[:SS[.fraction]],
+ * with an optional Z or +HH:MM zone. Zoned times are converted to UTC.
+ *
+ * @param text Field text (need not be NUL-terminated)
+ * @param len Field length in bytes
+ * @param unit Resolution of the result
+ * @param out Output time since the Unix epoch in unit
+ * @return true if the whole field is a valid timestamp within range, false otherwise
+ */
+bool tablr_parse_timestamp(const char* text, size_t len, TablrTimeUnit unit, int64_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TABLR_IO_PARSE_H */
@@ -0,0 +1,103 @@
+/**
+ * @file tbl.h
+ * @brief Native memory-mappable columnar file format
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_IO_TBL_H
+#define TABLR_IO_TBL_H
+
+#include "tablr/core/dataframe.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Tablr binary file write options
+ *
+ * Obtain defaults with tablr_tbl_options_default() and override fields as
+ * needed.
+ */
+typedef struct {
+    size_t block_rows;  /**< Rows per min/max statistics block (0 writes no statistics) */
+} TablrTblOptions;
+
+/**
+ * @brief Opaque handle to an open Tablr binary file
+ */
+typedef struct TablrTblFile TablrTblFile;
+
+/**
+ * @brief Get default Tablr binary write options (statistics every 65536 rows)
+ * @return Default options
+ */
+TablrTblOptions tablr_tbl_options_default(void);
+
+/**
+ * @brief Write dataframe to a Tablr binary file
+ * @param df DataFrame to write
+ * @param filename Output file path
+ * @param options Write options (NULL for defaults)
+ * @return true on success, false on failure
+ */
+bool tablr_to_tbl(const TablrDataFrame* df, const char* filename, const TablrTblOptions* options);
+
+/**
+ * @brief Read a Tablr binary file into a dataframe without copying column data
+ * @param filename Path to file
+ * @return Pointer to dataframe or NULL on failure
+ */
+TablrDataFrame* tablr_read_tbl(const char* filename);
+
+/**
+ * @brief Open a Tablr binary file
+ * @param filename Path to file
+ * @return File handle or NULL on failure
+ */
+TablrTblFile* tablr_tbl_open(const char* filename);
+
+/**
+ * @brief Close a Tablr binary file
+ * @param file File handle (may be NULL); dataframes already created stay valid
+ */
+void tablr_tbl_close(TablrTblFile* file);
+
+/**
+ * @brief Get number of rows in a Tablr binary file
+ * @param file File handle
+ * @return Number of rows
+ */
+size_t tablr_tbl_nrows(const TablrTblFile* file);
+
+/**
+ * @brief Get rows per statistics block
+ * @param file File handle
+ * @return Rows per block, or 0 if the file has no statistics
+ */
+size_t tablr_tbl_block_rows(const TablrTblFile* file);
+
+/**
+ * @brief Get minimum and maximum of a column within one block
+ * @param file File handle
+ * @param column Column name
+ * @param block Block index
+ * @param min Output minimum, one value of the column's type
+ * @param max Output maximum, one value of the column's type
+ * @return true on success, false if there are no statistics for the column or block
+ */
+bool tablr_tbl_block_minmax(const TablrTblFile* file, const char* column, size_t block, void* min, void* max);
+
+/**
+ * @brief Create a dataframe whose columns point into the file mapping
+ * @param file File handle
+ * @return Pointer to dataframe or NULL on failure
+ */
+TablrDataFrame* tablr_tbl_dataframe(const TablrTblFile* file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TABLR_IO_TBL_H */
@@ -0,0 +1,114 @@
+/**
+ * @file arith.h
+ * @brief Element-wise arithmetic, comparison and casts on the CPU
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_OPS_ARITH_H
+#define TABLR_OPS_ARITH_H
+
+#include "tablr/core/series.h"
+#include "tablr/core/cpu.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Element-wise arithmetic operators
+ */
+typedef enum {
+    TABLR_ARITH_ADD,  /**< a + b */
+    TABLR_ARITH_SUB,  /**< a - b */
+    TABLR_ARITH_MUL,  /**< a * b */
+    TABLR_ARITH_DIV,  /**< a / b, always in floating point */
+    TABLR_ARITH_MIN,  /**< Smaller of a and b */
+    TABLR_ARITH_MAX   /**< Larger of a and b */
+} TablrArithOp;
+
+/**
+ * @brief Apply an operator to two series element by element
+ *
+ * Element i of the result is a[i] op b[i]. A series of one element, or a
+ * constant series without nulls, is broadcast against the other series
+ * without being expanded. The result is null where either element is null.
+ *
+ * The result type is tablr_dtype_promote() of the two types, with these
+ * exceptions:
+ * - Division gives float64 unless the promoted type is a float.
+ * - Addition, subtraction and multiplication of bools give uint8.
+ * - A date or timestamp plus or minus an integer keeps its type; the
+ *   difference of two dates or timestamps is int64. Other arithmetic on
+ *   dates and timestamps is limited to min and max of one type and unit.
+ *
+ * Integer arithmetic wraps on overflow. Min and max give NaN if either
+ * element is NaN. Kernels are vectorized for SSE4.2, AVX2, AVX-512 or NEON,
+ * whichever the CPU supports best (see tablr_arith_simd_level()).
+ *
+ * @param a First operand
+ * @param op Operator
+ * @param b Second operand
+ * @return New series, or NULL on failure, unsupported types or sizes that
+ *         neither match nor broadcast
+ */
+TablrSeries* tablr_series_arith(const TablrSeries* a, TablrArithOp op, const TablrSeries* b);
+
+/**
+ * @brief Apply an operator to every element of a series and a value
+ *
+ * The value takes the type of the series if the series holds floats or the
+ * value is a whole number in the series' range; otherwise it is float64.
+ * Dates and timestamps add and subtract the value as a count of days or
+ * time units. For value op series, pass a constant series from
+ * tablr_series_full() to tablr_series_arith().
+ *
+ * @param series First operand
+ * @param op Operator
+ * @param value Second operand
+ * @return New series, or NULL on failure or unsupported types
+ */
+TablrSeries* tablr_series_arith_scalar(const TablrSeries* series, TablrArithOp op, double value);
+
+/**
+ * @brief Compare two series element by element
+ *
+ * Both series are compared in tablr_dtype_promote() of their types, and
+ * broadcast as in tablr_series_arith(). Dates and timestamps compare with
+ * their own type and unit only. To compare with a value, use
+ * tablr_series_compare().
+ *
+ * @param a First operand
+ * @param op Comparison
+ * @param b Second operand
+ * @return New bitmask series, null where either element is null, or NULL
+ *         on failure or unsupported types
+ */
+TablrSeries* tablr_series_compare_series(const TablrSeries* a, TablrCompareOp op, const TablrSeries* b);
+
+/**
+ * @brief Convert a series to another type
+ *
+ * Works between the integer, float and bool types, and between dates or
+ * timestamps and integers, which see their stored day or unit counts.
+ * Floats are truncated toward zero. Elements that do not fit the new type,
+ * such as NaN or 300 cast to int8, become null; conversion to bool gives
+ * true for every non-zero element. Casting to the same type returns a view.
+ *
+ * @param series Series to convert
+ * @param dtype New type
+ * @return New series, or NULL on failure or unsupported types
+ */
+TablrSeries* tablr_series_cast(const TablrSeries* series, TablrDType dtype);
+
+/**
+ * @brief Get the instruction set the arithmetic kernels run on
+ * @return SIMD level chosen for this CPU
+ */
+TablrSimdLevel tablr_arith_simd_level(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TABLR_OPS_ARITH_H */
@@ -0,0 +1,121 @@
+/**
+ * @file bitmask.h
+ * @brief Bit-packed boolean columns and mask kernels
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_OPS_BITMASK_H
+#define TABLR_OPS_BITMASK_H
+
+#include "tablr/core/series.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Pack a bool series into a bitmask series
+ *
+ * Nulls stay null. A bitmask series is returned as a view of itself.
+ *
+ * @param series Bool or bitmask series
+ * @return New bitmask series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_series_to_bitmask(const TablrSeries* series);
+
+/**
+ * @brief Unpack a bitmask series into a bool series
+ * @param series Bitmask series
+ * @return New bool series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_series_from_bitmask(const TablrSeries* series);
+
+/**
+ * @brief Get one element of a bitmask series
+ * @param mask Bitmask series
+ * @param index Element index
+ * @return Value of the element; false if out of range or not a bitmask
+ */
+bool tablr_bitmask_get(const TablrSeries* mask, size_t index);
+
+/**
+ * @brief Set one element of a bitmask series
+ *
+ * Copies the series first if its data is shared, like tablr_series_data().
+ *
+ * @param mask Bitmask series
+ * @param index Element index
+ * @param value New value
+ * @return true on success, false if out of range, not a bitmask or a copy failed
+ */
+bool tablr_bitmask_set(TablrSeries* mask, size_t index, bool value);
+
+/**
+ * @brief Get elements word * 64 to word * 64 + 63 of a bitmask series
+ *
+ * Bits past the end of the series are 0.
+ *
+ * @param mask Bitmask series
+ * @param word Block index
+ * @return Element bits, or 0 if out of range or not a bitmask
+ */
+uint64_t tablr_bitmask_word(const TablrSeries* mask, size_t word);
+
+/**
+ * @brief Element-wise AND of two bitmasks of the same length
+ *
+ * An element of the result is null if it is null in either input.
+ *
+ * @param a First bitmask
+ * @param b Second bitmask
+ * @return New bitmask series, or NULL on failure or mismatched inputs
+ */
+TablrSeries* tablr_bitmask_and(const TablrSeries* a, const TablrSeries* b);
+
+/**
+ * @brief Element-wise OR of two bitmasks of the same length
+ *
+ * An element of the result is null if it is null in either input.
+ *
+ * @param a First bitmask
+ * @param b Second bitmask
+ * @return New bitmask series, or NULL on failure or mismatched inputs
+ */
+TablrSeries* tablr_bitmask_or(const TablrSeries* a, const TablrSeries* b);
+
+/**
+ * @brief Element-wise NOT of a bitmask
+ *
+ * Null elements stay null.
+ *
+ * @param mask Bitmask series
+ * @return New bitmask series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_bitmask_not(const TablrSeries* mask);
+
+/**
+ * @brief Count the set, valid elements of a bitmask
+ * @param mask Bitmask series
+ * @return Number of true elements; 0 for NULL or other types
+ */
+size_t tablr_bitmask_count(const TablrSeries* mask);
+
+/**
+ * @brief Get the indices of the set, valid elements of a bitmask
+ *
+ * The indices are in increasing order, ready for
+ * tablr_dataframe_select_rows().
+ *
+ * @param mask Bitmask series
+ * @param count Output number of indices
+ * @return Array to free with free(), or NULL on failure or for other types
+ */
+size_t* tablr_bitmask_indices(const TablrSeries* mask, size_t* count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TABLR_OPS_BITMASK_H */
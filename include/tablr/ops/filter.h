@@ -31,6 +31,48 @@ typedef bool (*TablrFilterFunc)(size_t row, void* ctx);
  */
 TablrDataFrame* tablr_dataframe_filter(const TablrDataFrame* df, TablrFilterFunc predicate, void* ctx);
 
+/**
+ * @brief Keep the rows where a mask is true
+ *
+ * The mask is a bitmask or bool series with one element per row; null
+ * elements count as false. Masks can be combined first with
+ * tablr_bitmask_and() and tablr_bitmask_or().
+ *
+ * @param df Source dataframe
+ * @param mask Row mask
+ * @return New filtered dataframe or NULL on failure or if the mask does not match
+ */
+TablrDataFrame* tablr_dataframe_filter_mask(const TablrDataFrame* df, const TablrSeries* mask);
+
+/**
+ * @brief Keep the rows where a numeric column compares true with a value
+ *
+ * Uses tablr_series_compare(), so a compressed column is filtered without
+ * decoding the runs and blocks whose values decide the comparison. Rows
+ * with a null in the column are dropped.
+ *
+ * @param df Source dataframe
+ * @param column Integer, float or bool column
+ * @param op Comparison
+ * @param value Value to compare with
+ * @return New filtered dataframe or NULL on failure
+ */
+TablrDataFrame* tablr_dataframe_filter_compare(const TablrDataFrame* df, const char* column,
+                                               TablrCompareOp op, double value);
+
+/**
+ * @brief Filter rows whose column equals a string
+ *
+ * Works on string and categorical columns. A categorical column is matched
+ * by comparing codes, without string comparisons per row.
+ *
+ * @param df Source dataframe
+ * @param column Column name
+ * @param value Value to keep
+ * @return New filtered dataframe or NULL on failure or for other column types
+ */
+TablrDataFrame* tablr_dataframe_filter_equals(const TablrDataFrame* df, const char* column, const char* value);
+
 /**
  * @brief Select rows by index array
  * @param df Source dataframe
@@ -29,6 +29,11 @@ typedef enum {
 
 /**
  * @brief Group dataframe by column
+ *
+ * Returns the rows reordered so that rows with equal values in column are
+ * contiguous, groups in order of first appearance and null keys last.
+ * Categorical keys are grouped by code without comparing strings.
+ *
  * @param df Source dataframe
  * @param column Column name to group by
  * @return New grouped dataframe or NULL on failure
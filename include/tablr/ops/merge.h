@@ -26,6 +26,12 @@ typedef enum {
 
 /**
  * @brief Merge two dataframes on a column
+ *
+ * The output has the left columns followed by the right columns other than
+ * on, with rows in left order. Unmatched rows that the join type keeps get
+ * nulls on the other side; right-only rows come last. Null keys never
+ * match. Categorical keys are matched by code.
+ *
  * @param left Left dataframe
  * @param right Right dataframe
  * @param on Column name to join on
@@ -37,6 +43,10 @@ TablrDataFrame* tablr_dataframe_merge(const TablrDataFrame* left, const TablrDat
 
 /**
  * @brief Concatenate dataframes vertically
+ *
+ * Categorical columns with different dictionaries get a merged dictionary.
+ * Timestamp columns are converted to the time unit of the first dataframe.
+ *
  * @param dfs Array of dataframes
  * @param count Number of dataframes
  * @return New concatenated dataframe or NULL on failure
@@ -26,9 +26,23 @@
 
 #include "tablr/core/types.h"
 #include "tablr/core/series.h"
+#include "tablr/core/categorical.h"
+#include "tablr/core/encoding.h"
+#include "tablr/core/stats.h"
+#include "tablr/core/chunked.h"
 #include "tablr/core/dataframe.h"
+#include "tablr/core/parallel.h"
+#include "tablr/core/allocator.h"
+#include "tablr/core/cpu.h"
+#include "tablr/core/arrow.h"
 #include "tablr/io/csv.h"
+#include "tablr/io/parse.h"
+#include "tablr/io/format.h"
+#include "tablr/io/tbl.h"
+#include "tablr/io/parquet.h"
 #include "tablr/ops/filter.h"
+#include "tablr/ops/bitmask.h"
+#include "tablr/ops/arith.h"
 #include "tablr/ops/sort.h"
 #include "tablr/ops/groupby.h"
 #include "tablr/ops/merge.h"
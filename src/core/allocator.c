@@ -0,0 +1,453 @@
+/**
+ * @file allocator.c
+ * @brief Implementation of series data allocators
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * This file implements the default aligned allocator, a pool allocator with
+ * per-thread caches of power-of-two size classes, and bump-pointer arenas.
+ * Series buffers are allocated through the allocator selected for the
+ * calling thread, falling back to the global one.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "tablr/core/allocator.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <malloc.h>
+#else
+#include <pthread.h>
+#endif
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+#define POOL_MIN_SHIFT 6                  /**< Smallest class is 64 bytes */
+#define POOL_CLASSES 20                   /**< Classes from 64 B to 32 MB */
+#define POOL_CACHE_BYTES ((size_t)32 << 20)  /**< Cached bytes kept per thread, across classes */
+#define POOL_CACHE_COUNT 64               /**< Cached blocks kept per class and thread */
+
+#define ARENA_DEFAULT_BLOCK ((size_t)1 << 20)  /**< Default arena block size */
+#define ARENA_HEADER TABLR_ALIGNMENT           /**< Block header size, keeps data aligned */
+
+/* ========================================================================
+ * Default allocator
+ * ======================================================================== */
+
+static void* system_alloc(void* ctx, size_t size) {
+    (void)ctx;
+    if (size == 0) size = 1;
+#ifdef _WIN32
+    return _aligned_malloc(size, TABLR_ALIGNMENT);
+#else
+    void* ptr = NULL;
+    return posix_memalign(&ptr, TABLR_ALIGNMENT, size) == 0 ? ptr : NULL;
+#endif
+}
+
+static void system_free(void* ctx, void* ptr, size_t size) {
+    (void)ctx;
+    (void)size;
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+static const TablrAllocator system_allocator = { system_alloc, system_free, NULL };
+
+static const TablrAllocator* global_allocator = &system_allocator;
+static THREAD_LOCAL const TablrAllocator* thread_allocator = NULL;
+
+/**
+ * @brief Get the default allocator
+ *
+ * Allocates with posix_memalign (POSIX) or _aligned_malloc (Windows).
+ *
+ * @return Allocator pointer
+ */
+const TablrAllocator* tablr_default_allocator(void) {
+    return &system_allocator;
+}
+
+/**
+ * @brief Set the global allocator
+ *
+ * @param allocator Allocator to use, or NULL for the default allocator
+ */
+void tablr_set_allocator(const TablrAllocator* allocator) {
+    global_allocator = allocator ? allocator : &system_allocator;
+}
+
+/**
+ * @brief Set the calling thread's allocator
+ *
+ * @param allocator Allocator to use, or NULL to fall back to the global one
+ * @return Previous thread allocator, or NULL if none was set
+ */
+const TablrAllocator* tablr_set_thread_allocator(const TablrAllocator* allocator) {
+    const TablrAllocator* previous = thread_allocator;
+    thread_allocator = allocator;
+    return previous;
+}
+
+/**
+ * @brief Get the allocator for the calling thread
+ *
+ * @return Thread allocator if set, otherwise the global allocator
+ */
+const TablrAllocator* tablr_get_allocator(void) {
+    return thread_allocator ? thread_allocator : global_allocator;
+}
+
+/* ========================================================================
+ * Pool allocator
+ * ======================================================================== */
+
+/**
+ * @brief Free block kept in a thread cache
+ */
+typedef struct PoolBlock {
+    struct PoolBlock* next;  /**< Next cached block of the same class */
+} PoolBlock;
+
+/**
+ * @brief Per-thread lists of free blocks, one per size class
+ */
+typedef struct {
+    PoolBlock* head[POOL_CLASSES];  /**< Cached blocks */
+    size_t count[POOL_CLASSES];     /**< Number of cached blocks */
+    size_t bytes;                   /**< Bytes of every cached block */
+} PoolCache;
+
+static THREAD_LOCAL PoolCache* thread_cache = NULL;
+
+/**
+ * @brief Release every cached block and the cache itself
+ */
+static void cache_destroy(void* ptr) {
+    PoolCache* cache = (PoolCache*)ptr;
+    if (!cache) return;
+
+    for (int c = 0; c < POOL_CLASSES; c++) {
+        while (cache->head[c]) {
+            PoolBlock* block = cache->head[c];
+            cache->head[c] = block->next;
+            system_free(NULL, block, 0);
+        }
+    }
+    if (thread_cache == cache) thread_cache = NULL;
+    free(cache);
+}
+
+#ifdef _WIN32
+static DWORD cache_key = FLS_OUT_OF_INDEXES;
+static INIT_ONCE cache_once = INIT_ONCE_STATIC_INIT;
+
+static VOID WINAPI cache_exit(PVOID ptr) {
+    cache_destroy(ptr);
+}
+
+static BOOL CALLBACK cache_key_create(PINIT_ONCE once, PVOID param, PVOID* context) {
+    (void)once;
+    (void)param;
+    (void)context;
+    cache_key = FlsAlloc(cache_exit);
+    return TRUE;
+}
+#else
+static pthread_key_t cache_key;
+static pthread_once_t cache_once = PTHREAD_ONCE_INIT;
+static bool cache_key_ok = false;
+
+static void cache_key_create(void) {
+    cache_key_ok = pthread_key_create(&cache_key, cache_destroy) == 0;
+}
+#endif
+
+/**
+ * @brief Get the calling thread's cache, creating it on first use
+ *
+ * The cache is registered so that it is drained when the thread exits.
+ *
+ * @return Cache pointer, or NULL if it could not be created
+ */
+static PoolCache* get_cache(void) {
+    if (thread_cache) return thread_cache;
+
+#ifdef _WIN32
+    InitOnceExecuteOnce(&cache_once, cache_key_create, NULL, NULL);
+    if (cache_key == FLS_OUT_OF_INDEXES) return NULL;
+#else
+    pthread_once(&cache_once, cache_key_create);
+    if (!cache_key_ok) return NULL;
+#endif
+
+    PoolCache* cache = (PoolCache*)calloc(1, sizeof(PoolCache));
+    if (!cache) return NULL;
+
+#ifdef _WIN32
+    bool registered = FlsSetValue(cache_key, cache) != 0;
+#else
+    bool registered = pthread_setspecific(cache_key, cache) == 0;
+#endif
+    if (!registered) {
+        free(cache);
+        return NULL;
+    }
+    thread_cache = cache;
+    return cache;
+}
+
+/**
+ * @brief Get the size class of an allocation
+ * @return Class index, or -1 if the size is too large to pool
+ */
+static int size_class(size_t size) {
+    int c = 0;
+    size_t class_size = (size_t)1 << POOL_MIN_SHIFT;
+    while (class_size < size && c < POOL_CLASSES) {
+        class_size <<= 1;
+        c++;
+    }
+    return c < POOL_CLASSES ? c : -1;
+}
+
+static void* pool_alloc(void* ctx, size_t size) {
+    int c = size_class(size);
+    if (c < 0) return system_alloc(ctx, size);
+
+    PoolCache* cache = get_cache();
+    if (cache && cache->head[c]) {
+        PoolBlock* block = cache->head[c];
+        cache->head[c] = block->next;
+        cache->count[c]--;
+        cache->bytes -= (size_t)1 << (c + POOL_MIN_SHIFT);
+        return block;
+    }
+    return system_alloc(ctx, (size_t)1 << (c + POOL_MIN_SHIFT));
+}
+
+static void pool_free(void* ctx, void* ptr, size_t size) {
+    if (!ptr) return;
+
+    /* Keep the block unless the class list or the thread's total is full */
+    int c = size_class(size);
+    PoolCache* cache = c >= 0 ? get_cache() : NULL;
+    size_t class_bytes = c >= 0 ? (size_t)1 << (c + POOL_MIN_SHIFT) : 0;
+    if (!cache || cache->count[c] >= POOL_CACHE_COUNT || cache->bytes + class_bytes > POOL_CACHE_BYTES) {
+        system_free(ctx, ptr, size);
+        return;
+    }
+
+    PoolBlock* block = (PoolBlock*)ptr;
+    block->next = cache->head[c];
+    cache->head[c] = block;
+    cache->count[c]++;
+    cache->bytes += class_bytes;
+}
+
+static const TablrAllocator pool_allocator = { pool_alloc, pool_free, NULL };
+
+/**
+ * @brief Get the pool allocator
+ *
+ * @return Allocator pointer
+ */
+const TablrAllocator* tablr_pool_allocator(void) {
+    return &pool_allocator;
+}
+
+/**
+ * @brief Return the calling thread's cached pool blocks to the system
+ */
+void tablr_pool_trim(void) {
+    PoolCache* cache = thread_cache;
+    if (!cache) return;
+
+    for (int c = 0; c < POOL_CLASSES; c++) {
+        while (cache->head[c]) {
+            PoolBlock* block = cache->head[c];
+            cache->head[c] = block->next;
+            system_free(NULL, block, 0);
+        }
+        cache->count[c] = 0;
+    }
+    cache->bytes = 0;
+}
+
+/* ========================================================================
+ * Arena allocator
+ * ======================================================================== */
+
+/**
+ * @brief Arena block; data starts ARENA_HEADER bytes after the header
+ */
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;  /**< Next block (older, or dedicated) */
+    size_t size;              /**< Usable bytes after the header */
+    size_t used;              /**< Bytes handed out */
+} ArenaBlock;
+
+/**
+ * @brief Internal arena structure
+ */
+struct TablrArena {
+    TablrAllocator allocator;  /**< Allocator handing out arena memory */
+    ArenaBlock* blocks;        /**< Blocks, the one being filled first */
+    size_t block_size;         /**< Usable bytes per regular block */
+    size_t reserved;           /**< Total bytes of all blocks */
+#ifdef _WIN32
+    SRWLOCK lock;              /**< Guards the block list */
+#else
+    pthread_mutex_t lock;      /**< Guards the block list */
+#endif
+};
+
+/**
+ * @brief Allocate a block with room for size bytes
+ */
+static ArenaBlock* arena_block_new(TablrArena* arena, size_t size) {
+    ArenaBlock* block = (ArenaBlock*)system_alloc(NULL, ARENA_HEADER + size);
+    if (!block) return NULL;
+
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    arena->reserved += ARENA_HEADER + size;
+    return block;
+}
+
+static void* arena_alloc(void* ctx, size_t size) {
+    TablrArena* arena = (TablrArena*)ctx;
+    size = (size + TABLR_ALIGNMENT - 1) & ~(size_t)(TABLR_ALIGNMENT - 1);
+    if (size == 0) size = TABLR_ALIGNMENT;
+
+    void* ptr = NULL;
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&arena->lock);
+#else
+    pthread_mutex_lock(&arena->lock);
+#endif
+
+    ArenaBlock* head = arena->blocks;
+    if (size > arena->block_size / 4) {
+        /* Large requests get a dedicated block behind the one being filled */
+        ArenaBlock* block = arena_block_new(arena, size);
+        if (block) {
+            block->used = size;
+            if (head) {
+                block->next = head->next;
+                head->next = block;
+            } else {
+                arena->blocks = block;
+            }
+            ptr = (char*)block + ARENA_HEADER;
+        }
+    } else {
+        if (!head || head->size - head->used < size) {
+            ArenaBlock* block = arena_block_new(arena, arena->block_size);
+            if (block) {
+                block->next = head;
+                arena->blocks = block;
+            }
+            head = block;
+        }
+        if (head) {
+            ptr = (char*)head + ARENA_HEADER + head->used;
+            head->used += size;
+        }
+    }
+
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(&arena->lock);
+#else
+    pthread_mutex_unlock(&arena->lock);
+#endif
+    return ptr;
+}
+
+/**
+ * @brief Individual arena allocations are released with the arena
+ *
+ * Does not touch ctx, so series may be freed after their arena.
+ */
+static void arena_release(void* ctx, void* ptr, size_t size) {
+    (void)ctx;
+    (void)ptr;
+    (void)size;
+}
+
+/**
+ * @brief Create an arena
+ *
+ * @param block_size Bytes per block (0 for 1 MB)
+ * @return Pointer to arena, or NULL on failure
+ */
+TablrArena* tablr_arena_create(size_t block_size) {
+    TablrArena* arena = (TablrArena*)calloc(1, sizeof(TablrArena));
+    if (!arena) return NULL;
+
+#ifdef _WIN32
+    InitializeSRWLock(&arena->lock);
+#else
+    if (pthread_mutex_init(&arena->lock, NULL) != 0) {
+        free(arena);
+        return NULL;
+    }
+#endif
+    arena->block_size = block_size ? block_size : ARENA_DEFAULT_BLOCK;
+    arena->allocator.alloc = arena_alloc;
+    arena->allocator.free = arena_release;
+    arena->allocator.ctx = arena;
+    return arena;
+}
+
+/**
+ * @brief Get the allocator that allocates from an arena
+ *
+ * @param arena Arena
+ * @return Allocator pointer, or NULL if arena is NULL
+ */
+const TablrAllocator* tablr_arena_allocator(TablrArena* arena) {
+    return arena ? &arena->allocator : NULL;
+}
+
+/**
+ * @brief Get the number of bytes an arena has reserved
+ *
+ * @param arena Arena
+ * @return Total size of its blocks, or 0 if arena is NULL
+ */
+size_t tablr_arena_reserved(const TablrArena* arena) {
+    return arena ? arena->reserved : 0;
+}
+
+/**
+ * @brief Release an arena and all of its blocks
+ *
+ * @param arena Arena to free (can be NULL)
+ */
+void tablr_arena_free(TablrArena* arena) {
+    if (!arena) return;
+
+    while (arena->blocks) {
+        ArenaBlock* block = arena->blocks;
+        arena->blocks = block->next;
+        system_free(NULL, block, 0);
+    }
+#ifndef _WIN32
+    pthread_mutex_destroy(&arena->lock);
+#endif
+    free(arena);
+}
@@ -0,0 +1,622 @@
+/**
+ * @file arrow.c
+ * @brief Implementation of Arrow C Data Interface import and export
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * A dataframe maps to a struct array with one child per column. Exported
+ * numeric and string children point at the series data and hold a reference
+ * to it via tablr_series_share_data; imported numeric and large utf8
+ * children are moved out of the
+ * parent and released when the series that uses them is freed. Every child
+ * has its own private data, so consumers may move children independently as
+ * the interface allows.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#ifdef _WIN32
+#define strdup _strdup
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "tablr/core/arrow.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#define ARROW_MAX_BUFFERS 3  /**< Validity, offsets and data */
+
+/**
+ * @brief Private data of an exported column
+ */
+typedef struct {
+    const void* buffers[ARROW_MAX_BUFFERS];  /**< Buffer pointers handed to the consumer */
+    void* owned[ARROW_MAX_BUFFERS];          /**< Converted buffers freed on release */
+    TablrReleaseFunc release;                /**< Drops the shared series data, or NULL */
+    void* release_ctx;                       /**< Context of release */
+    struct ArrowArray dictionary;            /**< Categories of a categorical column */
+} ExportColumn;
+
+/**
+ * @brief Private data of an exported struct array
+ */
+typedef struct {
+    const void* validity;          /**< Struct validity (always NULL) */
+    struct ArrowArray** children;  /**< Child pointers */
+    struct ArrowArray* storage;    /**< Child structs */
+} ExportRoot;
+
+/**
+ * @brief Private data of an exported schema
+ */
+typedef struct {
+    char* name;                     /**< Owned field name */
+    struct ArrowSchema** children;  /**< Child pointers (root only) */
+    struct ArrowSchema* storage;    /**< Child structs (root only) */
+    struct ArrowSchema dictionary;  /**< Dictionary type of a categorical column */
+} ExportSchema;
+
+static void release_column(struct ArrowArray* array) {
+    ExportColumn* priv = (ExportColumn*)array->private_data;
+    if (array->dictionary && array->dictionary->release) array->dictionary->release(array->dictionary);
+    if (priv->release) priv->release(priv->release_ctx);
+    for (int i = 0; i < ARROW_MAX_BUFFERS; i++) free(priv->owned[i]);
+    free(priv);
+    array->release = NULL;
+}
+
+static void release_root(struct ArrowArray* array) {
+    ExportRoot* priv = (ExportRoot*)array->private_data;
+    for (int64_t i = 0; i < array->n_children; i++) {
+        struct ArrowArray* child = priv->children[i];
+        if (child->release) child->release(child);
+    }
+    free(priv->children);
+    free(priv->storage);
+    free(priv);
+    array->release = NULL;
+}
+
+/**
+ * @brief Release a dictionary schema, whose strings are all static
+ */
+static void release_static_schema(struct ArrowSchema* schema) {
+    schema->release = NULL;
+}
+
+static void release_schema(struct ArrowSchema* schema) {
+    ExportSchema* priv = (ExportSchema*)schema->private_data;
+    if (schema->dictionary && schema->dictionary->release) schema->dictionary->release(schema->dictionary);
+    for (int64_t i = 0; i < schema->n_children; i++) {
+        struct ArrowSchema* child = priv->children[i];
+        if (child->release) child->release(child);
+    }
+    free(priv->name);
+    free(priv->children);
+    free(priv->storage);
+    free(priv);
+    schema->release = NULL;
+}
+
+static const char* dtype_format(TablrDType dtype, TablrTimeUnit unit) {
+    static const char* const timestamp_formats[] = {"tss:", "tsm:", "tsu:", "tsn:"};
+    switch (dtype) {
+        case TABLR_INT8: return "c";
+        case TABLR_INT16: return "s";
+        case TABLR_INT32: return "i";
+        case TABLR_INT64: return "l";
+        case TABLR_UINT8: return "C";
+        case TABLR_UINT16: return "S";
+        case TABLR_UINT32: return "I";
+        case TABLR_UINT64: return "L";
+        case TABLR_DATE32: return "tdD";
+        case TABLR_TIMESTAMP64: return timestamp_formats[unit];
+        case TABLR_FLOAT32: return "f";
+        case TABLR_FLOAT64: return "g";
+        case TABLR_BOOL:
+        case TABLR_BITMASK: return "b";
+        case TABLR_CATEGORICAL: return "i";
+        default: return "U";
+    }
+}
+
+/**
+ * @brief Whether the host stores the low byte of a word first
+ */
+static bool host_little_endian(void) {
+    uint16_t probe = 1;
+    uint8_t first;
+    memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+/**
+ * @brief Pack a series' validity bits into an Arrow validity bitmap
+ * @return true on success or if the series has no nulls
+ */
+static bool export_validity(const TablrSeries* series, struct ArrowArray* out, ExportColumn* priv) {
+    size_t nulls = tablr_series_null_count(series);
+    if (nulls == 0) return true;
+
+    size_t n = tablr_series_size(series);
+    uint8_t* validity = (uint8_t*)malloc((n + 7) / 8);
+    if (!validity) return false;
+    for (size_t i = 0; i < (n + 7) / 8; i++) {
+        uint64_t word = tablr_series_validity_word(series, i / 8);
+        validity[i] = (uint8_t)(word >> (8 * (i % 8)));
+    }
+
+    priv->owned[0] = validity;
+    priv->buffers[0] = validity;
+    out->null_count = (int64_t)nulls;
+    return true;
+}
+
+/**
+ * @brief Export an empty large utf8 array, the dictionary of an all-null categorical
+ */
+static bool export_empty_strings(struct ArrowArray* out) {
+    static const int64_t offsets[1] = {0};
+    ExportColumn* priv = (ExportColumn*)calloc(1, sizeof(ExportColumn));
+    if (!priv) return false;
+
+    memset(out, 0, sizeof(*out));
+    priv->buffers[1] = offsets;
+    priv->buffers[2] = "";
+    out->n_buffers = 3;
+    out->buffers = priv->buffers;
+    out->private_data = priv;
+    out->release = release_column;
+    return true;
+}
+
+/**
+ * @brief Export one column into a child array
+ */
+static bool export_column(TablrSeries* series, struct ArrowArray* out, const char** format) {
+    ExportColumn* priv = (ExportColumn*)calloc(1, sizeof(ExportColumn));
+    if (!priv) return false;
+
+    TablrDType dtype = tablr_series_dtype(series);
+    size_t n = tablr_series_size(series);
+    const void* data = tablr_series_data_const(series);
+
+    memset(out, 0, sizeof(*out));
+    out->length = (int64_t)n;
+    out->n_buffers = 2;
+    out->buffers = priv->buffers;
+    out->private_data = priv;
+    out->release = release_column;
+    *format = dtype_format(dtype, tablr_series_time_unit(series));
+
+    if (!data && n > 0) {
+        release_column(out);
+        return false;
+    }
+
+    bool ok = true;
+    if (dtype == TABLR_STRING) {
+        /* The series layout is Arrow's large utf8: int64 offsets and one character buffer */
+        priv->buffers[1] = data;
+        priv->buffers[2] = tablr_series_string_chars(series);
+        out->n_buffers = 3;
+        ok = tablr_series_share_data(series, &priv->release, &priv->release_ctx);
+    } else if (dtype == TABLR_BOOL) {
+        const bool* values = (const bool*)data;
+        uint8_t* bits = (uint8_t*)calloc((n + 7) / 8 ? (n + 7) / 8 : 1, 1);
+        priv->owned[1] = bits;
+        priv->buffers[1] = bits;
+        ok = bits != NULL;
+        for (size_t i = 0; ok && i < n; i++) {
+            if (values[i]) bits[i >> 3] |= (uint8_t)(1u << (i & 7));
+        }
+    } else if (dtype == TABLR_BITMASK && !host_little_endian()) {
+        uint8_t* bits = (uint8_t*)malloc((n + 7) / 8);
+        priv->owned[1] = bits;
+        priv->buffers[1] = bits;
+        ok = bits != NULL;
+        for (size_t i = 0; ok && i < (n + 7) / 8; i++) {
+            bits[i] = (uint8_t)(((const uint64_t*)data)[i / 8] >> (8 * (i % 8)));
+        }
+    } else {
+        /* Bitmask words are laid out as Arrow's bitmap on little-endian hosts */
+        priv->buffers[1] = data;
+        ok = tablr_series_share_data(series, &priv->release, &priv->release_ctx);
+    }
+    if (ok) ok = export_validity(series, out, priv);
+
+    /* Codes are exported as int32 indices into a large utf8 dictionary */
+    const TablrSeries* categories = tablr_series_categories(series);
+    if (ok && dtype == TABLR_CATEGORICAL && categories) {
+        const char* dictionary_format;
+        TablrSeries* view = tablr_series_slice(categories, 0, tablr_series_size(categories));
+        ok = view && export_column(view, &priv->dictionary, &dictionary_format);
+        tablr_series_free(view);
+    } else if (ok && dtype == TABLR_CATEGORICAL) {
+        ok = export_empty_strings(&priv->dictionary);
+    }
+    if (ok && dtype == TABLR_CATEGORICAL) out->dictionary = &priv->dictionary;
+
+    if (!ok) {
+        release_column(out);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Export a dataframe as an Arrow struct array
+ *
+ * @param df DataFrame to export
+ * @param array Output array
+ * @param schema Output schema
+ * @return true on success, false on failure
+ */
+bool tablr_dataframe_export_arrow(const TablrDataFrame* df, struct ArrowArray* array, struct ArrowSchema* schema) {
+    if (!df || !array || !schema) return false;
+
+    size_t ncols = tablr_dataframe_ncols(df);
+
+    ExportRoot* root = (ExportRoot*)calloc(1, sizeof(ExportRoot));
+    ExportSchema* root_schema = (ExportSchema*)calloc(1, sizeof(ExportSchema));
+    bool ok = root && root_schema;
+    if (ok) {
+        root->children = (struct ArrowArray**)calloc(ncols ? ncols : 1, sizeof(struct ArrowArray*));
+        root->storage = (struct ArrowArray*)calloc(ncols ? ncols : 1, sizeof(struct ArrowArray));
+        root_schema->children = (struct ArrowSchema**)calloc(ncols ? ncols : 1, sizeof(struct ArrowSchema*));
+        root_schema->storage = (struct ArrowSchema*)calloc(ncols ? ncols : 1, sizeof(struct ArrowSchema));
+        ok = root->children && root->storage && root_schema->children && root_schema->storage;
+    }
+
+    memset(array, 0, sizeof(*array));
+    memset(schema, 0, sizeof(*schema));
+    if (ok) {
+        array->length = (int64_t)(ncols ? tablr_dataframe_nrows(df) : 0);
+        array->n_buffers = 1;
+        array->buffers = &root->validity;
+        array->children = root->children;
+        array->private_data = root;
+        array->release = release_root;
+
+        schema->format = "+s";
+        schema->name = "";
+        schema->children = root_schema->children;
+        schema->private_data = root_schema;
+        schema->release = release_schema;
+    } else if (root) {
+        free(root->children);
+        free(root->storage);
+    }
+    if (!ok && root_schema) {
+        free(root_schema->children);
+        free(root_schema->storage);
+    }
+    if (!ok) {
+        free(root);
+        free(root_schema);
+    }
+
+    /* Children are counted as they are built so failures release only those */
+    for (size_t c = 0; ok && c < ncols; c++) {
+        struct ArrowArray* child = &root->storage[c];
+        struct ArrowSchema* child_schema = &root_schema->storage[c];
+        const char* format;
+        ExportSchema* priv = (ExportSchema*)calloc(1, sizeof(ExportSchema));
+        if (priv) priv->name = strdup(tablr_dataframe_column_name_at(df, c));
+        if (!priv || !priv->name || !export_column(tablr_dataframe_column_at(df, c), child, &format)) {
+            if (priv) free(priv->name);
+            free(priv);
+            ok = false;
+            break;
+        }
+
+        memset(child_schema, 0, sizeof(*child_schema));
+        child_schema->format = format;
+        child_schema->name = priv->name;
+        child_schema->flags = ARROW_FLAG_NULLABLE;
+        child_schema->private_data = priv;
+        child_schema->release = release_schema;
+        if (child->dictionary) {
+            priv->dictionary.format = "U";
+            priv->dictionary.name = "";
+            priv->dictionary.release = release_static_schema;
+            child_schema->dictionary = &priv->dictionary;
+        }
+
+        root->children[c] = child;
+        root_schema->children[c] = child_schema;
+        array->n_children++;
+        schema->n_children++;
+    }
+
+    if (!ok && array->release) {
+        array->release(array);
+        schema->release(schema);
+    }
+    return ok;
+}
+
+/**
+ * @brief Release a child array that was moved out of its parent
+ */
+static void release_moved(void* ctx) {
+    struct ArrowArray* child = (struct ArrowArray*)ctx;
+    if (child->release) child->release(child);
+    free(child);
+}
+
+/**
+ * @brief Map an Arrow format string to a column type
+ *
+ * Timestamps of any time zone are accepted; their values are UTC already.
+ */
+static bool format_dtype(const char* format, TablrDType* dtype, TablrTimeUnit* unit) {
+    if (!format || !format[0]) return false;
+    if (strcmp(format, "tdD") == 0) {
+        *dtype = TABLR_DATE32;
+        return true;
+    }
+    if (strncmp(format, "ts", 2) == 0 && format[2] && format[3] == ':') {
+        switch (format[2]) {
+            case 's': *unit = TABLR_TIME_SECOND; break;
+            case 'm': *unit = TABLR_TIME_MILLISECOND; break;
+            case 'u': *unit = TABLR_TIME_MICROSECOND; break;
+            case 'n': *unit = TABLR_TIME_NANOSECOND; break;
+            default: return false;
+        }
+        *dtype = TABLR_TIMESTAMP64;
+        return true;
+    }
+    if (format[1]) return false;
+    switch (format[0]) {
+        case 'c': *dtype = TABLR_INT8; return true;
+        case 's': *dtype = TABLR_INT16; return true;
+        case 'i': *dtype = TABLR_INT32; return true;
+        case 'l': *dtype = TABLR_INT64; return true;
+        case 'C': *dtype = TABLR_UINT8; return true;
+        case 'S': *dtype = TABLR_UINT16; return true;
+        case 'I': *dtype = TABLR_UINT32; return true;
+        case 'L': *dtype = TABLR_UINT64; return true;
+        case 'f': *dtype = TABLR_FLOAT32; return true;
+        case 'g': *dtype = TABLR_FLOAT64; return true;
+        case 'b': *dtype = TABLR_BOOL; return true;
+        case 'u':
+        case 'U': *dtype = TABLR_STRING; return true;
+        default: return false;
+    }
+}
+
+static bool bit_set(const uint8_t* bits, size_t i) {
+    return (bits[i >> 3] >> (i & 7)) & 1;
+}
+
+/**
+ * @brief Mark the elements of a series that an Arrow validity bitmap marks null
+ * @return false on allocation failure
+ */
+static bool import_nulls(TablrSeries* series, const uint8_t* validity, size_t start, size_t n) {
+    return !validity || tablr_series_set_validity(series, 0, validity, start, n);
+}
+
+/**
+ * @brief Import a utf8 or large utf8 child as a string series
+ *
+ * Large utf8 already has the series layout, so the child is moved into the
+ * series and its buffers are used in place. utf8 offsets are widened into a
+ * new series.
+ *
+ * @return New series, or NULL on failure or invalid offsets
+ */
+static TablrSeries* import_strings(struct ArrowArray* child, bool large, const uint8_t* validity,
+                                   size_t start, size_t n) {
+    const char* chars = (const char*)child->buffers[2];
+    if (!child->buffers[1] || !chars) return NULL;
+
+    TablrSeries* series = NULL;
+    if (large) {
+        const int64_t* offsets = (const int64_t*)child->buffers[1] + start;
+        for (size_t i = 0; i < n; i++) {
+            if (offsets[i] < 0 || offsets[i + 1] < offsets[i]) return NULL;
+        }
+
+        struct ArrowArray* moved = (struct ArrowArray*)malloc(sizeof(struct ArrowArray));
+        if (!moved) return NULL;
+        *moved = *child;
+        child->release = NULL;
+        series = tablr_series_string_wrap(offsets, chars, n, TABLR_CPU, release_moved, moved);
+        if (!series) {
+            release_moved(moved);
+            return NULL;
+        }
+    } else {
+        const int32_t* offsets = (const int32_t*)child->buffers[1] + start;
+        for (size_t i = 0; i < n; i++) {
+            if (offsets[i] < 0 || offsets[i + 1] < offsets[i]) return NULL;
+        }
+
+        int64_t* out_offsets;
+        char* out_chars;
+        series = tablr_series_string_alloc(n, (size_t)(offsets[n] - offsets[0]), TABLR_CPU);
+        if (!series || !tablr_series_string_buffers(series, &out_offsets, &out_chars)) {
+            tablr_series_free(series);
+            return NULL;
+        }
+        for (size_t i = 0; i <= n; i++) {
+            out_offsets[i] = (int64_t)offsets[i] - offsets[0];
+        }
+        memcpy(out_chars, chars + offsets[0], (size_t)(offsets[n] - offsets[0]));
+    }
+
+    if (!import_nulls(series, validity, start, n)) {
+        tablr_series_free(series);
+        return NULL;
+    }
+    return series;
+}
+
+/**
+ * @brief Import a dictionary-encoded child with int32 indices and utf8 values as a categorical series
+ *
+ * The dictionary must not contain nulls. Codes are copied; the dictionary
+ * is imported like any other string child.
+ *
+ * @return New series, or NULL on failure or unsupported types
+ */
+static TablrSeries* import_categorical(struct ArrowArray* child, const struct ArrowSchema* child_schema,
+                                       size_t start, size_t n) {
+    struct ArrowArray* dictionary = child->dictionary;
+    const char* format = child_schema->dictionary->format;
+    bool ok = child_schema->format && strcmp(child_schema->format, "i") == 0 && format &&
+              (strcmp(format, "u") == 0 || strcmp(format, "U") == 0) && dictionary;
+    ok = ok && child->n_buffers == 2 && child->buffers && child->buffers[1];
+    ok = ok && dictionary->n_buffers == 3 && dictionary->buffers && dictionary->null_count == 0 &&
+         dictionary->length >= 0 && dictionary->offset >= 0;
+    if (!ok) return NULL;
+
+    TablrSeries* categories = NULL;
+    if (dictionary->length > 0) {
+        categories = import_strings(dictionary, format[0] == 'U', NULL, (size_t)dictionary->offset,
+                                    (size_t)dictionary->length);
+        if (!categories) return NULL;
+    }
+
+    const uint8_t* validity = child->null_count != 0 ? (const uint8_t*)child->buffers[0] : NULL;
+    const int32_t* codes = (const int32_t*)child->buffers[1] + start;
+    int32_t* copy = (int32_t*)malloc(n * sizeof(int32_t));
+    TablrSeries* series = NULL;
+    if (copy) {
+        for (size_t i = 0; i < n; i++) {
+            copy[i] = !validity || bit_set(validity, start + i) ? codes[i] : -1;
+        }
+        series = tablr_series_categorical(copy, n, categories, TABLR_CPU);
+    }
+    free(copy);
+    tablr_series_free(categories);
+    return series;
+}
+
+/**
+ * @brief Convert one child array into a series
+ * @param child Child array (moved out of the parent when shared)
+ * @param child_schema Schema of child
+ * @param start Index of the first element, including all offsets
+ * @param n Number of elements
+ * @return New series, or NULL on failure
+ */
+static TablrSeries* import_column(struct ArrowArray* child, const struct ArrowSchema* child_schema, size_t start,
+                                  size_t n) {
+    if (child_schema->dictionary) return import_categorical(child, child_schema, start, n);
+
+    const char* format = child_schema->format;
+    TablrDType dtype;
+    TablrTimeUnit unit = TABLR_TIME_MICROSECOND;
+    if (!format_dtype(format, &dtype, &unit) || child->dictionary) return NULL;
+
+    int64_t want_buffers = dtype == TABLR_STRING ? 3 : 2;
+    if (child->n_buffers != want_buffers || !child->buffers) return NULL;
+    const uint8_t* validity = child->null_count != 0 ? (const uint8_t*)child->buffers[0] : NULL;
+    if (dtype == TABLR_STRING) return import_strings(child, format[0] == 'U', validity, start, n);
+
+    if (dtype != TABLR_BOOL) {
+        size_t width = tablr_dtype_size(dtype);
+        const char* data = (const char*)child->buffers[1];
+        if (!data) return NULL;
+        data += start * width;
+
+        if (!validity) {
+            /* Move the child out so it lives exactly as long as the series */
+            struct ArrowArray* moved = (struct ArrowArray*)malloc(sizeof(struct ArrowArray));
+            if (!moved) return NULL;
+            *moved = *child;
+            child->release = NULL;
+            TablrSeries* series = tablr_series_wrap(data, n, dtype, TABLR_CPU, release_moved, moved);
+            if (!series) release_moved(moved);
+            if (series && dtype == TABLR_TIMESTAMP64) tablr_series_set_time_unit(series, unit);
+            return series;
+        }
+
+        TablrSeries* series = tablr_series_create(data, n, dtype, TABLR_CPU);
+        if (!series) return NULL;
+        if (dtype == TABLR_TIMESTAMP64) tablr_series_set_time_unit(series, unit);
+        char* out = (char*)tablr_series_data(series);
+        if (!out || !import_nulls(series, validity, start, n)) {
+            tablr_series_free(series);
+            return NULL;
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (bit_set(validity, start + i)) continue;
+            if (dtype == TABLR_FLOAT64) {
+                double nan = NAN;
+                memcpy(out + i * width, &nan, sizeof(nan));
+            } else if (dtype == TABLR_FLOAT32) {
+                float nan = NAN;
+                memcpy(out + i * width, &nan, sizeof(nan));
+            } else {
+                memset(out + i * width, 0, width);
+            }
+        }
+        return series;
+    }
+
+    const uint8_t* bits = (const uint8_t*)child->buffers[1];
+    TablrSeries* series = bits ? tablr_series_alloc(n, dtype, TABLR_CPU) : NULL;
+    bool* out = (bool*)tablr_series_data(series);
+    if (!out) {
+        tablr_series_free(series);
+        return NULL;
+    }
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (!validity || bit_set(validity, start + i)) && bit_set(bits, start + i);
+    }
+    if (!import_nulls(series, validity, start, n)) {
+        tablr_series_free(series);
+        return NULL;
+    }
+    return series;
+}
+
+/**
+ * @brief Import an Arrow struct array as a dataframe
+ *
+ * @param array Struct array (consumed)
+ * @param schema Schema of array (consumed)
+ * @return New dataframe, or NULL on failure
+ */
+TablrDataFrame* tablr_dataframe_import_arrow(struct ArrowArray* array, struct ArrowSchema* schema) {
+    if (!array || !schema || !array->release || !schema->release) return NULL;
+
+    TablrDataFrame* df = NULL;
+    bool ok = schema->format && strcmp(schema->format, "+s") == 0 && schema->n_children == array->n_children &&
+              array->length >= 0 && array->offset >= 0 &&
+              (array->null_count == 0 || !array->buffers || !array->buffers[0]);
+    if (ok) df = tablr_dataframe_create();
+    ok = ok && df;
+
+    size_t n = (size_t)array->length;
+    for (int64_t c = 0; ok && c < array->n_children && n > 0; c++) {
+        struct ArrowArray* child = array->children[c];
+        struct ArrowSchema* child_schema = schema->children[c];
+        ok = child && child_schema && child->offset >= 0 && child->length >= array->offset + array->length;
+        if (!ok) break;
+
+        size_t start = (size_t)(child->offset + array->offset);
+        TablrSeries* series = import_column(child, child_schema, start, n);
+        if (!series || !tablr_dataframe_add_column(df, child_schema->name ? child_schema->name : "", series)) {
+            tablr_series_free(series);
+            ok = false;
+        }
+    }
+
+    /* Children moved into series have release == NULL and are skipped */
+    array->release(array);
+    schema->release(schema);
+
+    if (!ok) {
+        tablr_dataframe_free(df);
+        return NULL;
+    }
+    return df;
+}
@@ -0,0 +1,356 @@
+/**
+ * @file categorical.c
+ * @brief Implementation of dictionary encoding
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * This file implements the category index, an open-addressing hash table
+ * of distinct strings that assigns dense codes in insertion order, and the
+ * conversions between string and categorical series built on it.
+ */
+
+#include "tablr/core/categorical.h"
+#include "tablr/core/stats.h"
+#include "series_nulls.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define INDEX_INITIAL_SLOTS 64      /**< Initial hash table size */
+#define INDEX_INITIAL_BYTES 1024    /**< Initial character buffer size */
+#define INDEX_EMPTY (-1)            /**< Unused hash table slot */
+
+/**
+ * @brief Category index state
+ *
+ * The strings are kept back to back in chars with count + 1 offsets, the
+ * same layout as a string series, so building the dictionary is one copy.
+ * Slots hold codes; each code's hash is kept for growing the table.
+ */
+struct TablrCategoryIndex {
+    int64_t* offsets;    /**< count + 1 offsets into chars */
+    uint64_t* hashes;    /**< Hash of each string */
+    size_t count;        /**< Number of strings */
+    size_t cap;          /**< Strings that fit in offsets and hashes */
+    char* chars;         /**< Characters of all strings */
+    size_t chars_len;    /**< Bytes used in chars */
+    size_t chars_cap;    /**< Bytes allocated for chars */
+    int32_t* slots;      /**< Open-addressing table of codes */
+    size_t mask;         /**< Number of slots minus one */
+};
+
+/**
+ * @brief Hash a string eight bytes at a time
+ */
+static uint64_t hash_bytes(const char* p, size_t len) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ len;
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+        p += 8;
+        len -= 8;
+    }
+    uint64_t tail = 0;
+    if (len > 0) memcpy(&tail, p, len);
+    h = (h ^ tail) * 0xC4CEB9FE1A85EC53ull;
+    return h ^ (h >> 29);
+}
+
+/**
+ * @brief Find the slot holding a string, or the empty slot where it belongs
+ */
+static size_t find_slot(const TablrCategoryIndex* index, const char* value, size_t length, uint64_t hash) {
+    size_t slot = (size_t)hash & index->mask;
+    for (;;) {
+        int32_t code = index->slots[slot];
+        if (code == INDEX_EMPTY) return slot;
+        int64_t begin = index->offsets[code];
+        if (index->hashes[code] == hash && (size_t)(index->offsets[code + 1] - begin) == length &&
+            (length == 0 || memcmp(index->chars + begin, value, length) == 0)) {
+            return slot;
+        }
+        slot = (slot + 1) & index->mask;
+    }
+}
+
+/**
+ * @brief Double the hash table and reinsert every code
+ */
+static bool grow_slots(TablrCategoryIndex* index) {
+    size_t nslots = (index->mask + 1) * 2;
+    int32_t* slots = (int32_t*)malloc(nslots * sizeof(int32_t));
+    if (!slots) return false;
+    for (size_t i = 0; i < nslots; i++) slots[i] = INDEX_EMPTY;
+
+    for (size_t code = 0; code < index->count; code++) {
+        size_t slot = (size_t)index->hashes[code] & (nslots - 1);
+        while (slots[slot] != INDEX_EMPTY) slot = (slot + 1) & (nslots - 1);
+        slots[slot] = (int32_t)code;
+    }
+    free(index->slots);
+    index->slots = slots;
+    index->mask = nslots - 1;
+    return true;
+}
+
+/**
+ * @brief Make room for one more string of length bytes
+ */
+static bool reserve(TablrCategoryIndex* index, size_t length) {
+    if (index->count == index->cap) {
+        size_t cap = index->cap * 2;
+        int64_t* offsets = (int64_t*)realloc(index->offsets, (cap + 1) * sizeof(int64_t));
+        if (!offsets) return false;
+        index->offsets = offsets;
+        uint64_t* hashes = (uint64_t*)realloc(index->hashes, cap * sizeof(uint64_t));
+        if (!hashes) return false;
+        index->hashes = hashes;
+        index->cap = cap;
+    }
+    if (length > index->chars_cap - index->chars_len) {
+        size_t cap = index->chars_cap;
+        while (cap - index->chars_len < length) cap *= 2;
+        char* chars = (char*)realloc(index->chars, cap);
+        if (!chars) return false;
+        index->chars = chars;
+        index->chars_cap = cap;
+    }
+    return (index->count + 1) * 2 <= index->mask + 1 || grow_slots(index);
+}
+
+/**
+ * @brief Create an empty category index
+ * @return Pointer to index, or NULL on allocation failure
+ */
+TablrCategoryIndex* tablr_category_index_create(void) {
+    return tablr_category_index_create_sized(0);
+}
+
+/**
+ * @brief Create an empty category index with room for a number of strings
+ *
+ * The table gets at least twice as many slots as expected strings, so it
+ * stays at most half full without growing.
+ *
+ * @param expected Number of distinct strings expected
+ * @return Pointer to index, or NULL on allocation failure
+ */
+TablrCategoryIndex* tablr_category_index_create_sized(size_t expected) {
+    TablrCategoryIndex* index = (TablrCategoryIndex*)calloc(1, sizeof(TablrCategoryIndex));
+    if (!index) return NULL;
+
+    size_t nslots = INDEX_INITIAL_SLOTS;
+    while (nslots / 2 < expected && nslots < ((size_t)1 << 31)) nslots *= 2;
+    index->cap = nslots / 2;
+    index->chars_cap = INDEX_INITIAL_BYTES;
+    index->mask = nslots - 1;
+    index->offsets = (int64_t*)malloc((index->cap + 1) * sizeof(int64_t));
+    index->hashes = (uint64_t*)malloc(index->cap * sizeof(uint64_t));
+    index->chars = (char*)malloc(index->chars_cap);
+    index->slots = (int32_t*)malloc(nslots * sizeof(int32_t));
+    if (!index->offsets || !index->hashes || !index->chars || !index->slots) {
+        tablr_category_index_free(index);
+        return NULL;
+    }
+
+    index->offsets[0] = 0;
+    for (size_t i = 0; i < nslots; i++) index->slots[i] = INDEX_EMPTY;
+    return index;
+}
+
+/**
+ * @brief Get the code of a string, adding it if it is new
+ *
+ * @param index Category index
+ * @param value Characters of the string
+ * @param length Length in bytes
+ * @return Code of the string, or -1 on allocation failure or once INT32_MAX
+ *         strings have been added
+ */
+int32_t tablr_category_index_add(TablrCategoryIndex* index, const char* value, size_t length) {
+    if (!index || (!value && length > 0)) return -1;
+
+    uint64_t hash = hash_bytes(value, length);
+    size_t slot = find_slot(index, value, length, hash);
+    if (index->slots[slot] != INDEX_EMPTY) return index->slots[slot];
+
+    if (index->count >= INT32_MAX) return -1;
+    size_t mask = index->mask;
+    if (!reserve(index, length)) return -1;
+    if (index->mask != mask) slot = find_slot(index, value, length, hash);
+
+    int32_t code = (int32_t)index->count++;
+    if (length > 0) memcpy(index->chars + index->chars_len, value, length);
+    index->chars_len += length;
+    index->offsets[code + 1] = (int64_t)index->chars_len;
+    index->hashes[code] = hash;
+    index->slots[slot] = code;
+    return code;
+}
+
+/**
+ * @brief Look up the code of a string
+ *
+ * @param index Category index
+ * @param value Characters of the string
+ * @param length Length in bytes
+ * @return Code of the string, or -1 if it is not in the index
+ */
+int32_t tablr_category_index_find(const TablrCategoryIndex* index, const char* value, size_t length) {
+    if (!index || (!value && length > 0)) return -1;
+    return index->slots[find_slot(index, value, length, hash_bytes(value, length))];
+}
+
+/**
+ * @brief Get the number of distinct strings in an index
+ *
+ * @param index Category index
+ * @return Number of codes assigned, or 0 if index is NULL
+ */
+size_t tablr_category_index_size(const TablrCategoryIndex* index) {
+    return index ? index->count : 0;
+}
+
+/**
+ * @brief Get the string with a code
+ *
+ * @param index Category index
+ * @param code Code of the string
+ * @param length Output length in bytes
+ * @return Pointer to the characters, or NULL if code is out of range
+ */
+const char* tablr_category_index_value(const TablrCategoryIndex* index, int32_t code, size_t* length) {
+    if (!index || code < 0 || (size_t)code >= index->count) return NULL;
+    if (length) *length = (size_t)(index->offsets[code + 1] - index->offsets[code]);
+    return index->chars + index->offsets[code];
+}
+
+/**
+ * @brief Copy the strings of an index into a dictionary
+ *
+ * @param index Category index
+ * @param device Target compute device
+ * @return New string series, or NULL on failure or if the index is empty
+ */
+TablrSeries* tablr_category_index_categories(const TablrCategoryIndex* index, TablrDevice device) {
+    if (!index || index->count == 0) return NULL;
+
+    TablrSeries* s = tablr_series_string_alloc(index->count, index->chars_len, device);
+    int64_t* offsets;
+    char* chars;
+    if (!s || !tablr_series_string_buffers(s, &offsets, &chars)) {
+        tablr_series_free(s);
+        return NULL;
+    }
+    memcpy(offsets, index->offsets, (index->count + 1) * sizeof(int64_t));
+    if (index->chars_len > 0) memcpy(chars, index->chars, index->chars_len);
+    return s;
+}
+
+/**
+ * @brief Free a category index
+ *
+ * @param index Index to free (can be NULL)
+ */
+void tablr_category_index_free(TablrCategoryIndex* index) {
+    if (!index) return;
+    free(index->offsets);
+    free(index->hashes);
+    free(index->chars);
+    free(index->slots);
+    free(index);
+}
+
+/**
+ * @brief Dictionary-encode a string series
+ *
+ * Hashes each valid element once; null elements get code -1. If the
+ * series has cached statistics, the index is sized from their distinct
+ * estimate.
+ *
+ * @param series String or categorical series
+ * @return New categorical series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_series_to_categorical(const TablrSeries* series) {
+    if (!series) return NULL;
+
+    TablrDType dtype = tablr_series_dtype(series);
+    size_t size = tablr_series_size(series);
+    if (dtype == TABLR_CATEGORICAL) return tablr_series_slice(series, 0, size);
+    if (dtype != TABLR_STRING) return NULL;
+
+    TablrSeriesStats stats;
+    size_t expected = tablr_series_stats_cached(series, &stats) ? stats.distinct : 0;
+    TablrCategoryIndex* index = tablr_category_index_create_sized(expected);
+    int32_t* codes = (int32_t*)malloc(size * sizeof(int32_t));
+    bool ok = index && codes;
+
+    const int64_t* offsets = tablr_series_string_offsets(series);
+    const char* chars = tablr_series_string_chars(series);
+    for (size_t i = 0; ok && i < size; i++) {
+        if (!tablr_series_is_valid(series, i)) {
+            codes[i] = -1;
+            continue;
+        }
+        codes[i] = tablr_category_index_add(index, chars + offsets[i], (size_t)(offsets[i + 1] - offsets[i]));
+        ok = codes[i] >= 0;
+    }
+
+    TablrSeries* categories = ok ? tablr_category_index_categories(index, tablr_series_device(series)) : NULL;
+    TablrSeries* result = ok ? tablr_series_categorical(codes, size, categories, tablr_series_device(series)) : NULL;
+
+    tablr_series_free(categories);
+    tablr_category_index_free(index);
+    free(codes);
+    return result;
+}
+
+/**
+ * @brief Decode a categorical series into a string series
+ *
+ * Sizes the character buffer exactly, then copies each element's category.
+ *
+ * @param series Categorical series
+ * @return New string series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_series_from_categorical(const TablrSeries* series) {
+    if (!series || tablr_series_dtype(series) != TABLR_CATEGORICAL) return NULL;
+
+    size_t size = tablr_series_size(series);
+    const int32_t* codes = (const int32_t*)tablr_series_data_const(series);
+    const TablrSeries* categories = tablr_series_categories(series);
+    const int64_t* cat_offsets = tablr_series_string_offsets(categories);
+    const char* cat_chars = tablr_series_string_chars(categories);
+    if (!codes && size > 0) return NULL;
+
+    size_t total = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (tablr_series_is_valid(series, i)) total += (size_t)(cat_offsets[codes[i] + 1] - cat_offsets[codes[i]]);
+    }
+
+    TablrSeries* out = tablr_series_string_alloc(size, total, tablr_series_device(series));
+    int64_t* offsets;
+    char* chars;
+    if (!out || !tablr_series_string_buffers(out, &offsets, &chars)) {
+        tablr_series_free(out);
+        return NULL;
+    }
+
+    int64_t pos = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (tablr_series_is_valid(series, i)) {
+            int64_t begin = cat_offsets[codes[i]];
+            int64_t len = cat_offsets[codes[i] + 1] - begin;
+            memcpy(chars + pos, cat_chars + begin, (size_t)len);
+            pos += len;
+        }
+        offsets[i + 1] = pos;
+    }
+
+    if (!tablr_series_copy_nulls(series, out)) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    return out;
+}
@@ -0,0 +1,344 @@
+/**
+ * @file chunked.c
+ * @brief Implementation of chunked series
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * A chunked buffer holds a list of series views, each an immutable chunk,
+ * and the row each chunk ends at. Appending adds a view, so a series grows
+ * without copying what it already holds. Readers that need one array get
+ * a flattened copy, made on first use and kept until the next append.
+ */
+
+#include "tablr/core/chunked.h"
+#include "tablr/core/encoding.h"
+#include "tablr/core/allocator.h"
+#include "chunks.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <stdatomic.h>
+#endif
+
+/**
+ * @brief List of immutable chunks
+ */
+struct TablrChunks {
+    TablrSeries** chunks;   /**< Chunks in row order */
+    size_t* ends;           /**< Row one past the last element of each chunk */
+    size_t count;           /**< Number of chunks */
+    size_t capacity;        /**< Room in chunks and ends */
+#ifdef _WIN32
+    TablrSeries* volatile flat;  /**< Every row in one plain series, or NULL until first needed */
+#else
+    _Atomic(TablrSeries*) flat;  /**< Every row in one plain series, or NULL until first needed */
+#endif
+};
+
+/**
+ * @brief Take the flattened copy out of a list
+ * @return The copy, or NULL if there was none
+ */
+static TablrSeries* take_flat(TablrChunks* chunks) {
+#ifdef _WIN32
+    return (TablrSeries*)InterlockedExchangePointer((void* volatile*)&chunks->flat, NULL);
+#else
+    return atomic_exchange(&chunks->flat, NULL);
+#endif
+}
+
+/**
+ * @brief Create an empty chunk list
+ *
+ * @return New list, or NULL on failure
+ */
+TablrChunks* tablr_chunks_create(void) {
+    TablrChunks* chunks = (TablrChunks*)calloc(1, sizeof(TablrChunks));
+    if (!chunks) return NULL;
+#ifdef _WIN32
+    chunks->flat = NULL;
+#else
+    atomic_init(&chunks->flat, NULL);
+#endif
+    return chunks;
+}
+
+/**
+ * @brief Free a chunk list, its chunks and its flattened copy
+ *
+ * @param chunks List (can be NULL)
+ */
+void tablr_chunks_free(TablrChunks* chunks) {
+    if (!chunks) return;
+    for (size_t i = 0; i < chunks->count; i++) tablr_series_free(chunks->chunks[i]);
+    tablr_series_free(take_flat(chunks));
+    free(chunks->chunks);
+    free(chunks->ends);
+    free(chunks);
+}
+
+/**
+ * @brief Add a chunk after the last one, taking ownership of it
+ *
+ * The list doubles its capacity when full.
+ *
+ * @return true on success, false on failure (chunk is not freed)
+ */
+bool tablr_chunks_push(TablrChunks* chunks, TablrSeries* chunk) {
+    if (chunks->count == chunks->capacity) {
+        size_t capacity = chunks->capacity ? chunks->capacity * 2 : 8;
+        TablrSeries** list = (TablrSeries**)realloc(chunks->chunks, capacity * sizeof(TablrSeries*));
+        if (!list) return false;
+        chunks->chunks = list;
+        size_t* ends = (size_t*)realloc(chunks->ends, capacity * sizeof(size_t));
+        if (!ends) return false;
+        chunks->ends = ends;
+        chunks->capacity = capacity;
+    }
+
+    chunks->chunks[chunks->count] = chunk;
+    chunks->ends[chunks->count] = tablr_chunks_rows(chunks) + tablr_series_size(chunk);
+    chunks->count++;
+    tablr_series_free(take_flat(chunks));
+    return true;
+}
+
+/**
+ * @brief Free the last chunk
+ */
+void tablr_chunks_pop(TablrChunks* chunks) {
+    if (chunks->count == 0) return;
+    tablr_series_free(chunks->chunks[--chunks->count]);
+    tablr_series_free(take_flat(chunks));
+}
+
+/**
+ * @brief Get the number of chunks
+ */
+size_t tablr_chunks_count(const TablrChunks* chunks) {
+    return chunks->count;
+}
+
+/**
+ * @brief Get the total number of rows of every chunk
+ */
+size_t tablr_chunks_rows(const TablrChunks* chunks) {
+    return chunks->count ? chunks->ends[chunks->count - 1] : 0;
+}
+
+/**
+ * @brief Get the index of the chunk holding a row
+ */
+size_t tablr_chunks_find(const TablrChunks* chunks, size_t row) {
+    size_t lo = 0, hi = chunks->count - 1;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (chunks->ends[mid] > row) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+/**
+ * @brief Get one chunk
+ *
+ * @param chunks List
+ * @param index Chunk index
+ * @param begin Output row of the chunk's first element
+ * @return The chunk, owned by the list
+ */
+const TablrSeries* tablr_chunks_get(const TablrChunks* chunks, size_t index, size_t* begin) {
+    *begin = index ? chunks->ends[index - 1] : 0;
+    return chunks->chunks[index];
+}
+
+/**
+ * @brief Read 64 bits of a bitmap starting at any bit; bits past nbits read as 0
+ */
+static uint64_t read_bits(const uint64_t* words, size_t nbits, size_t start) {
+    size_t w = start / 64;
+    unsigned shift = (unsigned)(start % 64);
+    uint64_t bits = words[w] >> shift;
+    if (shift && (w + 1) * 64 < nbits) bits |= words[w + 1] << (64 - shift);
+    if (nbits - start < 64) bits &= ((uint64_t)1 << (nbits - start)) - 1;
+    return bits;
+}
+
+/**
+ * @brief OR up to 64 bits into a zeroed bitmap at any bit position
+ */
+static void write_bits(uint64_t* words, size_t pos, uint64_t bits) {
+    unsigned shift = (unsigned)(pos % 64);
+    words[pos / 64] |= bits << shift;
+    if (shift && bits >> (64 - shift)) words[pos / 64 + 1] |= bits >> (64 - shift);
+}
+
+/**
+ * @brief Copy rows start to start + count - 1 into one new plain series
+ *
+ * Each chunk is copied with one read: fixed-width chunks through
+ * tablr_series_read(), so compressed chunks are decoded straight into
+ * the result.
+ *
+ * @param dictionary Categories of a categorical list (NULL otherwise)
+ * @return New series, or NULL on failure
+ */
+TablrSeries* tablr_chunks_copy(const TablrChunks* chunks, size_t start, size_t count,
+                               const TablrSeries* dictionary, TablrDevice device) {
+    TablrDType dtype = tablr_series_dtype(chunks->chunks[0]);
+    size_t end = start + count;
+    size_t first = tablr_chunks_find(chunks, start);
+
+    TablrSeries* out;
+    int64_t* out_offsets = NULL;
+    char* out_chars = NULL;
+    if (dtype == TABLR_STRING) {
+        size_t total = 0;
+        for (size_t i = first; i < chunks->count && (i ? chunks->ends[i - 1] : 0) < end; i++) {
+            size_t begin = i ? chunks->ends[i - 1] : 0;
+            size_t lo = start > begin ? start - begin : 0;
+            size_t hi = (chunks->ends[i] < end ? chunks->ends[i] : end) - begin;
+            const int64_t* offsets = tablr_series_string_offsets(chunks->chunks[i]);
+            total += (size_t)(offsets[hi] - offsets[lo]);
+        }
+        out = tablr_series_string_alloc(count, total, device);
+        if (out && !tablr_series_string_buffers(out, &out_offsets, &out_chars)) {
+            tablr_series_free(out);
+            return NULL;
+        }
+    } else if (dtype == TABLR_CATEGORICAL) {
+        out = tablr_series_categorical_alloc(count, dictionary, device);
+    } else if (dtype == TABLR_BITMASK) {
+        out = tablr_series_alloc(count, dtype, device);
+        uint64_t* words = (uint64_t*)tablr_series_data(out);
+        if (words) memset(words, 0, (count + 63) / 64 * sizeof(uint64_t));
+    } else {
+        out = tablr_series_alloc(count, dtype, device);
+    }
+    char* data = dtype == TABLR_STRING ? NULL : (char*)tablr_series_data(out);
+    if (!out || (dtype != TABLR_STRING && !data)) {
+        tablr_series_free(out);
+        return NULL;
+    }
+
+    size_t width = tablr_dtype_size(dtype);
+    size_t row = 0;
+    for (size_t i = first; row < count; i++) {
+        const TablrSeries* chunk = chunks->chunks[i];
+        size_t begin = i ? chunks->ends[i - 1] : 0;
+        size_t lo = start > begin ? start - begin : 0;
+        size_t hi = (chunks->ends[i] < end ? chunks->ends[i] : end) - begin;
+        size_t n = hi - lo;
+
+        if (dtype == TABLR_STRING) {
+            const int64_t* offsets = tablr_series_string_offsets(chunk);
+            int64_t shift = out_offsets[row] - offsets[lo];
+            memcpy(out_chars + out_offsets[row], tablr_series_string_chars(chunk) + offsets[lo],
+                   (size_t)(offsets[hi] - offsets[lo]));
+            for (size_t r = 1; r <= n; r++) out_offsets[row + r] = offsets[lo + r] + shift;
+        } else if (dtype == TABLR_CATEGORICAL) {
+            memcpy(data + row * width, (const int32_t*)tablr_series_data_const(chunk) + lo, n * width);
+        } else if (dtype == TABLR_BITMASK) {
+            const uint64_t* words = (const uint64_t*)tablr_series_data_const(chunk);
+            for (size_t b = 0; b < n; b += 64) {
+                write_bits((uint64_t*)data, row + b, read_bits(words, hi, lo + b));
+            }
+        } else {
+            tablr_series_read(chunk, lo, n, data + row * width);
+        }
+        row += n;
+    }
+    return out;
+}
+
+/**
+ * @brief Get every row in one plain series, flattening them on the first call
+ *
+ * The copy lives as long as the chunks, so it comes from the default
+ * allocator rather than the calling thread's, which may be an arena.
+ * Threads that race to flatten each build a copy; the first to publish
+ * its copy wins and the others free theirs.
+ *
+ * @return Flattened series, or NULL if the copy failed
+ */
+const TablrSeries* tablr_chunks_flat(TablrChunks* chunks, const TablrSeries* dictionary) {
+#ifdef _WIN32
+    TablrSeries* flat = chunks->flat;
+#else
+    TablrSeries* flat = atomic_load(&chunks->flat);
+#endif
+    if (flat) return flat;
+
+    const TablrAllocator* previous = tablr_set_thread_allocator(tablr_default_allocator());
+    TablrSeries* copy = tablr_chunks_copy(chunks, 0, tablr_chunks_rows(chunks), dictionary,
+                                          tablr_series_device(chunks->chunks[0]));
+    tablr_set_thread_allocator(previous);
+    if (!copy) return NULL;
+
+#ifdef _WIN32
+    flat = (TablrSeries*)InterlockedCompareExchangePointer((void* volatile*)&chunks->flat, copy, NULL);
+    if (!flat) return copy;
+#else
+    if (atomic_compare_exchange_strong(&chunks->flat, &flat, copy)) return copy;
+#endif
+    tablr_series_free(copy);
+    return flat;
+}
+
+/**
+ * @brief Get the bytes held by the chunks and the flattened copy
+ */
+size_t tablr_chunks_bytes(const TablrChunks* chunks) {
+    size_t bytes = sizeof(TablrChunks) + chunks->capacity * (sizeof(TablrSeries*) + sizeof(size_t));
+    for (size_t i = 0; i < chunks->count; i++) bytes += tablr_series_memory_usage(chunks->chunks[i]);
+#ifdef _WIN32
+    const TablrSeries* flat = chunks->flat;
+#else
+    const TablrSeries* flat = atomic_load(&((TablrChunks*)chunks)->flat);
+#endif
+    return bytes + tablr_series_memory_usage(flat);
+}
+
+/* ===================== Series API ===================== */
+
+/**
+ * @brief Get the number of chunks of a series
+ *
+ * @param series Series to query
+ * @return Number of chunks; 1 for a plain series, 0 for NULL
+ */
+size_t tablr_series_num_chunks(const TablrSeries* series) {
+    if (!series) return 0;
+    size_t offset;
+    const TablrChunks* chunks = tablr_series_chunks(series, &offset);
+    if (!chunks || tablr_series_size(series) == 0) return 1;
+    return tablr_chunks_find(chunks, offset + tablr_series_size(series) - 1) - tablr_chunks_find(chunks, offset) + 1;
+}
+
+/**
+ * @brief Get a view of one chunk of a series
+ *
+ * @param series Series to query
+ * @param index Chunk index, below tablr_series_num_chunks()
+ * @return New view of the chunk's elements in series, or NULL on failure
+ */
+TablrSeries* tablr_series_chunk(const TablrSeries* series, size_t index) {
+    if (index >= tablr_series_num_chunks(series)) return NULL;
+
+    size_t offset;
+    size_t size = tablr_series_size(series);
+    const TablrChunks* chunks = tablr_series_chunks(series, &offset);
+    if (!chunks) return tablr_series_slice(series, 0, size);
+
+    size_t begin;
+    const TablrSeries* chunk = tablr_chunks_get(chunks, tablr_chunks_find(chunks, offset) + index, &begin);
+    size_t lo = offset > begin ? offset - begin : 0;
+    size_t hi = tablr_series_size(chunk);
+    if (begin + hi > offset + size) hi = offset + size - begin;
+    TablrSeries* view = tablr_series_slice(chunk, lo, hi - lo);
+    if (view) tablr_series_set_time_unit(view, tablr_series_time_unit(series));
+    return view;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file chunks.h
+ * @brief Chunk lists behind chunked series buffers
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Not part of the public API. series.c keeps a TablrChunks in place of the
+ * element array of a chunked buffer; chunked.c stores, copies and flattens
+ * the chunks.
+ */
+
+#ifndef TABLR_CORE_CHUNKS_H
+#define TABLR_CORE_CHUNKS_H
+
+#include "tablr/core/chunked.h"
+
+/**
+ * @brief Opaque list of immutable chunks
+ */
+typedef struct TablrChunks TablrChunks;
+
+/**
+ * @brief Create an empty chunk list
+ * @return New list, or NULL on failure
+ */
+TablrChunks* tablr_chunks_create(void);
+
+/**
+ * @brief Free a chunk list, its chunks and its flattened copy
+ * @param chunks List (can be NULL)
+ */
+void tablr_chunks_free(TablrChunks* chunks);
+
+/**
+ * @brief Add a chunk after the last one, taking ownership of it
+ *
+ * Drops the flattened copy, which no longer covers every row.
+ *
+ * @return true on success, false on failure (chunk is not freed)
+ */
+bool tablr_chunks_push(TablrChunks* chunks, TablrSeries* chunk);
+
+/**
+ * @brief Free the last chunk
+ */
+void tablr_chunks_pop(TablrChunks* chunks);
+
+/**
+ * @brief Get the number of chunks
+ */
+size_t tablr_chunks_count(const TablrChunks* chunks);
+
+/**
+ * @brief Get the total number of rows of every chunk
+ */
+size_t tablr_chunks_rows(const TablrChunks* chunks);
+
+/**
+ * @brief Get the index of the chunk holding a row
+ */
+size_t tablr_chunks_find(const TablrChunks* chunks, size_t row);
+
+/**
+ * @brief Get one chunk
+ * @param chunks List
+ * @param index Chunk index
+ * @param begin Output row of the chunk's first element
+ * @return The chunk, owned by the list
+ */
+const TablrSeries* tablr_chunks_get(const TablrChunks* chunks, size_t index, size_t* begin);
+
+/**
+ * @brief Copy rows start to start + count - 1 into one new plain series
+ *
+ * Validity is not copied.
+ *
+ * @param dictionary Categories of a categorical list (NULL otherwise)
+ * @return New series, or NULL on failure
+ */
+TablrSeries* tablr_chunks_copy(const TablrChunks* chunks, size_t start, size_t count,
+                               const TablrSeries* dictionary, TablrDevice device);
+
+/**
+ * @brief Get every row in one plain series, flattening them on the first call
+ *
+ * Safe to call from several threads; the copy is kept until the list is
+ * freed or a chunk is added.
+ *
+ * @return Flattened series, or NULL if the copy failed
+ */
+const TablrSeries* tablr_chunks_flat(TablrChunks* chunks, const TablrSeries* dictionary);
+
+/**
+ * @brief Get the bytes held by the chunks and the flattened copy
+ */
+size_t tablr_chunks_bytes(const TablrChunks* chunks);
+
+/**
+ * @brief Get the chunk list behind a series
+ *
+ * Defined in series.c.
+ *
+ * @param series Series to query
+ * @param offset Output row of the series' first element in the list
+ * @return Chunk list, or NULL if the series is not chunked
+ */
+const TablrChunks* tablr_series_chunks(const TablrSeries* series, size_t* offset);
+
+/**
+ * @brief Drop the rows appended after the first size rows of a series
+ *
+ * Undoes tablr_series_append() calls made since the series had size rows.
+ * Defined in series.c.
+ */
+void tablr_series_unappend(TablrSeries* series, size_t size);
+
+#endif /* TABLR_CORE_CHUNKS_H */
@@ -0,0 +1,121 @@
+/**
+ * @file cpu.c
+ * @brief Implementation of CPU feature detection
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * This file detects SIMD extensions at runtime so kernels compiled for
+ * several instruction sets can pick the best one on the running machine.
+ */
+
+#include "tablr/core/cpu.h"
+
+#ifndef _WIN32
+#include <stdatomic.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define TABLR_X86_MSVC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TABLR_X86_GNU
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#define TABLR_ARM_NEON
+#endif
+
+#ifdef _WIN32
+static volatile long cached_level = -1;
+#else
+static _Atomic int cached_level = -1;
+#endif
+
+/**
+ * @brief Probe the CPU for supported SIMD extensions
+ */
+static TablrSimdLevel detect_simd_level(void) {
+#if defined(TABLR_X86_GNU)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")) {
+        return TABLR_SIMD_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) return TABLR_SIMD_AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return TABLR_SIMD_SSE42;
+    if (__builtin_cpu_supports("sse2")) return TABLR_SIMD_SSE2;
+    return TABLR_SIMD_SCALAR;
+#elif defined(TABLR_X86_MSVC)
+    int info[4];
+    __cpuid(info, 0);
+    int max_leaf = info[0];
+
+    __cpuid(info, 1);
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    bool sse42 = (info[2] & (1 << 20)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+
+    bool avx2 = false, avx512 = false;
+    if (max_leaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+        /* F, DQ, BW and VL, with the OS saving the opmask and upper ZMM state */
+        unsigned long need = (1ul << 16) | (1ul << 17) | (1ul << 30) | (1ul << 31);
+        avx512 = ((unsigned long)info[1] & need) == need && (_xgetbv(0) & 0xE6) == 0xE6;
+    }
+
+    if (avx512) return TABLR_SIMD_AVX512;
+    if (avx2) return TABLR_SIMD_AVX2;
+    if (sse42) return TABLR_SIMD_SSE42;
+    if (sse2) return TABLR_SIMD_SSE2;
+    return TABLR_SIMD_SCALAR;
+#elif defined(TABLR_ARM_NEON)
+    /* Advanced SIMD is part of every AArch64 CPU */
+    return TABLR_SIMD_NEON;
+#else
+    return TABLR_SIMD_SCALAR;
+#endif
+}
+
+/**
+ * @brief Get best supported SIMD level
+ *
+ * Detection runs once; concurrent first calls compute and store the same
+ * value, so the cache only needs to be atomic, not ordered.
+ *
+ * @return Detected SIMD level
+ */
+TablrSimdLevel tablr_cpu_simd_level(void) {
+#ifdef _WIN32
+    long level = cached_level;
+    if (level < 0) {
+        level = (long)detect_simd_level();
+        cached_level = level;
+    }
+#else
+    int level = atomic_load_explicit(&cached_level, memory_order_relaxed);
+    if (level < 0) {
+        level = (int)detect_simd_level();
+        atomic_store_explicit(&cached_level, level, memory_order_relaxed);
+    }
+#endif
+    return (TablrSimdLevel)level;
+}
+
+/**
+ * @brief Get string name of SIMD level
+ *
+ * @param level SIMD level
+ * @return String name (e.g., "sse2", "avx2")
+ */
+const char* tablr_simd_level_name(TablrSimdLevel level) {
+    switch (level) {
+        case TABLR_SIMD_SCALAR: return "scalar";
+        case TABLR_SIMD_SSE2:   return "sse2";
+        case TABLR_SIMD_SSE42:  return "sse4.2";
+        case TABLR_SIMD_AVX2:   return "avx2";
+        case TABLR_SIMD_AVX512: return "avx512";
+        case TABLR_SIMD_NEON:   return "neon";
+        default:                return "unknown";
+    }
+}
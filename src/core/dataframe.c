@@ -15,9 +15,12 @@
 #endif
 
 #include "tablr/core/dataframe.h"
+#include "series_text.h"
+#include "chunks.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
 
 /**
  * @brief Internal column structure
@@ -38,8 +41,62 @@ struct TablrDataFrame {
     Column* columns;  /**< Array of columns */
     size_t ncols;     /**< Number of columns */
     size_t nrows;     /**< Number of rows */
+    size_t* slots;    /**< Name hash table of column position + 1, 0 for empty */
+    size_t nslots;    /**< Hash table size, a power of two (0 before the first column) */
 };
 
+/**
+ * @brief Hash a column name (FNV-1a)
+ */
+static size_t hash_name(const char* name) {
+    uint64_t h = 14695981039346656037ULL;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        h ^= *p;
+        h *= 1099511628211ULL;
+    }
+    return (size_t)h;
+}
+
+/**
+ * @brief Find the hash slot holding name, or the empty slot where it belongs
+ */
+static size_t find_slot(const TablrDataFrame* df, const char* name) {
+    size_t mask = df->nslots - 1;
+    size_t i = hash_name(name) & mask;
+    while (df->slots[i] && strcmp(df->columns[df->slots[i] - 1].name, name) != 0) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/**
+ * @brief Index every current column in an emptied hash table
+ * 
+ * When names repeat, the first column with the name is the one found.
+ */
+static void fill_index(TablrDataFrame* df) {
+    memset(df->slots, 0, df->nslots * sizeof(size_t));
+    for (size_t c = 0; c < df->ncols; c++) {
+        size_t i = find_slot(df, df->columns[c].name);
+        if (!df->slots[i]) df->slots[i] = c + 1;
+    }
+}
+
+/**
+ * @brief Replace the name index with a larger table
+ * @return true on success, false if the table could not be allocated
+ */
+static bool grow_index(TablrDataFrame* df, size_t nslots) {
+    size_t* slots = (size_t*)malloc(nslots * sizeof(size_t));
+    if (!slots) return false;
+    
+    free(df->slots);
+    df->slots = slots;
+    df->nslots = nslots;
+    fill_index(df);
+    return true;
+}
+
 /**
  * @brief Create empty dataframe
  * 
@@ -54,6 +111,8 @@ TablrDataFrame* tablr_dataframe_create(void) {
     df->columns = NULL;
     df->ncols = 0;
     df->nrows = 0;
+    df->slots = NULL;
+    df->nslots = 0;
     
     return df;
 }
@@ -73,6 +132,7 @@ void tablr_dataframe_free(TablrDataFrame* df) {
         tablr_series_free(df->columns[i].series);
     }
     free(df->columns);
+    free(df->slots);
     free(df);
 }
 
@@ -92,11 +152,21 @@ bool tablr_dataframe_add_column(TablrDataFrame* df, const char* name, TablrSerie
     size_t series_size = tablr_series_size(series);
     if (df->ncols > 0 && series_size != df->nrows) return false;
     
+    /* Keep the name index at most half full */
+    if ((df->ncols + 1) * 2 > df->nslots && !grow_index(df, df->nslots ? df->nslots * 2 : 16)) {
+        return false;
+    }
+    
     Column* new_cols = (Column*)realloc(df->columns, (df->ncols + 1) * sizeof(Column));
     if (!new_cols) return false;
-    
     df->columns = new_cols;
-    df->columns[df->ncols].name = strdup(name);
+    
+    char* copy = strdup(name);
+    if (!copy) return false;
+    
+    size_t slot = find_slot(df, copy);
+    if (!df->slots[slot]) df->slots[slot] = df->ncols + 1;
+    df->columns[df->ncols].name = copy;
     df->columns[df->ncols].series = series;
     df->ncols++;
     
@@ -115,15 +185,51 @@ bool tablr_dataframe_add_column(TablrDataFrame* df, const char* name, TablrSerie
  * @return Series pointer, or NULL if not found
  */
 TablrSeries* tablr_dataframe_get_column(const TablrDataFrame* df, const char* name) {
-    if (!df || !name) return NULL;
+    size_t index;
+    return tablr_dataframe_column_index(df, name, &index) ? df->columns[index].series : NULL;
+}
+
+/**
+ * @brief Find the position of a column
+ * 
+ * Looks the name up in the dataframe's hash index, so the cost does not
+ * grow with the number of columns.
+ * 
+ * @param df DataFrame to query
+ * @param name Column name
+ * @param index Output position of the first column with this name
+ * @return true if found, false otherwise
+ */
+bool tablr_dataframe_column_index(const TablrDataFrame* df, const char* name, size_t* index) {
+    if (!df || !name || !index || df->ncols == 0) return false;
     
-    for (size_t i = 0; i < df->ncols; i++) {
-        if (strcmp(df->columns[i].name, name) == 0) {
-            return df->columns[i].series;
-        }
-    }
+    size_t slot = df->slots[find_slot(df, name)];
+    if (!slot) return false;
     
-    return NULL;
+    *index = slot - 1;
+    return true;
+}
+
+/**
+ * @brief Get column by position
+ * 
+ * @param df DataFrame to query
+ * @param index Column position
+ * @return Series pointer (owned by df), or NULL if out of range
+ */
+TablrSeries* tablr_dataframe_column_at(const TablrDataFrame* df, size_t index) {
+    return df && index < df->ncols ? df->columns[index].series : NULL;
+}
+
+/**
+ * @brief Get column name by position
+ * 
+ * @param df DataFrame to query
+ * @param index Column position
+ * @return Name (owned by df), or NULL if out of range
+ */
+const char* tablr_dataframe_column_name_at(const TablrDataFrame* df, size_t index) {
+    return df && index < df->ncols ? df->columns[index].name : NULL;
 }
 
 /**
@@ -138,21 +244,20 @@ TablrSeries* tablr_dataframe_get_column(const TablrDataFrame* df, const char* na
 bool tablr_dataframe_remove_column(TablrDataFrame* df, const char* name) {
     if (!df || !name) return false;
     
-    for (size_t i = 0; i < df->ncols; i++) {
-        if (strcmp(df->columns[i].name, name) == 0) {
-            free(df->columns[i].name);
-            tablr_series_free(df->columns[i].series);
-            
-            for (size_t j = i; j < df->ncols - 1; j++) {
-                df->columns[j] = df->columns[j + 1];
-            }
-            
-            df->ncols--;
-            return true;
-        }
+    size_t i;
+    if (!tablr_dataframe_column_index(df, name, &i)) return false;
+    
+    free(df->columns[i].name);
+    tablr_series_free(df->columns[i].series);
+    
+    for (size_t j = i; j < df->ncols - 1; j++) {
+        df->columns[j] = df->columns[j + 1];
     }
+    df->ncols--;
     
-    return false;
+    /* Positions after i shifted */
+    fill_index(df);
+    return true;
 }
 
 /**
@@ -228,15 +333,31 @@ void tablr_dataframe_print(const TablrDataFrame* df) {
     for (size_t row = 0; row < print_rows; row++) {
         for (size_t col = 0; col < df->ncols; col++) {
             TablrSeries* s = df->columns[col].series;
-            void* data = tablr_series_data(s);
+            const void* data = tablr_series_data_const(s);
             TablrDType dtype = tablr_series_dtype(s);
             
-            if (dtype == TABLR_INT32) {
-                printf("%-15d", ((int*)data)[row]);
+            if (!tablr_series_is_valid(s, row)) {
+                printf("%-15s", "null");
+            } else if (tablr_dtype_is_integer(dtype)) {
+                char text[TABLR_FORMAT_BUFFER_SIZE];
+                tablr_series_integer_text(s, row, text);
+                printf("%-15s", text);
             } else if (dtype == TABLR_FLOAT32) {
-                printf("%-15.2f", ((float*)data)[row]);
+                printf("%-15.2f", ((const float*)data)[row]);
             } else if (dtype == TABLR_FLOAT64) {
-                printf("%-15.2f", ((double*)data)[row]);
+                printf("%-15.2f", ((const double*)data)[row]);
+            } else if (dtype == TABLR_BOOL) {
+                printf("%-15s", ((const bool*)data)[row] ? "true" : "false");
+            } else if (dtype == TABLR_BITMASK) {
+                printf("%-15s", (((const uint64_t*)data)[row / 64] >> (row % 64)) & 1 ? "true" : "false");
+            } else if (dtype == TABLR_STRING) {
+                size_t len = 0;
+                const char* str = tablr_series_string_at(s, row, &len);
+                printf("%-15.*s", (int)len, str);
+            } else if (dtype == TABLR_CATEGORICAL) {
+                size_t len = 0;
+                const char* str = tablr_series_category_at(s, row, &len);
+                printf("%-15.*s", (int)len, str);
             }
         }
         printf("\n");
@@ -248,7 +369,8 @@ void tablr_dataframe_print(const TablrDataFrame* df) {
 /**
  * @brief Get first n rows
  * 
- * Creates a new dataframe containing the first n rows.
+ * Creates a new dataframe containing the first n rows. The columns are
+ * views of df's buffers, so this takes O(columns) time whatever n is.
  * 
  * @param df Source dataframe
  * @param n Number of rows to select
@@ -263,12 +385,7 @@ TablrDataFrame* tablr_dataframe_head(const TablrDataFrame* df, size_t n) {
     size_t rows = n < df->nrows ? n : df->nrows;
     
     for (size_t i = 0; i < df->ncols; i++) {
-        TablrSeries* s = df->columns[i].series;
-        void* data = tablr_series_data(s);
-        TablrDType dtype = tablr_series_dtype(s);
-        TablrDevice device = tablr_series_device(s);
-        
-        TablrSeries* new_series = tablr_series_create(data, rows, dtype, device);
+        TablrSeries* new_series = tablr_series_slice(df->columns[i].series, 0, rows);
         tablr_dataframe_add_column(result, df->columns[i].name, new_series);
     }
     
@@ -278,7 +395,8 @@ TablrDataFrame* tablr_dataframe_head(const TablrDataFrame* df, size_t n) {
 /**
  * @brief Get last n rows
  * 
- * Creates a new dataframe containing the last n rows.
+ * Creates a new dataframe containing the last n rows as views of df's
+ * buffers, like tablr_dataframe_head().
  * 
  * @param df Source dataframe
  * @param n Number of rows to select
@@ -294,14 +412,7 @@ TablrDataFrame* tablr_dataframe_tail(const TablrDataFrame* df, size_t n) {
     size_t start = df->nrows - rows;
     
     for (size_t i = 0; i < df->ncols; i++) {
-        TablrSeries* s = df->columns[i].series;
-        void* data = tablr_series_data(s);
-        TablrDType dtype = tablr_series_dtype(s);
-        TablrDevice device = tablr_series_device(s);
-        size_t elem_size = tablr_dtype_size(dtype);
-        
-        TablrSeries* new_series = tablr_series_create(
-            (char*)data + start * elem_size, rows, dtype, device);
+        TablrSeries* new_series = tablr_series_slice(df->columns[i].series, start, rows);
         tablr_dataframe_add_column(result, df->columns[i].name, new_series);
     }
     
@@ -311,7 +422,8 @@ TablrDataFrame* tablr_dataframe_tail(const TablrDataFrame* df, size_t n) {
 /**
  * @brief Copy dataframe
  * 
- * Creates a deep copy of the dataframe with all columns and data.
+ * Creates a new dataframe with the same columns. Column data is shared
+ * through reference-counted buffers rather than copied.
  * 
  * @param df DataFrame to copy
  * @return New dataframe copy, or NULL on failure
@@ -324,13 +436,72 @@ TablrDataFrame* tablr_dataframe_copy(const TablrDataFrame* df) {
     
     for (size_t i = 0; i < df->ncols; i++) {
         TablrSeries* s = df->columns[i].series;
-        void* data = tablr_series_data(s);
-        TablrDType dtype = tablr_series_dtype(s);
-        TablrDevice device = tablr_series_device(s);
-        
-        TablrSeries* new_series = tablr_series_create(data, tablr_series_size(s), dtype, device);
+        TablrSeries* new_series = tablr_series_slice(s, 0, tablr_series_size(s));
         tablr_dataframe_add_column(copy, df->columns[i].name, new_series);
     }
     
     return copy;
 }
+
+/**
+ * @brief Append the rows of one dataframe to another
+ * 
+ * Columns are matched by name and each is extended with
+ * tablr_series_append(), so the batch's buffers are shared rather than
+ * copied and the cost depends on the batch, not on df. If any column
+ * fails, the columns already extended are cut back.
+ * 
+ * @param df DataFrame to extend
+ * @param batch Rows to add, with the same column names and types
+ * @return true on success, false on failure (df unchanged)
+ */
+bool tablr_dataframe_append(TablrDataFrame* df, const TablrDataFrame* batch) {
+    if (!df || !batch) return false;
+    if (batch->ncols == 0) return true;
+    
+    if (df->ncols == 0) {
+        for (size_t c = 0; c < batch->ncols; c++) {
+            TablrSeries* s = batch->columns[c].series;
+            TablrSeries* view = tablr_series_slice(s, 0, tablr_series_size(s));
+            if (!tablr_dataframe_add_column(df, batch->columns[c].name, view)) {
+                tablr_series_free(view);
+                while (df->ncols > 0) tablr_dataframe_remove_column(df, df->columns[df->ncols - 1].name);
+                df->nrows = 0;
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    if (batch->ncols != df->ncols) return false;
+    for (size_t c = 0; c < df->ncols; c++) {
+        const TablrSeries* s = tablr_dataframe_get_column(batch, df->columns[c].name);
+        if (!s || tablr_series_dtype(s) != tablr_series_dtype(df->columns[c].series)) return false;
+    }
+    
+    for (size_t c = 0; c < df->ncols; c++) {
+        const TablrSeries* s = tablr_dataframe_get_column(batch, df->columns[c].name);
+        if (!tablr_series_append(df->columns[c].series, s)) {
+            while (c-- > 0) tablr_series_unappend(df->columns[c].series, df->nrows);
+            return false;
+        }
+    }
+    df->nrows += batch->nrows;
+    return true;
+}
+
+/**
+ * @brief Copy every chunked column into one contiguous buffer
+ * 
+ * @param df DataFrame to compact
+ * @return true on success, false if a column could not be copied
+ */
+bool tablr_dataframe_rechunk(TablrDataFrame* df) {
+    if (!df) return false;
+    
+    bool ok = true;
+    for (size_t c = 0; c < df->ncols; c++) {
+        ok = tablr_series_rechunk(df->columns[c].series) && ok;
+    }
+    return ok;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file encoded.h
+ * @brief Compressed element storage behind series buffers
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Not part of the public API. series.c keeps a TablrEncoded in place of the
+ * element array of a compressed buffer; encoding.c builds, decodes and
+ * scans them.
+ */
+
+#ifndef TABLR_CORE_ENCODED_H
+#define TABLR_CORE_ENCODED_H
+
+#include "tablr/core/encoding.h"
+
+/**
+ * @brief Opaque compressed element array
+ */
+typedef struct TablrEncoded TablrEncoded;
+
+/**
+ * @brief Compress an element array
+ * @param data Plain elements
+ * @param size Number of elements
+ * @param dtype Element type
+ * @return New encoded array, or NULL on failure or if no encoding is smaller
+ */
+TablrEncoded* tablr_encoded_create(const void* data, size_t size, TablrDType dtype);
+
+/**
+ * @brief Create an array whose elements all hold one value
+ * @param size Number of elements
+ * @param dtype Element type
+ * @param value The value, one element of dtype
+ * @return New encoded array, or NULL on failure or for other types
+ */
+TablrEncoded* tablr_encoded_constant(size_t size, TablrDType dtype, const void* value);
+
+/**
+ * @brief Create a float64 array holding start + i * step at element i
+ * @return New encoded array, or NULL on failure
+ */
+TablrEncoded* tablr_encoded_range(size_t size, double start, double step);
+
+/**
+ * @brief Free an encoded array and its decoded copy
+ * @param enc Encoded array (can be NULL)
+ */
+void tablr_encoded_free(TablrEncoded* enc);
+
+/**
+ * @brief Get the encoding of an encoded array
+ */
+TablrEncoding tablr_encoded_kind(const TablrEncoded* enc);
+
+/**
+ * @brief Get the bytes held by an encoded array, including its decoded copy
+ */
+size_t tablr_encoded_bytes(const TablrEncoded* enc);
+
+/**
+ * @brief Get every element decoded, decoding them on the first call
+ *
+ * Safe to call from several threads; the decoded copy comes from the
+ * default allocator and is kept until the encoded array is freed.
+ *
+ * @return Plain elements, or NULL if the allocation failed
+ */
+const void* tablr_encoded_values(TablrEncoded* enc);
+
+/**
+ * @brief Decode elements start to start + count - 1 into out
+ */
+void tablr_encoded_decode(const TablrEncoded* enc, size_t start, size_t count, void* out);
+
+/**
+ * @brief Create a read-only series over an encoded array, taking ownership of it
+ *
+ * Defined in series.c.
+ *
+ * @return New series, or NULL on failure (enc is not freed)
+ */
+TablrSeries* tablr_series_from_encoded(TablrEncoded* enc, size_t size, TablrDType dtype, TablrDevice device);
+
+/**
+ * @brief Get the encoded array behind a series
+ *
+ * Defined in series.c.
+ *
+ * @param series Series to query
+ * @param offset Output index of the series' first element in the array
+ * @return Encoded array, or NULL if the series is plain
+ */
+const TablrEncoded* tablr_series_encoded(const TablrSeries* series, size_t* offset);
+
+#endif /* TABLR_CORE_ENCODED_H */
@@ -0,0 +1,1178 @@
+/**
+ * @file encoding.c
+ * @brief Implementation of compressed series encodings
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Elements are encoded as 64-bit keys: integers with the sign bit flipped,
+ * so that unsigned key order is value order, and floats as their bit
+ * patterns. Run-length encoding keeps one key and end row per run. Delta
+ * and frame-of-reference encodings split the rows into blocks of
+ * ENCODING_BLOCK and bit-pack, per block, either the differences between
+ * neighbours less their minimum or the keys less the block minimum, at the
+ * narrowest width that holds them. Every block also records its smallest
+ * and largest key, which scans use as a zone map.
+ *
+ * Constant and range arrays hold no elements at all: every key is computed
+ * from the first value and the step when it is needed.
+ *
+ * Scans walk a series in segments: one run, one block or, for plain and
+ * range series, ENCODING_BLOCK rows. A run is a single value, and a block's
+ * bounds often decide a comparison for all of its rows, so only the
+ * remaining segments are decoded, one at a time, into a small buffer.
+ * Chunked series are scanned one chunk at a time, each chunk with its own
+ * encoding.
+ */
+
+#include "tablr/core/encoding.h"
+#include "tablr/core/allocator.h"
+#include "encoded.h"
+#include "chunks.h"
+#include "series_nulls.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <stdatomic.h>
+#endif
+
+#define ENCODING_BLOCK 1024  /**< Rows per delta or frame-of-reference block, and per scan segment */
+
+/**
+ * @brief One block of a delta or frame-of-reference array
+ */
+typedef struct {
+    uint64_t ref;    /**< Frame of reference: smallest key; delta: first key */
+    uint64_t base;   /**< Delta: smallest difference; 0 for frame of reference */
+    uint64_t min;    /**< Smallest key in the block */
+    uint64_t max;    /**< Largest key in the block */
+    uint64_t word;   /**< Index of the block's first packed word */
+    uint32_t width;  /**< Bits per packed value */
+} EncodedBlock;
+
+/**
+ * @brief Compressed element array
+ */
+struct TablrEncoded {
+    TablrEncoding kind;     /**< Encoding of the keys */
+    TablrDType dtype;       /**< Element type */
+    size_t size;            /**< Number of elements */
+    uint64_t* run_keys;     /**< RLE: key of each run */
+    size_t* run_ends;       /**< RLE: index one past the last row of each run */
+    size_t nruns;           /**< RLE: number of runs */
+    EncodedBlock* blocks;   /**< Delta and frame of reference: block headers */
+    size_t nblocks;         /**< Number of blocks */
+    uint64_t* packed;       /**< Bit-packed values of every block */
+    size_t npacked;         /**< Number of packed words */
+    uint64_t first;         /**< Constant: key of every element; integer range: first value */
+    uint64_t step;          /**< Integer range: difference between neighbouring values */
+    double float_first;     /**< Float range: first value */
+    double float_step;      /**< Float range: difference between neighbouring values */
+#ifdef _WIN32
+    void* volatile values;  /**< Decoded elements, or NULL until first needed */
+#else
+    _Atomic(void*) values;  /**< Decoded elements, or NULL until first needed */
+#endif
+};
+
+/* ===================== Keys ===================== */
+
+/**
+ * @brief Bit that is flipped to turn a value into a key
+ */
+static uint64_t sign_bit(TablrDType dtype) {
+    switch (dtype) {
+        case TABLR_INT8: return 0x80u;
+        case TABLR_INT16: return 0x8000u;
+        case TABLR_INT32:
+        case TABLR_DATE32: return 0x80000000u;
+        case TABLR_INT64:
+        case TABLR_TIMESTAMP64: return 0x8000000000000000ull;
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Whether a dtype can be encoded and scanned
+ */
+static bool is_numeric(TablrDType dtype) {
+    return tablr_dtype_is_integer(dtype) || dtype == TABLR_FLOAT32 || dtype == TABLR_FLOAT64 ||
+           dtype == TABLR_BOOL;
+}
+
+static uint64_t load_key(const void* data, size_t width, uint64_t sign, size_t i) {
+    switch (width) {
+        case 1: return ((const uint8_t*)data)[i] ^ sign;
+        case 2: return ((const uint16_t*)data)[i] ^ sign;
+        case 4: return ((const uint32_t*)data)[i] ^ sign;
+        default: return ((const uint64_t*)data)[i] ^ sign;
+    }
+}
+
+static void store_key(void* out, size_t width, uint64_t sign, size_t i, uint64_t key) {
+    key ^= sign;
+    switch (width) {
+        case 1: ((uint8_t*)out)[i] = (uint8_t)key; break;
+        case 2: ((uint16_t*)out)[i] = (uint16_t)key; break;
+        case 4: ((uint32_t*)out)[i] = (uint32_t)key; break;
+        default: ((uint64_t*)out)[i] = key; break;
+    }
+}
+
+/**
+ * @brief Value of a key as a double
+ */
+static double key_double(TablrDType dtype, uint64_t key) {
+    uint64_t bits = key ^ sign_bit(dtype);
+    switch (dtype) {
+        case TABLR_INT8: return (double)(int8_t)bits;
+        case TABLR_INT16: return (double)(int16_t)bits;
+        case TABLR_INT32:
+        case TABLR_DATE32: return (double)(int32_t)bits;
+        case TABLR_INT64:
+        case TABLR_TIMESTAMP64: return (double)(int64_t)bits;
+        case TABLR_FLOAT32: {
+            uint32_t u = (uint32_t)bits;
+            float f;
+            memcpy(&f, &u, sizeof(f));
+            return (double)f;
+        }
+        case TABLR_FLOAT64: {
+            double d;
+            memcpy(&d, &bits, sizeof(d));
+            return d;
+        }
+        default: return (double)bits;
+    }
+}
+
+/**
+ * @brief Key of a value given as 64 bits: an integer, or a double for floats
+ */
+static uint64_t value_key(TablrDType dtype, uint64_t bits) {
+    size_t width = tablr_dtype_size(dtype);
+    if (dtype == TABLR_FLOAT32) {
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        float f = (float)d;
+        uint32_t u;
+        memcpy(&u, &f, sizeof(u));
+        return u;
+    }
+    if (width < 8) bits &= ((uint64_t)1 << (width * 8)) - 1;
+    return bits ^ sign_bit(dtype);
+}
+
+/**
+ * @brief Key of a double converted to an element type
+ */
+static uint64_t double_key(TablrDType dtype, double value) {
+    uint64_t bits;
+    if (dtype == TABLR_FLOAT32 || dtype == TABLR_FLOAT64) memcpy(&bits, &value, sizeof(bits));
+    else if (dtype == TABLR_BOOL) bits = value != 0.0;
+    else if (dtype == TABLR_UINT64) bits = (uint64_t)value;
+    else bits = (uint64_t)(int64_t)value;
+    return value_key(dtype, bits);
+}
+
+/* ===================== Bit packing ===================== */
+
+/**
+ * @brief Number of bits needed to hold a value
+ */
+static uint32_t bit_width(uint64_t v) {
+    uint32_t n = 0;
+    for (; v; v >>= 1) n++;
+    return n;
+}
+
+/**
+ * @brief Number of 64-bit words holding count values of width bits
+ */
+static size_t packed_words(size_t count, uint32_t width) {
+    return (size_t)(((uint64_t)count * width + 63) / 64);
+}
+
+/**
+ * @brief OR a value of width bits into zeroed words at a bit position
+ */
+static void pack(uint64_t* words, uint64_t pos, uint64_t value, uint32_t width) {
+    if (width == 0) return;
+    size_t w = (size_t)(pos / 64);
+    unsigned shift = (unsigned)(pos % 64);
+    words[w] |= value << shift;
+    if (shift + width > 64) words[w + 1] |= value >> (64 - shift);
+}
+
+/**
+ * @brief Read a value of width bits at a bit position
+ */
+static uint64_t unpack(const uint64_t* words, uint64_t pos, uint32_t width) {
+    if (width == 0) return 0;
+    size_t w = (size_t)(pos / 64);
+    unsigned shift = (unsigned)(pos % 64);
+    uint64_t v = words[w] >> shift;
+    if (shift + width > 64) v |= words[w + 1] << (64 - shift);
+    return width == 64 ? v : v & (((uint64_t)1 << width) - 1);
+}
+
+/* ===================== Encoding ===================== */
+
+/**
+ * @brief Find the bounds and packed widths of one block for both block encodings
+ */
+static void measure_block(const void* data, size_t width, uint64_t sign, size_t begin, size_t end,
+                          EncodedBlock* ref, EncodedBlock* delta) {
+    uint64_t first = load_key(data, width, sign, begin);
+    uint64_t lo = first, hi = first;
+    uint64_t dlo = UINT64_MAX, dhi = 0;
+    uint64_t prev = first;
+    for (size_t i = begin + 1; i < end; i++) {
+        uint64_t k = load_key(data, width, sign, i);
+        uint64_t d = k - prev;
+        if (k < lo) lo = k;
+        if (k > hi) hi = k;
+        if (d < dlo) dlo = d;
+        if (d > dhi) dhi = d;
+        prev = k;
+    }
+    if (end - begin == 1) dlo = 0;
+
+    ref->ref = lo;
+    ref->base = 0;
+    ref->min = delta->min = lo;
+    ref->max = delta->max = hi;
+    ref->width = bit_width(hi - lo);
+    delta->ref = first;
+    delta->base = dlo;
+    delta->width = bit_width(dhi - dlo);
+}
+
+/**
+ * @brief Pack the keys of every block against its header
+ * @return true on success
+ */
+static bool pack_blocks(TablrEncoded* enc, const void* data, size_t width, uint64_t sign) {
+    enc->packed = (uint64_t*)calloc(enc->npacked ? enc->npacked : 1, sizeof(uint64_t));
+    if (!enc->packed) return false;
+
+    for (size_t b = 0; b < enc->nblocks; b++) {
+        const EncodedBlock* blk = &enc->blocks[b];
+        size_t begin = b * ENCODING_BLOCK;
+        size_t end = begin + ENCODING_BLOCK < enc->size ? begin + ENCODING_BLOCK : enc->size;
+        uint64_t pos = blk->word * 64;
+        uint64_t prev = load_key(data, width, sign, begin);
+        for (size_t i = begin; i < end; i++) {
+            uint64_t k = load_key(data, width, sign, i);
+            if (enc->kind == TABLR_ENCODING_FOR) {
+                pack(enc->packed, pos + (uint64_t)(i - begin) * blk->width, k - blk->ref, blk->width);
+            } else if (i > begin) {
+                pack(enc->packed, pos + (uint64_t)(i - begin - 1) * blk->width, k - prev - blk->base, blk->width);
+            }
+            prev = k;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Store the runs of equal keys
+ * @return true on success
+ */
+static bool build_runs(TablrEncoded* enc, const void* data, size_t width, uint64_t sign) {
+    enc->run_keys = (uint64_t*)malloc(enc->nruns * sizeof(uint64_t));
+    enc->run_ends = (size_t*)malloc(enc->nruns * sizeof(size_t));
+    if (!enc->run_keys || !enc->run_ends) return false;
+
+    size_t r = 0;
+    enc->run_keys[0] = load_key(data, width, sign, 0);
+    for (size_t i = 1; i < enc->size; i++) {
+        uint64_t k = load_key(data, width, sign, i);
+        if (k == enc->run_keys[r]) continue;
+        enc->run_ends[r++] = i;
+        enc->run_keys[r] = k;
+    }
+    enc->run_ends[r] = enc->size;
+    return true;
+}
+
+/**
+ * @brief Allocate an empty encoded array
+ * @return New encoded array, or NULL on failure
+ */
+static TablrEncoded* encoded_new(TablrEncoding kind, TablrDType dtype, size_t size) {
+    TablrEncoded* enc = (TablrEncoded*)calloc(1, sizeof(TablrEncoded));
+    if (!enc) return NULL;
+    enc->kind = kind;
+    enc->dtype = dtype;
+    enc->size = size;
+#ifdef _WIN32
+    enc->values = NULL;
+#else
+    atomic_init(&enc->values, NULL);
+#endif
+    return enc;
+}
+
+/**
+ * @brief Compress an element array
+ *
+ * One pass measures every candidate: the number of runs, and for each
+ * block its bounds and the widths both block encodings would pack at.
+ * The smallest candidate is then built in a second pass.
+ *
+ * @param data Plain elements
+ * @param size Number of elements
+ * @param dtype Element type
+ * @return New encoded array, or NULL on failure or if no encoding is smaller
+ */
+TablrEncoded* tablr_encoded_create(const void* data, size_t size, TablrDType dtype) {
+    if (!data || size == 0 || !is_numeric(dtype)) return NULL;
+
+    size_t width = tablr_dtype_size(dtype);
+    uint64_t sign = sign_bit(dtype);
+    bool blocks = tablr_dtype_is_integer(dtype);
+    size_t nblocks = (size + ENCODING_BLOCK - 1) / ENCODING_BLOCK;
+
+    size_t nruns = 1;
+    for (size_t i = 1; i < size; i++) {
+        if (load_key(data, width, sign, i) != load_key(data, width, sign, i - 1)) nruns++;
+    }
+
+    EncodedBlock* refs = blocks ? (EncodedBlock*)malloc(nblocks * sizeof(EncodedBlock)) : NULL;
+    EncodedBlock* deltas = blocks ? (EncodedBlock*)malloc(nblocks * sizeof(EncodedBlock)) : NULL;
+    if (blocks && (!refs || !deltas)) {
+        free(refs);
+        free(deltas);
+        return NULL;
+    }
+    size_t ref_words = 0, delta_words = 0;
+    for (size_t b = 0; blocks && b < nblocks; b++) {
+        size_t begin = b * ENCODING_BLOCK;
+        size_t end = begin + ENCODING_BLOCK < size ? begin + ENCODING_BLOCK : size;
+        measure_block(data, width, sign, begin, end, &refs[b], &deltas[b]);
+        refs[b].word = ref_words;
+        deltas[b].word = delta_words;
+        ref_words += packed_words(end - begin, refs[b].width);
+        delta_words += packed_words(end - begin - 1, deltas[b].width);
+    }
+
+    size_t best = size * width;
+    TablrEncoding kind = TABLR_ENCODING_PLAIN;
+    size_t rle_bytes = nruns * (sizeof(uint64_t) + sizeof(size_t));
+    size_t ref_bytes = nblocks * sizeof(EncodedBlock) + ref_words * sizeof(uint64_t);
+    size_t delta_bytes = nblocks * sizeof(EncodedBlock) + delta_words * sizeof(uint64_t);
+    if (rle_bytes < best) {
+        best = rle_bytes;
+        kind = TABLR_ENCODING_RLE;
+    }
+    if (blocks && ref_bytes < best) {
+        best = ref_bytes;
+        kind = TABLR_ENCODING_FOR;
+    }
+    if (blocks && delta_bytes < best) {
+        kind = TABLR_ENCODING_DELTA;
+    }
+
+    TablrEncoded* enc = kind != TABLR_ENCODING_PLAIN ? encoded_new(kind, dtype, size) : NULL;
+    bool ok = enc != NULL;
+    if (ok) {
+        if (kind == TABLR_ENCODING_RLE) {
+            enc->nruns = nruns;
+            ok = build_runs(enc, data, width, sign);
+        } else {
+            enc->nblocks = nblocks;
+            enc->blocks = kind == TABLR_ENCODING_FOR ? refs : deltas;
+            enc->npacked = kind == TABLR_ENCODING_FOR ? ref_words : delta_words;
+            if (kind == TABLR_ENCODING_FOR) refs = NULL;
+            else deltas = NULL;
+            ok = pack_blocks(enc, data, width, sign);
+        }
+    }
+
+    free(refs);
+    free(deltas);
+    if (!ok) {
+        tablr_encoded_free(enc);
+        return NULL;
+    }
+    return enc;
+}
+
+/**
+ * @brief Create an array whose elements all hold one value
+ *
+ * @param size Number of elements
+ * @param dtype Element type
+ * @param value The value, one element of dtype
+ * @return New encoded array, or NULL on failure or for other types
+ */
+TablrEncoded* tablr_encoded_constant(size_t size, TablrDType dtype, const void* value) {
+    if (!value || size == 0 || !is_numeric(dtype)) return NULL;
+    TablrEncoded* enc = encoded_new(TABLR_ENCODING_CONSTANT, dtype, size);
+    if (enc) enc->first = load_key(value, tablr_dtype_size(dtype), sign_bit(dtype), 0);
+    return enc;
+}
+
+/**
+ * @brief Create a float64 array holding start + i * step at element i
+ *
+ * @param size Number of elements
+ * @param start First value
+ * @param step Difference between neighbouring values
+ * @return New encoded array, or NULL on failure
+ */
+TablrEncoded* tablr_encoded_range(size_t size, double start, double step) {
+    if (size == 0) return NULL;
+    TablrEncoded* enc = encoded_new(TABLR_ENCODING_RANGE, TABLR_FLOAT64, size);
+    if (enc) {
+        enc->float_first = start;
+        enc->float_step = step;
+    }
+    return enc;
+}
+
+/**
+ * @brief Free an encoded array and its decoded copy
+ *
+ * @param enc Encoded array (can be NULL)
+ */
+void tablr_encoded_free(TablrEncoded* enc) {
+    if (!enc) return;
+
+#ifdef _WIN32
+    void* values = enc->values;
+#else
+    void* values = atomic_load(&enc->values);
+#endif
+    if (values) {
+        const TablrAllocator* allocator = tablr_default_allocator();
+        allocator->free(allocator->ctx, values, enc->size * tablr_dtype_size(enc->dtype));
+    }
+    free(enc->run_keys);
+    free(enc->run_ends);
+    free(enc->blocks);
+    free(enc->packed);
+    free(enc);
+}
+
+/**
+ * @brief Get the encoding of an encoded array
+ */
+TablrEncoding tablr_encoded_kind(const TablrEncoded* enc) {
+    return enc->kind;
+}
+
+/**
+ * @brief Get the bytes held by an encoded array, including its decoded copy
+ */
+size_t tablr_encoded_bytes(const TablrEncoded* enc) {
+    size_t bytes = sizeof(TablrEncoded) + enc->nruns * (sizeof(uint64_t) + sizeof(size_t)) +
+                   enc->nblocks * sizeof(EncodedBlock) + enc->npacked * sizeof(uint64_t);
+#ifdef _WIN32
+    bool decoded = enc->values != NULL;
+#else
+    bool decoded = atomic_load(&((TablrEncoded*)enc)->values) != NULL;
+#endif
+    if (decoded) bytes += enc->size * tablr_dtype_size(enc->dtype);
+    return bytes;
+}
+
+/* ===================== Decoding ===================== */
+
+/**
+ * @brief Index of the run holding a row
+ */
+static size_t find_run(const TablrEncoded* enc, size_t row) {
+    size_t lo = 0, hi = enc->nruns - 1;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (enc->run_ends[mid] > row) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+/**
+ * @brief Key of one row of a range array
+ */
+static uint64_t range_key(const TablrEncoded* enc, size_t row) {
+    if (enc->dtype == TABLR_FLOAT32 || enc->dtype == TABLR_FLOAT64) {
+        double d = enc->float_first + (double)row * enc->float_step;
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+        return value_key(enc->dtype, bits);
+    }
+    return value_key(enc->dtype, enc->first + (uint64_t)row * enc->step);
+}
+
+/**
+ * @brief Decode the keys of rows start to start + count - 1
+ *
+ * A delta block is summed from its first row up to the first row needed.
+ */
+static void decode_keys(const TablrEncoded* enc, size_t start, size_t count, uint64_t* out) {
+    size_t end = start + count;
+    if (enc->kind == TABLR_ENCODING_CONSTANT) {
+        for (size_t i = 0; i < count; i++) out[i] = enc->first;
+        return;
+    }
+    if (enc->kind == TABLR_ENCODING_RANGE) {
+        for (size_t i = start; i < end; i++) out[i - start] = range_key(enc, i);
+        return;
+    }
+    if (enc->kind == TABLR_ENCODING_RLE) {
+        size_t r = find_run(enc, start);
+        for (size_t i = start; i < end; r++) {
+            size_t stop = enc->run_ends[r] < end ? enc->run_ends[r] : end;
+            for (; i < stop; i++) out[i - start] = enc->run_keys[r];
+        }
+        return;
+    }
+
+    for (size_t i = start; i < end;) {
+        size_t b = i / ENCODING_BLOCK;
+        size_t first = b * ENCODING_BLOCK;
+        size_t stop = first + ENCODING_BLOCK < end ? first + ENCODING_BLOCK : end;
+        const EncodedBlock* blk = &enc->blocks[b];
+        uint64_t pos = blk->word * 64;
+        if (enc->kind == TABLR_ENCODING_FOR) {
+            for (; i < stop; i++) {
+                out[i - start] = blk->ref + unpack(enc->packed, pos + (uint64_t)(i - first) * blk->width, blk->width);
+            }
+            continue;
+        }
+        uint64_t k = blk->ref;
+        for (size_t j = first; j < stop; j++) {
+            if (j > first) k += blk->base + unpack(enc->packed, pos + (uint64_t)(j - first - 1) * blk->width, blk->width);
+            if (j >= i) out[j - start] = k;
+        }
+        i = stop;
+    }
+}
+
+/**
+ * @brief Decode elements start to start + count - 1 into out
+ */
+void tablr_encoded_decode(const TablrEncoded* enc, size_t start, size_t count, void* out) {
+    size_t width = tablr_dtype_size(enc->dtype);
+    uint64_t sign = sign_bit(enc->dtype);
+    uint64_t keys[ENCODING_BLOCK];
+    for (size_t done = 0; done < count; done += ENCODING_BLOCK) {
+        size_t n = count - done < ENCODING_BLOCK ? count - done : ENCODING_BLOCK;
+        decode_keys(enc, start + done, n, keys);
+        for (size_t i = 0; i < n; i++) store_key(out, width, sign, done + i, keys[i]);
+    }
+}
+
+/**
+ * @brief Get every element decoded, decoding them on the first call
+ *
+ * The copy lives as long as the encoded array, so it comes from the
+ * default allocator rather than the calling thread's, which may be an
+ * arena. Threads that race to decode each build a copy; the first to
+ * publish its copy wins and the others free theirs.
+ *
+ * @return Plain elements, or NULL if the allocation failed
+ */
+const void* tablr_encoded_values(TablrEncoded* enc) {
+#ifdef _WIN32
+    void* values = enc->values;
+#else
+    void* values = atomic_load(&enc->values);
+#endif
+    if (values) return values;
+
+    const TablrAllocator* allocator = tablr_default_allocator();
+    size_t bytes = enc->size * tablr_dtype_size(enc->dtype);
+    void* decoded = allocator->alloc(allocator->ctx, bytes);
+    if (!decoded) return NULL;
+    tablr_encoded_decode(enc, 0, enc->size, decoded);
+
+#ifdef _WIN32
+    values = InterlockedCompareExchangePointer(&enc->values, decoded, NULL);
+    if (!values) return decoded;
+#else
+    if (atomic_compare_exchange_strong(&enc->values, &values, decoded)) return decoded;
+#endif
+    allocator->free(allocator->ctx, decoded, bytes);
+    return values;
+}
+
+/* ===================== Series API ===================== */
+
+/**
+ * @brief Compress a numeric series with the smallest encoding that fits it
+ *
+ * @param series Series to compress
+ * @return New series, or NULL on failure
+ */
+TablrSeries* tablr_series_compress(const TablrSeries* series) {
+    if (!series) return NULL;
+
+    size_t size = tablr_series_size(series);
+    TablrDType dtype = tablr_series_dtype(series);
+    size_t offset;
+    TablrEncoded* enc = tablr_series_encoded(series, &offset) ? NULL
+        : tablr_encoded_create(tablr_series_data_const(series), size, dtype);
+    if (!enc) return tablr_series_slice(series, 0, size);
+
+    TablrSeries* out = tablr_series_from_encoded(enc, size, dtype, tablr_series_device(series));
+    if (!out) {
+        tablr_encoded_free(enc);
+        return NULL;
+    }
+    if (dtype == TABLR_TIMESTAMP64) tablr_series_set_time_unit(out, tablr_series_time_unit(series));
+    if (!tablr_series_copy_nulls(series, out)) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+/**
+ * @brief Decode a series into plain values
+ *
+ * @param series Series to decode
+ * @return New plain series, or NULL on failure
+ */
+TablrSeries* tablr_series_decompress(const TablrSeries* series) {
+    size_t offset;
+    const TablrEncoded* enc = tablr_series_encoded(series, &offset);
+    if (!enc) return series ? tablr_series_slice(series, 0, tablr_series_size(series)) : NULL;
+
+    size_t size = tablr_series_size(series);
+    TablrSeries* out = tablr_series_alloc(size, enc->dtype, tablr_series_device(series));
+    void* data = tablr_series_data(out);
+    if (!data) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    tablr_encoded_decode(enc, offset, size, data);
+    if (enc->dtype == TABLR_TIMESTAMP64) tablr_series_set_time_unit(out, tablr_series_time_unit(series));
+    if (!tablr_series_copy_nulls(series, out)) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+/**
+ * @brief Get the encoding of a series
+ *
+ * @param series Series to query
+ * @return Encoding; TABLR_ENCODING_PLAIN for NULL
+ */
+TablrEncoding tablr_series_encoding(const TablrSeries* series) {
+    size_t offset;
+    const TablrEncoded* enc = tablr_series_encoded(series, &offset);
+    return enc ? enc->kind : TABLR_ENCODING_PLAIN;
+}
+
+/**
+ * @brief Copy a range of elements into a caller's array
+ *
+ * @param series Fixed-width series
+ * @param start Index of the first element
+ * @param count Number of elements
+ * @param out Output array
+ * @return true on success, false if the range or type is invalid
+ */
+bool tablr_series_read(const TablrSeries* series, size_t start, size_t count, void* out) {
+    TablrDType dtype = tablr_series_dtype(series);
+    size_t size = tablr_series_size(series);
+    size_t width = tablr_dtype_size(dtype);
+    if (!series || !out || dtype == TABLR_STRING || width == 0 || start > size || count > size - start) return false;
+
+    size_t offset;
+    const TablrChunks* chunks = tablr_series_chunks(series, &offset);
+    if (chunks) {
+        /* Read each chunk's part of the range in place */
+        size_t row = offset + start, end = row + count;
+        for (size_t i = tablr_chunks_find(chunks, row); row < end; i++) {
+            size_t begin;
+            const TablrSeries* chunk = tablr_chunks_get(chunks, i, &begin);
+            size_t stop = begin + tablr_series_size(chunk) < end ? begin + tablr_series_size(chunk) : end;
+            tablr_series_read(chunk, row - begin, stop - row, out);
+            out = (char*)out + (stop - row) * width;
+            row = stop;
+        }
+        return true;
+    }
+    const TablrEncoded* enc = tablr_series_encoded(series, &offset);
+    if (enc) tablr_encoded_decode(enc, offset + start, count, out);
+    else memcpy(out, (const char*)tablr_series_data_const(series) + start * width, count * width);
+    return true;
+}
+
+/* ===================== Lazy series ===================== */
+
+/**
+ * @brief Wrap an encoded array in a series, freeing it on failure
+ */
+static TablrSeries* lazy_series(TablrEncoded* enc, TablrDevice device) {
+    if (!enc) return NULL;
+    TablrSeries* out = tablr_series_from_encoded(enc, enc->size, enc->dtype, device);
+    if (!out) tablr_encoded_free(enc);
+    return out;
+}
+
+/**
+ * @brief Create a series whose elements all hold one value, without storing them
+ *
+ * @param size Number of elements
+ * @param dtype Numeric, bool, date or timestamp type
+ * @param value Value converted to dtype
+ * @param device Target compute device
+ * @return New series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_series_full(size_t size, TablrDType dtype, double value, TablrDevice device) {
+    if (size == 0 || !is_numeric(dtype)) return NULL;
+
+    TablrEncoded* enc = encoded_new(TABLR_ENCODING_CONSTANT, dtype, size);
+    if (enc) enc->first = double_key(dtype, value);
+    return lazy_series(enc, device);
+}
+
+/**
+ * @brief Whether count steps from start stay within the range of a dtype
+ */
+static bool sequence_fits(TablrDType dtype, int64_t start, int64_t step, size_t count) {
+    int64_t lo = INT64_MIN, hi = INT64_MAX;
+    switch (dtype) {
+        case TABLR_INT8: lo = INT8_MIN; hi = INT8_MAX; break;
+        case TABLR_INT16: lo = INT16_MIN; hi = INT16_MAX; break;
+        case TABLR_INT32:
+        case TABLR_DATE32: lo = INT32_MIN; hi = INT32_MAX; break;
+        case TABLR_UINT8: lo = 0; hi = UINT8_MAX; break;
+        case TABLR_UINT16: lo = 0; hi = UINT16_MAX; break;
+        case TABLR_UINT32: lo = 0; hi = UINT32_MAX; break;
+        case TABLR_UINT64: lo = 0; break;
+        default: break;
+    }
+    if (start < lo || start > hi) return false;
+
+    /* Room left in the direction of travel, in whole steps */
+    uint64_t room = step >= 0 ? (uint64_t)hi - (uint64_t)start : (uint64_t)start - (uint64_t)lo;
+    uint64_t stride = step >= 0 ? (uint64_t)step : 0 - (uint64_t)step;
+    return stride == 0 || (uint64_t)count <= room / stride;
+}
+
+/**
+ * @brief Create a series holding start + i * step at element i, without storing it
+ *
+ * @param start First value
+ * @param step Difference between neighbouring values
+ * @param size Number of elements
+ * @param dtype Integer, float, date or timestamp type
+ * @param device Target compute device
+ * @return New series, or NULL on failure, for other types or if a value overflows dtype
+ */
+TablrSeries* tablr_series_sequence(int64_t start, int64_t step, size_t size, TablrDType dtype, TablrDevice device) {
+    if (size == 0 || !is_numeric(dtype) || dtype == TABLR_BOOL) return NULL;
+    bool floating = dtype == TABLR_FLOAT32 || dtype == TABLR_FLOAT64;
+    if (!floating && !sequence_fits(dtype, start, step, size - 1)) return NULL;
+
+    TablrEncoded* enc = encoded_new(TABLR_ENCODING_RANGE, dtype, size);
+    if (enc) {
+        enc->first = (uint64_t)start;
+        enc->step = (uint64_t)step;
+        enc->float_first = (double)start;
+        enc->float_step = (double)step;
+    }
+    return lazy_series(enc, device);
+}
+
+/**
+ * @brief Whether every element of a series stores the same value
+ *
+ * @param series Series to query
+ * @return true for constant series and single-run RLE views, false otherwise
+ */
+bool tablr_series_is_constant(const TablrSeries* series) {
+    size_t offset;
+    const TablrEncoded* enc = tablr_series_encoded(series, &offset);
+    if (!enc) return false;
+    if (enc->kind == TABLR_ENCODING_CONSTANT) return true;
+    return enc->kind == TABLR_ENCODING_RLE && enc->run_ends[find_run(enc, offset)] >= offset + tablr_series_size(series);
+}
+
+/**
+ * @brief Create a constant series repeating the first element of a series
+ *
+ * @param series Numeric, bool, date or timestamp series
+ * @param size Number of elements
+ * @return New series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_series_broadcast(const TablrSeries* series, size_t size) {
+    TablrDType dtype = tablr_series_dtype(series);
+    uint64_t value;
+    if (!series || size == 0 || !is_numeric(dtype) || !tablr_series_read(series, 0, 1, &value)) return NULL;
+
+    TablrSeries* out = lazy_series(tablr_encoded_constant(size, dtype, &value), tablr_series_device(series));
+    if (!out) return NULL;
+    if (dtype == TABLR_TIMESTAMP64) tablr_series_set_time_unit(out, tablr_series_time_unit(series));
+    for (size_t i = 0; !tablr_series_is_valid(series, 0) && i < size; i++) {
+        if (!tablr_series_set_valid(out, i, false)) {
+            tablr_series_free(out);
+            return NULL;
+        }
+    }
+    return out;
+}
+
+/* ===================== Scans ===================== */
+
+/**
+ * @brief Rows of a series that one scan step covers
+ */
+typedef struct {
+    size_t begin;      /**< First row, relative to the series */
+    size_t end;        /**< One past the last row */
+    bool constant;     /**< Every row holds min (a run or a constant) */
+    bool bounded;      /**< min and max bound every row (part of a block or a range) */
+    bool whole;        /**< min and max are attained (a whole block or part of a range) */
+    uint64_t min;      /**< Smallest key, if constant or bounded */
+    uint64_t max;      /**< Largest key, if constant or bounded */
+} Segment;
+
+/**
+ * @brief Find the segment starting at a row of a series
+ */
+static void next_segment(const TablrEncoded* enc, size_t offset, size_t size, size_t begin, Segment* seg) {
+    memset(seg, 0, sizeof(*seg));
+    seg->begin = begin;
+    size_t row = offset + begin;
+
+    if (!enc) {
+        seg->end = begin + ENCODING_BLOCK < size ? begin + ENCODING_BLOCK : size;
+    } else if (enc->kind == TABLR_ENCODING_CONSTANT) {
+        seg->end = size;
+        seg->constant = true;
+        seg->min = seg->max = enc->first;
+    } else if (enc->kind == TABLR_ENCODING_RANGE) {
+        /* Values are monotonic, so the end rows bound the segment */
+        seg->end = begin + ENCODING_BLOCK < size ? begin + ENCODING_BLOCK : size;
+        seg->bounded = seg->whole = true;
+        seg->min = range_key(enc, row);
+        seg->max = range_key(enc, offset + seg->end - 1);
+        if (key_double(enc->dtype, seg->min) > key_double(enc->dtype, seg->max)) {
+            uint64_t k = seg->min;
+            seg->min = seg->max;
+            seg->max = k;
+        }
+    } else if (enc->kind == TABLR_ENCODING_RLE) {
+        size_t r = find_run(enc, row);
+        seg->end = enc->run_ends[r] - offset < size ? enc->run_ends[r] - offset : size;
+        seg->constant = true;
+        seg->min = seg->max = enc->run_keys[r];
+    } else {
+        size_t b = row / ENCODING_BLOCK;
+        size_t block_end = (b + 1) * ENCODING_BLOCK < enc->size ? (b + 1) * ENCODING_BLOCK : enc->size;
+        seg->end = block_end - offset < size ? block_end - offset : size;
+        seg->bounded = true;
+        seg->whole = row == b * ENCODING_BLOCK && seg->end + offset == block_end;
+        seg->min = enc->blocks[b].min;
+        seg->max = enc->blocks[b].max;
+    }
+}
+
+/**
+ * @brief Decode the rows of a segment as doubles
+ */
+static void segment_values(const TablrSeries* s, const TablrEncoded* enc, size_t offset, const Segment* seg,
+                           double* out) {
+    TablrDType dtype = tablr_series_dtype(s);
+    size_t n = seg->end - seg->begin;
+    uint64_t keys[ENCODING_BLOCK];
+    if (enc) {
+        decode_keys(enc, offset + seg->begin, n, keys);
+    } else {
+        const void* data = tablr_series_data_const(s);
+        size_t width = tablr_dtype_size(dtype);
+        uint64_t sign = sign_bit(dtype);
+        for (size_t i = 0; i < n; i++) keys[i] = load_key(data, width, sign, seg->begin + i);
+    }
+    for (size_t i = 0; i < n; i++) out[i] = key_double(dtype, keys[i]);
+}
+
+/**
+ * @brief Get the validity of 64 rows from any row of a series
+ */
+static uint64_t valid_bits(const TablrSeries* s, size_t row) {
+    size_t w = row / 64;
+    unsigned shift = (unsigned)(row % 64);
+    uint64_t bits = tablr_series_validity_word(s, w) >> shift;
+    if (shift) bits |= tablr_series_validity_word(s, w + 1) << (64 - shift);
+    return bits;
+}
+
+static size_t popcount64(uint64_t word) {
+#ifdef _MSC_VER
+    return (size_t)__popcnt64(word);
+#else
+    return (size_t)__builtin_popcountll(word);
+#endif
+}
+
+/**
+ * @brief Fill the validity of a segment's rows, bit j for row begin + j
+ *
+ * Runs and constants can be longer than ENCODING_BLOCK; for them valid is
+ * NULL and only the count is wanted.
+ *
+ * @return Number of valid rows
+ */
+static size_t segment_validity(const TablrSeries* s, bool nulls, const Segment* seg, uint64_t* valid) {
+    size_t n = seg->end - seg->begin;
+    if (!nulls && !valid) return n;
+    size_t count = 0;
+    for (size_t w = 0; w * 64 < n; w++) {
+        uint64_t bits = nulls ? valid_bits(s, seg->begin + w * 64) : ~(uint64_t)0;
+        if (n - w * 64 < 64) bits &= ((uint64_t)1 << (n - w * 64)) - 1;
+        if (valid) valid[w] = bits;
+        count += popcount64(bits);
+    }
+    return count;
+}
+
+/**
+ * @brief Whether a series is chunked, so that scans go chunk by chunk
+ */
+static bool is_chunked(const TablrSeries* s) {
+    size_t offset;
+    return tablr_series_chunks(s, &offset) != NULL;
+}
+
+/**
+ * @brief Sum the valid elements of a numeric series
+ *
+ * @param series Numeric series
+ * @param sum Output sum
+ * @return true on success, false for other types
+ */
+bool tablr_series_sum(const TablrSeries* series, double* sum) {
+    if (!series || !sum || !is_numeric(tablr_series_dtype(series))) return false;
+    if (is_chunked(series)) {
+        double total = 0.0;
+        for (size_t i = 0; i < tablr_series_num_chunks(series); i++) {
+            TablrSeries* chunk = tablr_series_chunk(series, i);
+            double part;
+            bool ok = tablr_series_sum(chunk, &part);
+            tablr_series_free(chunk);
+            if (!ok) return false;
+            total += part;
+        }
+        *sum = total;
+        return true;
+    }
+
+    size_t offset = 0;
+    const TablrEncoded* enc = tablr_series_encoded(series, &offset);
+    TablrDType dtype = tablr_series_dtype(series);
+    size_t size = tablr_series_size(series);
+    bool nulls = tablr_series_null_count(series) > 0;
+    uint64_t valid[ENCODING_BLOCK / 64];
+    double values[ENCODING_BLOCK];
+
+    double total = 0.0;
+    Segment seg;
+    for (size_t begin = 0; begin < size; begin = seg.end) {
+        next_segment(enc, offset, size, begin, &seg);
+        size_t count = segment_validity(series, nulls, &seg, seg.constant ? NULL : valid);
+        if (count == 0) continue;
+        if (seg.constant) {
+            total += (double)count * key_double(dtype, seg.min);
+            continue;
+        }
+        segment_values(series, enc, offset, &seg, values);
+        for (size_t i = 0; i < seg.end - seg.begin; i++) {
+            if ((valid[i / 64] >> (i % 64)) & 1) total += values[i];
+        }
+    }
+    *sum = total;
+    return true;
+}
+
+/**
+ * @brief Get the smallest and largest valid elements of a numeric series
+ *
+ * @param series Numeric series
+ * @param min Output minimum
+ * @param max Output maximum
+ * @return true on success, false for other types or if no element is valid
+ */
+bool tablr_series_min_max(const TablrSeries* series, double* min, double* max) {
+    if (!series || !min || !max || !is_numeric(tablr_series_dtype(series))) return false;
+    if (is_chunked(series)) {
+        double lo = INFINITY, hi = -INFINITY;
+        bool any = false;
+        for (size_t i = 0; i < tablr_series_num_chunks(series); i++) {
+            TablrSeries* chunk = tablr_series_chunk(series, i);
+            if (!chunk) return false;
+            double a, b;
+            if (tablr_series_min_max(chunk, &a, &b)) {
+                any = true;
+                if (a < lo) lo = a;
+                if (b > hi) hi = b;
+            }
+            tablr_series_free(chunk);
+        }
+        *min = lo;
+        *max = hi;
+        return any;
+    }
+
+    size_t offset = 0;
+    const TablrEncoded* enc = tablr_series_encoded(series, &offset);
+    TablrDType dtype = tablr_series_dtype(series);
+    size_t size = tablr_series_size(series);
+    bool nulls = tablr_series_null_count(series) > 0;
+    uint64_t valid[ENCODING_BLOCK / 64];
+    double values[ENCODING_BLOCK];
+
+    double lo = INFINITY, hi = -INFINITY;
+    bool any = false;
+    Segment seg;
+    for (size_t begin = 0; begin < size; begin = seg.end) {
+        next_segment(enc, offset, size, begin, &seg);
+        size_t n = seg.end - seg.begin;
+        size_t count = segment_validity(series, nulls, &seg, seg.constant ? NULL : valid);
+        if (count == 0) continue;
+        any = true;
+        if (seg.constant || (seg.whole && count == n)) {
+            double a = key_double(dtype, seg.min), b = key_double(dtype, seg.max);
+            if (a < lo) lo = a;
+            if (b > hi) hi = b;
+            continue;
+        }
+        segment_values(series, enc, offset, &seg, values);
+        for (size_t i = 0; i < n; i++) {
+            if (!((valid[i / 64] >> (i % 64)) & 1)) continue;
+            if (values[i] < lo) lo = values[i];
+            if (values[i] > hi) hi = values[i];
+        }
+    }
+    *min = lo;
+    *max = hi;
+    return any;
+}
+
+static bool compare(double a, TablrCompareOp op, double b) {
+    switch (op) {
+        case TABLR_CMP_EQ: return a == b;
+        case TABLR_CMP_NE: return a != b;
+        case TABLR_CMP_LT: return a < b;
+        case TABLR_CMP_LE: return a <= b;
+        case TABLR_CMP_GT: return a > b;
+        default: return a >= b;
+    }
+}
+
+/**
+ * @brief Decide a comparison for every value in [lo, hi]
+ * @return 1 if it holds for all of them, 0 if for none, -1 if it depends
+ */
+static int compare_bounds(double lo, double hi, TablrCompareOp op, double value) {
+    /* NaN compares unequal to everything; NaN bounds come from all-NaN runs */
+    if (isnan(value) || isnan(lo) || isnan(hi)) return op == TABLR_CMP_NE;
+    switch (op) {
+        case TABLR_CMP_EQ: return value < lo || value > hi ? 0 : lo == hi ? 1 : -1;
+        case TABLR_CMP_NE: return value < lo || value > hi ? 1 : lo == hi ? 0 : -1;
+        case TABLR_CMP_LT: return hi < value ? 1 : lo >= value ? 0 : -1;
+        case TABLR_CMP_LE: return hi <= value ? 1 : lo > value ? 0 : -1;
+        case TABLR_CMP_GT: return lo > value ? 1 : hi <= value ? 0 : -1;
+        default: return lo >= value ? 1 : hi < value ? 0 : -1;
+    }
+}
+
+/**
+ * @brief Set bits begin to end - 1 of a bitmap
+ */
+static void set_bits(uint64_t* words, size_t begin, size_t end) {
+    while (begin < end) {
+        size_t w = begin / 64;
+        unsigned lo = (unsigned)(begin % 64);
+        size_t n = end - begin < 64 - lo ? end - begin : 64 - lo;
+        words[w] |= (n == 64 ? ~(uint64_t)0 : (((uint64_t)1 << n) - 1)) << lo;
+        begin += n;
+    }
+}
+
+/**
+ * @brief OR up to 64 bits into a bitmap at any bit position
+ */
+static void or_bits(uint64_t* words, size_t pos, uint64_t bits) {
+    unsigned shift = (unsigned)(pos % 64);
+    words[pos / 64] |= bits << shift;
+    if (shift && bits >> (64 - shift)) words[pos / 64 + 1] |= bits >> (64 - shift);
+}
+
+/**
+ * @brief Compare every element of a numeric series with a value
+ *
+ * @param series Numeric series
+ * @param op Comparison
+ * @param value Value to compare with
+ * @return New bitmask series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_series_compare(const TablrSeries* series, TablrCompareOp op, double value) {
+    if (!series || !is_numeric(tablr_series_dtype(series))) return NULL;
+
+    size_t offset = 0;
+    const TablrEncoded* enc = tablr_series_encoded(series, &offset);
+    TablrDType dtype = tablr_series_dtype(series);
+    size_t size = tablr_series_size(series);
+    TablrSeries* out = tablr_series_zeros(size, TABLR_BITMASK, tablr_series_device(series));
+    uint64_t* bits = (uint64_t*)tablr_series_data(out);
+    if (!bits) {
+        tablr_series_free(out);
+        return NULL;
+    }
+
+    bool chunked = is_chunked(series);
+    if (chunked) {
+        /* Compare each chunk and copy its bits into place */
+        size_t row = 0;
+        for (size_t i = 0; i < tablr_series_num_chunks(series); i++) {
+            TablrSeries* chunk = tablr_series_chunk(series, i);
+            TablrSeries* part = tablr_series_compare(chunk, op, value);
+            const uint64_t* part_bits = (const uint64_t*)tablr_series_data_const(part);
+            size_t n = tablr_series_size(chunk);
+            for (size_t w = 0; part_bits && w * 64 < n; w++) or_bits(bits, row + w * 64, part_bits[w]);
+            tablr_series_free(chunk);
+            tablr_series_free(part);
+            if (!part_bits) {
+                tablr_series_free(out);
+                return NULL;
+            }
+            row += n;
+        }
+    }
+
+    double values[ENCODING_BLOCK];
+    Segment seg;
+    for (size_t begin = 0; !chunked && begin < size; begin = seg.end) {
+        next_segment(enc, offset, size, begin, &seg);
+        int decided = seg.constant || seg.bounded
+            ? compare_bounds(key_double(dtype, seg.min), key_double(dtype, seg.max), op, value) : -1;
+        if (decided == 1) set_bits(bits, seg.begin, seg.end);
+        if (decided >= 0) continue;
+
+        segment_values(series, enc, offset, &seg, values);
+        for (size_t i = 0; i < seg.end - seg.begin; i++) {
+            size_t row = seg.begin + i;
+            if (compare(values[i], op, value)) bits[row / 64] |= (uint64_t)1 << (row % 64);
+        }
+    }
+
+    if (!tablr_series_copy_nulls(series, out)) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    return out;
+}
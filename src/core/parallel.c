@@ -0,0 +1,174 @@
+/**
+ * @file parallel.c
+ * @brief Implementation of multi-threaded execution helpers
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * This file implements a minimal fork-join parallel loop on top of native
+ * threads (pthreads or Win32). Tasks are handed out dynamically through an
+ * atomic counter so that unevenly sized tasks still balance across threads.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#endif
+
+#include "tablr/core/parallel.h"
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#endif
+
+#define MAX_THREADS 256  /**< Upper bound on worker threads */
+
+static int num_threads = 0;
+
+/**
+ * @brief Shared state of one parallel loop
+ */
+typedef struct {
+    size_t count;             /**< Number of tasks */
+    TablrParallelFunc func;   /**< Task function */
+    void* ctx;                /**< User context */
+#ifdef _WIN32
+    volatile LONG64 next;     /**< Next task index to hand out */
+#else
+    atomic_size_t next;       /**< Next task index to hand out */
+#endif
+} ParallelJob;
+
+/**
+ * @brief Claim the next unprocessed task index
+ */
+static size_t claim_task(ParallelJob* job) {
+#ifdef _WIN32
+    return (size_t)(InterlockedIncrement64(&job->next) - 1);
+#else
+    return atomic_fetch_add(&job->next, 1);
+#endif
+}
+
+/**
+ * @brief Process tasks until none are left
+ */
+static void run_tasks(ParallelJob* job) {
+    for (;;) {
+        size_t i = claim_task(job);
+        if (i >= job->count) break;
+        job->func(i, job->ctx);
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI worker_main(LPVOID arg) {
+    run_tasks((ParallelJob*)arg);
+    return 0;
+}
+#else
+static void* worker_main(void* arg) {
+    run_tasks((ParallelJob*)arg);
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Query number of online CPUs
+ */
+static int hardware_threads(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+/**
+ * @brief Set number of worker threads
+ *
+ * Values above the internal limit are clamped. Passing 0 restores the default
+ * of one thread per online CPU.
+ *
+ * @param n Thread count
+ */
+void tablr_set_num_threads(int n) {
+    if (n < 0) n = 0;
+    if (n > MAX_THREADS) n = MAX_THREADS;
+    num_threads = n;
+}
+
+/**
+ * @brief Get number of worker threads
+ *
+ * @return Configured thread count, or number of online CPUs if unset
+ */
+int tablr_get_num_threads(void) {
+    if (num_threads > 0) return num_threads;
+    int n = hardware_threads();
+    return n > MAX_THREADS ? MAX_THREADS : n;
+}
+
+/**
+ * @brief Run tasks in parallel
+ *
+ * Spawns up to tablr_get_num_threads() - 1 helper threads and participates
+ * from the calling thread. Returns once every task has completed. If threads
+ * cannot be created the remaining work runs on the calling thread.
+ *
+ * @param count Number of tasks
+ * @param func Task function
+ * @param ctx User context
+ */
+void tablr_parallel_for(size_t count, TablrParallelFunc func, void* ctx) {
+    if (count == 0 || !func) return;
+
+    size_t nthreads = (size_t)tablr_get_num_threads();
+    if (nthreads > count) nthreads = count;
+
+    if (nthreads <= 1) {
+        for (size_t i = 0; i < count; i++) func(i, ctx);
+        return;
+    }
+
+    ParallelJob job;
+    job.count = count;
+    job.func = func;
+    job.ctx = ctx;
+#ifdef _WIN32
+    job.next = 0;
+    HANDLE threads[MAX_THREADS];
+#else
+    atomic_init(&job.next, 0);
+    pthread_t threads[MAX_THREADS];
+#endif
+
+    size_t started = 0;
+    for (size_t t = 1; t < nthreads; t++) {
+#ifdef _WIN32
+        threads[started] = CreateThread(NULL, 0, worker_main, &job, 0, NULL);
+        if (!threads[started]) break;
+#else
+        if (pthread_create(&threads[started], NULL, worker_main, &job) != 0) break;
+#endif
+        started++;
+    }
+
+    run_tasks(&job);
+
+    for (size_t t = 0; t < started; t++) {
+#ifdef _WIN32
+        WaitForSingleObject(threads[t], INFINITE);
+        CloseHandle(threads[t]);
+#else
+        pthread_join(threads[t], NULL);
+#endif
+    }
+}
@@ -9,90 +9,1090 @@
  */
 
 #include "tablr/core/series.h"
+#include "tablr/core/allocator.h"
+#include "tablr/core/categorical.h"
+#include "series_text.h"
+#include "encoded.h"
+#include "chunks.h"
+#include "series_stats.h"
+#include "series_nulls.h"
 #include "tablr/device/device.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <stdatomic.h>
+#endif
+
+/**
+ * @brief Reference-counted data buffer
+ * 
+ * Holds the elements of one or more series. Series created from the same
+ * buffer (slices, copies, views on another device) each keep a reference;
+ * the data is freed, or handed back through release, when the last one is
+ * dropped.
+ * 
+ * For TABLR_STRING, data is an array of size + 1 offsets into chars, and
+ * element i is the bytes chars[data[i]] up to chars[data[i + 1]]. For
+ * TABLR_CATEGORICAL, data holds int32 codes into dictionary. For
+ * TABLR_BITMASK, data holds uint64_t words with element i in bit i % 64 of
+ * word i / 64. A compressed buffer has no data of its own: encoded holds
+ * the elements, and data is the decoded copy once one has been asked for.
+ * A chunked buffer has no data either: chunks holds the elements, and
+ * validity covers every chunk, with room for rows still to be appended.
+ */
+typedef struct {
+    void* data;               /**< Element array (string offsets for TABLR_STRING) */
+    size_t size;              /**< Number of elements in data */
+    TablrDType dtype;         /**< Data type of elements */
+    char* chars;              /**< String characters, or NULL for other types */
+    size_t chars_bytes;       /**< Size passed to allocator.alloc for chars */
+    TablrReleaseFunc release; /**< Releases externally owned data, or NULL if owned */
+    void* release_ctx;        /**< Context passed to release */
+    TablrDeallocFunc dealloc; /**< Frees adopted data, or NULL for free() */
+    TablrAllocator allocator; /**< Allocator data came from (free is NULL if adopted) */
+    size_t bytes;             /**< Size passed to allocator.alloc */
+    bool readonly;            /**< Data must not be written in place */
+    uint64_t* validity;       /**< Bit i set if element i is valid, or NULL if all are */
+    TablrSeries* dictionary;  /**< Categories of a TABLR_CATEGORICAL buffer, or NULL */
+    TablrEncoded* encoded;    /**< Compressed elements, or NULL if data holds them plainly */
+    TablrChunks* chunks;      /**< Chunked elements, or NULL if data holds them plainly */
+    size_t validity_words;    /**< Words allocated for validity if more than size needs, else 0 */
+#ifdef _WIN32
+    volatile LONG refs;       /**< Number of owners */
+#else
+    atomic_size_t refs;       /**< Number of owners */
+#endif
+} TablrBuffer;
+
+/**
+ * @brief Internal series structure
+ * 
+ * A series is a window of size elements starting at offset into a shared
+ * buffer, with a data type and target device. The offset of a TABLR_BITMASK
+ * series is always a multiple of 64, so its elements start at bit 0 of a
+ * word. Statistics of the window are cached on the series itself, since
+ * other series over the same buffer cover other elements.
+ */
+struct TablrSeries {
+    TablrBuffer* buffer;      /**< Shared element storage */
+    size_t offset;            /**< Index of the first element in buffer */
+    size_t size;              /**< Number of elements */
+    TablrDType dtype;         /**< Data type of elements */
+    TablrTimeUnit unit;       /**< Resolution of TABLR_TIMESTAMP64 elements */
+    TablrDevice device;       /**< Target compute device */
+    TablrSeriesStats stats;   /**< Cached statistics, if stats_state is STATS_READY */
+#ifdef _WIN32
+    volatile LONG stats_state; /**< STATS_EMPTY, STATS_WRITING or STATS_READY */
+#else
+    atomic_int stats_state;   /**< STATS_EMPTY, STATS_WRITING or STATS_READY */
+#endif
+};
+
+#define STATS_EMPTY 0    /**< No statistics cached */
+#define STATS_WRITING 1  /**< A thread is storing statistics */
+#define STATS_READY 2    /**< stats holds the statistics of the series */
+
+/**
+ * @brief Get the address of the first element of a series
+ */
+static inline void* series_ptr(const TablrSeries* s) {
+    if (s->buffer->chunks) {
+        const TablrSeries* flat = tablr_chunks_flat(s->buffer->chunks, s->buffer->dictionary);
+        if (!flat) return NULL;
+        if (s->dtype == TABLR_BITMASK) return (uint64_t*)flat->buffer->data + s->offset / 64;
+        return (char*)flat->buffer->data + s->offset * tablr_dtype_size(s->dtype);
+    }
+    if (s->buffer->encoded) {
+        const void* values = tablr_encoded_values(s->buffer->encoded);
+        return values ? (char*)values + s->offset * tablr_dtype_size(s->dtype) : NULL;
+    }
+    if (s->dtype == TABLR_BITMASK) return (uint64_t*)s->buffer->data + s->offset / 64;
+    return (char*)s->buffer->data + s->offset * tablr_dtype_size(s->dtype);
+}
+
+/**
+ * @brief Get the character buffer that a string series' offsets index
+ */
+static inline char* series_chars(const TablrSeries* s) {
+    if (s->buffer->chunks) {
+        const TablrSeries* flat = tablr_chunks_flat(s->buffer->chunks, NULL);
+        return flat ? flat->buffer->chars : NULL;
+    }
+    return s->buffer->chars;
+}
+
+/**
+ * @brief Wrap an element array in a buffer with one reference
+ * @return New buffer, or NULL on failure (data is not freed)
+ */
+static TablrBuffer* buffer_new(void* data, size_t size, TablrDType dtype,
+                               TablrReleaseFunc release, void* ctx) {
+    TablrBuffer* buffer = (TablrBuffer*)malloc(sizeof(TablrBuffer));
+    if (!buffer) return NULL;
+    
+    buffer->data = data;
+    buffer->size = size;
+    buffer->dtype = dtype;
+    buffer->chars = NULL;
+    buffer->chars_bytes = 0;
+    buffer->release = release;
+    buffer->release_ctx = ctx;
+    buffer->dealloc = NULL;
+    buffer->allocator.alloc = NULL;
+    buffer->allocator.free = NULL;
+    buffer->allocator.ctx = NULL;
+    buffer->bytes = 0;
+    buffer->readonly = false;
+    buffer->validity = NULL;
+    buffer->dictionary = NULL;
+    buffer->encoded = NULL;
+    buffer->chunks = NULL;
+    buffer->validity_words = 0;
+#ifdef _WIN32
+    buffer->refs = 1;
+#else
+    atomic_init(&buffer->refs, 1);
+#endif
+    return buffer;
+}
+
+/**
+ * @brief Add an owner to a buffer
+ */
+static void buffer_retain(TablrBuffer* buffer) {
+#ifdef _WIN32
+    InterlockedIncrement(&buffer->refs);
+#else
+    atomic_fetch_add_explicit(&buffer->refs, 1, memory_order_relaxed);
+#endif
+}
+
+/**
+ * @brief Get the number of owners of a buffer
+ */
+static size_t buffer_refs(TablrBuffer* buffer) {
+#ifdef _WIN32
+    return (size_t)InterlockedCompareExchange(&buffer->refs, 0, 0);
+#else
+    return atomic_load(&buffer->refs);
+#endif
+}
+
+/**
+ * @brief Drop one owner of a buffer, freeing it after the last one
+ */
+static void buffer_release(void* ctx) {
+    TablrBuffer* buffer = (TablrBuffer*)ctx;
+#ifdef _WIN32
+    bool last = InterlockedDecrement(&buffer->refs) == 0;
+#else
+    bool last = atomic_fetch_sub(&buffer->refs, 1) == 1;
+#endif
+    if (!last) return;
+    
+    if (buffer->release) {
+        buffer->release(buffer->release_ctx);
+    } else if (buffer->allocator.free) {
+        buffer->allocator.free(buffer->allocator.ctx, buffer->data, buffer->bytes);
+        if (buffer->chars) buffer->allocator.free(buffer->allocator.ctx, buffer->chars, buffer->chars_bytes);
+    } else if (buffer->dealloc) {
+        buffer->dealloc(buffer->data);
+    } else {
+        free(buffer->data);
+    }
+    free(buffer->validity);
+    tablr_series_free(buffer->dictionary);
+    tablr_encoded_free(buffer->encoded);
+    tablr_chunks_free(buffer->chunks);
+    free(buffer);
+}
+
+/**
+ * @brief Number of 64-bit words in a bitmap of n bits
+ */
+static inline size_t bitmap_words(size_t n) {
+    return (n + 63) / 64;
+}
+
+/**
+ * @brief Size in bytes of size elements of a fixed-width type
+ */
+static inline size_t values_bytes(size_t size, TablrDType dtype) {
+    if (dtype == TABLR_BITMASK) return bitmap_words(size) * sizeof(uint64_t);
+    return size * tablr_dtype_size(dtype);
+}
+
+/**
+ * @brief Clear the bits of a bitmap's last word past its first n bits
+ */
+static inline void bitmap_clear_tail(uint64_t* bits, size_t n) {
+    if (n % 64) bits[n / 64] &= ((uint64_t)1 << (n % 64)) - 1;
+}
+
+/**
+ * @brief Read 64 bits of a bitmap starting at any bit
+ * @param bits Bitmap
+ * @param nbits Number of bits that may be read; later bits read as 0
+ * @param start Index of the first bit
+ */
+static uint64_t bitmap_word(const uint64_t* bits, size_t nbits, size_t start) {
+    size_t lo = start / 64;
+    unsigned shift = (unsigned)(start % 64);
+    uint64_t word = bits[lo] >> shift;
+    if (shift && lo + 1 < bitmap_words(nbits)) word |= bits[lo + 1] << (64 - shift);
+    if (nbits - start < 64) word &= ((uint64_t)1 << (nbits - start)) - 1;
+    return word;
+}
+
+/**
+ * @brief Count the set bits of a word
+ */
+static inline size_t popcount64(uint64_t word) {
+#ifdef _MSC_VER
+    return (size_t)__popcnt64(word);
+#else
+    return (size_t)__builtin_popcountll(word);
+#endif
+}
+
+/**
+ * @brief Release callback for external data nobody needs to be told about
+ */
+static void no_release(void* ctx) {
+    (void)ctx;
+}
+
+/**
+ * @brief Create a series over part of a buffer, taking over one reference
+ * @return New series, or NULL on failure (the buffer reference is not dropped)
+ */
+static TablrSeries* series_new(TablrBuffer* buffer, size_t offset, size_t size, TablrDType dtype,
+                               TablrDevice device) {
+    TablrSeries* s = (TablrSeries*)malloc(sizeof(TablrSeries));
+    if (!s) return NULL;
+    
+    s->buffer = buffer;
+    s->offset = offset;
+    s->size = size;
+    s->dtype = dtype;
+    s->unit = TABLR_TIME_MICROSECOND;
+    s->device = device;
+#ifdef _WIN32
+    s->stats_state = STATS_EMPTY;
+#else
+    atomic_init(&s->stats_state, STATS_EMPTY);
+#endif
+    return s;
+}
+
+/**
+ * @brief Create a series owning a freshly allocated element array
+ * @return New series, or NULL on failure (data is not freed)
+ */
+static TablrSeries* series_own(void* data, size_t size, TablrDType dtype, TablrDevice device) {
+    TablrBuffer* buffer = buffer_new(data, size, dtype, NULL, NULL);
+    if (!buffer) return NULL;
+    
+    TablrSeries* s = series_new(buffer, 0, size, dtype, device);
+    if (!s) free(buffer);
+    return s;
+}
+
+/**
+ * @brief Create a string series with room for chars_size characters
+ * 
+ * Every offset starts at 0, so all elements are empty strings until the
+ * caller fills in offsets and characters.
+ * 
+ * @return New series, or NULL on failure
+ */
+static TablrSeries* strings_alloc(size_t size, size_t chars_size, TablrDevice device) {
+    const TablrAllocator* allocator = tablr_get_allocator();
+    size_t bytes = (size + 1) * sizeof(int64_t);
+    size_t chars_bytes = chars_size ? chars_size : 1;
+    void* data = allocator->alloc(allocator->ctx, bytes);
+    char* chars = data ? (char*)allocator->alloc(allocator->ctx, chars_bytes) : NULL;
+    TablrSeries* s = chars ? series_own(data, size, TABLR_STRING, device) : NULL;
+    if (!s) {
+        if (chars) allocator->free(allocator->ctx, chars, chars_bytes);
+        if (data) allocator->free(allocator->ctx, data, bytes);
+        return NULL;
+    }
+    
+    memset(data, 0, bytes);
+    s->buffer->chars = chars;
+    s->buffer->chars_bytes = chars_bytes;
+    s->buffer->allocator = *allocator;
+    s->buffer->bytes = bytes;
+    return s;
+}
+
+/**
+ * @brief Create a series over a new buffer from the thread's allocator
+ * 
+ * The elements are uninitialized, except that strings are empty.
+ * 
+ * @return New series, or NULL on failure
+ */
+static TablrSeries* series_alloc(size_t size, TablrDType dtype, TablrDevice device) {
+    if (dtype == TABLR_STRING) return strings_alloc(size, 0, device);
+    
+    const TablrAllocator* allocator = tablr_get_allocator();
+    size_t bytes = values_bytes(size, dtype);
+    void* data = allocator->alloc(allocator->ctx, bytes);
+    if (!data) return NULL;
+    
+    TablrSeries* s = series_own(data, size, dtype, device);
+    if (!s) {
+        allocator->free(allocator->ctx, data, bytes);
+        return NULL;
+    }
+    s->buffer->allocator = *allocator;
+    s->buffer->bytes = bytes;
+    return s;
+}
+
+/**
+ * @brief Copy C strings into a new string series
+ * 
+ * @param strs Array of NUL-terminated strings; NULL entries become nulls
+ * @return New series, or NULL on failure
+ */
+static TablrSeries* strings_create(const char* const* strs, size_t size, TablrDevice device) {
+    size_t total = 0;
+    bool nulls = false;
+    for (size_t i = 0; i < size; i++) {
+        if (strs[i]) total += strlen(strs[i]);
+        else nulls = true;
+    }
+    
+    TablrSeries* s = strings_alloc(size, total, device);
+    if (!s) return NULL;
+    
+    int64_t* offsets = (int64_t*)s->buffer->data;
+    char* chars = s->buffer->chars;
+    size_t pos = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (strs[i]) {
+            size_t len = strlen(strs[i]);
+            memcpy(chars + pos, strs[i], len);
+            pos += len;
+        }
+        offsets[i + 1] = (int64_t)pos;
+    }
+    
+    for (size_t i = 0; nulls && i < size; i++) {
+        if (!strs[i] && !tablr_series_set_valid(s, i, false)) {
+            tablr_series_free(s);
+            return NULL;
+        }
+    }
+    return s;
+}
+
+/**
+ * @brief Create series from array data
+ * 
+ * Allocates and initializes a new series by copying data from the provided array.
+ * For TABLR_STRING the data is an array of char*; the strings are copied
+ * back to back into one character buffer and NULL entries become nulls.
+ * 
+ * @param data Pointer to source data array
+ * @param size Number of elements in array
+ * @param dtype Data type of elements
+ * @param device Target compute device
+ * @return Pointer to new series, or NULL on failure
+ */
+TablrSeries* tablr_series_create(const void* data, size_t size, TablrDType dtype, TablrDevice device) {
+    if (!data || size == 0 || dtype == TABLR_CATEGORICAL) return NULL;
+    if (dtype == TABLR_STRING) return strings_create((const char* const*)data, size, device);
+    
+    TablrSeries* s = series_alloc(size, dtype, device);
+    if (!s) return NULL;
+    memcpy(series_ptr(s), data, values_bytes(size, dtype));
+    if (dtype == TABLR_BITMASK) bitmap_clear_tail((uint64_t*)series_ptr(s), size);
+    return s;
+}
+
+/**
+ * @brief Wrap a lazily generated array in a series, freeing it on failure
+ * @return New series, or NULL on failure or if enc is NULL
+ */
+static TablrSeries* series_lazy(TablrEncoded* enc, size_t size, TablrDType dtype, TablrDevice device) {
+    TablrSeries* s = enc ? tablr_series_from_encoded(enc, size, dtype, device) : NULL;
+    if (enc && !s) tablr_encoded_free(enc);
+    return s;
+}
+
+/**
+ * @brief Whether zeros and ones of a type are created lazily
+ */
+static bool is_lazy_dtype(TablrDType dtype) {
+    return tablr_dtype_is_integer(dtype) || dtype == TABLR_FLOAT32 || dtype == TABLR_FLOAT64 ||
+           dtype == TABLR_BOOL;
+}
+
+/**
+ * @brief Create series filled with zeros
+ * 
+ * Numeric, bool, date and timestamp series are lazy constants that store
+ * the value once and are filled only when a raw pointer is requested.
+ * Bitmask and string series are allocated and zeroed.
+ * 
+ * @param size Number of elements
+ * @param dtype Data type of elements
+ * @param device Target compute device
+ * @return Pointer to new series, or NULL on failure
+ */
+TablrSeries* tablr_series_zeros(size_t size, TablrDType dtype, TablrDevice device) {
+    if (size == 0 || dtype == TABLR_CATEGORICAL) return NULL;
+    
+    if (is_lazy_dtype(dtype)) {
+        uint64_t zero = 0;
+        return series_lazy(tablr_encoded_constant(size, dtype, &zero), size, dtype, device);
+    }
+    TablrSeries* s = series_alloc(size, dtype, device);
+    if (s) memset(series_ptr(s), 0, values_bytes(size, dtype));
+    return s;
+}
+
+/**
+ * @brief Create series with uninitialized elements
+ * 
+ * Allocates from the calling thread's allocator for the caller to fill in
+ * through tablr_series_data(). String elements start empty; use
+ * tablr_series_string_alloc() to reserve room for characters.
+ * 
+ * @param size Number of elements
+ * @param dtype Data type of elements
+ * @param device Target compute device
+ * @return Pointer to new series, or NULL on failure
+ */
+TablrSeries* tablr_series_alloc(size_t size, TablrDType dtype, TablrDevice device) {
+    if (size == 0 || dtype == TABLR_CATEGORICAL) return NULL;
+    return series_alloc(size, dtype, device);
+}
+
+/**
+ * @brief Create series over existing data without copying
+ * 
+ * The series uses data in place. It does not free data or, for string
+ * series, the strings; instead release(ctx) is called when the series and
+ * every slice of it have been freed, so the owner of the memory can keep it
+ * alive until then.
+ * 
+ * @param data Pointer to data array
+ * @param size Number of elements
+ * @param dtype Data type of elements
+ * @param device Target compute device
+ * @param release Called with ctx when the series is freed (may be NULL)
+ * @param ctx Context passed to release
+ * @return Pointer to new series, or NULL on failure or for TABLR_STRING and
+ *         TABLR_CATEGORICAL (release is not called)
+ */
+TablrSeries* tablr_series_external(void* data, size_t size, TablrDType dtype, TablrDevice device,
+                                   TablrReleaseFunc release, void* ctx) {
+    if (!data || size == 0 || dtype == TABLR_STRING || dtype == TABLR_CATEGORICAL) return NULL;
+    
+    TablrBuffer* buffer = buffer_new(data, size, dtype, release ? release : no_release, ctx);
+    if (!buffer) return NULL;
+    
+    TablrSeries* s = series_new(buffer, 0, size, dtype, device);
+    if (!s) free(buffer);
+    return s;
+}
+
+/**
+ * @brief Create series that takes ownership of a buffer
+ * 
+ * No data is copied. The series frees data with dealloc, or with free()
+ * if dealloc is NULL, once it and every view of it have been freed. Not
+ * available for TABLR_STRING or TABLR_CATEGORICAL.
+ * 
+ * @param data Heap buffer of size elements
+ * @param size Number of elements
+ * @param dtype Data type of elements
+ * @param device Target compute device
+ * @param dealloc Frees data (may be NULL)
+ * @return Pointer to new series, or NULL on failure (data is not freed)
+ */
+TablrSeries* tablr_series_adopt(void* data, size_t size, TablrDType dtype, TablrDevice device,
+                                TablrDeallocFunc dealloc) {
+    if (!data || size == 0 || dtype == TABLR_STRING || dtype == TABLR_CATEGORICAL) return NULL;
+    
+    TablrSeries* s = series_own(data, size, dtype, device);
+    if (s) s->buffer->dealloc = dealloc;
+    return s;
+}
+
+/**
+ * @brief Create read-only series over memory kept alive by its owner
+ * 
+ * Like tablr_series_external(), but the data is never written: getting a
+ * writable pointer with tablr_series_data() copies it first.
+ * 
+ * @param data Pointer to data array
+ * @param size Number of elements
+ * @param dtype Data type of elements
+ * @param device Target compute device
+ * @param keepalive Called with ctx once the data is no longer used (may be NULL)
+ * @param ctx Context passed to keepalive
+ * @return Pointer to new series, or NULL on failure (keepalive is not called)
+ */
+TablrSeries* tablr_series_wrap(const void* data, size_t size, TablrDType dtype, TablrDevice device,
+                               TablrReleaseFunc keepalive, void* ctx) {
+    TablrSeries* s = tablr_series_external((void*)data, size, dtype, device, keepalive, ctx);
+    if (s) s->buffer->readonly = true;
+    return s;
+}
+
+/**
+ * @brief Create string series with room for a number of characters
+ * 
+ * Fill it through tablr_series_string_buffers(): offsets[0] is 0 and
+ * element i must end at offsets[i + 1].
+ * 
+ * @param size Number of elements
+ * @param chars_size Total bytes of all elements
+ * @param device Target compute device
+ * @return Pointer to new series, or NULL on failure
+ */
+TablrSeries* tablr_series_string_alloc(size_t size, size_t chars_size, TablrDevice device) {
+    if (size == 0) return NULL;
+    return strings_alloc(size, chars_size, device);
+}
+
+/**
+ * @brief Create read-only string series over existing offsets and characters
+ * 
+ * Neither buffer is copied or written. Offsets must be non-decreasing and
+ * within chars; offsets[0] need not be 0, which allows wrapping a window
+ * of a larger string array.
+ * 
+ * @param offsets size + 1 character offsets
+ * @param chars Character buffer
+ * @param size Number of elements
+ * @param device Target compute device
+ * @param keepalive Called with ctx once neither buffer is used (may be NULL)
+ * @param ctx Context passed to keepalive
+ * @return Pointer to new series, or NULL on failure (keepalive is not called)
+ */
+TablrSeries* tablr_series_string_wrap(const int64_t* offsets, const char* chars, size_t size, TablrDevice device,
+                                      TablrReleaseFunc keepalive, void* ctx) {
+    if (!offsets || !chars || size == 0) return NULL;
+    
+    TablrBuffer* buffer = buffer_new((void*)offsets, size, TABLR_STRING, keepalive ? keepalive : no_release, ctx);
+    if (!buffer) return NULL;
+    buffer->chars = (char*)chars;
+    buffer->readonly = true;
+    
+    TablrSeries* s = series_new(buffer, 0, size, TABLR_STRING, device);
+    if (!s) free(buffer);
+    return s;
+}
+
+/**
+ * @brief Create a categorical series sharing a dictionary
+ * 
+ * The series keeps its own reference to the dictionary's buffer, so the
+ * caller may free categories afterwards.
+ * 
+ * @return New series with uninitialized codes, or NULL on failure
+ */
+static TablrSeries* categorical_alloc(size_t size, const TablrSeries* categories, TablrDevice device) {
+    if (categories && (categories->dtype != TABLR_STRING || tablr_series_null_count(categories) > 0)) return NULL;
+    
+    TablrSeries* s = series_alloc(size, TABLR_CATEGORICAL, device);
+    if (!s || !categories) return s;
+    
+    s->buffer->dictionary = tablr_series_slice(categories, 0, categories->size);
+    if (!s->buffer->dictionary) {
+        tablr_series_free(s);
+        return NULL;
+    }
+    return s;
+}
+
+/**
+ * @brief Create categorical series with uninitialized codes
+ * 
+ * @param size Number of elements
+ * @param categories Distinct values the codes index (may be NULL)
+ * @param device Target compute device
+ * @return Pointer to new series, or NULL on failure or if categories is
+ *         not a string series without nulls
+ */
+TablrSeries* tablr_series_categorical_alloc(size_t size, const TablrSeries* categories, TablrDevice device) {
+    if (size == 0) return NULL;
+    return categorical_alloc(size, categories, device);
+}
+
+/**
+ * @brief Create categorical series from codes and a dictionary
+ * 
+ * Copies the codes and shares categories. Every code is checked against
+ * the number of categories; negative codes are stored as -1 and marked
+ * null.
+ * 
+ * @param codes Element codes
+ * @param size Number of elements
+ * @param categories Distinct values the codes index (may be NULL)
+ * @param device Target compute device
+ * @return Pointer to new series, or NULL on failure or if a code is out of range
+ */
+TablrSeries* tablr_series_categorical(const int32_t* codes, size_t size, const TablrSeries* categories,
+                                      TablrDevice device) {
+    if (!codes || size == 0) return NULL;
+    
+    int64_t ncategories = categories ? (int64_t)categories->size : 0;
+    bool nulls = false;
+    for (size_t i = 0; i < size; i++) {
+        if (codes[i] >= ncategories) return NULL;
+        if (codes[i] < 0) nulls = true;
+    }
+    
+    TablrSeries* s = categorical_alloc(size, categories, device);
+    if (!s) return NULL;
+    
+    int32_t* out = (int32_t*)series_ptr(s);
+    for (size_t i = 0; i < size; i++) {
+        out[i] = codes[i] < 0 ? -1 : codes[i];
+    }
+    for (size_t i = 0; nulls && i < size; i++) {
+        if (codes[i] < 0 && !tablr_series_set_valid(s, i, false)) {
+            tablr_series_free(s);
+            return NULL;
+        }
+    }
+    return s;
+}
+
+/**
+ * @brief Get the dictionary of a categorical series
+ * 
+ * @param series Categorical series
+ * @return Categories indexed by the codes, or NULL for other types or if
+ *         the series has no categories
+ */
+const TablrSeries* tablr_series_categories(const TablrSeries* series) {
+    if (!series || series->dtype != TABLR_CATEGORICAL) return NULL;
+    return series->buffer->dictionary;
+}
+
+/**
+ * @brief Get the value of one element of a categorical series
+ * 
+ * Looks the element's code up in the dictionary. The characters are not
+ * NUL-terminated.
+ * 
+ * @param series Categorical series
+ * @param index Element index
+ * @param length Output length in bytes
+ * @return Pointer to the first character, or NULL if out of range, null
+ *         or not a categorical series
+ */
+const char* tablr_series_category_at(const TablrSeries* series, size_t index, size_t* length) {
+    if (!series || series->dtype != TABLR_CATEGORICAL || !tablr_series_is_valid(series, index)) return NULL;
+    
+    int32_t code = ((const int32_t*)series_ptr(series))[index];
+    return tablr_series_string_at(series->buffer->dictionary, (size_t)code, length);
+}
+
+/**
+ * @brief Create a read-only series over an encoded array, taking ownership of it
+ * 
+ * @param enc Encoded elements
+ * @param size Number of elements
+ * @param dtype Data type of elements
+ * @param device Target compute device
+ * @return New series, or NULL on failure (enc is not freed)
+ */
+TablrSeries* tablr_series_from_encoded(TablrEncoded* enc, size_t size, TablrDType dtype, TablrDevice device) {
+    TablrSeries* s = series_own(NULL, size, dtype, device);
+    if (!s) return NULL;
+    s->buffer->encoded = enc;
+    s->buffer->readonly = true;
+    return s;
+}
+
+/**
+ * @brief Get the encoded array behind a series
+ * 
+ * @param series Series to query
+ * @param offset Output index of the series' first element in the array
+ * @return Encoded array, or NULL if the series is plain
+ */
+const TablrEncoded* tablr_series_encoded(const TablrSeries* series, size_t* offset) {
+    if (!series || !series->buffer->encoded) return NULL;
+    *offset = series->offset;
+    return series->buffer->encoded;
+}
+
+static bool series_unshare(TablrSeries* series);
+
+/**
+ * @brief Get the chunk list behind a series
+ * 
+ * @param series Series to query
+ * @param offset Output row of the series' first element in the list
+ * @return Chunk list, or NULL if the series is not chunked
+ */
+const TablrChunks* tablr_series_chunks(const TablrSeries* series, size_t* offset) {
+    if (!series || !series->buffer->chunks) return NULL;
+    *offset = series->offset;
+    return series->buffer->chunks;
+}
 
 /**
- * @brief Internal series structure
+ * @brief Make room in a chunked buffer's validity bitmap for size rows
+ * 
+ * The bitmap at least doubles when it grows, so appends copy each word a
+ * constant number of times on average. A new bitmap starts all valid.
  * 
- * Contains the actual data, size, data type, and target device
- * for a one-dimensional array of values.
+ * @return true on success, false on failure (buffer unchanged)
  */
-struct TablrSeries {
-    void* data;          /**< Pointer to series data */
-    size_t size;         /**< Number of elements */
-    TablrDType dtype;    /**< Data type of elements */
-    TablrDevice device;  /**< Target compute device */
-};
+static bool validity_reserve(TablrBuffer* buffer, size_t size) {
+    size_t have = buffer->validity_words ? buffer->validity_words : bitmap_words(buffer->size);
+    size_t need = bitmap_words(size);
+    if (buffer->validity && need <= have) return true;
+    
+    size_t words = buffer->validity && have * 2 > need ? have * 2 : need;
+    uint64_t* bits = (uint64_t*)realloc(buffer->validity, words * sizeof(uint64_t));
+    if (!bits) return false;
+    size_t keep = buffer->validity ? have : 0;
+    memset(bits + keep, 0xFF, (words - keep) * sizeof(uint64_t));
+    buffer->validity = bits;
+    buffer->validity_words = words;
+    return true;
+}
 
 /**
- * @brief Create series from array data
+ * @brief Give a series a chunked buffer of its own that ends where it ends
  * 
- * Allocates and initializes a new series by copying data from the provided array.
+ * A plain series becomes one chunk, a view of itself; a chunked series
+ * shared with others gets a new list of views of its chunks. Validity and
+ * the dictionary are copied along.
  * 
- * @param data Pointer to source data array
- * @param size Number of elements in array
- * @param dtype Data type of elements
- * @param device Target compute device
- * @return Pointer to new series, or NULL on failure
+ * @return true on success, false on failure (series unchanged)
  */
-TablrSeries* tablr_series_create(const void* data, size_t size, TablrDType dtype, TablrDevice device) {
-    if (!data || size == 0) return NULL;
-    
-    TablrSeries* s = (TablrSeries*)malloc(sizeof(TablrSeries));
-    if (!s) return NULL;
+static bool series_make_chunked(TablrSeries* series) {
+    TablrBuffer* old = series->buffer;
+    if (old->chunks && buffer_refs(old) == 1 && series->offset + series->size == old->size) return true;
     
-    size_t elem_size = tablr_dtype_size(dtype);
-    s->data = malloc(size * elem_size);
-    if (!s->data) {
-        free(s);
-        return NULL;
+    TablrBuffer* buffer = buffer_new(NULL, series->size, series->dtype, NULL, NULL);
+    bool ok = buffer && (buffer->chunks = tablr_chunks_create()) != NULL;
+    size_t nchunks = tablr_series_num_chunks(series);
+    for (size_t i = 0; ok && i < nchunks; i++) {
+        TablrSeries* piece = tablr_series_chunk(series, i);
+        ok = piece && tablr_chunks_push(buffer->chunks, piece);
+        if (!ok) tablr_series_free(piece);
+    }
+    if (ok && old->dictionary) {
+        buffer->dictionary = tablr_series_slice(old->dictionary, 0, old->dictionary->size);
+        ok = buffer->dictionary != NULL;
+    }
+    if (ok && old->validity) {
+        ok = validity_reserve(buffer, series->size);
+        for (size_t w = 0; ok && w < bitmap_words(series->size); w++) {
+            buffer->validity[w] = bitmap_word(old->validity, series->offset + series->size, series->offset + w * 64);
+        }
+    }
+    if (!ok) {
+        if (buffer) buffer_release(buffer);
+        return false;
     }
     
-    memcpy(s->data, data, size * elem_size);
-    s->size = size;
-    s->dtype = dtype;
-    s->device = device;
+    buffer->readonly = true;
+    buffer_release(old);
+    series->buffer = buffer;
+    series->offset = 0;
+    return true;
+}
+
+/**
+ * @brief Whether two categorical series share one dictionary
+ */
+static bool same_dictionary(const TablrSeries* a, const TablrSeries* b) {
+    const TablrSeries* x = a->buffer->dictionary;
+    const TablrSeries* y = b->buffer->dictionary;
+    if (!x || !y) return x == y;
+    return x->buffer == y->buffer && x->offset == y->offset && x->size == y->size;
+}
+
+/**
+ * @brief Recode a categorical series into the dictionary of another
+ * 
+ * Categories the dictionary lacks are added after its own, so codes
+ * already stored against it stay valid.
+ * 
+ * @param series Series whose dictionary to use
+ * @param chunk Series to recode
+ * @param dictionary Output extended dictionary, or NULL if none was needed
+ * @return New series, or NULL on failure
+ */
+static TablrSeries* recode_categories(const TablrSeries* series, const TablrSeries* chunk, TablrSeries** dictionary) {
+    const TablrSeries* current = series->buffer->dictionary;
+    const TablrSeries* incoming = chunk->buffer->dictionary;
+    size_t ncurrent = current ? current->size : 0;
+    size_t nincoming = incoming ? incoming->size : 0;
     
-    return s;
+    TablrCategoryIndex* index = tablr_category_index_create_sized(ncurrent + nincoming);
+    int32_t* map = (int32_t*)malloc((nincoming ? nincoming : 1) * sizeof(int32_t));
+    int32_t* codes = (int32_t*)malloc(chunk->size * sizeof(int32_t));
+    bool ok = index && map && codes;
+    for (size_t c = 0; ok && c < ncurrent; c++) {
+        size_t len = 0;
+        const char* chars = tablr_series_string_at(current, c, &len);
+        ok = chars && tablr_category_index_add(index, chars, len) >= 0;
+    }
+    for (size_t c = 0; ok && c < nincoming; c++) {
+        size_t len = 0;
+        const char* chars = tablr_series_string_at(incoming, c, &len);
+        map[c] = chars ? tablr_category_index_add(index, chars, len) : -1;
+        ok = map[c] >= 0;
+    }
+    const int32_t* src = ok ? (const int32_t*)series_ptr(chunk) : NULL;
+    for (size_t r = 0; src && r < chunk->size; r++) {
+        codes[r] = tablr_series_is_valid(chunk, r) ? map[src[r]] : -1;
+    }
+    
+    *dictionary = src && tablr_category_index_size(index) > ncurrent
+        ? tablr_category_index_categories(index, series->device) : NULL;
+    TablrSeries* out = src && (*dictionary || tablr_category_index_size(index) == ncurrent)
+        ? tablr_series_categorical(codes, chunk->size, *dictionary ? *dictionary : current, series->device) : NULL;
+    if (!out) {
+        tablr_series_free(*dictionary);
+        *dictionary = NULL;
+    }
+    tablr_category_index_free(index);
+    free(map);
+    free(codes);
+    return out;
 }
 
 /**
- * @brief Create series filled with zeros
+ * @brief Append the elements of one series to another
  * 
- * Allocates a new series and initializes all elements to zero.
+ * The chunks of chunk are added as views; only a categorical chunk with
+ * another dictionary is copied, to recode it. The validity bits of the
+ * new rows are copied into the series' bitmap if either side has nulls.
  * 
- * @param size Number of elements
- * @param dtype Data type of elements
- * @param device Target compute device
- * @return Pointer to new series, or NULL on failure
+ * @param series Series to extend
+ * @param chunk Elements to add
+ * @return true on success, false on failure (series unchanged)
  */
-TablrSeries* tablr_series_zeros(size_t size, TablrDType dtype, TablrDevice device) {
-    if (size == 0) return NULL;
+bool tablr_series_append(TablrSeries* series, const TablrSeries* chunk) {
+    if (!series || !chunk || chunk->dtype != series->dtype) return false;
+    if (series->dtype == TABLR_TIMESTAMP64 && chunk->unit != series->unit) return false;
+    if (chunk->size == 0) return true;
     
-    TablrSeries* s = (TablrSeries*)malloc(sizeof(TablrSeries));
-    if (!s) return NULL;
+    /* Take the new chunks first, since chunk may be series itself */
+    TablrSeries* dictionary = NULL;
+    bool recode = series->dtype == TABLR_CATEGORICAL && !same_dictionary(series, chunk);
+    size_t npieces = recode ? 1 : tablr_series_num_chunks(chunk);
+    TablrSeries** pieces = (TablrSeries**)calloc(npieces, sizeof(TablrSeries*));
+    bool ok = pieces != NULL;
+    for (size_t i = 0; ok && i < npieces; i++) {
+        pieces[i] = recode ? recode_categories(series, chunk, &dictionary) : tablr_series_chunk(chunk, i);
+        ok = pieces[i] != NULL;
+    }
     
-    size_t elem_size = tablr_dtype_size(dtype);
-    s->data = calloc(size, elem_size);
-    if (!s->data) {
-        free(s);
-        return NULL;
+    size_t size = series->size + chunk->size;
+    ok = ok && series_make_chunked(series);
+    TablrBuffer* buffer = series->buffer;
+    bool nulls = buffer->validity || tablr_series_null_count(chunk) > 0;
+    ok = ok && (!nulls || validity_reserve(buffer, size));
+    size_t pushed = 0;
+    while (ok && pushed < npieces) {
+        ok = tablr_chunks_push(buffer->chunks, pieces[pushed]);
+        if (ok) pieces[pushed++] = NULL;
     }
+    if (!ok) {
+        while (pushed-- > 0) tablr_chunks_pop(buffer->chunks);
+        for (size_t i = 0; pieces && i < npieces; i++) tablr_series_free(pieces[i]);
+        free(pieces);
+        tablr_series_free(dictionary);
+        return false;
+    }
+    free(pieces);
     
-    s->size = size;
-    s->dtype = dtype;
-    s->device = device;
+    for (size_t w = 0; nulls && w < bitmap_words(chunk->size); w++) {
+        size_t bit = series->size + w * 64;
+        size_t n = chunk->size - w * 64 < 64 ? chunk->size - w * 64 : 64;
+        uint64_t mask = n == 64 ? ~(uint64_t)0 : ((uint64_t)1 << n) - 1;
+        uint64_t word = tablr_series_validity_word(chunk, w) & mask;
+        unsigned shift = (unsigned)(bit % 64);
+        buffer->validity[bit / 64] = (buffer->validity[bit / 64] & ~(mask << shift)) | (word << shift);
+        if (shift && n > 64 - shift) {
+            uint64_t* next = &buffer->validity[bit / 64 + 1];
+            *next = (*next & ~(mask >> (64 - shift))) | (word >> (64 - shift));
+        }
+    }
+    if (dictionary) {
+        tablr_series_free(buffer->dictionary);
+        buffer->dictionary = dictionary;
+    }
+    buffer->size = size;
+    series->size = size;
+    tablr_series_stats_clear(series);
+    return true;
+}
+
+/**
+ * @brief Drop the rows appended after the first size rows of a series
+ * 
+ * @param series Series appended to
+ * @param size Number of rows to keep
+ */
+void tablr_series_unappend(TablrSeries* series, size_t size) {
+    TablrChunks* chunks = series->buffer->chunks;
+    if (!chunks || size >= series->size) return;
     
+    size_t begin;
+    while (tablr_chunks_count(chunks) > 1 &&
+           (tablr_chunks_get(chunks, tablr_chunks_count(chunks) - 1, &begin), begin >= series->offset + size)) {
+        tablr_chunks_pop(chunks);
+    }
+    series->buffer->size = tablr_chunks_rows(chunks);
+    series->size = size;
+    tablr_series_stats_clear(series);
+}
+
+/**
+ * @brief Copy a chunked series into one contiguous buffer
+ * 
+ * @param series Series to compact
+ * @return true on success, false on failure (series unchanged)
+ */
+bool tablr_series_rechunk(TablrSeries* series) {
+    if (!series) return false;
+    return !series->buffer->chunks || series_unshare(series);
+}
+
+/**
+ * @brief Get the cached statistics of a series
+ * 
+ * @param series Series to query
+ * @param stats Output statistics
+ * @return true if statistics were cached, false otherwise
+ */
+bool tablr_series_stats_load(const TablrSeries* series, TablrSeriesStats* stats) {
+#ifdef _WIN32
+    bool ready = InterlockedCompareExchange((volatile LONG*)&series->stats_state, 0, 0) == STATS_READY;
+#else
+    bool ready = atomic_load(&((TablrSeries*)series)->stats_state) == STATS_READY;
+#endif
+    if (ready) *stats = series->stats;
+    return ready;
+}
+
+/**
+ * @brief Cache statistics on a series
+ * 
+ * The cache is logically part of a const series, so this writes through a
+ * cast. Only the thread that moves the state from empty to writing stores.
+ * 
+ * @param series Series to modify
+ * @param stats Statistics of the series
+ */
+void tablr_series_stats_save(const TablrSeries* series, const TablrSeriesStats* stats) {
+    TablrSeries* s = (TablrSeries*)series;
+#ifdef _WIN32
+    if (InterlockedCompareExchange(&s->stats_state, STATS_WRITING, STATS_EMPTY) != STATS_EMPTY) return;
+    s->stats = *stats;
+    InterlockedExchange(&s->stats_state, STATS_READY);
+#else
+    int expected = STATS_EMPTY;
+    if (!atomic_compare_exchange_strong(&s->stats_state, &expected, STATS_WRITING)) return;
+    s->stats = *stats;
+    atomic_store(&s->stats_state, STATS_READY);
+#endif
+}
+
+/**
+ * @brief Drop the cached statistics of a series
+ * 
+ * @param series Series to modify
+ */
+void tablr_series_stats_clear(TablrSeries* series) {
+#ifdef _WIN32
+    InterlockedExchange(&series->stats_state, STATS_EMPTY);
+#else
+    atomic_store(&series->stats_state, STATS_EMPTY);
+#endif
+}
+
+/**
+ * @brief Give a new view over all of a series the source's statistics
+ */
+static void inherit_stats(TablrSeries* view, const TablrSeries* source) {
+    TablrSeriesStats stats;
+    if (tablr_series_stats_load(source, &stats)) tablr_series_stats_save(view, &stats);
+}
+
+/**
+ * @brief Take an extra reference to a series' data
+ * 
+ * Adds an owner to the buffer behind the series. The buffer stays alive
+ * until the series, its slices and every shared reference are released.
+ * 
+ * @param series Series whose data to share
+ * @param release Output function to call once the reference is dropped
+ * @param ctx Output context for release
+ * @return true on success, false on failure
+ */
+bool tablr_series_share_data(TablrSeries* series, TablrReleaseFunc* release, void** ctx) {
+    if (!series || !release || !ctx) return false;
+    
+    buffer_retain(series->buffer);
+    *release = buffer_release;
+    *ctx = series->buffer;
+    return true;
+}
+
+/**
+ * @brief Create a view of part of a series
+ * 
+ * The view shares the source's buffer, so this takes O(1) time and memory
+ * regardless of length. The source may be freed before the view. Bitmask
+ * slices that do not start on a word boundary are the exception: they are
+ * copied, one shifted word per 64 elements, to keep bitmask series aligned.
+ * 
+ * @param series Source series
+ * @param offset Index of the first element
+ * @param length Number of elements
+ * @return New series, or NULL if the range is empty or out of bounds
+ */
+TablrSeries* tablr_series_slice(const TablrSeries* series, size_t offset, size_t length) {
+    if (!series || length == 0 || offset > series->size || length > series->size - offset) return NULL;
+    
+    buffer_retain(series->buffer);
+    TablrSeries* s = series_new(series->buffer, series->offset + offset, length,
+                                series->dtype, series->device);
+    if (!s) {
+        buffer_release(series->buffer);
+        return NULL;
+    }
+    s->unit = series->unit;
+    if (s->dtype == TABLR_BITMASK && s->offset % 64 && !series_unshare(s)) {
+        tablr_series_free(s);
+        return NULL;
+    }
+    if (length == series->size) inherit_stats(s, series);
     return s;
 }
 
 /**
  * @brief Create series filled with ones
  * 
- * Allocates a new series and initializes all elements to one.
+ * Lazy for the same types as tablr_series_zeros(); a bitmask has every
+ * bit set.
  * 
  * @param size Number of elements
  * @param dtype Data type of elements
@@ -100,27 +1100,42 @@ TablrSeries* tablr_series_zeros(size_t size, TablrDType dtype, TablrDevice devic
  * @return Pointer to new series, or NULL on failure
  */
 TablrSeries* tablr_series_ones(size_t size, TablrDType dtype, TablrDevice device) {
-    TablrSeries* s = tablr_series_zeros(size, dtype, device);
-    if (!s) return NULL;
+    if (size == 0 || dtype == TABLR_CATEGORICAL) return NULL;
     
-    if (dtype == TABLR_INT32) {
-        int* data = (int*)s->data;
-        for (size_t i = 0; i < size; i++) data[i] = 1;
-    } else if (dtype == TABLR_FLOAT32) {
-        float* data = (float*)s->data;
-        for (size_t i = 0; i < size; i++) data[i] = 1.0f;
-    } else if (dtype == TABLR_FLOAT64) {
-        double* data = (double*)s->data;
-        for (size_t i = 0; i < size; i++) data[i] = 1.0;
+    if (dtype == TABLR_BITMASK) {
+        TablrSeries* s = series_alloc(size, dtype, device);
+        if (!s) return NULL;
+        memset(series_ptr(s), 0xFF, values_bytes(size, dtype));
+        bitmap_clear_tail((uint64_t*)series_ptr(s), size);
+        return s;
     }
+    if (!is_lazy_dtype(dtype)) return tablr_series_zeros(size, dtype, device);
     
-    return s;
+    union {
+        uint8_t u8;
+        uint16_t u16;
+        uint32_t u32;
+        uint64_t u64;
+        float f32;
+        double f64;
+    } one;
+    size_t width = tablr_dtype_size(dtype);
+    if (dtype == TABLR_FLOAT32) one.f32 = 1.0f;
+    else if (dtype == TABLR_FLOAT64) one.f64 = 1.0;
+    else if (width == 1) one.u8 = 1;
+    else if (width == 2) one.u16 = 1;
+    else if (width == 4) one.u32 = 1;
+    else one.u64 = 1;
+    return series_lazy(tablr_encoded_constant(size, dtype, &one), size, dtype, device);
 }
 
 /**
  * @brief Create series with range of values
  * 
- * Creates a series with evenly spaced values from start to stop (exclusive).
+ * Creates a series with evenly spaced values from start to stop
+ * (exclusive). The series is lazy: element i is computed as
+ * start + i * step when read, and stored only when a raw pointer is
+ * requested.
  * 
  * @param start Starting value
  * @param stop Ending value (exclusive)
@@ -132,29 +1147,23 @@ TablrSeries* tablr_series_arange(double start, double stop, double step, TablrDe
     if (step == 0.0 || (stop - start) / step < 0) return NULL;
     
     size_t size = (size_t)((stop - start) / step);
-    TablrSeries* s = tablr_series_zeros(size, TABLR_FLOAT64, device);
-    if (!s) return NULL;
-    
-    double* data = (double*)s->data;
-    for (size_t i = 0; i < size; i++) {
-        data[i] = start + i * step;
-    }
-    
-    return s;
+    return series_lazy(tablr_encoded_range(size, start, step), size, TABLR_FLOAT64, device);
 }
 
 /**
  * @brief Free series memory
  * 
- * Deallocates all memory associated with the series including data and structure.
+ * Drops the series' reference to its buffer. The data is freed with the
+ * last reference, including the characters of a string series; for
+ * series created with tablr_series_external() the release callback is
+ * called instead.
  * 
  * @param series Series to free (can be NULL)
  */
 void tablr_series_free(TablrSeries* series) {
-    if (series) {
-        free(series->data);
-        free(series);
-    }
+    if (!series) return;
+    buffer_release(series->buffer);
+    free(series);
 }
 
 /**
@@ -181,6 +1190,33 @@ TablrDType tablr_series_dtype(const TablrSeries* series) {
     return series ? series->dtype : TABLR_INT32;
 }
 
+/**
+ * @brief Get the time unit of a timestamp series
+ * 
+ * @param series Series to query
+ * @return Unit of the elements; TABLR_TIME_MICROSECOND for other types or NULL
+ */
+TablrTimeUnit tablr_series_time_unit(const TablrSeries* series) {
+    return series && series->dtype == TABLR_TIMESTAMP64 ? series->unit : TABLR_TIME_MICROSECOND;
+}
+
+/**
+ * @brief Set the time unit of a timestamp series
+ * 
+ * Only the interpretation of the stored values changes, not the values.
+ * The unit belongs to this series object, so other views of the same
+ * data keep theirs.
+ * 
+ * @param series Timestamp series
+ * @param unit New unit
+ * @return true on success, false if series is not a timestamp series
+ */
+bool tablr_series_set_time_unit(TablrSeries* series, TablrTimeUnit unit) {
+    if (!series || series->dtype != TABLR_TIMESTAMP64 || (unsigned)unit > TABLR_TIME_NANOSECOND) return false;
+    series->unit = unit;
+    return true;
+}
+
 /**
  * @brief Get series device
  * 
@@ -194,21 +1230,384 @@ TablrDevice tablr_series_device(const TablrSeries* series) {
 }
 
 /**
- * @brief Get pointer to series data
+ * @brief Give a series its own copy of the elements it covers
+ * 
+ * Used before handing out a mutable pointer to a buffer that other series
+ * or shared references can see. Validity bits are copied along.
+ * 
+ * @param series Series to detach from its buffer
+ * @return true on success, false if an allocation failed (series unchanged)
+ */
+static bool series_unshare(TablrSeries* series) {
+    TablrSeries* copy;
+    if (series->buffer->chunks) {
+        /* Copy just this series' rows out of the chunks */
+        copy = tablr_chunks_copy(series->buffer->chunks, series->offset, series->size,
+                                 series->buffer->dictionary, series->device);
+    } else if (series->dtype == TABLR_STRING) {
+        const int64_t* offsets = (const int64_t*)series_ptr(series);
+        size_t base = (size_t)offsets[0];
+        copy = strings_alloc(series->size, (size_t)offsets[series->size] - base, series->device);
+        if (copy) {
+            int64_t* out = (int64_t*)copy->buffer->data;
+            for (size_t i = 0; i <= series->size; i++) out[i] = offsets[i] - (int64_t)base;
+            memcpy(copy->buffer->chars, series->buffer->chars + base, (size_t)out[series->size]);
+        }
+    } else if (series->dtype == TABLR_CATEGORICAL) {
+        copy = categorical_alloc(series->size, series->buffer->dictionary, series->device);
+        if (copy) memcpy(copy->buffer->data, series_ptr(series), series->size * sizeof(int32_t));
+    } else if (series->dtype == TABLR_BITMASK) {
+        /* Read from the buffer directly: a new slice may not start on a word */
+        const uint64_t* bits = (const uint64_t*)series->buffer->data;
+        size_t end = series->offset + series->size;
+        copy = series_alloc(series->size, TABLR_BITMASK, series->device);
+        for (size_t w = 0; copy && w < bitmap_words(series->size); w++) {
+            ((uint64_t*)copy->buffer->data)[w] = bitmap_word(bits, end, series->offset + w * 64);
+        }
+    } else if (series->buffer->encoded) {
+        /* Decode just this series' range rather than the whole buffer */
+        copy = series_alloc(series->size, series->dtype, series->device);
+        if (copy) tablr_encoded_decode(series->buffer->encoded, series->offset, series->size, copy->buffer->data);
+    } else {
+        copy = tablr_series_create(series_ptr(series), series->size, series->dtype, series->device);
+    }
+    if (!copy) return false;
+    
+    const uint64_t* validity = series->buffer->validity;
+    if (validity) {
+        size_t nwords = bitmap_words(series->size);
+        size_t end = series->offset + series->size;
+        copy->buffer->validity = (uint64_t*)malloc(nwords * sizeof(uint64_t));
+        if (!copy->buffer->validity) {
+            tablr_series_free(copy);
+            return false;
+        }
+        for (size_t w = 0; w < nwords; w++) {
+            copy->buffer->validity[w] = bitmap_word(validity, end, series->offset + w * 64);
+        }
+    }
+    
+    buffer_release(series->buffer);
+    series->buffer = copy->buffer;
+    series->offset = 0;
+    free(copy);
+    return true;
+}
+
+/**
+ * @brief Get writable pointer to series data
+ * 
+ * Buffers are copy-on-write: if anything else refers to the series'
+ * buffer, or the series was created with tablr_series_wrap(), the elements
+ * of this series are copied into a private buffer first, so writes never
+ * show through views, copies or shared references. The pointer stays
+ * writable until the series is shared again. Cached statistics are
+ * dropped here, since the caller is about to write; statistics cached
+ * after this call go stale if the caller keeps writing through the pointer.
+ * 
+ * @param series Series to query
+ * @return Pointer to data, or NULL if series is NULL or the copy failed
+ */
+void* tablr_series_data(TablrSeries* series) {
+    if (!series) return NULL;
+    tablr_series_stats_clear(series);
+    if ((series->buffer->readonly || buffer_refs(series->buffer) > 1) && !series_unshare(series)) return NULL;
+    return series_ptr(series);
+}
+
+/**
+ * @brief Get read-only pointer to series data
+ * 
+ * Never copies a plain series, so the pointer may refer to memory shared
+ * with other series. Compressed and lazy series are decoded, and chunked
+ * series flattened, on first use; that copy is cached on the buffer.
+ * 
+ * @param series Series to query
+ * @return Pointer to data, or NULL if series is NULL or decoding failed
+ */
+const void* tablr_series_data_const(const TablrSeries* series) {
+    return series ? series_ptr(series) : NULL;
+}
+
+/**
+ * @brief Get writable offsets and characters of a string series
+ * 
+ * Copy-on-write like tablr_series_data(). Offsets may not start at 0 for a
+ * slice; they index into the returned character buffer directly.
+ * 
+ * @param series String series
+ * @param offsets Output size + 1 offsets
+ * @param chars Output character buffer
+ * @return true on success, false if series is not a string series or the copy failed
+ */
+bool tablr_series_string_buffers(TablrSeries* series, int64_t** offsets, char** chars) {
+    if (!series || series->dtype != TABLR_STRING || !offsets || !chars) return false;
+    tablr_series_stats_clear(series);
+    if ((series->buffer->readonly || buffer_refs(series->buffer) > 1) && !series_unshare(series)) return false;
+    
+    *offsets = (int64_t*)series_ptr(series);
+    *chars = series_chars(series);
+    return true;
+}
+
+/**
+ * @brief Get the offsets of a string series
+ * 
+ * @param series String series
+ * @return size + 1 offsets into tablr_series_string_chars(), or NULL if not
+ *         a string series or a chunked series could not be flattened
+ */
+const int64_t* tablr_series_string_offsets(const TablrSeries* series) {
+    if (!series || series->dtype != TABLR_STRING) return NULL;
+    return (const int64_t*)series_ptr(series);
+}
+
+/**
+ * @brief Get the character buffer of a string series
+ * 
+ * @param series String series
+ * @return Characters of all elements back to back, or NULL if not a string
+ *         series or a chunked series could not be flattened
+ */
+const char* tablr_series_string_chars(const TablrSeries* series) {
+    if (!series || series->dtype != TABLR_STRING) return NULL;
+    return series_chars(series);
+}
+
+/**
+ * @brief Get one element of a string series
+ * 
+ * The characters are not NUL-terminated.
+ * 
+ * @param series String series
+ * @param index Element index
+ * @param length Output length in bytes
+ * @return Pointer to the first character, or NULL if out of range, not a
+ *         string series or a chunked series could not be flattened
+ */
+const char* tablr_series_string_at(const TablrSeries* series, size_t index, size_t* length) {
+    if (!series || series->dtype != TABLR_STRING || index >= series->size) return NULL;
+    
+    const int64_t* offsets = (const int64_t*)series_ptr(series);
+    const char* chars = series_chars(series);
+    if (!offsets || !chars) return NULL;
+    if (length) *length = (size_t)(offsets[index + 1] - offsets[index]);
+    return chars + offsets[index];
+}
+
+/**
+ * @brief Count null elements
+ * 
+ * Counts the cleared bits of the validity bitmap a word at a time.
+ * 
+ * @param series Series to query
+ * @return Number of null elements, 0 if the series has no bitmap or is NULL
+ */
+size_t tablr_series_null_count(const TablrSeries* series) {
+    if (!series || !series->buffer->validity) return 0;
+    
+    TablrSeriesStats stats;
+    if (tablr_series_stats_load(series, &stats)) return stats.null_count;
+    
+    size_t valid = 0;
+    size_t nwords = bitmap_words(series->size);
+    for (size_t w = 0; w < nwords; w++) {
+        valid += popcount64(tablr_series_validity_word(series, w));
+    }
+    return series->size - valid;
+}
+
+/**
+ * @brief Check whether an element is valid (not null)
+ * 
+ * @param series Series to query
+ * @param index Element index
+ * @return true if the element is valid, false if it is null or out of range
+ */
+bool tablr_series_is_valid(const TablrSeries* series, size_t index) {
+    if (!series || index >= series->size) return false;
+    
+    const uint64_t* validity = series->buffer->validity;
+    size_t bit = series->offset + index;
+    return !validity || ((validity[bit / 64] >> (bit % 64)) & 1);
+}
+
+/**
+ * @brief Get a series' validity bitmap for writing
+ * 
+ * Clears cached statistics, copies a shared or chunked buffer first and
+ * creates an all-valid bitmap if there is none.
+ * 
+ * @return Bitmap indexed by buffer element, or NULL on failure
+ */
+static uint64_t* writable_validity(TablrSeries* series) {
+    tablr_series_stats_clear(series);
+    if ((series->buffer->chunks || buffer_refs(series->buffer) > 1) && !series_unshare(series)) return NULL;
+    
+    TablrBuffer* buffer = series->buffer;
+    if (!buffer->validity) {
+        size_t nwords = bitmap_words(buffer->size);
+        buffer->validity = (uint64_t*)malloc(nwords * sizeof(uint64_t));
+        if (!buffer->validity) return NULL;
+        memset(buffer->validity, 0xFF, nwords * sizeof(uint64_t));
+    }
+    return buffer->validity;
+}
+
+/**
+ * @brief Mark an element as valid or null
+ * 
+ * The bitmap is created, all valid, the first time an element is marked
+ * null. Like tablr_series_data(), this copies the series first if its
+ * buffer is shared or chunked. The element's value is left as it is.
+ * 
+ * @param series Series to modify
+ * @param index Element index
+ * @param valid Whether the element is valid
+ * @return true on success, false if index is out of range or a copy failed
+ */
+bool tablr_series_set_valid(TablrSeries* series, size_t index, bool valid) {
+    if (!series || index >= series->size) return false;
+    if (valid && !series->buffer->validity) return true;
+    
+    uint64_t* validity = writable_validity(series);
+    if (!validity) return false;
+    size_t bit = series->offset + index;
+    uint64_t mask = (uint64_t)1 << (bit % 64);
+    if (valid) validity[bit / 64] |= mask;
+    else validity[bit / 64] &= ~mask;
+    return true;
+}
+
+/**
+ * @brief Read up to 64 bits of a byte-ordered bitmap starting at any bit
+ *
+ * Reads only the bytes holding bits start to start + n - 1, so a bitmap
+ * may end on any byte.
+ */
+static uint64_t bitmap_bytes_word(const uint8_t* bytes, size_t start, size_t n) {
+    const uint8_t* p = bytes + start / 8;
+    unsigned shift = (unsigned)(start % 8);
+    size_t nbytes = (shift + n + 7) / 8;
+    uint64_t word = 0;
+    for (size_t i = 0; i < nbytes && i < 8; i++) word |= (uint64_t)p[i] << (8 * i);
+    word >>= shift;
+    if (nbytes > 8) word |= (uint64_t)p[8] << (64 - shift);
+    return n < 64 ? word & (((uint64_t)1 << n) - 1) : word;
+}
+
+/**
+ * @brief Set the validity of a run of elements from a bitmap
+ * 
+ * Writes 64 elements per step instead of one bit per call.
+ * 
+ * @param series Series to modify
+ * @param index First element to set
+ * @param bits Validity bitmap, or NULL to mark the elements valid
+ * @param bit_offset Bit of bits that holds element index
+ * @param count Number of elements
+ * @return true on success, false if out of range or a copy failed
+ */
+bool tablr_series_set_validity(TablrSeries* series, size_t index, const uint8_t* bits, size_t bit_offset,
+                               size_t count) {
+    if (!series || index > series->size || count > series->size - index) return false;
+    if (count == 0 || (!bits && !series->buffer->validity)) return true;
+    
+    uint64_t* validity = writable_validity(series);
+    if (!validity) return false;
+    size_t start = series->offset + index;
+    for (size_t i = 0; i < count; i += 64) {
+        size_t n = count - i < 64 ? count - i : 64;
+        uint64_t mask = n < 64 ? ((uint64_t)1 << n) - 1 : ~(uint64_t)0;
+        uint64_t word = bits ? bitmap_bytes_word(bits, bit_offset + i, n) : mask;
+        
+        /* The 64 bits may straddle two words of the series' bitmap */
+        size_t bit = start + i;
+        unsigned shift = (unsigned)(bit % 64);
+        uint64_t* dst = &validity[bit / 64];
+        dst[0] = (dst[0] & ~(mask << shift)) | (word << shift);
+        if (shift && n > 64 - shift) {
+            dst[1] = (dst[1] & ~(mask >> (64 - shift))) | (word >> (64 - shift));
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Mark the null elements of src null in dst
+ *
+ * @param src Series whose nulls are copied
+ * @param dst Series to modify, at least as long as src
+ * @return true on success, false if dst is too short or a copy failed
+ */
+bool tablr_series_copy_nulls(const TablrSeries* src, TablrSeries* dst) {
+    if (!src || !dst || src->size > dst->size) return false;
+    if (tablr_series_null_count(src) == 0) return true;
+    
+    uint64_t* validity = writable_validity(dst);
+    if (!validity) return false;
+    for (size_t w = 0; w < bitmap_words(src->size); w++) {
+        size_t n = src->size - w * 64 < 64 ? src->size - w * 64 : 64;
+        uint64_t mask = n < 64 ? ((uint64_t)1 << n) - 1 : ~(uint64_t)0;
+        uint64_t nulls = ~tablr_series_validity_word(src, w) & mask;
+        if (!nulls) continue;
+        
+        size_t bit = dst->offset + w * 64;
+        unsigned shift = (unsigned)(bit % 64);
+        validity[bit / 64] &= ~(nulls << shift);
+        if (shift && n > 64 - shift) validity[bit / 64 + 1] &= ~(nulls >> (64 - shift));
+    }
+    return true;
+}
+
+/**
+ * @brief Get the validity bits of 64 consecutive elements
  * 
- * Returns a pointer to the underlying data array. Use with caution.
+ * Bit j of the result is set if element word * 64 + j is valid. Kernels
+ * use this to test 64 rows at once and skip per-row null checks for blocks
+ * that are all ones.
+ * 
+ * @param series Series to query
+ * @param word Block index
+ * @return Validity bits; bits past the end of the series are 0
+ */
+uint64_t tablr_series_validity_word(const TablrSeries* series, size_t word) {
+    if (!series || word >= bitmap_words(series->size)) return 0;
+    
+    size_t start = word * 64;
+    if (series->buffer->validity) {
+        return bitmap_word(series->buffer->validity, series->offset + series->size, series->offset + start);
+    }
+    size_t n = series->size - start;
+    return n >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << n) - 1;
+}
+
+/**
+ * @brief Get the bytes held by the buffer behind a series
  * 
  * @param series Series to query
- * @return Pointer to data, or NULL if series is NULL
+ * @return Size in bytes; 0 for NULL
  */
-void* tablr_series_data(const TablrSeries* series) {
-    return series ? series->data : NULL;
+size_t tablr_series_memory_usage(const TablrSeries* series) {
+    if (!series) return 0;
+    
+    const TablrBuffer* buffer = series->buffer;
+    size_t bytes;
+    if (buffer->encoded) bytes = tablr_encoded_bytes(buffer->encoded);
+    else if (buffer->chunks) bytes = tablr_chunks_bytes(buffer->chunks);
+    else if (buffer->dtype == TABLR_STRING) bytes = (buffer->size + 1) * sizeof(int64_t) + buffer->chars_bytes;
+    else bytes = values_bytes(buffer->size, buffer->dtype);
+    if (buffer->validity) {
+        bytes += (buffer->validity_words ? buffer->validity_words : bitmap_words(buffer->size)) * sizeof(uint64_t);
+    }
+    return bytes;
 }
 
 /**
  * @brief Transfer series to different device
  * 
- * Creates a copy of the series on the specified device.
+ * Returns a view of the same buffer tagged with the specified device; no
+ * data is copied.
  * 
  * @param series Source series
  * @param device Target device
@@ -216,7 +1615,16 @@ void* tablr_series_data(const TablrSeries* series) {
  */
 TablrSeries* tablr_series_to_device(const TablrSeries* series, TablrDevice device) {
     if (!series) return NULL;
-    return tablr_series_create(series->data, series->size, series->dtype, device);
+    
+    buffer_retain(series->buffer);
+    TablrSeries* s = series_new(series->buffer, series->offset, series->size, series->dtype, device);
+    if (!s) {
+        buffer_release(series->buffer);
+        return NULL;
+    }
+    s->unit = series->unit;
+    inherit_stats(s, series);
+    return s;
 }
 
 /**
@@ -229,18 +1637,34 @@ TablrSeries* tablr_series_to_device(const TablrSeries* series, TablrDevice devic
 void tablr_series_print(const TablrSeries* series) {
     if (!series) return;
     
+    const void* data = series_ptr(series);
     printf("Series(size=%zu, dtype=%s, device=%d)\n[", 
            series->size, tablr_dtype_name(series->dtype), series->device);
     
     size_t print_max = series->size < 10 ? series->size : 10;
     
     for (size_t i = 0; i < print_max; i++) {
-        if (series->dtype == TABLR_INT32) {
-            printf("%d", ((int*)series->data)[i]);
+        if (tablr_dtype_is_integer(series->dtype)) {
+            char text[TABLR_FORMAT_BUFFER_SIZE];
+            tablr_series_integer_text(series, i, text);
+            printf("%s", text);
         } else if (series->dtype == TABLR_FLOAT32) {
-            printf("%.2f", ((float*)series->data)[i]);
+            printf("%.2f", ((const float*)data)[i]);
         } else if (series->dtype == TABLR_FLOAT64) {
-            printf("%.2f", ((double*)series->data)[i]);
+            printf("%.2f", ((const double*)data)[i]);
+        } else if (series->dtype == TABLR_BOOL) {
+            printf("%s", ((const bool*)data)[i] ? "true" : "false");
+        } else if (series->dtype == TABLR_BITMASK) {
+            printf("%s", (((const uint64_t*)data)[i / 64] >> (i % 64)) & 1 ? "true" : "false");
+        } else if (series->dtype == TABLR_STRING) {
+            size_t len = 0;
+            const char* str = tablr_series_string_at(series, i, &len);
+            printf("\"%.*s\"", (int)len, str);
+        } else if (series->dtype == TABLR_CATEGORICAL) {
+            size_t len = 0;
+            const char* str = tablr_series_category_at(series, i, &len);
+            if (str) printf("\"%.*s\"", (int)len, str);
+            else printf("null");
         }
         if (i < print_max - 1) printf(", ");
     }
@@ -249,6 +1673,34 @@ void tablr_series_print(const TablrSeries* series) {
     printf("]\n");
 }
 
+/**
+ * @brief Format one element of an integer, date or timestamp series
+ * 
+ * @param series Series with an integer dtype
+ * @param index Element index
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_series_integer_text(const TablrSeries* series, size_t index, char* buf) {
+    const void* data = series_ptr(series);
+    switch (series->dtype) {
+        case TABLR_INT8: return tablr_format_int64(((const int8_t*)data)[index], buf);
+        case TABLR_INT16: return tablr_format_int64(((const int16_t*)data)[index], buf);
+        case TABLR_INT32: return tablr_format_int64(((const int32_t*)data)[index], buf);
+        case TABLR_INT64: return tablr_format_int64(((const int64_t*)data)[index], buf);
+        case TABLR_UINT8: return tablr_format_uint64(((const uint8_t*)data)[index], buf);
+        case TABLR_UINT16: return tablr_format_uint64(((const uint16_t*)data)[index], buf);
+        case TABLR_UINT32: return tablr_format_uint64(((const uint32_t*)data)[index], buf);
+        case TABLR_UINT64: return tablr_format_uint64(((const uint64_t*)data)[index], buf);
+        case TABLR_DATE32: return tablr_format_date32(((const int32_t*)data)[index], buf);
+        case TABLR_TIMESTAMP64:
+            return tablr_format_timestamp(((const int64_t*)data)[index], series->unit, buf);
+        default:
+            buf[0] = '\0';
+            return 0;
+    }
+}
+
 /**
  * @brief Create series from array data using default device
  * 
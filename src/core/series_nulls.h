@@ -0,0 +1,29 @@
+/**
+ * @file series_nulls.h
+ * @brief Copying null rows between series
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Not part of the public API. Used by the core operations that build a
+ * new series from an existing one and must keep its nulls.
+ */
+
+#ifndef TABLR_CORE_SERIES_NULLS_H
+#define TABLR_CORE_SERIES_NULLS_H
+
+#include "tablr/core/series.h"
+
+/**
+ * @brief Mark the null elements of src null in dst
+ *
+ * src is checked for nulls once; if it has any, its validity is ANDed
+ * into dst a word at a time. Elements of dst past the end of src are left
+ * as they are.
+ *
+ * @param src Series whose nulls are copied
+ * @param dst Series to modify, at least as long as src
+ * @return true on success, false if dst is too short or a copy failed
+ */
+bool tablr_series_copy_nulls(const TablrSeries* src, TablrSeries* dst);
+
+#endif /* TABLR_CORE_SERIES_NULLS_H */
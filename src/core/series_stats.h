@@ -0,0 +1,35 @@
+/**
+ * @file series_stats.h
+ * @brief Statistics cache kept on each series
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Not part of the public API. series.c stores the statistics computed by
+ * stats.c on each series and drops them when the series is written.
+ */
+
+#ifndef TABLR_CORE_SERIES_STATS_H
+#define TABLR_CORE_SERIES_STATS_H
+
+#include "tablr/core/stats.h"
+
+/**
+ * @brief Get the cached statistics of a series
+ * @return true if statistics were cached, false otherwise
+ */
+bool tablr_series_stats_load(const TablrSeries* series, TablrSeriesStats* stats);
+
+/**
+ * @brief Cache statistics on a series
+ *
+ * Safe to call from several threads; if another thread is storing at the
+ * same time, this call does nothing.
+ */
+void tablr_series_stats_save(const TablrSeries* series, const TablrSeriesStats* stats);
+
+/**
+ * @brief Drop the cached statistics of a series
+ */
+void tablr_series_stats_clear(TablrSeries* series);
+
+#endif /* TABLR_CORE_SERIES_STATS_H */
@@ -0,0 +1,29 @@
+/**
+ * @file series_text.h
+ * @brief Text of integer, date and timestamp elements for printing
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Not part of the public API.
+ */
+
+#ifndef TABLR_CORE_SERIES_TEXT_H
+#define TABLR_CORE_SERIES_TEXT_H
+
+#include "tablr/core/series.h"
+#include "tablr/io/format.h"
+
+/**
+ * @brief Format one element of a series whose dtype is an integer type
+ *
+ * Integers are written in decimal, dates as YYYY-MM-DD and timestamps in
+ * ISO-8601 at the series' time unit.
+ *
+ * @param series Series with tablr_dtype_is_integer(dtype)
+ * @param index Element index
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_series_integer_text(const TablrSeries* series, size_t index, char* buf);
+
+#endif /* TABLR_CORE_SERIES_TEXT_H */
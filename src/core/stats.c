@@ -0,0 +1,380 @@
+/**
+ * @file stats.c
+ * @brief Implementation of cached per-series statistics
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * One pass over a series finds its bounds, null count and sort order, and
+ * counts distinct values: exactly, in a small hash set, up to
+ * STATS_EXACT of them, and beyond that with a HyperLogLog sketch of 1024
+ * one-byte registers. The result is cached on the series by
+ * series.c until the series is written.
+ */
+
+#include "tablr/core/stats.h"
+#include "tablr/core/encoding.h"
+#include "tablr/core/chunked.h"
+#include "series_stats.h"
+#include <math.h>
+#include <string.h>
+
+#define STATS_BLOCK_ROWS 1024    /**< Rows of a compressed series decoded per step */
+#define STATS_REGISTER_BITS 10   /**< Hash bits that pick a sketch register */
+#define STATS_REGISTERS (1 << STATS_REGISTER_BITS)
+#define STATS_EXACT 256          /**< Distinct values counted exactly */
+
+/**
+ * @brief State of one statistics pass
+ */
+typedef struct {
+    TablrSeriesStats st;                 /**< Statistics so far */
+    uint8_t registers[STATS_REGISTERS];  /**< HyperLogLog registers */
+    uint64_t exact[STATS_EXACT * 2];     /**< Open-addressing set of hashes seen; 0 is empty */
+    size_t nexact;                       /**< Hashes in exact; over STATS_EXACT once it gave up */
+    size_t valid;                        /**< Number of valid elements seen */
+    bool null_seen;                      /**< A null element has been seen */
+    unsigned char prev[8];               /**< Last valid value, in the element type */
+} Scan;
+
+/**
+ * @brief Scramble a 64-bit value for use as a hash (splitmix64 finalizer)
+ */
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Hash a string eight bytes at a time
+ */
+static uint64_t hash_bytes(const char* p, size_t len) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ len;
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+        p += 8;
+        len -= 8;
+    }
+    uint64_t tail = 0;
+    if (len > 0) memcpy(&tail, p, len);
+    return mix64(h ^ tail);
+}
+
+static uint64_t int_key(int64_t v) {
+    return mix64((uint64_t)v);
+}
+
+static uint64_t uint_key(uint64_t v) {
+    return mix64(v);
+}
+
+/**
+ * @brief Hash of a float, with -0.0 equal to 0.0
+ */
+static uint64_t float_key(double d) {
+    if (d == 0.0) d = 0.0;
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return mix64(bits);
+}
+
+static bool never_nan(double v) {
+    (void)v;
+    return false;
+}
+
+/**
+ * @brief Add a hashed value to the distinct counts
+ *
+ * The top bits pick a sketch register, which keeps the longest run of
+ * leading zeros seen in the remaining bits. Until it overflows, the exact
+ * set also records the hash.
+ */
+static void distinct_add(Scan* sc, uint64_t hash) {
+    size_t r = (size_t)(hash >> (64 - STATS_REGISTER_BITS));
+    uint64_t rest = (hash << STATS_REGISTER_BITS) | ((uint64_t)1 << (STATS_REGISTER_BITS - 1));
+    uint8_t rank = 1;
+    for (; !(rest >> 63); rest <<= 1) rank++;
+    if (rank > sc->registers[r]) sc->registers[r] = rank;
+
+    if (sc->nexact > STATS_EXACT) return;
+    uint64_t h = hash | 1;
+    size_t slot = (size_t)h & (STATS_EXACT * 2 - 1);
+    while (sc->exact[slot] && sc->exact[slot] != h) slot = (slot + 1) & (STATS_EXACT * 2 - 1);
+    if (!sc->exact[slot]) {
+        sc->exact[slot] = h;
+        sc->nexact++;
+    }
+}
+
+/**
+ * @brief Estimate the number of distinct values
+ *
+ * Exact up to STATS_EXACT values. Beyond that, counts that leave sketch
+ * registers empty use linear counting, and larger ones the HyperLogLog
+ * harmonic mean.
+ */
+static size_t distinct_estimate(const Scan* sc) {
+    if (sc->nexact <= STATS_EXACT) return sc->nexact;
+
+    double m = (double)STATS_REGISTERS;
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (size_t r = 0; r < STATS_REGISTERS; r++) {
+        sum += ldexp(1.0, -(int)sc->registers[r]);
+        if (sc->registers[r] == 0) zeros++;
+    }
+    double estimate = 0.7213 / (1.0 + 1.079 / m) * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) estimate = m * log(m / (double)zeros);
+
+    size_t distinct = (size_t)(estimate + 0.5);
+    if (distinct == 0) distinct = 1;
+    return distinct < sc->valid ? distinct : sc->valid;
+}
+
+/**
+ * @brief Record a valid element that compares cmp against the previous one
+ *
+ * A valid element after a null means the nulls are not all last.
+ */
+static void order_add(Scan* sc, int cmp) {
+    if (sc->null_seen) sc->st.sorted = sc->st.reverse_sorted = false;
+    if (sc->valid > 0 && cmp < 0) sc->st.sorted = false;
+    if (sc->valid > 0 && cmp > 0) sc->st.reverse_sorted = false;
+    sc->valid++;
+}
+
+/**
+ * @brief Define a statistics pass for one numeric element type
+ *
+ * values holds rows first to first + count - 1, where first is a multiple
+ * of 64. The previous value is carried between calls in the scan state, so
+ * a compressed series can be fed one decoded block at a time.
+ */
+#define SCAN_KERNEL(name, ctype, key, is_nan)                                         \
+    static void name(const TablrSeries* s, const void* values, size_t first, size_t count, \
+                     Scan* sc) {                                                      \
+        const ctype* data = (const ctype*)values;                                     \
+        ctype prev;                                                                   \
+        memcpy(&prev, sc->prev, sizeof(prev));                                        \
+        uint64_t bits = 0;                                                            \
+        for (size_t i = 0; i < count; i++) {                                          \
+            if (i % 64 == 0) bits = tablr_series_validity_word(s, (first + i) / 64);  \
+            if (!((bits >> (i % 64)) & 1)) {                                          \
+                sc->null_seen = true;                                                 \
+                continue;                                                             \
+            }                                                                         \
+            ctype v = data[i];                                                        \
+            if (is_nan(v)) {                                                          \
+                sc->st.sorted = sc->st.reverse_sorted = false;                        \
+                sc->valid++;                                                          \
+                distinct_add(sc, mix64(0x7FF8000000000000ull));                       \
+                continue;                                                             \
+            }                                                                         \
+            order_add(sc, (v > prev) - (v < prev));                                   \
+            if ((double)v < sc->st.min) sc->st.min = (double)v;                       \
+            if ((double)v > sc->st.max) sc->st.max = (double)v;                       \
+            distinct_add(sc, key(v));                                                 \
+            prev = v;                                                                 \
+        }                                                                             \
+        memcpy(sc->prev, &prev, sizeof(prev));                                        \
+    }
+
+SCAN_KERNEL(scan_int8, int8_t, int_key, never_nan)
+SCAN_KERNEL(scan_int16, int16_t, int_key, never_nan)
+SCAN_KERNEL(scan_int32, int32_t, int_key, never_nan)
+SCAN_KERNEL(scan_int64, int64_t, int_key, never_nan)
+SCAN_KERNEL(scan_uint8, uint8_t, uint_key, never_nan)
+SCAN_KERNEL(scan_uint16, uint16_t, uint_key, never_nan)
+SCAN_KERNEL(scan_uint32, uint32_t, uint_key, never_nan)
+SCAN_KERNEL(scan_uint64, uint64_t, uint_key, never_nan)
+SCAN_KERNEL(scan_float32, float, float_key, isnan)
+SCAN_KERNEL(scan_float64, double, float_key, isnan)
+SCAN_KERNEL(scan_bool, bool, uint_key, never_nan)
+
+/**
+ * @brief Scan rows first to first + count - 1 of a fixed-width series
+ */
+static void scan_values(const TablrSeries* s, const void* values, size_t first, size_t count, Scan* sc) {
+    switch (tablr_series_dtype(s)) {
+        case TABLR_INT8: scan_int8(s, values, first, count, sc); break;
+        case TABLR_INT16: scan_int16(s, values, first, count, sc); break;
+        case TABLR_INT32:
+        case TABLR_DATE32: scan_int32(s, values, first, count, sc); break;
+        case TABLR_INT64:
+        case TABLR_TIMESTAMP64: scan_int64(s, values, first, count, sc); break;
+        case TABLR_UINT8: scan_uint8(s, values, first, count, sc); break;
+        case TABLR_UINT16: scan_uint16(s, values, first, count, sc); break;
+        case TABLR_UINT32: scan_uint32(s, values, first, count, sc); break;
+        case TABLR_UINT64: scan_uint64(s, values, first, count, sc); break;
+        case TABLR_FLOAT32: scan_float32(s, values, first, count, sc); break;
+        case TABLR_FLOAT64: scan_float64(s, values, first, count, sc); break;
+        case TABLR_BOOL: scan_bool(s, values, first, count, sc); break;
+        default: break;
+    }
+}
+
+/**
+ * @brief Scan a bitmask series
+ */
+static void scan_bits(const TablrSeries* s, Scan* sc) {
+    const uint64_t* words = (const uint64_t*)tablr_series_data_const(s);
+    size_t size = tablr_series_size(s);
+    bool prev = false;
+    for (size_t i = 0; i < size; i++) {
+        if (!tablr_series_is_valid(s, i)) {
+            sc->null_seen = true;
+            continue;
+        }
+        bool v = (words[i / 64] >> (i % 64)) & 1;
+        order_add(sc, (int)v - (int)prev);
+        double d = v ? 1.0 : 0.0;
+        if (d < sc->st.min) sc->st.min = d;
+        if (d > sc->st.max) sc->st.max = d;
+        distinct_add(sc, uint_key(v));
+        prev = v;
+    }
+}
+
+/**
+ * @brief Order two strings by their bytes, shorter prefixes first
+ */
+static int compare_bytes(const char* a, size_t alen, const char* b, size_t blen) {
+    int cmp = memcmp(a, b, alen < blen ? alen : blen);
+    if (cmp != 0) return (cmp > 0) - (cmp < 0);
+    return (alen > blen) - (alen < blen);
+}
+
+/**
+ * @brief Scan a string series
+ */
+static void scan_strings(const TablrSeries* s, Scan* sc) {
+    size_t size = tablr_series_size(s);
+    const char* prev = NULL;
+    size_t prev_len = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (!tablr_series_is_valid(s, i)) {
+            sc->null_seen = true;
+            continue;
+        }
+        size_t len;
+        const char* chars = tablr_series_string_at(s, i, &len);
+        order_add(sc, prev ? compare_bytes(chars, len, prev, prev_len) : 0);
+        distinct_add(sc, hash_bytes(chars, len));
+        prev = chars;
+        prev_len = len;
+    }
+}
+
+/**
+ * @brief Scan a categorical series
+ *
+ * Categories are compared only where the code changes. At most every
+ * category is distinct.
+ */
+static void scan_categories(const TablrSeries* s, Scan* sc) {
+    const TablrSeries* categories = tablr_series_categories(s);
+    const int32_t* codes = (const int32_t*)tablr_series_data_const(s);
+    size_t size = tablr_series_size(s);
+    int32_t prev = -1;
+    for (size_t i = 0; i < size; i++) {
+        if (!tablr_series_is_valid(s, i)) {
+            sc->null_seen = true;
+            continue;
+        }
+        int cmp = 0;
+        if (prev >= 0 && codes[i] != prev) {
+            size_t alen, blen;
+            const char* a = tablr_series_string_at(categories, (size_t)codes[i], &alen);
+            const char* b = tablr_series_string_at(categories, (size_t)prev, &blen);
+            cmp = compare_bytes(a, alen, b, blen);
+        }
+        order_add(sc, cmp);
+        distinct_add(sc, uint_key((uint64_t)codes[i]));
+        prev = codes[i];
+    }
+}
+
+/**
+ * @brief Get the statistics of a series, computing them on first use
+ *
+ * Compressed series are decoded a block at a time rather than all at once,
+ * and constant series without nulls are described from their one value.
+ *
+ * @param series Series to describe
+ * @param stats Output statistics
+ * @return true on success, false if series or stats is NULL
+ */
+bool tablr_series_stats(const TablrSeries* series, TablrSeriesStats* stats) {
+    if (!series || !stats) return false;
+    if (tablr_series_stats_load(series, stats)) return true;
+
+    Scan sc;
+    memset(&sc, 0, sizeof(sc));
+    sc.st.min = INFINITY;
+    sc.st.max = -INFINITY;
+    sc.st.sorted = true;
+    sc.st.reverse_sorted = true;
+
+    size_t size = tablr_series_size(series);
+    switch (tablr_series_dtype(series)) {
+        case TABLR_STRING: scan_strings(series, &sc); break;
+        case TABLR_CATEGORICAL: scan_categories(series, &sc); break;
+        case TABLR_BITMASK: scan_bits(series, &sc); break;
+        default:
+            if (tablr_series_null_count(series) == 0 && tablr_series_is_constant(series)) {
+                /* Every element equals the first */
+                uint64_t first;
+                tablr_series_read(series, 0, 1, &first);
+                scan_values(series, &first, 0, 1, &sc);
+                sc.valid = size;
+            } else if (tablr_series_encoding(series) != TABLR_ENCODING_PLAIN ||
+                       tablr_series_num_chunks(series) > 1) {
+                uint64_t block[STATS_BLOCK_ROWS];
+                for (size_t first = 0; first < size; first += STATS_BLOCK_ROWS) {
+                    size_t count = size - first < STATS_BLOCK_ROWS ? size - first : STATS_BLOCK_ROWS;
+                    tablr_series_read(series, first, count, block);
+                    scan_values(series, block, first, count, &sc);
+                }
+            } else {
+                scan_values(series, tablr_series_data_const(series), 0, size, &sc);
+            }
+            break;
+    }
+
+    sc.st.null_count = size - sc.valid;
+    sc.st.distinct = distinct_estimate(&sc);
+    if (tablr_series_dtype(series) == TABLR_CATEGORICAL) {
+        size_t ncategories = tablr_series_size(tablr_series_categories(series));
+        if (sc.st.distinct > ncategories) sc.st.distinct = ncategories;
+    }
+
+    tablr_series_stats_save(series, &sc.st);
+    *stats = sc.st;
+    return true;
+}
+
+/**
+ * @brief Get the statistics of a series only if they are already cached
+ *
+ * @param series Series to describe
+ * @param stats Output statistics
+ * @return true if statistics were cached, false otherwise
+ */
+bool tablr_series_stats_cached(const TablrSeries* series, TablrSeriesStats* stats) {
+    return series && stats && tablr_series_stats_load(series, stats);
+}
+
+/**
+ * @brief Drop the cached statistics of a series
+ *
+ * @param series Series to modify (can be NULL)
+ */
+void tablr_series_invalidate_stats(TablrSeries* series) {
+    if (series) tablr_series_stats_clear(series);
+}
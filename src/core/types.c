@@ -9,27 +9,41 @@
  */
 
 #include "tablr/core/types.h"
+#include <stdint.h>
 
 /**
  * @brief Get size of data type in bytes
  * 
  * Returns the memory size required for a single element of the given data type.
+ * For TABLR_STRING this is the size of one offset into the character buffer,
+ * and for TABLR_CATEGORICAL the size of one code. TABLR_BITMASK elements
+ * take one bit each and have no byte size.
  * 
  * @param dtype Data type to query
- * @return Size in bytes, or 0 for unknown types
+ * @return Size in bytes, or 0 for TABLR_BITMASK and unknown types
  */
 size_t tablr_dtype_size(TablrDType dtype) {
     switch (dtype) {
         case TABLR_INT32:
         case TABLR_FLOAT32:
+        case TABLR_CATEGORICAL:
+        case TABLR_UINT32:
+        case TABLR_DATE32:
             return 4;
         case TABLR_INT64:
         case TABLR_FLOAT64:
+        case TABLR_UINT64:
+        case TABLR_TIMESTAMP64:
             return 8;
+        case TABLR_INT16:
+        case TABLR_UINT16:
+            return 2;
         case TABLR_BOOL:
+        case TABLR_INT8:
+        case TABLR_UINT8:
             return 1;
         case TABLR_STRING:
-            return sizeof(char*);
+            return sizeof(int64_t);
         default:
             return 0;
     }
@@ -51,6 +65,117 @@ const char* tablr_dtype_name(TablrDType dtype) {
         case TABLR_FLOAT64:  return "float64";
         case TABLR_STRING:   return "string";
         case TABLR_BOOL:     return "bool";
+        case TABLR_CATEGORICAL: return "categorical";
+        case TABLR_INT8:     return "int8";
+        case TABLR_INT16:    return "int16";
+        case TABLR_UINT8:    return "uint8";
+        case TABLR_UINT16:   return "uint16";
+        case TABLR_UINT32:   return "uint32";
+        case TABLR_UINT64:   return "uint64";
+        case TABLR_DATE32:   return "date32";
+        case TABLR_TIMESTAMP64: return "timestamp64";
+        case TABLR_BITMASK:  return "bitmask";
         default:             return "unknown";
     }
 }
+
+/**
+ * @brief Check whether a data type stores integers
+ * 
+ * @param dtype Data type to query
+ * @return true for signed and unsigned integers, DATE32 and TIMESTAMP64
+ */
+bool tablr_dtype_is_integer(TablrDType dtype) {
+    switch (dtype) {
+        case TABLR_INT8:
+        case TABLR_INT16:
+        case TABLR_INT32:
+        case TABLR_INT64:
+        case TABLR_UINT8:
+        case TABLR_UINT16:
+        case TABLR_UINT32:
+        case TABLR_UINT64:
+        case TABLR_DATE32:
+        case TABLR_TIMESTAMP64:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Get the number of time units in one second
+ * 
+ * @param unit Time unit to query
+ * @return Units per second, or 1 for unknown units
+ */
+int64_t tablr_time_unit_per_second(TablrTimeUnit unit) {
+    switch (unit) {
+        case TABLR_TIME_MILLISECOND: return 1000;
+        case TABLR_TIME_MICROSECOND: return 1000000;
+        case TABLR_TIME_NANOSECOND:  return 1000000000;
+        default:                     return 1;
+    }
+}
+
+/**
+ * @brief Whether a type is a plain number: integer, float or bool
+ */
+static bool is_number(TablrDType dtype) {
+    return (tablr_dtype_is_integer(dtype) && dtype != TABLR_DATE32 && dtype != TABLR_TIMESTAMP64) ||
+           dtype == TABLR_FLOAT32 || dtype == TABLR_FLOAT64 || dtype == TABLR_BOOL;
+}
+
+/**
+ * @brief Whether an integer type is signed
+ */
+static bool is_signed(TablrDType dtype) {
+    return dtype == TABLR_INT8 || dtype == TABLR_INT16 || dtype == TABLR_INT32 || dtype == TABLR_INT64;
+}
+
+/**
+ * @brief Get the signed integer type of a width in bytes
+ */
+static TablrDType signed_of_size(size_t size) {
+    switch (size) {
+        case 1: return TABLR_INT8;
+        case 2: return TABLR_INT16;
+        case 4: return TABLR_INT32;
+        default: return TABLR_INT64;
+    }
+}
+
+/**
+ * @brief Get the type two numeric types combine to
+ * 
+ * @param a First type
+ * @param b Second type
+ * @param out Output common type
+ * @return true on success, false for non-numeric types
+ */
+bool tablr_dtype_promote(TablrDType a, TablrDType b, TablrDType* out) {
+    if (!out || !is_number(a) || !is_number(b)) return false;
+    if (a == b) {
+        *out = a;
+        return true;
+    }
+    if (a == TABLR_BOOL) a = TABLR_UINT8;
+    if (b == TABLR_BOOL) b = TABLR_UINT8;
+    
+    bool afloat = a == TABLR_FLOAT32 || a == TABLR_FLOAT64;
+    bool bfloat = b == TABLR_FLOAT32 || b == TABLR_FLOAT64;
+    size_t asize = tablr_dtype_size(a), bsize = tablr_dtype_size(b);
+    if (afloat || bfloat) {
+        /* float32 holds every integer of up to 16 bits exactly */
+        bool narrow = (afloat ? bsize : asize) <= 2 || (afloat && bfloat);
+        *out = a == TABLR_FLOAT64 || b == TABLR_FLOAT64 || !narrow ? TABLR_FLOAT64 : TABLR_FLOAT32;
+    } else if (is_signed(a) == is_signed(b)) {
+        *out = asize >= bsize ? a : b;
+    } else {
+        TablrDType s = is_signed(a) ? a : b;
+        size_t ssize = is_signed(a) ? asize : bsize;
+        size_t usize = is_signed(a) ? bsize : asize;
+        *out = ssize > usize ? s : usize < 8 ? signed_of_size(usize * 2) : TABLR_FLOAT64;
+    }
+    return true;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file calendar.h
+ * @brief Proleptic Gregorian calendar arithmetic for date and timestamp text
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Not part of the public API. Conversions between civil dates and days
+ * since 1970-01-01 use Howard Hinnant's branch-free era algorithms, which
+ * are exact over the whole int64 range used here.
+ */
+
+#ifndef TABLR_IO_CALENDAR_H
+#define TABLR_IO_CALENDAR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CALENDAR_SECONDS_PER_DAY 86400  /**< Seconds in a day (no leap seconds) */
+
+/**
+ * @brief Days from 1970-01-01 to year-month-day
+ */
+static inline int64_t calendar_days_from_civil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yoe = (unsigned)(year - era * 400);
+    unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+/**
+ * @brief Civil date of a day count from 1970-01-01
+ */
+static inline void calendar_civil_from_days(int64_t days, int64_t* year, unsigned* month, unsigned* day) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned doe = (unsigned)(days - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    *day = doy - (153 * mp + 2) / 5 + 1;
+    *month = mp < 10 ? mp + 3 : mp - 9;
+    *year = (int64_t)yoe + era * 400 + (*month <= 2);
+}
+
+/**
+ * @brief Number of days in a month
+ */
+static inline unsigned calendar_days_in_month(int64_t year, unsigned month) {
+    static const unsigned days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : days[month - 1];
+}
+
+/**
+ * @brief Floor division, rounding toward negative infinity
+ */
+static inline int64_t calendar_floor_div(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+#endif /* TABLR_IO_CALENDAR_H */
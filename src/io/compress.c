@@ -0,0 +1,299 @@
+/**
+ * @file compress.c
+ * @brief Implementation of the block compression codecs
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * The snappy compressor follows the reference design: input is cut into
+ * 64 KB blocks, four-byte sequences are hashed into a table of recent
+ * positions, and matches are emitted as two-byte or one-byte copies so that
+ * every offset fits in 16 bits. Decompression bounds-checks every element.
+ *
+ * zstd is resolved at runtime with dlopen/LoadLibrary exactly once; only
+ * the four stable one-shot entry points are used.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#endif
+
+#include "compress.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+#define SNAPPY_BLOCK_SIZE 65536        /**< Input bytes per compression block */
+#define SNAPPY_HASH_BITS 14            /**< log2 of the match table size */
+#define SNAPPY_MIN_MATCH 4             /**< Shortest copy worth emitting */
+#define SNAPPY_INPUT_MARGIN 15         /**< Tail bytes always emitted as a literal */
+#define ZSTD_LEVEL 3                   /**< Default zstd compression level */
+
+/* ===================== Snappy ===================== */
+
+static uint32_t load32(const char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t snappy_hash(uint32_t bytes) {
+    return (bytes * 0x1E35A7BDu) >> (32 - SNAPPY_HASH_BITS);
+}
+
+static char* emit_literal(char* op, const char* lit, size_t len) {
+    size_t n = len - 1;
+    if (n < 60) {
+        *op++ = (char)(n << 2);
+    } else {
+        int count = n < (1u << 8) ? 1 : n < (1u << 16) ? 2 : n < (1u << 24) ? 3 : 4;
+        *op++ = (char)((59 + count) << 2);
+        for (int i = 0; i < count; i++) *op++ = (char)(n >> (8 * i));
+    }
+    memcpy(op, lit, len);
+    return op + len;
+}
+
+static char* emit_copy_upto64(char* op, size_t offset, size_t len) {
+    if (len < 12 && offset < 2048) {
+        *op++ = (char)(1 | ((len - 4) << 2) | ((offset >> 8) << 5));
+        *op++ = (char)offset;
+    } else {
+        *op++ = (char)(2 | ((len - 1) << 2));
+        *op++ = (char)offset;
+        *op++ = (char)(offset >> 8);
+    }
+    return op;
+}
+
+static char* emit_copy(char* op, size_t offset, size_t len) {
+    while (len >= 68) {
+        op = emit_copy_upto64(op, offset, 64);
+        len -= 64;
+    }
+    if (len > 64) {
+        op = emit_copy_upto64(op, offset, 60);
+        len -= 60;
+    }
+    return emit_copy_upto64(op, offset, len);
+}
+
+static char* compress_block(const char* src, size_t len, char* op, uint16_t* table) {
+    const char* lit = src;
+    if (len < SNAPPY_INPUT_MARGIN) return len ? emit_literal(op, lit, len) : op;
+
+    memset(table, 0, sizeof(uint16_t) << SNAPPY_HASH_BITS);
+    const char* ip = src + 1;
+    const char* limit = src + len - SNAPPY_INPUT_MARGIN;
+    uint32_t skip = 32;
+
+    while (ip < limit) {
+        uint32_t bytes = load32(ip);
+        uint32_t h = snappy_hash(bytes);
+        const char* cand = src + table[h];
+        table[h] = (uint16_t)(ip - src);
+
+        if (cand >= ip || load32(cand) != bytes) {
+            /* Step faster through incompressible input */
+            ip += skip++ >> 5;
+            continue;
+        }
+        skip = 32;
+
+        if (ip > lit) op = emit_literal(op, lit, (size_t)(ip - lit));
+
+        const char* end = src + len;
+        size_t match = SNAPPY_MIN_MATCH;
+        while (ip + match < end && cand[match] == ip[match]) match++;
+        op = emit_copy(op, (size_t)(ip - cand), match);
+
+        ip += match;
+        lit = ip;
+        if (ip < limit) table[snappy_hash(load32(ip - 1))] = (uint16_t)(ip - 1 - src);
+    }
+
+    if (lit < src + len) op = emit_literal(op, lit, (size_t)(src + len - lit));
+    return op;
+}
+
+size_t tablr_snappy_max_length(size_t len) {
+    return 32 + len + len / 6;
+}
+
+size_t tablr_snappy_compress(const char* src, size_t len, char* dst) {
+    char* op = dst;
+    size_t n = len;
+    while (n >= 0x80) {
+        *op++ = (char)(n | 0x80);
+        n >>= 7;
+    }
+    *op++ = (char)n;
+
+    uint16_t table[1u << SNAPPY_HASH_BITS];
+    for (size_t pos = 0; pos < len; pos += SNAPPY_BLOCK_SIZE) {
+        size_t block = len - pos < SNAPPY_BLOCK_SIZE ? len - pos : SNAPPY_BLOCK_SIZE;
+        op = compress_block(src + pos, block, op, table);
+    }
+    return (size_t)(op - dst);
+}
+
+bool tablr_snappy_uncompress(const char* src, size_t len, char* dst, size_t dst_len) {
+    const uint8_t* ip = (const uint8_t*)src;
+    const uint8_t* end = ip + len;
+
+    uint64_t expected = 0;
+    for (int shift = 0;; shift += 7) {
+        if (ip >= end || shift > 63) return false;
+        uint8_t byte = *ip++;
+        expected |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    if (expected != dst_len) return false;
+
+    size_t out = 0;
+    while (ip < end) {
+        uint8_t tag = *ip++;
+        size_t length;
+        size_t offset;
+
+        if ((tag & 3) == 0) {
+            length = (size_t)(tag >> 2) + 1;
+            if (length > 60) {
+                size_t count = length - 60;
+                if ((size_t)(end - ip) < count) return false;
+                length = 0;
+                for (size_t i = 0; i < count; i++) length |= (size_t)ip[i] << (8 * i);
+                length += 1;
+                ip += count;
+            }
+            if ((size_t)(end - ip) < length || dst_len - out < length) return false;
+            memcpy(dst + out, ip, length);
+            ip += length;
+            out += length;
+            continue;
+        }
+
+        if ((tag & 3) == 1) {
+            if (ip >= end) return false;
+            length = ((tag >> 2) & 7) + 4;
+            offset = ((size_t)(tag >> 5) << 8) | *ip++;
+        } else if ((tag & 3) == 2) {
+            if (end - ip < 2) return false;
+            length = (size_t)(tag >> 2) + 1;
+            offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+            ip += 2;
+        } else {
+            if (end - ip < 4) return false;
+            length = (size_t)(tag >> 2) + 1;
+            offset = (size_t)ip[0] | ((size_t)ip[1] << 8) | ((size_t)ip[2] << 16) | ((size_t)ip[3] << 24);
+            ip += 4;
+        }
+
+        if (offset == 0 || offset > out || dst_len - out < length) return false;
+        if (offset >= length) {
+            memcpy(dst + out, dst + out - offset, length);
+        } else {
+            /* Overlapping copy repeats the last offset bytes */
+            for (size_t i = 0; i < length; i++) dst[out + i] = dst[out - offset + i];
+        }
+        out += length;
+    }
+
+    return out == dst_len;
+}
+
+/* ===================== zstd (runtime loaded) ===================== */
+
+typedef size_t (*ZstdCompressFunc)(void* dst, size_t cap, const void* src, size_t len, int level);
+typedef size_t (*ZstdDecompressFunc)(void* dst, size_t cap, const void* src, size_t len);
+typedef size_t (*ZstdBoundFunc)(size_t len);
+typedef unsigned (*ZstdIsErrorFunc)(size_t code);
+
+/**
+ * @brief Entry points resolved from the zstd library
+ */
+static struct {
+    ZstdCompressFunc compress;
+    ZstdDecompressFunc decompress;
+    ZstdBoundFunc bound;
+    ZstdIsErrorFunc is_error;
+} zstd;
+
+#ifdef _WIN32
+static INIT_ONCE zstd_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK zstd_load(PINIT_ONCE once, PVOID param, PVOID* context) {
+    (void)once;
+    (void)param;
+    (void)context;
+    HMODULE lib = LoadLibraryA("zstd.dll");
+    if (!lib) lib = LoadLibraryA("libzstd.dll");
+    if (!lib) return TRUE;
+    zstd.compress = (ZstdCompressFunc)(void*)GetProcAddress(lib, "ZSTD_compress");
+    zstd.decompress = (ZstdDecompressFunc)(void*)GetProcAddress(lib, "ZSTD_decompress");
+    zstd.bound = (ZstdBoundFunc)(void*)GetProcAddress(lib, "ZSTD_compressBound");
+    zstd.is_error = (ZstdIsErrorFunc)(void*)GetProcAddress(lib, "ZSTD_isError");
+    return TRUE;
+}
+
+static void zstd_init(void) {
+    InitOnceExecuteOnce(&zstd_once, zstd_load, NULL, NULL);
+}
+#else
+static pthread_once_t zstd_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Look up a symbol as a function pointer without a data-to-function cast
+ */
+static void resolve(void* lib, const char* name, void* fn, size_t size) {
+    void* sym = dlsym(lib, name);
+    memcpy(fn, &sym, size);
+}
+
+static void zstd_load(void) {
+    static const char* const names[] = {"libzstd.so.1", "libzstd.so", "libzstd.1.dylib", "libzstd.dylib"};
+    void* lib = NULL;
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]) && !lib; i++) {
+        lib = dlopen(names[i], RTLD_NOW | RTLD_LOCAL);
+    }
+    if (!lib) return;
+    resolve(lib, "ZSTD_compress", &zstd.compress, sizeof(zstd.compress));
+    resolve(lib, "ZSTD_decompress", &zstd.decompress, sizeof(zstd.decompress));
+    resolve(lib, "ZSTD_compressBound", &zstd.bound, sizeof(zstd.bound));
+    resolve(lib, "ZSTD_isError", &zstd.is_error, sizeof(zstd.is_error));
+}
+
+static void zstd_init(void) {
+    pthread_once(&zstd_once, zstd_load);
+}
+#endif
+
+bool tablr_zstd_available(void) {
+    zstd_init();
+    return zstd.compress && zstd.decompress && zstd.bound && zstd.is_error;
+}
+
+size_t tablr_zstd_max_length(size_t len) {
+    return tablr_zstd_available() ? zstd.bound(len) : 0;
+}
+
+bool tablr_zstd_compress(const char* src, size_t len, char* dst, size_t* out_len) {
+    if (!tablr_zstd_available()) return false;
+    size_t n = zstd.compress(dst, zstd.bound(len), src, len, ZSTD_LEVEL);
+    if (zstd.is_error(n)) return false;
+    *out_len = n;
+    return true;
+}
+
+bool tablr_zstd_uncompress(const char* src, size_t len, char* dst, size_t dst_len) {
+    if (!tablr_zstd_available()) return false;
+    size_t n = zstd.decompress(dst, dst_len, src, len);
+    return !zstd.is_error(n) && n == dst_len;
+}
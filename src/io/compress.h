@@ -0,0 +1,78 @@
+/**
+ * @file compress.h
+ * @brief Internal block compression codecs
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Not part of the public API. Used by the Parquet reader and writer for page
+ * compression. Snappy is built in; zstd is loaded from the system zstd
+ * shared library on first use, so Tablr has no build-time dependency on it
+ * and reports zstd as unavailable when the library is missing.
+ */
+
+#ifndef TABLR_IO_COMPRESS_H
+#define TABLR_IO_COMPRESS_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Upper bound on the size of snappy output
+ * @param len Uncompressed size in bytes
+ * @return Bytes the destination of tablr_snappy_compress must hold
+ */
+size_t tablr_snappy_max_length(size_t len);
+
+/**
+ * @brief Compress a block in the raw snappy format
+ * @param src Input bytes
+ * @param len Input size
+ * @param dst Output buffer of at least tablr_snappy_max_length(len) bytes
+ * @return Compressed size in bytes
+ */
+size_t tablr_snappy_compress(const char* src, size_t len, char* dst);
+
+/**
+ * @brief Decompress a raw snappy block of known uncompressed size
+ * @param src Compressed bytes
+ * @param len Compressed size
+ * @param dst Output buffer
+ * @param dst_len Exact expected uncompressed size
+ * @return true on success, false if the input is malformed or the size differs
+ */
+bool tablr_snappy_uncompress(const char* src, size_t len, char* dst, size_t dst_len);
+
+/**
+ * @brief Check whether the zstd library could be loaded
+ * @return true if zstd compression and decompression are available
+ */
+bool tablr_zstd_available(void);
+
+/**
+ * @brief Upper bound on the size of zstd output
+ * @param len Uncompressed size in bytes
+ * @return Bytes the destination of tablr_zstd_compress must hold, 0 if zstd is unavailable
+ */
+size_t tablr_zstd_max_length(size_t len);
+
+/**
+ * @brief Compress a block as one zstd frame
+ * @param src Input bytes
+ * @param len Input size
+ * @param dst Output buffer of at least tablr_zstd_max_length(len) bytes
+ * @param out_len Output compressed size
+ * @return true on success, false on failure or if zstd is unavailable
+ */
+bool tablr_zstd_compress(const char* src, size_t len, char* dst, size_t* out_len);
+
+/**
+ * @brief Decompress zstd frames of known total uncompressed size
+ * @param src Compressed bytes
+ * @param len Compressed size
+ * @param dst Output buffer
+ * @param dst_len Exact expected uncompressed size
+ * @return true on success, false on malformed input, size mismatch or if zstd is unavailable
+ */
+bool tablr_zstd_uncompress(const char* src, size_t len, char* dst, size_t dst_len);
+
+#endif /* TABLR_IO_COMPRESS_H */
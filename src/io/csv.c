@@ -10,27 +10,1648 @@
 
 #define _CRT_SECURE_NO_WARNINGS
 
-#define _CRT_SECURE_NO_WARNINGS
+#ifdef _WIN32
+#define strdup _strdup
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "tablr/io/csv.h"
+#include "tablr/io/parse.h"
+#include "tablr/io/format.h"
+#include "tablr/core/parallel.h"
+#include "tablr/core/allocator.h"
+#include "tablr/core/categorical.h"
+#include "file_map.h"
+#include "csv_tokenizer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+
+#define CSV_MIN_CHUNK_BYTES (1u << 20)  /**< Smallest chunk worth a thread */
+#define CSV_CHUNKS_PER_THREAD 4         /**< Chunks per thread for load balance */
+#define CSV_INITIAL_ROWS 1024           /**< Initial per-chunk row capacity */
+#define CSV_INITIAL_TEXT_BYTES 16384    /**< Initial per-chunk string column capacity */
+#define CSV_DEFAULT_INFER_ROWS 1000     /**< Default rows sampled for inference */
+#define CSV_MIN_SAMPLE_PER_CHUNK 16     /**< Minimum rows sampled per chunk */
+#define CSV_DEFAULT_BATCH_ROWS 65536    /**< Default streaming batch rows */
+#define CSV_DEFAULT_BATCH_BYTES (64u << 20) /**< Default streaming batch bytes */
+#define CSV_READ_BLOCK_BYTES (1u << 20) /**< Initial streaming buffer size */
+#define CSV_SKIP_FIELD SIZE_MAX         /**< Column slot of a field that is not read */
+#define CSV_WRITE_BLOCK_ROWS 16384      /**< Default rows formatted per block */
+#define CSV_WRITE_BUFFER_BYTES (1u << 20) /**< Initial block buffer size */
+#define CSV_BLOCKS_PER_THREAD 2         /**< Blocks in flight per worker thread */
+
+/**
+ * @brief Inferred value kind, ordered from narrowest to widest
+ */
+typedef enum {
+    KIND_NONE,     /**< Only empty fields seen */
+    KIND_BOOL,     /**< true/false literals */
+    KIND_INT32,    /**< Integers within int32 range */
+    KIND_INT64,    /**< Integers within int64 range */
+    KIND_FLOAT64,  /**< Any other number */
+    KIND_DATE32,   /**< ISO-8601 dates */
+    KIND_TIMESTAMP, /**< ISO-8601 dates with a time of day */
+    KIND_STRING    /**< Anything else */
+} CsvKind;
+
+/**
+ * @brief Growable character buffer of one string column in one chunk
+ */
+typedef struct {
+    char* data;  /**< Unescaped field contents, back to back */
+    size_t len;  /**< Bytes used */
+    size_t cap;  /**< Bytes allocated */
+} CsvText;
+
+/**
+ * @brief Per-chunk parse state
+ *
+ * Each chunk covers whole lines of the mapped file and owns its own column
+ * buffers so chunks can be parsed without synchronization. A string column
+ * buffer holds the end offset of each row within the column's text, and a
+ * categorical column buffer holds codes into the chunk's own categories.
+ */
+typedef struct {
+    const char* begin;  /**< First byte of chunk */
+    const char* end;    /**< One past last byte of chunk */
+    void** cols;        /**< Per-column value buffers */
+    CsvText* text;      /**< Per-column character data of string columns */
+    TablrCategoryIndex** dicts; /**< Per-column categories seen in categorical columns */
+    int32_t** remap;    /**< Per-column file-wide code of each chunk category */
+    uint64_t** nulls;   /**< Per-column bitmap of null rows, NULL until one is seen */
+    CsvKind* widen;     /**< Widest kind seen per column that did not fit */
+    size_t nrows;       /**< Rows parsed */
+    size_t cap;         /**< Row capacity of each buffer */
+    bool failed;        /**< Allocation failure flag */
+} CsvChunk;
+
+/**
+ * @brief Shared state for the parallel parse
+ */
+typedef struct {
+    CsvChunk* chunks;         /**< Chunk array */
+    size_t ncols;             /**< Number of columns read */
+    const size_t* slots;      /**< Column read from each file field, or CSV_SKIP_FIELD */
+    size_t span;              /**< Fields per row up to the last one read */
+    char delimiter;           /**< Field delimiter */
+    char comment;             /**< Comment line character, or '\0' */
+    const TablrDType* types;  /**< Column types */
+    const bool* inferred;     /**< Whether a column type may still widen */
+    TablrTimeUnit unit;       /**< Unit of timestamp columns */
+    const TablrAllocator* allocator; /**< Caller's allocator, for column buffers */
+} CsvParseJob;
+
+/**
+ * @brief Shared state for the parallel stitch
+ */
+typedef struct {
+    const CsvChunk* chunks;   /**< Parsed chunks */
+    size_t nchunks;           /**< Number of chunks */
+    const TablrDType* types;  /**< Column types */
+    void** out;               /**< Output buffer per column (offsets for strings, codes for categoricals) */
+    char** chars;             /**< Output character buffer per string column */
+} CsvStitchJob;
+
+/**
+ * @brief Narrow a raw field to its content
+ *
+ * Drops the '\r' of a CRLF row ending and the enclosing quotes of a quoted
+ * field.
+ *
+ * @return true if the content still contains "" escapes
+ */
+static bool field_content(const char** begin, const char** end, bool row_end) {
+    const char* b = *begin;
+    const char* e = *end;
+
+    if (row_end && e > b && e[-1] == '\r') e--;
+
+    bool escaped = false;
+    if (e - b >= 2 && *b == '"' && e[-1] == '"') {
+        b++;
+        e--;
+        escaped = memchr(b, '"', (size_t)(e - b)) != NULL;
+    }
+
+    *begin = b;
+    *end = e;
+    return escaped;
+}
+
+/**
+ * @brief Copy field content into a new string, collapsing "" escapes
+ * @return Newly allocated string or NULL on allocation failure
+ */
+static char* copy_field(const char* p, size_t len, bool escaped) {
+    char* s = (char*)malloc(len + 1);
+    if (!s) return NULL;
+
+    if (!escaped) {
+        memcpy(s, p, len);
+        s[len] = '\0';
+        return s;
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        s[n++] = p[i];
+        if (p[i] == '"' && i + 1 < len && p[i + 1] == '"') i++;
+    }
+    s[n] = '\0';
+    return s;
+}
+
+/**
+ * @brief Append field content to a column's text, collapsing "" escapes
+ * @return false on allocation failure
+ */
+static bool text_append(CsvText* text, const char* p, size_t len, bool escaped) {
+    if (len == 0) return true;
+    if (len > text->cap - text->len) {
+        size_t cap = text->cap ? text->cap : CSV_INITIAL_TEXT_BYTES;
+        while (cap - text->len < len) cap *= 2;
+        char* grown = (char*)realloc(text->data, cap);
+        if (!grown) return false;
+        text->data = grown;
+        text->cap = cap;
+    }
+
+    char* dst = text->data + text->len;
+    if (!escaped) {
+        memcpy(dst, p, len);
+        text->len += len;
+        return true;
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        dst[n++] = p[i];
+        if (p[i] == '"' && i + 1 < len && p[i + 1] == '"') i++;
+    }
+    text->len += n;
+    return true;
+}
+
+/**
+ * @brief Check whether a raw field is an entirely blank line
+ */
+static bool is_blank_row(const char* begin, const char* end) {
+    return begin == end || (end - begin == 1 && *begin == '\r');
+}
+
+/**
+ * @brief Check whether a row is a comment line
+ * @param begin First byte of the row's first raw field
+ */
+static bool is_comment_row(const char* begin, const char* end, char comment) {
+    return comment != '\0' && begin < end && *begin == comment;
+}
+
+/**
+ * @brief Check whether a raw line holds data rather than being blank or a comment
+ * @param end End of line, excluding the '\n'
+ */
+static bool is_data_line(const char* begin, const char* end, char comment) {
+    return !is_blank_row(begin, end) && !is_comment_row(begin, end, comment);
+}
+
+/**
+ * @brief Skip whole rows, honouring quoted newlines
+ *
+ * @param p Start of a row
+ * @param count Rows to skip
+ * @param comment Comment character; blank and comment lines are not counted
+ *                unless data_only is false
+ * @param data_only Whether only data rows count towards count
+ * @return Start of the row after the last one skipped, or end
+ */
+static const char* skip_rows(const char* p, const char* end, size_t count, char comment, bool data_only) {
+    bool in_quote = false;
+    const char* row = p;
+
+    while (count > 0 && p < end) {
+        const char* nl = (const char*)memchr(p, '\n', (size_t)(end - p));
+        const char* line_end = nl ? nl : end;
+        if (tablr_csv_count_quotes(p, line_end) & 1) in_quote = !in_quote;
+        p = nl ? nl + 1 : end;
+        if (in_quote && nl) continue;
+
+        if (!data_only || is_data_line(row, line_end, comment)) count--;
+        row = p;
+    }
+    return p;
+}
+
+/**
+ * @brief Skip blank and comment lines
+ * @return Start of the first data row at or after p, or end
+ */
+static const char* first_data_row(const char* p, const char* end, char comment) {
+    while (p < end) {
+        const char* nl = (const char*)memchr(p, '\n', (size_t)(end - p));
+        if (is_data_line(p, nl ? nl : end, comment)) break;
+        p = skip_rows(p, end, 1, comment, false);
+    }
+    return p;
+}
+
+/**
+ * @brief Parse boolean literal (true/false in any letter case)
+ */
+static bool parse_bool(const char* p, size_t len, bool* out) {
+    static const char t[] = "true";
+    static const char f[] = "false";
+    const char* lit;
+
+    if (len == 4) lit = t;
+    else if (len == 5) lit = f;
+    else return false;
+
+    for (size_t i = 0; i < len; i++) {
+        char c = p[i];
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != lit[i]) return false;
+    }
+
+    *out = len == 4;
+    return true;
+}
+
+/**
+ * @brief Determine narrowest kind that can hold a non-empty field
+ */
+static CsvKind classify_field(const char* p, size_t len) {
+    bool b;
+    int64_t i;
+    double d;
+    int32_t days;
+
+    if (parse_bool(p, len, &b)) return KIND_BOOL;
+    if (tablr_parse_int64(p, len, &i)) {
+        return (i >= INT32_MIN && i <= INT32_MAX) ? KIND_INT32 : KIND_INT64;
+    }
+    if (tablr_parse_double(p, len, &d)) return KIND_FLOAT64;
+    if (tablr_parse_date32(p, len, &days)) return KIND_DATE32;
+    if (tablr_parse_timestamp(p, len, TABLR_TIME_SECOND, &i)) return KIND_TIMESTAMP;
+    return KIND_STRING;
+}
+
+/**
+ * @brief Check whether a kind holds dates or timestamps
+ */
+static bool is_temporal_kind(CsvKind kind) {
+    return kind == KIND_DATE32 || kind == KIND_TIMESTAMP;
+}
+
+/**
+ * @brief Combine two kinds into one that can hold both
+ *
+ * Numbers widen to the larger numeric kind and dates to timestamps;
+ * booleans or temporal values mixed with numbers become strings.
+ */
+static CsvKind merge_kinds(CsvKind a, CsvKind b) {
+    if (a == KIND_NONE) return b;
+    if (b == KIND_NONE) return a;
+    if (a == b) return a;
+    if (a == KIND_BOOL || b == KIND_BOOL) return KIND_STRING;
+    if (is_temporal_kind(a) != is_temporal_kind(b)) return KIND_STRING;
+    return a > b ? a : b;
+}
+
+/**
+ * @brief Map an inferred kind to a column type
+ */
+static TablrDType kind_dtype(CsvKind kind) {
+    switch (kind) {
+        case KIND_BOOL:   return TABLR_BOOL;
+        case KIND_INT32:  return TABLR_INT32;
+        case KIND_INT64:  return TABLR_INT64;
+        case KIND_DATE32: return TABLR_DATE32;
+        case KIND_TIMESTAMP: return TABLR_TIMESTAMP64;
+        case KIND_STRING: return TABLR_STRING;
+        default:          return TABLR_FLOAT64;
+    }
+}
+
+/**
+ * @brief Map a column type back to its inference kind
+ */
+static CsvKind dtype_kind(TablrDType dtype) {
+    switch (dtype) {
+        case TABLR_BOOL:   return KIND_BOOL;
+        case TABLR_INT32:  return KIND_INT32;
+        case TABLR_INT64:  return KIND_INT64;
+        case TABLR_DATE32: return KIND_DATE32;
+        case TABLR_TIMESTAMP64: return KIND_TIMESTAMP;
+        case TABLR_STRING:
+        case TABLR_CATEGORICAL: return KIND_STRING;
+        default:           return KIND_FLOAT64;
+    }
+}
+
+/**
+ * @brief Store one field into a typed, non-string column buffer
+ *
+ * Empty fields become NaN for floats, false for booleans and 0 for integers,
+ * dates and timestamps. The caller also marks unquoted empty fields as null.
+ *
+ * @return false if the field does not fit the column type
+ */
+static bool store_field(void* col, size_t row, TablrDType dtype, TablrTimeUnit unit, const char* p, size_t len) {
+    int32_t i32 = 0;
+    int64_t i64 = 0;
+    uint64_t u64 = 0;
+    double d = NAN;
+    bool b = false;
+    bool ok = true;
+
+    switch (dtype) {
+        case TABLR_INT8:
+            if (len > 0) ok = tablr_parse_int32(p, len, &i32) && i32 >= INT8_MIN && i32 <= INT8_MAX;
+            ((int8_t*)col)[row] = ok ? (int8_t)i32 : 0;
+            return ok;
+        case TABLR_INT16:
+            if (len > 0) ok = tablr_parse_int32(p, len, &i32) && i32 >= INT16_MIN && i32 <= INT16_MAX;
+            ((int16_t*)col)[row] = ok ? (int16_t)i32 : 0;
+            return ok;
+        case TABLR_UINT8:
+            if (len > 0) ok = tablr_parse_uint64(p, len, &u64) && u64 <= UINT8_MAX;
+            ((uint8_t*)col)[row] = ok ? (uint8_t)u64 : 0;
+            return ok;
+        case TABLR_UINT16:
+            if (len > 0) ok = tablr_parse_uint64(p, len, &u64) && u64 <= UINT16_MAX;
+            ((uint16_t*)col)[row] = ok ? (uint16_t)u64 : 0;
+            return ok;
+        case TABLR_UINT32:
+            if (len > 0) ok = tablr_parse_uint64(p, len, &u64) && u64 <= UINT32_MAX;
+            ((uint32_t*)col)[row] = ok ? (uint32_t)u64 : 0;
+            return ok;
+        case TABLR_UINT64:
+            if (len > 0) ok = tablr_parse_uint64(p, len, &u64);
+            ((uint64_t*)col)[row] = ok ? u64 : 0;
+            return ok;
+        case TABLR_DATE32:
+            if (len > 0) ok = tablr_parse_date32(p, len, &i32);
+            ((int32_t*)col)[row] = ok ? i32 : 0;
+            return ok;
+        case TABLR_TIMESTAMP64:
+            if (len > 0) ok = tablr_parse_timestamp(p, len, unit, &i64);
+            ((int64_t*)col)[row] = ok ? i64 : 0;
+            return ok;
+        case TABLR_INT32:
+            if (len > 0) ok = tablr_parse_int32(p, len, &i32);
+            ((int32_t*)col)[row] = ok ? i32 : 0;
+            return ok;
+        case TABLR_INT64:
+            if (len > 0) ok = tablr_parse_int64(p, len, &i64);
+            ((int64_t*)col)[row] = ok ? i64 : 0;
+            return ok;
+        case TABLR_FLOAT32:
+            if (len > 0) ok = tablr_parse_double(p, len, &d);
+            ((float*)col)[row] = ok ? (float)d : NAN;
+            return ok;
+        case TABLR_FLOAT64:
+            if (len > 0) ok = tablr_parse_double(p, len, &d);
+            ((double*)col)[row] = ok ? d : NAN;
+            return ok;
+        case TABLR_BOOL:
+            if (len > 0) ok = parse_bool(p, len, &b);
+            ((bool*)col)[row] = b;
+            return ok;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Record kept in the TABLR_ALIGNMENT bytes in front of a chunk column
+ */
+typedef struct {
+    TablrAllocator allocator;  /**< Allocator the block came from */
+    size_t bytes;              /**< Size passed to allocator.alloc */
+} CsvColumnHeader;
+
+/**
+ * @brief Allocate a chunk column on a TABLR_ALIGNMENT boundary
+ *
+ * Column buffers come from the reading thread's allocator, passed to the
+ * workers, rather than malloc, so a single-chunk file can hand them to its
+ * series without a copy and still meet the series alignment guarantee. The
+ * header in front of the column lets any thread free it.
+ */
+static void* column_alloc(const TablrAllocator* allocator, size_t bytes) {
+    size_t total = TABLR_ALIGNMENT + bytes;
+    char* block = (char*)allocator->alloc(allocator->ctx, total);
+    if (!block) return NULL;
+    CsvColumnHeader* header = (CsvColumnHeader*)block;
+    header->allocator = *allocator;
+    header->bytes = total;
+    return block + TABLR_ALIGNMENT;
+}
+
+/**
+ * @brief Free a buffer from column_alloc
+ */
+static void column_free(void* data) {
+    if (!data) return;
+    char* block = (char*)data - TABLR_ALIGNMENT;
+    CsvColumnHeader header = *(const CsvColumnHeader*)block;
+    header.allocator.free(header.allocator.ctx, block, header.bytes);
+}
+
+/**
+ * @brief Owner of a chunk column handed to a series
+ *
+ * Keeps a copy of the header outside the block, so the series can still be
+ * freed after an arena the column came from is gone.
+ */
+typedef struct {
+    CsvColumnHeader header;  /**< Copy of the column's header */
+    void* block;             /**< Block returned by allocator.alloc */
+} CsvColumnOwner;
+
+/**
+ * @brief Release callback of an adopted chunk column
+ */
+static void column_release(void* ctx) {
+    CsvColumnOwner* owner = (CsvColumnOwner*)ctx;
+    owner->header.allocator.free(owner->header.allocator.ctx, owner->block, owner->header.bytes);
+    free(owner);
+}
+
+/**
+ * @brief Create a series that takes over a chunk column without copying
+ * @return New series, or NULL on failure (the column still belongs to the chunk)
+ */
+static TablrSeries* column_adopt(void* data, size_t size, TablrDType dtype) {
+    CsvColumnOwner* owner = (CsvColumnOwner*)malloc(sizeof(CsvColumnOwner));
+    if (!owner) return NULL;
+    owner->block = (char*)data - TABLR_ALIGNMENT;
+    owner->header = *(const CsvColumnHeader*)owner->block;
+    TablrSeries* series = tablr_series_external(data, size, dtype, TABLR_CPU, column_release, owner);
+    if (!series) free(owner);
+    return series;
+}
+
+/**
+ * @brief Free per-chunk buffers
+ */
+static void chunk_release(CsvChunk* chunk, size_t ncols) {
+    for (size_t c = 0; chunk->cols && c < ncols; c++) {
+        column_free(chunk->cols[c]);
+    }
+    for (size_t c = 0; chunk->text && c < ncols; c++) {
+        free(chunk->text[c].data);
+    }
+    for (size_t c = 0; chunk->dicts && c < ncols; c++) {
+        tablr_category_index_free(chunk->dicts[c]);
+    }
+    for (size_t c = 0; chunk->remap && c < ncols; c++) {
+        free(chunk->remap[c]);
+    }
+    for (size_t c = 0; chunk->nulls && c < ncols; c++) {
+        free(chunk->nulls[c]);
+    }
+    free(chunk->cols);
+    free(chunk->text);
+    free(chunk->dicts);
+    free(chunk->remap);
+    free(chunk->nulls);
+    free(chunk->widen);
+    chunk->cols = NULL;
+    chunk->text = NULL;
+    chunk->dicts = NULL;
+    chunk->remap = NULL;
+    chunk->nulls = NULL;
+    chunk->widen = NULL;
+    chunk->nrows = 0;
+    chunk->cap = 0;
+    chunk->failed = false;
+}
+
+/**
+ * @brief Grow chunk column buffers
+ */
+static bool chunk_grow(CsvChunk* chunk, size_t ncols, const TablrDType* types,
+                       const TablrAllocator* allocator) {
+    size_t new_cap = chunk->cap ? chunk->cap * 2 : CSV_INITIAL_ROWS;
+    for (size_t c = 0; c < ncols; c++) {
+        size_t elem_size = tablr_dtype_size(types[c]);
+        void* grown = column_alloc(allocator, new_cap * elem_size);
+        if (!grown) return false;
+        if (chunk->nrows) memcpy(grown, chunk->cols[c], chunk->nrows * elem_size);
+        column_free(chunk->cols[c]);
+        chunk->cols[c] = grown;
+    }
+    size_t old_words = (chunk->cap + 63) / 64;
+    size_t new_words = (new_cap + 63) / 64;
+    for (size_t c = 0; c < ncols; c++) {
+        if (!chunk->nulls[c]) continue;
+        uint64_t* grown = (uint64_t*)realloc(chunk->nulls[c], new_words * sizeof(uint64_t));
+        if (!grown) return false;
+        memset(grown + old_words, 0, (new_words - old_words) * sizeof(uint64_t));
+        chunk->nulls[c] = grown;
+    }
+    chunk->cap = new_cap;
+    return true;
+}
+
+/**
+ * @brief Record the current row of a column as null
+ *
+ * Bitmaps are only allocated for columns that have a null, so columns
+ * without gaps cost nothing.
+ */
+static bool chunk_mark_null(CsvChunk* chunk, size_t col) {
+    if (!chunk->nulls[col]) {
+        chunk->nulls[col] = (uint64_t*)calloc((chunk->cap + 63) / 64, sizeof(uint64_t));
+        if (!chunk->nulls[col]) return false;
+    }
+    chunk->nulls[col][chunk->nrows / 64] |= (uint64_t)1 << (chunk->nrows % 64);
+    return true;
+}
+
+/**
+ * @brief Get the chunk code of a categorical field, adding the category if new
+ *
+ * Escaped fields are unescaped into the column's text buffer first.
+ *
+ * @return Code, or -1 on allocation failure
+ */
+static int32_t chunk_category(CsvChunk* chunk, size_t col, const char* p, size_t len, bool escaped) {
+    if (!escaped) return tablr_category_index_add(chunk->dicts[col], p, len);
+
+    CsvText* text = &chunk->text[col];
+    text->len = 0;
+    if (!text_append(text, p, len, true)) return -1;
+    return tablr_category_index_add(chunk->dicts[col], text->data, text->len);
+}
+
+/**
+ * @brief Parse every row of one chunk into its column buffers
+ *
+ * Fields that do not fit an inferred column type are recorded in the chunk's
+ * widen array so the caller can re-parse with a wider type.
+ */
+static void parse_chunk(size_t index, void* ctx) {
+    CsvParseJob* job = (CsvParseJob*)ctx;
+    CsvChunk* chunk = &job->chunks[index];
+    size_t ncols = job->ncols;
+
+    chunk->cols = (void**)calloc(ncols, sizeof(void*));
+    chunk->text = (CsvText*)calloc(ncols, sizeof(CsvText));
+    chunk->dicts = (TablrCategoryIndex**)calloc(ncols, sizeof(TablrCategoryIndex*));
+    chunk->remap = (int32_t**)calloc(ncols, sizeof(int32_t*));
+    chunk->nulls = (uint64_t**)calloc(ncols, sizeof(uint64_t*));
+    chunk->widen = (CsvKind*)calloc(ncols, sizeof(CsvKind));
+    TablrCsvTokenizer* tok = (TablrCsvTokenizer*)malloc(sizeof(TablrCsvTokenizer));
+    bool ok = chunk->cols && chunk->text && chunk->dicts && chunk->remap && chunk->nulls && chunk->widen && tok;
+    for (size_t c = 0; ok && c < ncols; c++) {
+        if (job->types[c] == TABLR_CATEGORICAL) ok = (chunk->dicts[c] = tablr_category_index_create()) != NULL;
+    }
+    if (!ok) {
+        chunk->failed = true;
+        free(tok);
+        return;
+    }
+
+    tablr_csv_tokenizer_init(tok, chunk->begin, chunk->end, job->delimiter);
+
+    const char* fb;
+    const char* fe;
+    bool row_end;
+    size_t col = 0;
+
+    while (tablr_csv_next_field(tok, &fb, &fe, &row_end)) {
+        if (col == 0) {
+            if (row_end && is_blank_row(fb, fe)) continue;
+            if (is_comment_row(fb, fe, job->comment)) {
+                if (!row_end) tablr_csv_skip_row(tok);
+                continue;
+            }
+            if (chunk->nrows >= chunk->cap && !chunk_grow(chunk, ncols, job->types, job->allocator)) {
+                chunk->failed = true;
+                break;
+            }
+        }
+
+        /* Store this field, then pad short rows with empty fields */
+        const char* raw = fb;
+        bool escaped = job->slots[col] != CSV_SKIP_FIELD && field_content(&fb, &fe, row_end);
+        size_t last = row_end ? job->span : col + 1;
+        for (; col < last && !chunk->failed; col++) {
+            size_t slot = job->slots[col];
+            if (slot != CSV_SKIP_FIELD) {
+                size_t len = (size_t)(fe - fb);
+                TablrDType dtype = job->types[slot];
+
+                /* A quoted "" is an empty string rather than a missing value, except as an integer or date */
+                bool valueless = tablr_dtype_is_integer(dtype) || dtype == TABLR_DATE32 || dtype == TABLR_TIMESTAMP64;
+                if (len == 0 && (fb == raw || valueless) && !chunk_mark_null(chunk, slot)) {
+                    chunk->failed = true;
+                    break;
+                }
+
+                if (dtype == TABLR_STRING) {
+                    CsvText* text = &chunk->text[slot];
+                    if (!text_append(text, fb, len, escaped)) chunk->failed = true;
+                    ((int64_t*)chunk->cols[slot])[chunk->nrows] = (int64_t)text->len;
+                } else if (dtype == TABLR_CATEGORICAL) {
+                    bool missing = len == 0 && fb == raw;
+                    int32_t code = missing ? -1 : chunk_category(chunk, slot, fb, len, escaped);
+                    if (code < 0 && !missing) chunk->failed = true;
+                    ((int32_t*)chunk->cols[slot])[chunk->nrows] = code;
+                } else if (!store_field(chunk->cols[slot], chunk->nrows, dtype, job->unit, fb, len) &&
+                           job->inferred[slot]) {
+                    chunk->widen[slot] = merge_kinds(chunk->widen[slot], classify_field(fb, len));
+                }
+            }
+            fb = fe;
+            raw = fe;
+        }
+        if (chunk->failed) break;
+
+        /* Fields past the last one read are never looked at */
+        if (!row_end && col >= job->span) {
+            tablr_csv_skip_row(tok);
+            row_end = true;
+        }
+        if (row_end) {
+            chunk->nrows++;
+            col = 0;
+        }
+    }
+
+    free(tok);
+}
+
+/**
+ * @brief Concatenate one string column of every chunk into its output buffers
+ *
+ * Chunk end offsets are relative to the chunk's text, so each is shifted by
+ * the text length of the chunks before it.
+ */
+static void stitch_strings(const CsvStitchJob* job, size_t col) {
+    int64_t* offsets = (int64_t*)job->out[col];
+    char* chars = job->chars[col];
+    size_t row = 0;
+    int64_t base = 0;
+    for (size_t i = 0; i < job->nchunks; i++) {
+        const CsvChunk* chunk = &job->chunks[i];
+        if (chunk->nrows == 0) continue;
+        const int64_t* ends = (const int64_t*)chunk->cols[col];
+        for (size_t r = 0; r < chunk->nrows; r++) {
+            offsets[row + r + 1] = base + ends[r];
+        }
+        if (chunk->text[col].len > 0) memcpy(chars + base, chunk->text[col].data, chunk->text[col].len);
+        row += chunk->nrows;
+        base += (int64_t)chunk->text[col].len;
+    }
+}
+
+/**
+ * @brief Concatenate one categorical column of every chunk into its output codes
+ *
+ * Chunk codes are translated to file-wide codes through the chunk's remap
+ * table; missing fields keep code -1.
+ */
+static void stitch_codes(const CsvStitchJob* job, size_t col) {
+    int32_t* codes = (int32_t*)job->out[col];
+    size_t row = 0;
+    for (size_t i = 0; i < job->nchunks; i++) {
+        const CsvChunk* chunk = &job->chunks[i];
+        if (chunk->nrows == 0) continue;
+        const int32_t* local = (const int32_t*)chunk->cols[col];
+        const int32_t* remap = chunk->remap[col];
+        for (size_t r = 0; r < chunk->nrows; r++) {
+            codes[row + r] = local[r] >= 0 ? remap[local[r]] : -1;
+        }
+        row += chunk->nrows;
+    }
+}
+
+/**
+ * @brief Concatenate one column of every chunk into its output buffer
+ */
+static void stitch_column(size_t col, void* ctx) {
+    CsvStitchJob* job = (CsvStitchJob*)ctx;
+    char* out = (char*)job->out[col];
+    if (!out) return;
+    if (job->types[col] == TABLR_STRING) {
+        stitch_strings(job, col);
+        return;
+    }
+    if (job->types[col] == TABLR_CATEGORICAL) {
+        stitch_codes(job, col);
+        return;
+    }
+
+    size_t elem_size = tablr_dtype_size(job->types[col]);
+    size_t offset = 0;
+    for (size_t i = 0; i < job->nchunks; i++) {
+        const CsvChunk* chunk = &job->chunks[i];
+        if (chunk->nrows == 0) continue;
+        memcpy(out + offset, chunk->cols[col], chunk->nrows * elem_size);
+        offset += chunk->nrows * elem_size;
+    }
+}
+
+/**
+ * @brief Mark the rows recorded as null in every chunk on a column's series
+ * @return false on allocation failure
+ */
+static bool apply_nulls(TablrSeries* series, const CsvChunk* chunks, size_t nchunks, size_t col) {
+    size_t base = 0;
+    for (size_t i = 0; i < nchunks; i++) {
+        const CsvChunk* chunk = &chunks[i];
+        const uint64_t* nulls = chunk->nulls ? chunk->nulls[col] : NULL;
+        size_t rows = chunk->nrows;
+        size_t start = base;
+        base += rows;
+        if (!nulls) continue;
+
+        /* Invert the chunk's null bits into a validity bitmap and copy it in one pass */
+        size_t nbytes = (rows + 7) / 8;
+        uint8_t* valid = (uint8_t*)malloc(nbytes ? nbytes : 1);
+        if (!valid) return false;
+        for (size_t b = 0; b < nbytes; b++) valid[b] = (uint8_t)~(nulls[b / 8] >> (8 * (b % 8)));
+        bool ok = tablr_series_set_validity(series, start, valid, 0, rows);
+        free(valid);
+        if (!ok) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Read the header (or first) row into column names
+ *
+ * @param body Output start of the data rows
+ * @return Number of columns found, 0 on failure
+ */
+static size_t parse_header(TablrCsvTokenizer* tok, const char* begin, const char* end, char delimiter,
+                           bool has_header, char*** names_out, const char** body) {
+    tablr_csv_tokenizer_init(tok, begin, end, delimiter);
+
+    size_t ncols = 0;
+    size_t cap = 0;
+    char** names = NULL;
+    const char* fb;
+    const char* fe;
+    bool row_end = false;
+
+    while (!row_end && tablr_csv_next_field(tok, &fb, &fe, &row_end)) {
+        if (ncols == cap) {
+            cap = cap ? cap * 2 : 16;
+            char** grown = (char**)realloc(names, cap * sizeof(char*));
+            if (!grown) break;
+            names = grown;
+        }
+
+        bool escaped = field_content(&fb, &fe, row_end);
+        char col_name[32];
+        if (has_header) {
+            names[ncols] = copy_field(fb, (size_t)(fe - fb), escaped);
+        } else {
+            snprintf(col_name, sizeof(col_name), "col%zu", ncols);
+            names[ncols] = strdup(col_name);
+        }
+        ncols++;
+    }
+
+    if (!row_end) {
+        for (size_t c = 0; c < ncols; c++) free(names[c]);
+        free(names);
+        return 0;
+    }
+
+    *names_out = names;
+    *body = has_header ? tablr_csv_tokenizer_position(tok) : begin;
+    return ncols;
+}
+
+/**
+ * @brief Shared state for counting quotes in nominal chunk ranges
+ */
+typedef struct {
+    const char** starts;  /**< Nominal range starts (count + 1 entries) */
+    size_t* quotes;       /**< Quote count per range */
+} CsvQuoteJob;
+
+/**
+ * @brief Count quotes of one nominal range
+ */
+static void count_range_quotes(size_t index, void* ctx) {
+    CsvQuoteJob* job = (CsvQuoteJob*)ctx;
+    job->quotes[index] = tablr_csv_count_quotes(job->starts[index], job->starts[index + 1]);
+}
+
+/**
+ * @brief Find the first row start at or after p
+ *
+ * @param in_quote Whether p lies inside a quoted field
+ */
+static const char* next_row_start(const char* p, const char* end, bool in_quote) {
+    for (; p < end; p++) {
+        if (*p == '"') in_quote = !in_quote;
+        else if (*p == '\n' && !in_quote) return p + 1;
+    }
+    return end;
+}
+
+/**
+ * @brief Split [begin, end) into chunks that start on row boundaries
+ *
+ * Quote counts of evenly sized nominal ranges are computed in parallel; their
+ * running parity tells whether each nominal split point lies inside a quoted
+ * field, so the split can move to the next newline that really ends a row.
+ *
+ * @return Number of chunks written to chunks
+ */
+static size_t split_chunks(const char* begin, const char* end, CsvChunk* chunks, size_t max_chunks) {
+    size_t total = (size_t)(end - begin);
+    size_t nchunks = total / CSV_MIN_CHUNK_BYTES;
+    if (nchunks > max_chunks) nchunks = max_chunks;
+    if (nchunks == 0) nchunks = 1;
+
+    const char** starts = (const char**)malloc((nchunks + 1) * sizeof(const char*));
+    size_t* quotes = (size_t*)calloc(nchunks, sizeof(size_t));
+    if (!starts || !quotes) {
+        free(starts);
+        free(quotes);
+        nchunks = 1;
+    } else {
+        for (size_t i = 0; i < nchunks; i++) starts[i] = begin + total / nchunks * i;
+        starts[nchunks] = end;
+        if (nchunks > 1) {
+            CsvQuoteJob quote_job = { starts, quotes };
+            tablr_parallel_for(nchunks, count_range_quotes, &quote_job);
+        }
+    }
+
+    size_t count = 0;
+    size_t parity = 0;
+    const char* p = begin;
+    for (size_t i = 1; i <= nchunks && p < end; i++) {
+        const char* stop = end;
+        if (i < nchunks) {
+            parity += quotes[i - 1];
+            stop = starts[i] < p ? next_row_start(p, end, false)
+                                 : next_row_start(starts[i], end, parity & 1);
+        }
+        if (stop == p) continue;
+
+        memset(&chunks[count], 0, sizeof(CsvChunk));
+        chunks[count].begin = p;
+        chunks[count].end = stop;
+        count++;
+        p = stop;
+    }
+
+    free(starts);
+    free(quotes);
+    return count;
+}
+
+/**
+ * @brief Infer column kinds from a sample of rows
+ *
+ * Samples the first rows of every chunk so that the sample is spread across
+ * the file rather than taken only from its head. Empty fields say nothing
+ * about the type: they are read as nulls of whatever the column becomes.
+ */
+static void infer_kinds(TablrCsvTokenizer* tok, const CsvParseJob* job, size_t nchunks,
+                        size_t infer_rows, CsvKind* kinds) {
+    size_t ncols = job->ncols;
+    size_t per_chunk = nchunks ? infer_rows / nchunks : 0;
+    if (per_chunk < CSV_MIN_SAMPLE_PER_CHUNK) per_chunk = CSV_MIN_SAMPLE_PER_CHUNK;
+
+    for (size_t i = 0; i < nchunks; i++) {
+        tablr_csv_tokenizer_init(tok, job->chunks[i].begin, job->chunks[i].end, job->delimiter);
+
+        const char* fb;
+        const char* fe;
+        bool row_end;
+        size_t col = 0;
+        size_t sampled = 0;
+
+        while (sampled < per_chunk && tablr_csv_next_field(tok, &fb, &fe, &row_end)) {
+            if (col == 0) {
+                if (row_end && is_blank_row(fb, fe)) continue;
+                if (is_comment_row(fb, fe, job->comment)) {
+                    if (!row_end) tablr_csv_skip_row(tok);
+                    continue;
+                }
+            }
+
+            size_t slot = job->slots[col];
+            if (slot != CSV_SKIP_FIELD) {
+                field_content(&fb, &fe, row_end);
+                size_t len = (size_t)(fe - fb);
+                if (len > 0 && kinds[slot] != KIND_STRING) {
+                    kinds[slot] = merge_kinds(kinds[slot], classify_field(fb, len));
+                }
+            }
+            col++;
+
+            if (!row_end && col >= job->span) {
+                tablr_csv_skip_row(tok);
+                row_end = true;
+            }
+            if (row_end) {
+                col = 0;
+                sampled++;
+            }
+        }
+    }
+
+    for (size_t c = 0; c < ncols; c++) {
+        if (kinds[c] == KIND_NONE) kinds[c] = KIND_FLOAT64;
+    }
+}
+
+/**
+ * @brief Resolve explicit column types from options
+ * @return true if every column has an explicit type
+ */
+static bool apply_schema(const TablrCsvOptions* options, char** headers, size_t ncols,
+                         TablrDType* types, bool* inferred) {
+    bool all_explicit = true;
+
+    for (size_t c = 0; c < ncols; c++) {
+        inferred[c] = true;
+        if (!options->dtypes) continue;
+
+        for (size_t i = 0; i < options->num_dtypes; i++) {
+            bool match = options->dtype_columns
+                ? (options->dtype_columns[i] && headers[c] && strcmp(options->dtype_columns[i], headers[c]) == 0)
+                : i == c;
+            if (match) {
+                types[c] = options->dtypes[i];
+                inferred[c] = false;
+                break;
+            }
+        }
+    }
+
+    for (size_t c = 0; c < ncols; c++) {
+        if (inferred[c]) all_explicit = false;
+    }
+    return all_explicit;
+}
+
+/**
+ * @brief Column names and types shared by every parsed range of one file
+ */
+typedef struct {
+    size_t ncols;         /**< Number of columns read */
+    char** names;         /**< Column names */
+    TablrDType* types;    /**< Current column types */
+    bool* inferred;       /**< Whether a column type is inferred and may widen */
+    bool resolved;        /**< Whether inferred types have been chosen */
+    size_t* slots;        /**< Column read from each file field, or CSV_SKIP_FIELD */
+    size_t span;          /**< Fields per row up to the last one read */
+} CsvSchema;
+
+/**
+ * @brief Free schema storage
+ */
+static void schema_free(CsvSchema* schema) {
+    for (size_t c = 0; schema->names && c < schema->ncols; c++) {
+        free(schema->names[c]);
+    }
+    free(schema->names);
+    free(schema->types);
+    free(schema->inferred);
+    free(schema->slots);
+    memset(schema, 0, sizeof(CsvSchema));
+}
+
+/**
+ * @brief Check whether options select a file field
+ * @return false if usecols is set and does not name the field
+ */
+static bool field_selected(const TablrCsvOptions* options, const char* name, size_t field) {
+    if (options->num_usecols == 0) return true;
+
+    for (size_t i = 0; i < options->num_usecols; i++) {
+        if (options->usecols) {
+            if (options->usecols[i] && name && strcmp(options->usecols[i], name) == 0) return true;
+        } else if (options->usecol_indices && options->usecol_indices[i] == field) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Read the header row of [begin, end) and resolve the columns to read
+ *
+ * Selected columns keep their file order. Explicit column types are applied
+ * to the selected columns.
+ *
+ * @param body Set to the first data byte
+ * @return true on success, false if a selected column does not exist
+ */
+static bool schema_init(CsvSchema* schema, TablrCsvTokenizer* tok, const char* begin, const char* end,
+                        const TablrCsvOptions* options, const char** body) {
+    memset(schema, 0, sizeof(CsvSchema));
+    size_t nfields = parse_header(tok, begin, end, options->delimiter, options->has_header,
+                                  &schema->names, body);
+    if (nfields == 0) return false;
+
+    schema->slots = (size_t*)malloc(nfields * sizeof(size_t));
+    if (!schema->slots) {
+        schema->ncols = nfields;
+        schema_free(schema);
+        return false;
+    }
+
+    /* Every requested column must exist */
+    bool found = true;
+    for (size_t i = 0; i < options->num_usecols && found; i++) {
+        if (options->usecols) {
+            found = false;
+            for (size_t f = 0; f < nfields && !found; f++) {
+                found = options->usecols[i] && schema->names[f] && strcmp(options->usecols[i], schema->names[f]) == 0;
+            }
+        } else {
+            found = options->usecol_indices && options->usecol_indices[i] < nfields;
+        }
+    }
 
-#ifdef _WIN32
-#define strdup _strdup
-#else
-#define _POSIX_C_SOURCE 200809L
-#endif
+    /* Compact the names of selected fields to the front */
+    size_t ncols = 0;
+    for (size_t f = 0; f < nfields; f++) {
+        char* name = schema->names[f];
+        if (field_selected(options, name, f)) {
+            schema->slots[f] = ncols;
+            schema->names[ncols++] = name;
+            schema->span = f + 1;
+        } else {
+            schema->slots[f] = CSV_SKIP_FIELD;
+            free(name);
+        }
+    }
+    schema->ncols = ncols;
 
-#include "tablr/io/csv.h"
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
+    if (ncols == 0 || !found) {
+        schema_free(schema);
+        return false;
+    }
+
+    schema->types = (TablrDType*)calloc(ncols, sizeof(TablrDType));
+    schema->inferred = (bool*)calloc(ncols, sizeof(bool));
+    if (!schema->types || !schema->inferred) {
+        schema_free(schema);
+        return false;
+    }
+
+    schema->resolved = apply_schema(options, schema->names, ncols, schema->types, schema->inferred);
+    return true;
+}
+
+/**
+ * @brief Build the categorical series of one column from the chunk categories
+ *
+ * Merges every chunk's categories, in file order, into one dictionary and
+ * records in each chunk the file-wide code of each of its categories, for
+ * stitch_codes() to translate the codes with. Each distinct value is hashed
+ * once per chunk it appears in rather than once per row.
+ *
+ * @return Series with uninitialized codes, or NULL on failure
+ */
+static TablrSeries* merge_categories(CsvChunk* chunks, size_t nchunks, size_t col, size_t nrows) {
+    TablrCategoryIndex* index = tablr_category_index_create();
+    bool ok = index != NULL;
+    for (size_t i = 0; ok && i < nchunks; i++) {
+        const TablrCategoryIndex* local = chunks[i].dicts[col];
+        size_t count = tablr_category_index_size(local);
+        chunks[i].remap[col] = (int32_t*)malloc((count ? count : 1) * sizeof(int32_t));
+        ok = chunks[i].remap[col] != NULL;
+        for (int32_t code = 0; ok && (size_t)code < count; code++) {
+            size_t len;
+            const char* value = tablr_category_index_value(local, code, &len);
+            chunks[i].remap[col][code] = tablr_category_index_add(index, value, len);
+            ok = chunks[i].remap[col][code] >= 0;
+        }
+    }
+
+    TablrSeries* categories = ok ? tablr_category_index_categories(index, TABLR_CPU) : NULL;
+    TablrSeries* series = ok ? tablr_series_categorical_alloc(nrows, categories, TABLR_CPU) : NULL;
+    tablr_series_free(categories);
+    tablr_category_index_free(index);
+    return series;
+}
+
+/**
+ * @brief Parse the rows of [begin, end) into a new dataframe
+ *
+ * Splits the range into row-aligned chunks, parses them in parallel into
+ * per-chunk column buffers and stitches the buffers into the final columns.
+ * Inferred types are chosen from the first range parsed with the schema; any
+ * inferred column that later meets a field it cannot hold is widened in the
+ * schema and the range is parsed again.
+ *
+ * @return New dataframe, or NULL on failure
+ */
+static TablrDataFrame* parse_rows(CsvSchema* schema, TablrCsvTokenizer* tok, const char* begin, const char* end,
+                                  const TablrCsvOptions* options) {
+    TablrDataFrame* df = tablr_dataframe_create();
+    if (!df) return NULL;
+
+    size_t ncols = schema->ncols;
+    TablrDType* types = schema->types;
+    const bool* inferred = schema->inferred;
+    char delimiter = options->delimiter;
+
+    size_t max_chunks = (size_t)tablr_get_num_threads() * CSV_CHUNKS_PER_THREAD;
+    CsvChunk* chunks = (CsvChunk*)calloc(max_chunks, sizeof(CsvChunk));
+    CsvKind* kinds = (CsvKind*)calloc(ncols, sizeof(CsvKind));
+    bool ok = chunks && kinds;
+
+    size_t nchunks = ok ? split_chunks(begin, end, chunks, max_chunks) : 0;
+    CsvParseJob parse_job = { chunks, ncols, schema->slots, schema->span, delimiter, options->comment,
+                              types, inferred, options->time_unit, tablr_get_allocator() };
+
+    if (ok && !schema->resolved) {
+        size_t infer_rows = options->infer_rows ? options->infer_rows : CSV_DEFAULT_INFER_ROWS;
+        infer_kinds(tok, &parse_job, nchunks, infer_rows, kinds);
+        for (size_t c = 0; c < ncols; c++) {
+            if (inferred[c]) types[c] = kind_dtype(kinds[c]);
+        }
+        schema->resolved = true;
+    }
+
+    /* Parse, widening inferred columns until every field fits */
+    while (ok) {
+        tablr_parallel_for(nchunks, parse_chunk, &parse_job);
+
+        bool widened = false;
+        for (size_t c = 0; c < ncols; c++) {
+            kinds[c] = dtype_kind(types[c]);
+        }
+        for (size_t i = 0; i < nchunks; i++) {
+            if (chunks[i].failed) ok = false;
+            for (size_t c = 0; ok && c < ncols; c++) {
+                if (inferred[c]) kinds[c] = merge_kinds(kinds[c], chunks[i].widen[c]);
+            }
+        }
+        for (size_t c = 0; ok && c < ncols; c++) {
+            if (inferred[c] && kind_dtype(kinds[c]) != types[c]) widened = true;
+        }
+        if (!ok || !widened) break;
+
+        for (size_t i = 0; i < nchunks; i++) {
+            chunk_release(&chunks[i], ncols);
+        }
+        for (size_t c = 0; c < ncols; c++) {
+            if (inferred[c]) types[c] = kind_dtype(kinds[c]);
+        }
+    }
+
+    size_t nrows = 0;
+    for (size_t i = 0; ok && i < nchunks; i++) {
+        nrows += chunks[i].nrows;
+    }
+
+    /* A single parsed chunk already holds whole numeric columns; adopt its buffers */
+    CsvChunk* whole = NULL;
+    for (size_t i = 0; ok && i < nchunks; i++) {
+        if (chunks[i].nrows == nrows) whole = &chunks[i];
+    }
+
+    /* Otherwise stitch chunk buffers directly into the column storage */
+    TablrSeries** series = ok ? (TablrSeries**)calloc(ncols, sizeof(TablrSeries*)) : NULL;
+    void** out = ok ? (void**)calloc(ncols, sizeof(void*)) : NULL;
+    char** chars = ok ? (char**)calloc(ncols, sizeof(char*)) : NULL;
+    if (series && out && chars && nrows > 0) {
+        bool stitch = false;
+        for (size_t c = 0; ok && c < ncols; c++) {
+            if (types[c] == TABLR_STRING) {
+                size_t bytes = 0;
+                for (size_t i = 0; i < nchunks; i++) bytes += chunks[i].text[c].len;
+                series[c] = tablr_series_string_alloc(nrows, bytes, TABLR_CPU);
+                int64_t* offsets = NULL;
+                if (series[c] && tablr_series_string_buffers(series[c], &offsets, &chars[c])) {
+                    out[c] = offsets;
+                    stitch = true;
+                } else {
+                    ok = false;
+                }
+            } else if (types[c] == TABLR_CATEGORICAL) {
+                series[c] = merge_categories(chunks, nchunks, c, nrows);
+                out[c] = tablr_series_data(series[c]);
+                stitch = true;
+            } else if (whole) {
+                /* No trimming realloc: it could move the buffer off its alignment */
+                series[c] = column_adopt(whole->cols[c], nrows, types[c]);
+                if (series[c]) whole->cols[c] = NULL;
+            } else {
+                series[c] = tablr_series_alloc(nrows, types[c], TABLR_CPU);
+                out[c] = tablr_series_data(series[c]);
+                stitch = true;
+            }
+            if (!series[c]) ok = false;
+        }
+        if (ok && stitch) {
+            CsvStitchJob stitch_job = { chunks, nchunks, types, out, chars };
+            tablr_parallel_for(ncols, stitch_column, &stitch_job);
+        }
+        for (size_t c = 0; ok && c < ncols; c++) {
+            ok = apply_nulls(series[c], chunks, nchunks, c);
+        }
+    } else if (!series || !out || !chars) {
+        ok = false;
+    }
+
+    for (size_t c = 0; series && c < ncols; c++) {
+        if (series[c]) {
+            if (types[c] == TABLR_TIMESTAMP64) tablr_series_set_time_unit(series[c], options->time_unit);
+            const char* name = schema->names[c] ? schema->names[c] : "";
+            if (!ok || !tablr_dataframe_add_column(df, name, series[c])) {
+                tablr_series_free(series[c]);
+            }
+        }
+    }
+
+    for (size_t i = 0; chunks && i < nchunks; i++) {
+        chunk_release(&chunks[i], ncols);
+    }
+
+    free(chars);
+    free(out);
+    free(series);
+    free(kinds);
+    free(chunks);
+
+    if (!ok) {
+        tablr_dataframe_free(df);
+        return NULL;
+    }
+
+    return df;
+}
+
+/**
+ * @brief Get default CSV read options
+ *
+ * Comma delimiter, header row, every column read with its type inferred, no
+ * row limits and no comment character. Timestamps are read in microseconds.
+ * Streaming readers return batches of at most 65536 rows or 64 MB of text.
+ *
+ * @return Options structure with default values
+ */
+TablrCsvOptions tablr_csv_options_default(void) {
+    TablrCsvOptions options;
+    options.delimiter = ',';
+    options.has_header = true;
+    options.dtypes = NULL;
+    options.dtype_columns = NULL;
+    options.num_dtypes = 0;
+    options.infer_rows = CSV_DEFAULT_INFER_ROWS;
+    options.batch_rows = CSV_DEFAULT_BATCH_ROWS;
+    options.batch_bytes = CSV_DEFAULT_BATCH_BYTES;
+    options.usecols = NULL;
+    options.usecol_indices = NULL;
+    options.num_usecols = 0;
+    options.nrows = 0;
+    options.skiprows = 0;
+    options.comment = '\0';
+    options.time_unit = TABLR_TIME_MICROSECOND;
+    return options;
+}
+
+/**
+ * @brief Read CSV file into dataframe with options
+ * 
+ * Memory-maps the file, splits the body into row-aligned chunks and parses
+ * the chunks in parallel into per-chunk column buffers, which are then stitched
+ * into the final columns. Line length is unbounded. Fields follow RFC 4180:
+ * quoted fields may contain delimiters, newlines and "" escaped quotes.
+ * 
+ * Column types come from options->dtypes where given and are otherwise
+ * inferred from a sample of rows as bool, int32, int64, float64, date32,
+ * timestamp64 or string.
+ * If a later row does not fit an inferred type, the column is widened and the
+ * file is parsed again. Blank lines are skipped.
+ * 
+ * @param filename Path to CSV file
+ * @param options Read options (NULL for defaults)
+ * @return New dataframe with CSV data, or NULL on failure
+ */
+TablrDataFrame* tablr_read_csv_opts(const char* filename, const TablrCsvOptions* options) {
+    TablrCsvOptions defaults = tablr_csv_options_default();
+    if (!options) options = &defaults;
+
+    TablrFileMap map;
+    if (!tablr_file_map_open(&map, filename)) return NULL;
+
+    const char* begin = map.data;
+    const char* end = map.data + map.size;
+    if (begin) {
+        begin = skip_rows(begin, end, options->skiprows, options->comment, false);
+        begin = first_data_row(begin, end, options->comment);
+    }
+    if (begin == end) {
+        tablr_file_map_close(&map);
+        return tablr_dataframe_create();
+    }
+
+    TablrDataFrame* df = NULL;
+    TablrCsvTokenizer* tok = (TablrCsvTokenizer*)malloc(sizeof(TablrCsvTokenizer));
+    CsvSchema schema;
+    const char* body = begin;
+    if (tok && schema_init(&schema, tok, begin, end, options, &body)) {
+        /* Only the rows within the limit are ever split and parsed */
+        if (options->nrows > 0) end = skip_rows(body, end, options->nrows, options->comment, true);
+        df = parse_rows(&schema, tok, body, end, options);
+        schema_free(&schema);
+    }
+
+    free(tok);
+    tablr_file_map_close(&map);
+    return df;
+}
+
+/**
+ * @brief Streaming CSV reader state
+ *
+ * Holds a window of unconsumed file bytes in [pos, len) of buf. Row ends are
+ * located incrementally from scan onwards, so bytes are never examined twice.
+ */
+struct TablrCsvReader {
+    FILE* file;                /**< Source file */
+    TablrCsvOptions options;   /**< Read options */
+    CsvSchema schema;          /**< Column names and types */
+    TablrCsvTokenizer* tok;    /**< Tokenizer used for header and inference */
+    char* buf;                 /**< Read buffer */
+    size_t cap;                /**< Buffer capacity */
+    size_t len;                /**< Bytes held in buffer */
+    size_t pos;                /**< First unconsumed byte */
+    size_t scan;               /**< First byte not yet scanned for row ends */
+    size_t last_row;           /**< End of the last complete row found */
+    size_t rows;               /**< Complete rows counted in [pos, last_row) */
+    size_t remaining;          /**< Data rows left under the nrows limit */
+    bool in_quote;             /**< Quote state at scan */
+    bool eof;                  /**< Whether the file is exhausted */
+    bool failed;               /**< Read or allocation failure flag */
+};
+
+/**
+ * @brief Read more of the file into the buffer
+ *
+ * Moves unconsumed bytes to the front first and grows the buffer only when it
+ * is full of them, so its size stays near one batch.
+ *
+ * @return false on read or allocation failure
+ */
+static bool reader_fill(TablrCsvReader* reader) {
+    if (reader->pos > 0) {
+        size_t keep = reader->len - reader->pos;
+        memmove(reader->buf, reader->buf + reader->pos, keep);
+        reader->scan -= reader->pos;
+        reader->last_row -= reader->pos;
+        reader->len = keep;
+        reader->pos = 0;
+    }
+
+    if (reader->len == reader->cap) {
+        size_t new_cap = reader->cap ? reader->cap * 2 : CSV_READ_BLOCK_BYTES;
+        char* grown = (char*)realloc(reader->buf, new_cap);
+        if (!grown) return false;
+        reader->buf = grown;
+        reader->cap = new_cap;
+    }
+
+    size_t n = fread(reader->buf + reader->len, 1, reader->cap - reader->len, reader->file);
+    if (n == 0) {
+        if (ferror(reader->file)) return false;
+        reader->eof = true;
+    }
+    reader->len += n;
+    return true;
+}
+
+/**
+ * @brief Find the end of the next batch in the buffer
+ *
+ * A batch ends after max_rows rows, or at the first row end at or past
+ * max_bytes bytes, so it never splits a row. At end of file the batch takes
+ * every remaining byte. Blank and comment lines are not counted as rows
+ * unless data_only is false.
+ *
+ * @param stop Set to the buffer offset one past the batch
+ * @return true if a batch was found, false if more input is needed
+ */
+static bool reader_scan(TablrCsvReader* reader, size_t max_rows, size_t max_bytes, bool data_only,
+                        size_t* stop) {
+    const char* base = reader->buf;
+    const char* p = base + reader->scan;
+    const char* end = base + reader->len;
+
+    while (p < end) {
+        const char* nl = (const char*)memchr(p, '\n', (size_t)(end - p));
+        const char* line_end = nl ? nl : end;
+        if (tablr_csv_count_quotes(p, line_end) & 1) reader->in_quote = !reader->in_quote;
+        if (!nl) {
+            p = end;
+            break;
+        }
+
+        p = nl + 1;
+        if (reader->in_quote) continue;
+
+        if (!data_only || is_data_line(base + reader->last_row, nl, reader->options.comment)) reader->rows++;
+        reader->last_row = (size_t)(p - base);
+        if ((max_rows && reader->rows >= max_rows) ||
+            (max_bytes && reader->last_row - reader->pos >= max_bytes)) {
+            reader->scan = reader->last_row;
+            *stop = reader->last_row;
+            return true;
+        }
+    }
+    reader->scan = (size_t)(p - base);
+
+    if (reader->eof && reader->len > reader->pos) {
+        reader->scan = reader->len;
+        reader->last_row = reader->len;
+        *stop = reader->len;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Locate the next batch, reading from the file as needed
+ * @return true if a batch was found, false at end of file or on failure
+ */
+static bool reader_next_range(TablrCsvReader* reader, size_t max_rows, size_t max_bytes, bool data_only,
+                              size_t* stop) {
+    while (!reader_scan(reader, max_rows, max_bytes, data_only, stop)) {
+        if (reader->eof) return false;
+        if (!reader_fill(reader)) {
+            reader->failed = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Mark [pos, stop) as consumed
+ */
+static void reader_consume(TablrCsvReader* reader, size_t stop) {
+    reader->pos = stop;
+    reader->rows = 0;
+    if (reader->last_row < stop) reader->last_row = stop;
+}
+
+/**
+ * @brief Open a streaming CSV reader
+ *
+ * Reads the header row and resolves explicit column types. Inferred column
+ * types are chosen from the first batch and kept for later batches, except
+ * that a column is widened from the batch where a field first does not fit.
+ * Only one batch of text is held in memory at a time.
+ *
+ * @param filename Path to CSV file
+ * @param options Read options (NULL for defaults)
+ * @return New reader, or NULL on failure
+ */
+TablrCsvReader* tablr_csv_reader_open(const char* filename, const TablrCsvOptions* options) {
+    if (!filename) return NULL;
+
+    TablrCsvReader* reader = (TablrCsvReader*)calloc(1, sizeof(TablrCsvReader));
+    if (!reader) return NULL;
+
+    reader->options = options ? *options : tablr_csv_options_default();
+    reader->file = fopen(filename, "rb");
+    reader->tok = (TablrCsvTokenizer*)malloc(sizeof(TablrCsvTokenizer));
+    if (!reader->file || !reader->tok) {
+        tablr_csv_reader_close(reader);
+        return NULL;
+    }
+
+    reader->remaining = reader->options.nrows ? reader->options.nrows : SIZE_MAX;
+
+    /* Skip leading lines, then find the first data row */
+    size_t stop;
+    if (reader->options.skiprows > 0 && reader_next_range(reader, reader->options.skiprows, 0, false, &stop)) {
+        reader_consume(reader, stop);
+    }
+
+    const char* header = NULL;
+    if (!reader->failed && reader_next_range(reader, 1, 0, true, &stop)) {
+        header = first_data_row(reader->buf + reader->pos, reader->buf + stop, reader->options.comment);
+    }
+    if (reader->failed) {
+        tablr_csv_reader_close(reader);
+        return NULL;
+    }
+    if (!header || header == reader->buf + stop) {
+        return reader;  /* No data, no batches */
+    }
+
+    const char* body;
+    if (!schema_init(&reader->schema, reader->tok, header, reader->buf + stop, &reader->options, &body)) {
+        tablr_csv_reader_close(reader);
+        return NULL;
+    }
+
+    if (reader->options.has_header) {
+        reader_consume(reader, stop);
+    } else {
+        /* The first row is data, scan it again as part of the first batch */
+        reader->pos = (size_t)(header - reader->buf);
+        reader->scan = reader->pos;
+        reader->last_row = reader->pos;
+        reader->rows = 0;
+        reader->in_quote = false;
+    }
+
+    /* Column selection and explicit schema pointers are not needed past this point */
+    reader->options.dtypes = NULL;
+    reader->options.dtype_columns = NULL;
+    reader->options.num_dtypes = 0;
+    reader->options.usecols = NULL;
+    reader->options.usecol_indices = NULL;
+    reader->options.num_usecols = 0;
+    return reader;
+}
+
+/**
+ * @brief Read the next batch of rows
+ *
+ * Batches hold at most options->batch_rows rows and end at the first row
+ * boundary past options->batch_bytes bytes of text, whichever comes first.
+ * Reading stops after options->nrows data rows in total. Batches made only of
+ * blank or comment lines are skipped.
+ *
+ * @param reader Reader handle
+ * @return New dataframe owned by the caller, or NULL at end of file or on failure
+ */
+TablrDataFrame* tablr_csv_reader_next(TablrCsvReader* reader) {
+    if (!reader || reader->failed || reader->schema.ncols == 0) return NULL;
+
+    size_t stop;
+    while (reader->remaining > 0) {
+        size_t max_rows = reader->options.batch_rows;
+        if (max_rows == 0 || max_rows > reader->remaining) max_rows = reader->remaining;
+        if (!reader_next_range(reader, max_rows, reader->options.batch_bytes, true, &stop)) break;
+
+        TablrDataFrame* df = parse_rows(&reader->schema, reader->tok, reader->buf + reader->pos,
+                                        reader->buf + stop, &reader->options);
+        reader_consume(reader, stop);
+        if (!df) {
+            reader->failed = true;
+            return NULL;
+        }
+
+        size_t nrows = tablr_dataframe_nrows(df);
+        if (nrows > 0) {
+            reader->remaining -= nrows < reader->remaining ? nrows : reader->remaining;
+            return df;
+        }
+        tablr_dataframe_free(df);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Check whether the reader stopped because of an error
+ *
+ * @param reader Reader handle
+ * @return true if a read, parse or allocation error occurred
+ */
+bool tablr_csv_reader_failed(const TablrCsvReader* reader) {
+    return !reader || reader->failed;
+}
 
-#define MAX_LINE_LENGTH 65536  /**< Maximum CSV line length */
-#define MAX_COLUMNS 1024        /**< Maximum number of columns */
+/**
+ * @brief Close a streaming CSV reader
+ *
+ * Batches already returned stay valid.
+ *
+ * @param reader Reader handle (may be NULL)
+ */
+void tablr_csv_reader_close(TablrCsvReader* reader) {
+    if (!reader) return;
+    if (reader->file) fclose(reader->file);
+    schema_free(&reader->schema);
+    free(reader->tok);
+    free(reader->buf);
+    free(reader);
+}
 
 /**
  * @brief Read CSV file into dataframe
  * 
- * Parses a CSV file and creates a dataframe with the data. Supports custom
- * delimiters and optional header rows.
+ * Reads with inferred column types. See tablr_read_csv_opts().
  * 
  * @param filename Path to CSV file
  * @param delimiter Column delimiter character (e.g., ',' or '\t')
@@ -38,79 +1659,319 @@
  * @return New dataframe with CSV data, or NULL on failure
  */
 TablrDataFrame* tablr_read_csv(const char* filename, char delimiter, bool has_header) {
-    FILE* f = fopen(filename, "r");
-    if (!f) return NULL;
-    
-    TablrDataFrame* df = tablr_dataframe_create();
-    if (!df) {
-        fclose(f);
-        return NULL;
+    TablrCsvOptions options = tablr_csv_options_default();
+    options.delimiter = delimiter;
+    options.has_header = has_header;
+    return tablr_read_csv_opts(filename, &options);
+}
+
+/**
+ * @brief Growable output buffer for one block of formatted rows
+ */
+typedef struct {
+    char* data;    /**< Formatted text */
+    size_t len;    /**< Bytes used */
+    size_t cap;    /**< Bytes allocated */
+    bool failed;   /**< Allocation failure flag */
+} CsvBuffer;
+
+/**
+ * @brief Shared state for formatting row blocks
+ */
+typedef struct {
+    const void** data;        /**< Value buffer per column (offsets for strings) */
+    const char** chars;       /**< Character buffer per string or categorical column */
+    const int64_t** dict;     /**< Dictionary offsets per categorical column */
+    const TablrDType* types;  /**< Column types */
+    const TablrTimeUnit* units; /**< Time unit per column (timestamp columns only) */
+    TablrSeries** nullable;   /**< Column series if it has nulls, otherwise NULL */
+    size_t ncols;             /**< Number of columns */
+    size_t nrows;             /**< Number of rows */
+    char delimiter;           /**< Field delimiter */
+    size_t block_rows;        /**< Rows per block */
+    size_t first_block;       /**< Block index of buffers[0] */
+    CsvBuffer* buffers;       /**< Output buffer per block of the current wave */
+} CsvFormatJob;
+
+/**
+ * @brief Make room for extra bytes in a buffer
+ */
+static bool buffer_reserve(CsvBuffer* buf, size_t extra) {
+    if (buf->len + extra <= buf->cap) return true;
+
+    size_t new_cap = buf->cap ? buf->cap * 2 : CSV_WRITE_BUFFER_BYTES;
+    while (new_cap < buf->len + extra) new_cap *= 2;
+    char* grown = (char*)realloc(buf->data, new_cap);
+    if (!grown) {
+        buf->failed = true;
+        return false;
     }
-    
-    char line[MAX_LINE_LENGTH];
-    char* headers[MAX_COLUMNS] = {0};
-    size_t ncols = 0;
-    
-    if (has_header && fgets(line, sizeof(line), f)) {
-        char* token = strtok(line, &delimiter);
-        while (token && ncols < MAX_COLUMNS) {
-            size_t len = strlen(token);
-            if (len > 0 && token[len-1] == '\n') token[len-1] = '\0';
-            if (len > 1 && token[len-2] == '\r') token[len-2] = '\0';
-            headers[ncols++] = strdup(token);
-            token = strtok(NULL, &delimiter);
-        }
-    }
-    
-    double** col_data = (double**)calloc(ncols, sizeof(double*));
-    size_t* col_sizes = (size_t*)calloc(ncols, sizeof(size_t));
-    size_t* col_caps = (size_t*)calloc(ncols, sizeof(size_t));
-    
-    for (size_t i = 0; i < ncols; i++) {
-        col_caps[i] = 1024;
-        col_data[i] = (double*)malloc(col_caps[i] * sizeof(double));
-    }
-    
-    while (fgets(line, sizeof(line), f)) {
-        char* token = strtok(line, &delimiter);
-        size_t col = 0;
-        
-        while (token && col < ncols) {
-            if (col_sizes[col] >= col_caps[col]) {
-                col_caps[col] *= 2;
-                col_data[col] = (double*)realloc(col_data[col], col_caps[col] * sizeof(double));
-            }
-            col_data[col][col_sizes[col]++] = atof(token);
-            token = strtok(NULL, &delimiter);
-            col++;
+    buf->data = grown;
+    buf->cap = new_cap;
+    return true;
+}
+
+/**
+ * @brief Append a text field, quoting it if it contains special characters
+ *
+ * Fields containing the delimiter, a quote or a line break are enclosed in
+ * quotes with embedded quotes doubled, as in RFC 4180. An empty string is
+ * written as "" so it is not read back as null.
+ */
+static void append_text(CsvBuffer* buf, const char* text, size_t len, char delimiter) {
+    if (!buffer_reserve(buf, 2 * len + 2)) return;
+
+    bool quote = len == 0;
+    for (size_t i = 0; i < len && !quote; i++) {
+        char ch = text[i];
+        quote = ch == delimiter || ch == '"' || ch == '\n' || ch == '\r';
+    }
+    if (!quote) {
+        memcpy(buf->data + buf->len, text, len);
+        buf->len += len;
+        return;
+    }
+
+    char* p = buf->data + buf->len;
+    *p++ = '"';
+    for (size_t i = 0; i < len; i++) {
+        if (text[i] == '"') *p++ = '"';
+        *p++ = text[i];
+    }
+    *p++ = '"';
+    buf->len = (size_t)(p - buf->data);
+}
+
+/**
+ * @brief Append one value with its column's formatter
+ *
+ * A categorical value is written as its category, looked up through the
+ * dictionary offsets dict. Dates and timestamps are written as ISO-8601.
+ */
+static void append_value(CsvBuffer* buf, const void* data, const char* chars, const int64_t* dict, TablrDType dtype,
+                         TablrTimeUnit unit, size_t row, char delimiter) {
+    if (dtype == TABLR_STRING) {
+        const int64_t* offsets = (const int64_t*)data;
+        append_text(buf, chars + offsets[row], (size_t)(offsets[row + 1] - offsets[row]), delimiter);
+        return;
+    }
+    if (dtype == TABLR_CATEGORICAL) {
+        int32_t code = ((const int32_t*)data)[row];
+        append_text(buf, chars + dict[code], (size_t)(dict[code + 1] - dict[code]), delimiter);
+        return;
+    }
+    if (!buffer_reserve(buf, TABLR_FORMAT_BUFFER_SIZE)) return;
+
+    char* out = buf->data + buf->len;
+    switch (dtype) {
+        case TABLR_INT32:
+            buf->len += tablr_format_int32(((const int32_t*)data)[row], out);
+            break;
+        case TABLR_INT64:
+            buf->len += tablr_format_int64(((const int64_t*)data)[row], out);
+            break;
+        case TABLR_INT8:
+            buf->len += tablr_format_int32(((const int8_t*)data)[row], out);
+            break;
+        case TABLR_INT16:
+            buf->len += tablr_format_int32(((const int16_t*)data)[row], out);
+            break;
+        case TABLR_UINT8:
+            buf->len += tablr_format_uint64(((const uint8_t*)data)[row], out);
+            break;
+        case TABLR_UINT16:
+            buf->len += tablr_format_uint64(((const uint16_t*)data)[row], out);
+            break;
+        case TABLR_UINT32:
+            buf->len += tablr_format_uint64(((const uint32_t*)data)[row], out);
+            break;
+        case TABLR_UINT64:
+            buf->len += tablr_format_uint64(((const uint64_t*)data)[row], out);
+            break;
+        case TABLR_DATE32:
+            buf->len += tablr_format_date32(((const int32_t*)data)[row], out);
+            break;
+        case TABLR_TIMESTAMP64:
+            buf->len += tablr_format_timestamp(((const int64_t*)data)[row], unit, out);
+            break;
+        case TABLR_FLOAT32: {
+            float v = ((const float*)data)[row];
+            if (!isnan(v)) buf->len += tablr_format_float(v, out);
+            break;
         }
+        case TABLR_FLOAT64: {
+            double v = ((const double*)data)[row];
+            if (!isnan(v)) buf->len += tablr_format_double(v, out);
+            break;
+        }
+        case TABLR_BOOL:
+        case TABLR_BITMASK:
+            if (dtype == TABLR_BOOL ? ((const bool*)data)[row]
+                                    : (((const uint64_t*)data)[row / 64] >> (row % 64)) & 1) {
+                memcpy(out, "true", 4);
+                buf->len += 4;
+            } else {
+                memcpy(out, "false", 5);
+                buf->len += 5;
+            }
+            break;
+        default:
+            break;
     }
-    
-    for (size_t i = 0; i < ncols; i++) {
-        TablrSeries* s = tablr_series_create(col_data[i], col_sizes[i], TABLR_FLOAT64, TABLR_CPU);
-        char col_name[32];
-        if (headers[i]) {
-            tablr_dataframe_add_column(df, headers[i], s);
-            free(headers[i]);
+}
+
+/**
+ * @brief Format one block of rows into its buffer
+ *
+ * Nulls and missing float values are written as empty fields. A row whose
+ * only field is empty is written as "" so it is not read back as a blank line.
+ */
+static void format_block(size_t index, void* ctx) {
+    CsvFormatJob* job = (CsvFormatJob*)ctx;
+    CsvBuffer* buf = &job->buffers[index];
+    size_t begin = (job->first_block + index) * job->block_rows;
+    size_t end = begin + job->block_rows;
+    if (end > job->nrows) end = job->nrows;
+
+    buf->len = 0;
+    buf->failed = false;
+
+    for (size_t row = begin; row < end && !buf->failed; row++) {
+        size_t row_start = buf->len;
+        for (size_t col = 0; col < job->ncols; col++) {
+            if (!job->nullable[col] || tablr_series_is_valid(job->nullable[col], row)) {
+                append_value(buf, job->data[col], job->chars[col], job->dict[col], job->types[col],
+                             job->units[col], row, job->delimiter);
+            }
+            if (buffer_reserve(buf, 3)) {
+                buf->data[buf->len++] = col + 1 < job->ncols ? job->delimiter : '\n';
+            }
+        }
+        if (!buf->failed && buf->len == row_start + 1) {
+            buf->data[row_start] = '"';
+            buf->data[row_start + 1] = '"';
+            buf->data[row_start + 2] = '\n';
+            buf->len = row_start + 3;
+        }
+    }
+}
+
+/**
+ * @brief Get default CSV write options
+ *
+ * Comma delimiter, header row, blocks of 16384 rows formatted in parallel.
+ *
+ * @return Options structure with default values
+ */
+TablrCsvWriteOptions tablr_csv_write_options_default(void) {
+    TablrCsvWriteOptions options;
+    options.delimiter = ',';
+    options.write_header = true;
+    options.block_rows = CSV_WRITE_BLOCK_ROWS;
+    options.parallel = true;
+    return options;
+}
+
+/**
+ * @brief Write dataframe to CSV file with options
+ *
+ * Rows are formatted in blocks into large in-memory buffers, one typed
+ * formatter per column, and each buffer is written with a single fwrite.
+ * With options->parallel, a wave of blocks is formatted on the worker threads
+ * and then written in row order, so memory stays bounded by the wave size.
+ * Floating point values use the shortest text that reads back to the same
+ * value; missing values are written as empty fields.
+ *
+ * @param df DataFrame to write
+ * @param filename Output file path
+ * @param options Write options (NULL for defaults)
+ * @return true on success, false on failure
+ */
+bool tablr_to_csv_opts(const TablrDataFrame* df, const char* filename, const TablrCsvWriteOptions* options) {
+    if (!df || !filename) return false;
+
+    TablrCsvWriteOptions defaults = tablr_csv_write_options_default();
+    if (!options) options = &defaults;
+
+    size_t ncols = tablr_dataframe_ncols(df);
+    size_t nrows = tablr_dataframe_nrows(df);
+
+    const void** data = (const void**)calloc(ncols ? ncols : 1, sizeof(void*));
+    const char** chars = (const char**)calloc(ncols ? ncols : 1, sizeof(char*));
+    const int64_t** dict = (const int64_t**)calloc(ncols ? ncols : 1, sizeof(int64_t*));
+    TablrDType* types = (TablrDType*)calloc(ncols ? ncols : 1, sizeof(TablrDType));
+    TablrTimeUnit* units = (TablrTimeUnit*)calloc(ncols ? ncols : 1, sizeof(TablrTimeUnit));
+    TablrSeries** nullable = (TablrSeries**)calloc(ncols ? ncols : 1, sizeof(TablrSeries*));
+    bool ok = data && chars && dict && types && units && nullable;
+    for (size_t c = 0; ok && c < ncols; c++) {
+        TablrSeries* series = tablr_dataframe_column_at(df, c);
+        const TablrSeries* categories = tablr_series_categories(series);
+        data[c] = tablr_series_data_const(series);
+        chars[c] = categories ? tablr_series_string_chars(categories) : tablr_series_string_chars(series);
+        dict[c] = tablr_series_string_offsets(categories);
+        types[c] = tablr_series_dtype(series);
+        ok = nrows == 0 || (data[c] && (types[c] != TABLR_STRING || chars[c]));
+        units[c] = tablr_series_time_unit(series);
+        if (tablr_series_null_count(series) > 0) nullable[c] = series;
+    }
+
+    size_t block_rows = options->block_rows ? options->block_rows : CSV_WRITE_BLOCK_ROWS;
+    size_t nblocks = (nrows + block_rows - 1) / block_rows;
+    size_t wave = options->parallel ? (size_t)tablr_get_num_threads() * CSV_BLOCKS_PER_THREAD : 1;
+    if (wave > nblocks) wave = nblocks;
+    if (wave == 0) wave = 1;
+
+    CsvBuffer* buffers = ok ? (CsvBuffer*)calloc(wave, sizeof(CsvBuffer)) : NULL;
+    FILE* f = buffers ? fopen(filename, "wb") : NULL;
+    ok = f != NULL;
+
+    if (ok && options->write_header && ncols > 0) {
+        CsvBuffer* header = &buffers[0];
+        for (size_t c = 0; c < ncols; c++) {
+            const char* name = tablr_dataframe_column_name_at(df, c);
+            if (name) append_text(header, name, strlen(name), options->delimiter);
+            if (buffer_reserve(header, 1)) {
+                header->data[header->len++] = c + 1 < ncols ? options->delimiter : '\n';
+            }
+        }
+        ok = !header->failed && fwrite(header->data, 1, header->len, f) == header->len;
+    }
+
+    CsvFormatJob job = { data, chars, dict, types, units, nullable, ncols, nrows, options->delimiter, block_rows, 0, buffers };
+    for (size_t first = 0; ok && ncols > 0 && first < nblocks; first += wave) {
+        size_t count = nblocks - first < wave ? nblocks - first : wave;
+        job.first_block = first;
+        if (options->parallel) {
+            tablr_parallel_for(count, format_block, &job);
         } else {
-            snprintf(col_name, sizeof(col_name), "col%zu", i);
-            tablr_dataframe_add_column(df, col_name, s);
+            for (size_t i = 0; i < count; i++) format_block(i, &job);
+        }
+
+        for (size_t i = 0; ok && i < count; i++) {
+            ok = !buffers[i].failed && fwrite(buffers[i].data, 1, buffers[i].len, f) == buffers[i].len;
         }
-        free(col_data[i]);
     }
-    
-    free(col_data);
-    free(col_sizes);
-    free(col_caps);
-    fclose(f);
-    
-    return df;
+
+    if (f && fclose(f) != 0) ok = false;
+
+    for (size_t i = 0; buffers && i < wave; i++) {
+        free(buffers[i].data);
+    }
+    free(buffers);
+    free(nullable);
+    free(units);
+    free(types);
+    free(dict);
+    free(chars);
+    free(data);
+    return ok;
 }
 
 /**
  * @brief Write dataframe to CSV file
  * 
- * Writes dataframe contents to a CSV file with custom delimiter and optional header.
+ * Writes dataframe contents to a CSV file with custom delimiter and optional
+ * header. See tablr_to_csv_opts().
  * 
  * @param df DataFrame to write
  * @param filename Output file path
@@ -119,49 +1980,10 @@ TablrDataFrame* tablr_read_csv(const char* filename, char delimiter, bool has_he
  * @return true on success, false on failure
  */
 bool tablr_to_csv(const TablrDataFrame* df, const char* filename, char delimiter, bool write_header) {
-    if (!df || !filename) return false;
-    
-    FILE* f = fopen(filename, "w");
-    if (!f) return false;
-    
-    size_t ncols = tablr_dataframe_ncols(df);
-    size_t nrows = tablr_dataframe_nrows(df);
-    
-    if (write_header) {
-        size_t count;
-        char** names = tablr_dataframe_columns(df, &count);
-        for (size_t i = 0; i < count; i++) {
-            fprintf(f, "%s%c", names[i], i < count - 1 ? delimiter : '\n');
-            free(names[i]);
-        }
-        free(names);
-    }
-    
-    for (size_t row = 0; row < nrows; row++) {
-        for (size_t col = 0; col < ncols; col++) {
-            size_t count;
-            char** names = tablr_dataframe_columns(df, &count);
-            TablrSeries* s = tablr_dataframe_get_column(df, names[col]);
-            void* data = tablr_series_data(s);
-            TablrDType dtype = tablr_series_dtype(s);
-            
-            if (dtype == TABLR_INT32) {
-                fprintf(f, "%d", ((int*)data)[row]);
-            } else if (dtype == TABLR_FLOAT32) {
-                fprintf(f, "%.6f", ((float*)data)[row]);
-            } else if (dtype == TABLR_FLOAT64) {
-                fprintf(f, "%.6f", ((double*)data)[row]);
-            }
-            
-            fprintf(f, "%c", col < ncols - 1 ? delimiter : '\n');
-            
-            for (size_t i = 0; i < count; i++) free(names[i]);
-            free(names);
-        }
-    }
-    
-    fclose(f);
-    return true;
+    TablrCsvWriteOptions options = tablr_csv_write_options_default();
+    options.delimiter = delimiter;
+    options.write_header = write_header;
+    return tablr_to_csv_opts(df, filename, &options);
 }
 
 /**
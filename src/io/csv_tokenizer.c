@@ -0,0 +1,283 @@
+/**
+ * @file csv_tokenizer.c
+ * @brief Implementation of the vectorized CSV structural tokenizer
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Each window is processed in two steps. First a SIMD kernel (AVX2, SSE2 or
+ * scalar, picked at runtime) classifies every 64-byte block into quote,
+ * delimiter and newline bitmasks. Then the quote mask is turned into an
+ * "inside quotes" mask with a prefix XOR, which also handles "" escapes since
+ * they toggle twice, and the remaining delimiters and newlines are emitted as
+ * field boundaries.
+ */
+
+#include "csv_tokenizer.h"
+#include "tablr/core/cpu.h"
+#include <string.h>
+
+#ifndef _WIN32
+#include <stdatomic.h>
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HAVE_X86_SIMD
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#define HAVE_X86_SIMD
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+#define BLOCK_BYTES 64                                 /**< Bytes per bitmask block */
+#define WINDOW_BLOCKS (CSV_WINDOW_BYTES / BLOCK_BYTES)  /**< Blocks per window */
+
+/**
+ * @brief Block classifier: one bit per byte for quotes, delimiters, newlines
+ */
+typedef void (*ClassifyFunc)(const char* p, size_t nblocks, char delimiter,
+                             uint64_t* quote, uint64_t* delim, uint64_t* newline);
+
+/**
+ * @brief Portable byte-at-a-time classifier
+ */
+static void classify_scalar(const char* p, size_t nblocks, char delimiter,
+                            uint64_t* quote, uint64_t* delim, uint64_t* newline) {
+    for (size_t b = 0; b < nblocks; b++) {
+        const char* s = p + b * BLOCK_BYTES;
+        uint64_t mq = 0, md = 0, mn = 0;
+        for (int i = 0; i < BLOCK_BYTES; i++) {
+            uint64_t bit = 1ULL << i;
+            if (s[i] == '"') mq |= bit;
+            if (s[i] == delimiter) md |= bit;
+            if (s[i] == '\n') mn |= bit;
+        }
+        quote[b] = mq;
+        delim[b] = md;
+        newline[b] = mn;
+    }
+}
+
+#ifdef HAVE_X86_SIMD
+/**
+ * @brief SSE2 classifier, 16 bytes per compare
+ */
+TARGET_SSE2
+static void classify_sse2(const char* p, size_t nblocks, char delimiter,
+                          uint64_t* quote, uint64_t* delim, uint64_t* newline) {
+    const __m128i vq = _mm_set1_epi8('"');
+    const __m128i vd = _mm_set1_epi8(delimiter);
+    const __m128i vn = _mm_set1_epi8('\n');
+
+    for (size_t b = 0; b < nblocks; b++) {
+        const char* s = p + b * BLOCK_BYTES;
+        uint64_t mq = 0, md = 0, mn = 0;
+        for (int i = 0; i < 4; i++) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(s + 16 * i));
+            mq |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, vq)) << (16 * i);
+            md |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, vd)) << (16 * i);
+            mn |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, vn)) << (16 * i);
+        }
+        quote[b] = mq;
+        delim[b] = md;
+        newline[b] = mn;
+    }
+}
+
+/**
+ * @brief AVX2 classifier, 32 bytes per compare
+ */
+TARGET_AVX2
+static void classify_avx2(const char* p, size_t nblocks, char delimiter,
+                          uint64_t* quote, uint64_t* delim, uint64_t* newline) {
+    const __m256i vq = _mm256_set1_epi8('"');
+    const __m256i vd = _mm256_set1_epi8(delimiter);
+    const __m256i vn = _mm256_set1_epi8('\n');
+
+    for (size_t b = 0; b < nblocks; b++) {
+        const char* s = p + b * BLOCK_BYTES;
+        __m256i lo = _mm256_loadu_si256((const __m256i*)s);
+        __m256i hi = _mm256_loadu_si256((const __m256i*)(s + 32));
+        quote[b] = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, vq)) |
+                   (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, vq)) << 32;
+        delim[b] = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, vd)) |
+                   (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, vd)) << 32;
+        newline[b] = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, vn)) |
+                     (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, vn)) << 32;
+    }
+}
+#endif
+
+/**
+ * @brief Pick the best classifier for this CPU
+ */
+static ClassifyFunc select_classifier(void) {
+#ifdef HAVE_X86_SIMD
+    TablrSimdLevel level = tablr_cpu_simd_level();
+    if (level >= TABLR_SIMD_AVX2) return classify_avx2;
+    if (level >= TABLR_SIMD_SSE2) return classify_sse2;
+#endif
+    return classify_scalar;
+}
+
+#ifdef _WIN32
+static volatile ClassifyFunc classify = NULL;
+#else
+static _Atomic(ClassifyFunc) classify = NULL;
+#endif
+
+/**
+ * @brief Get the classifier, selecting it on first use
+ *
+ * Concurrent first calls select and store the same function, so the
+ * pointer only needs to be atomic, not ordered.
+ */
+static ClassifyFunc classifier(void) {
+#ifdef _WIN32
+    ClassifyFunc selected = classify;
+    if (!selected) classify = selected = select_classifier();
+#else
+    ClassifyFunc selected = atomic_load_explicit(&classify, memory_order_relaxed);
+    if (!selected) {
+        selected = select_classifier();
+        atomic_store_explicit(&classify, selected, memory_order_relaxed);
+    }
+#endif
+    return selected;
+}
+
+/**
+ * @brief Running XOR of all lower bits: 1 between an opening and closing quote
+ */
+static uint64_t prefix_xor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+/**
+ * @brief Index of lowest set bit of a nonzero value
+ */
+static int trailing_zeroes(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(v);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return (int)index;
+#else
+    int n = 0;
+    while (!(v & 1)) {
+        v >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/**
+ * @brief Start tokenizing a range
+ *
+ * @param t Tokenizer state
+ * @param begin First byte
+ * @param end One past last byte
+ * @param delimiter Field delimiter
+ */
+void tablr_csv_tokenizer_init(TablrCsvTokenizer* t, const char* begin, const char* end, char delimiter) {
+    t->pos = begin;
+    t->end = end;
+    t->window = begin;
+    t->field = begin;
+    t->in_quote = 0;
+    t->count = 0;
+    t->next = 0;
+    t->row_open = false;
+    t->delimiter = delimiter;
+}
+
+/**
+ * @brief Scan the next window
+ *
+ * Full blocks are classified in place; a trailing partial block is copied
+ * into a padded buffer so kernels never read past the input.
+ *
+ * @param t Tokenizer state
+ */
+void tablr_csv_tokenizer_fill(TablrCsvTokenizer* t) {
+    uint64_t quote[WINDOW_BLOCKS];
+    uint64_t delim[WINDOW_BLOCKS];
+    uint64_t newline[WINDOW_BLOCKS];
+
+    size_t len = (size_t)(t->end - t->pos);
+    if (len > CSV_WINDOW_BYTES) len = CSV_WINDOW_BYTES;
+
+    size_t full = len / BLOCK_BYTES;
+    size_t tail = len % BLOCK_BYTES;
+    ClassifyFunc classify_blocks = classifier();
+    classify_blocks(t->pos, full, t->delimiter, quote, delim, newline);
+
+    size_t nblocks = full;
+    if (tail > 0) {
+        char padded[BLOCK_BYTES];
+        memset(padded, 0, sizeof(padded));
+        memcpy(padded, t->pos + full * BLOCK_BYTES, tail);
+        classify_blocks(padded, 1, t->delimiter, &quote[full], &delim[full], &newline[full]);
+
+        uint64_t valid = (1ULL << tail) - 1;
+        quote[full] &= valid;
+        delim[full] &= valid;
+        newline[full] &= valid;
+        nblocks++;
+    }
+
+    uint64_t carry = t->in_quote;
+    size_t n = 0;
+    for (size_t b = 0; b < nblocks; b++) {
+        uint64_t inside = prefix_xor(quote[b]) ^ carry;
+        carry = 0 - (inside >> 63);
+
+        uint64_t rows = newline[b] & ~inside;
+        uint64_t structural = (delim[b] & ~inside) | rows;
+        uint32_t base = (uint32_t)(b * BLOCK_BYTES);
+
+        while (structural) {
+            int bit = trailing_zeroes(structural);
+            uint32_t flag = ((rows >> bit) & 1) ? CSV_TOKEN_ROW_END : 0;
+            t->tokens[n++] = (base + (uint32_t)bit) | flag;
+            structural &= structural - 1;
+        }
+    }
+
+    t->in_quote = carry;
+    t->window = t->pos;
+    t->pos += len;
+    t->count = n;
+    t->next = 0;
+}
+
+/**
+ * @brief Count quote characters
+ *
+ * @param begin First byte
+ * @param end One past last byte
+ * @return Number of '"' bytes in the range
+ */
+size_t tablr_csv_count_quotes(const char* begin, const char* end) {
+    size_t n = 0;
+    const char* p = begin;
+    while (p < end) {
+        p = (const char*)memchr(p, '"', (size_t)(end - p));
+        if (!p) break;
+        n++;
+        p++;
+    }
+    return n;
+}
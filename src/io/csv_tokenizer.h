@@ -0,0 +1,127 @@
+/**
+ * @file csv_tokenizer.h
+ * @brief Internal vectorized CSV structural tokenizer
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Not part of the public API. The tokenizer scans input in windows of 64-byte
+ * blocks, classifying delimiters, quotes and newlines with SIMD compares and
+ * masking out everything inside RFC 4180 quoted fields. Field boundaries are
+ * then handed out one at a time by tablr_csv_next_field().
+ */
+
+#ifndef TABLR_IO_CSV_TOKENIZER_H
+#define TABLR_IO_CSV_TOKENIZER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CSV_WINDOW_BYTES 4096u          /**< Bytes scanned per window */
+#define CSV_TOKEN_ROW_END 0x80000000u   /**< Token flag: field ends a row */
+
+/**
+ * @brief Tokenizer state over one contiguous input range
+ *
+ * The range must start outside a quoted field.
+ */
+typedef struct {
+    const char* pos;        /**< Next byte to scan */
+    const char* end;        /**< End of input */
+    const char* window;     /**< Base of the current window */
+    const char* field;      /**< Start of the next field */
+    uint64_t in_quote;      /**< All ones if scanning inside quotes */
+    size_t count;           /**< Tokens in the current window */
+    size_t next;            /**< Next token to hand out */
+    bool row_open;          /**< A field has been returned since the last row end */
+    char delimiter;         /**< Field delimiter */
+    uint32_t tokens[CSV_WINDOW_BYTES];  /**< Window offsets, CSV_TOKEN_ROW_END for newlines */
+} TablrCsvTokenizer;
+
+/**
+ * @brief Start tokenizing [begin, end)
+ * @param t Tokenizer state
+ * @param begin First byte (outside quotes)
+ * @param end One past last byte
+ * @param delimiter Field delimiter
+ */
+void tablr_csv_tokenizer_init(TablrCsvTokenizer* t, const char* begin, const char* end, char delimiter);
+
+/**
+ * @brief Scan the next window of input into t->tokens
+ * @param t Tokenizer state
+ */
+void tablr_csv_tokenizer_fill(TablrCsvTokenizer* t);
+
+/**
+ * @brief Return the next raw field
+ *
+ * The field still contains its quotes and, for the last field of a row, any
+ * trailing '\r'. An input that does not end with a newline yields a final row.
+ *
+ * @param t Tokenizer state
+ * @param begin Output field start
+ * @param end Output field end
+ * @param row_end Output flag set when the field is the last of its row
+ * @return false when the input is exhausted
+ */
+static inline bool tablr_csv_next_field(TablrCsvTokenizer* t, const char** begin,
+                                        const char** end, bool* row_end) {
+    while (t->next == t->count) {
+        if (t->pos >= t->end) {
+            if (t->field < t->end || t->row_open) {
+                *begin = t->field;
+                *end = t->end;
+                *row_end = true;
+                t->field = t->end;
+                t->row_open = false;
+                return true;
+            }
+            return false;
+        }
+        tablr_csv_tokenizer_fill(t);
+    }
+
+    uint32_t tok = t->tokens[t->next++];
+    const char* p = t->window + (tok & ~CSV_TOKEN_ROW_END);
+    *begin = t->field;
+    *end = p;
+    *row_end = (tok & CSV_TOKEN_ROW_END) != 0;
+    t->field = p + 1;
+    t->row_open = !*row_end;
+    return true;
+}
+
+/**
+ * @brief Skip to the start of the next row
+ * @param t Tokenizer state
+ * @return false when the input is exhausted
+ */
+static inline bool tablr_csv_skip_row(TablrCsvTokenizer* t) {
+    const char* b;
+    const char* e;
+    bool row_end = false;
+    while (!row_end) {
+        if (!tablr_csv_next_field(t, &b, &e, &row_end)) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Current read position (start of the next field)
+ * @param t Tokenizer state
+ * @return Pointer to the next unconsumed byte
+ */
+static inline const char* tablr_csv_tokenizer_position(const TablrCsvTokenizer* t) {
+    return t->field;
+}
+
+/**
+ * @brief Count quote characters in [begin, end)
+ * @param begin First byte
+ * @param end One past last byte
+ * @return Number of '"' bytes
+ */
+size_t tablr_csv_count_quotes(const char* begin, const char* end);
+
+#endif /* TABLR_IO_CSV_TOKENIZER_H */
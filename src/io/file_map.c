@@ -0,0 +1,139 @@
+/**
+ * @file file_map.c
+ * @brief Implementation of memory-mapped file helper
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * This file wraps mmap (POSIX) and file mapping objects (Windows) behind a
+ * small interface used by the file readers.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "file_map.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Map a whole file read-only or copy-on-write
+ *
+ * Empty files succeed with a NULL data pointer since zero-length mappings are
+ * not portable.
+ */
+static bool map_file(TablrFileMap* map, const char* filename, bool copy_on_write) {
+    if (!map || !filename) return false;
+
+    map->data = NULL;
+    map->size = 0;
+    map->handle = NULL;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) return false;
+
+    void* data = MapViewOfFile(mapping, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    map->data = (const char*)data;
+    map->size = (size_t)size.QuadPart;
+    map->handle = mapping;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return true;
+    }
+
+    int prot = copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* data = mmap(NULL, (size_t)st.st_size, prot, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    /* Readers that scan the whole file benefit from early readahead; columnar
+       loads touch only the pages they use */
+    if (!copy_on_write) posix_madvise(data, (size_t)st.st_size, POSIX_MADV_WILLNEED);
+
+    map->data = (const char*)data;
+    map->size = (size_t)st.st_size;
+#endif
+
+    return true;
+}
+
+/**
+ * @brief Map a file into memory
+ *
+ * Maps the whole file read-only.
+ *
+ * @param map Output mapping
+ * @param filename Path to file
+ * @return true on success, false on failure
+ */
+bool tablr_file_map_open(TablrFileMap* map, const char* filename) {
+    return map_file(map, filename, false);
+}
+
+/**
+ * @brief Map a file into memory with copy-on-write pages
+ *
+ * @param map Output mapping
+ * @param filename Path to file
+ * @return true on success, false on failure
+ */
+bool tablr_file_map_open_private(TablrFileMap* map, const char* filename) {
+    return map_file(map, filename, true);
+}
+
+/**
+ * @brief Unmap a file
+ *
+ * @param map Mapping to release (can be empty)
+ */
+void tablr_file_map_close(TablrFileMap* map) {
+    if (!map) return;
+
+#ifdef _WIN32
+    if (map->data) UnmapViewOfFile(map->data);
+    if (map->handle) CloseHandle((HANDLE)map->handle);
+#else
+    if (map->data) munmap((void*)map->data, map->size);
+#endif
+
+    map->data = NULL;
+    map->size = 0;
+    map->handle = NULL;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file file_map.h
+ * @brief Internal memory-mapped file helper
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Not part of the public API. Used by the file readers in src/io.
+ */
+
+#ifndef TABLR_IO_FILE_MAP_H
+#define TABLR_IO_FILE_MAP_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Read-only view of an entire file
+ */
+typedef struct {
+    const char* data;  /**< Mapped bytes (NULL for empty files) */
+    size_t size;       /**< File size in bytes */
+    void* handle;      /**< Platform mapping handle */
+} TablrFileMap;
+
+/**
+ * @brief Map a file into memory for reading
+ * @param map Output mapping
+ * @param filename Path to file
+ * @return true on success (including empty files), false on failure
+ */
+bool tablr_file_map_open(TablrFileMap* map, const char* filename);
+
+/**
+ * @brief Map a file into memory with private copy-on-write pages
+ *
+ * The mapping may be written through a cast; written pages become private
+ * copies and the file itself is never modified.
+ *
+ * @param map Output mapping
+ * @param filename Path to file
+ * @return true on success (including empty files), false on failure
+ */
+bool tablr_file_map_open_private(TablrFileMap* map, const char* filename);
+
+/**
+ * @brief Unmap a file previously mapped with tablr_file_map_open
+ * @param map Mapping to release
+ */
+void tablr_file_map_close(TablrFileMap* map);
+
+#endif /* TABLR_IO_FILE_MAP_H */
@@ -0,0 +1,486 @@
+/**
+ * @file format.c
+ * @brief Implementation of locale-independent numeric formatting
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * This file implements number to text conversion for text export. Floating
+ * point values are converted with the Schubfach algorithm, which like Ryu
+ * finds the shortest decimal that rounds back to the same binary value using
+ * a single 128-bit power-of-ten table and no big integer arithmetic. Digits
+ * are written two at a time from a lookup table.
+ *
+ * Output matches the shortest "repr" style: fixed notation for decimal
+ * exponents in [-4, 16), scientific notation otherwise, and a trailing ".0"
+ * on integral values so they read back as floating point. Dates and
+ * timestamps are written in ISO-8601 form.
+ */
+
+#include "tablr/io/format.h"
+#include "pow10_table.h"
+#include "calendar.h"
+#include <string.h>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#define DOUBLE_MANTISSA_BITS 52   /**< Explicit double mantissa bits */
+#define DOUBLE_EXPONENT_BIAS 1075 /**< Double bias including mantissa shift */
+#define FLOAT_MANTISSA_BITS 23    /**< Explicit float mantissa bits */
+#define FLOAT_EXPONENT_BIAS 150   /**< Float bias including mantissa shift */
+#define FIXED_MIN_EXP (-4)        /**< Smallest exponent printed in fixed notation */
+#define FIXED_MAX_EXP 16          /**< Exponents from here on use scientific notation */
+
+/**
+ * @brief Two-digit strings "00" to "99"
+ */
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/**
+ * @brief 128-bit unsigned product
+ */
+typedef struct {
+    uint64_t low;   /**< Low 64 bits */
+    uint64_t high;  /**< High 64 bits */
+} U128;
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 uint128_native;
+#endif
+
+/**
+ * @brief Full 64x64 -> 128-bit multiplication
+ */
+static U128 full_mul(uint64_t a, uint64_t b) {
+    U128 r;
+#if defined(__SIZEOF_INT128__)
+    uint128_native p = (uint128_native)a * b;
+    r.low = (uint64_t)p;
+    r.high = (uint64_t)(p >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    r.low = _umul128(a, b, &r.high);
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    r.high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    r.low = (cross << 32) | (uint32_t)lo_lo;
+#endif
+    return r;
+}
+
+/**
+ * @brief floor(e * log10(2)) for |e| <= 2620
+ */
+static int floor_log10_pow2(int e) {
+    return (e * 1262611) >> 22;
+}
+
+/**
+ * @brief floor(e * log10(2) + log10(3/4)) for |e| <= 2620
+ */
+static int floor_log10_three_quarters_pow2(int e) {
+    return (e * 1262611 - 524031) >> 22;
+}
+
+/**
+ * @brief floor(e * log2(10)) for |e| <= 1233
+ */
+static int floor_log2_pow10(int e) {
+    return (e * 1741647) >> 19;
+}
+
+/**
+ * @brief floor(g * cp / 2^128), with the lowest bit set if inexact
+ */
+static uint64_t round_to_odd(const uint64_t* g, uint64_t cp) {
+    U128 x = full_mul(g[1], cp);
+    U128 y = full_mul(g[0], cp);
+    uint64_t z = y.low + x.high;
+    uint64_t y1 = y.high + (z < y.low);
+    return y1 | (z > 1);
+}
+
+/**
+ * @brief Shortest decimal in the rounding interval of c * 2^q
+ *
+ * @param c Binary significand including the hidden bit
+ * @param q Binary exponent
+ * @param lower_closer Whether the next smaller value is half as far away
+ *                     (c is a power of two at an exponent boundary)
+ * @param digits Decimal significand
+ * @param exponent Decimal exponent
+ */
+static void to_decimal(uint64_t c, int q, bool lower_closer, uint64_t* digits, int* exponent) {
+    bool accept_bounds = (c & 1) == 0;
+
+    uint64_t cb = c << 2;
+    uint64_t cbl = cb - 2 + (lower_closer ? 1 : 0);
+    uint64_t cbr = cb + 2;
+
+    int k = lower_closer ? floor_log10_three_quarters_pow2(q) : floor_log10_pow2(q);
+    int h = q + floor_log2_pow10(-k) + 1;
+    const uint64_t* g = &pow10_table[2 * (-k - POW10_MIN_EXP)];
+
+    uint64_t vbl = round_to_odd(g, cbl << h);
+    uint64_t vb = round_to_odd(g, cb << h);
+    uint64_t vbr = round_to_odd(g, cbr << h);
+
+    uint64_t lower = vbl + (accept_bounds ? 0 : 1);
+    uint64_t upper = vbr - (accept_bounds ? 0 : 1);
+
+    /* Try one digit fewer first */
+    uint64_t s = vb >> 2;
+    if (s >= 10) {
+        uint64_t sp = s / 10;
+        bool up_inside = lower <= 40 * sp;
+        bool wp_inside = 40 * sp + 40 <= upper;
+        if (up_inside != wp_inside) {
+            *digits = sp + (wp_inside ? 1 : 0);
+            *exponent = k + 1;
+            return;
+        }
+    }
+
+    bool u_inside = lower <= 4 * s;
+    bool w_inside = 4 * s + 4 <= upper;
+    if (u_inside != w_inside) {
+        *digits = s + (w_inside ? 1 : 0);
+        *exponent = k;
+        return;
+    }
+
+    /* Both candidates are inside, pick the closer one, ties to even */
+    uint64_t mid = 4 * s + 2;
+    bool round_up = vb > mid || (vb == mid && (s & 1) != 0);
+    *digits = s + (round_up ? 1 : 0);
+    *exponent = k;
+}
+
+/**
+ * @brief Number of decimal digits of v
+ */
+static int decimal_length(uint64_t v) {
+    int n = 1;
+    while (v >= 100) {
+        v /= 100;
+        n += 2;
+    }
+    return n + (v >= 10 ? 1 : 0);
+}
+
+/**
+ * @brief Write exactly n digits of v ending at out + n
+ */
+static void write_digits(uint64_t v, char* out, int n) {
+    char* p = out + n;
+    while (v >= 100) {
+        const char* pair = &digit_pairs[(v % 100) * 2];
+        v /= 100;
+        *--p = pair[1];
+        *--p = pair[0];
+    }
+    if (v >= 10) {
+        const char* pair = &digit_pairs[v * 2];
+        *--p = pair[1];
+        *--p = pair[0];
+    } else {
+        *--p = (char)('0' + v);
+    }
+}
+
+/**
+ * @brief Write v as exactly n digits, padded with leading zeros
+ */
+static void write_padded(uint64_t v, char* out, int n) {
+    for (int i = n - 1; i >= 0; i--) {
+        out[i] = (char)('0' + v % 10);
+        v /= 10;
+    }
+}
+
+/**
+ * @brief Lay out digits * 10^exponent in fixed or scientific notation
+ */
+static size_t write_decimal(uint64_t digits, int exponent, bool negative, char* buf) {
+    while (digits >= 10 && digits % 10 == 0) {
+        digits /= 10;
+        exponent++;
+    }
+
+    char text[20];
+    int n = decimal_length(digits);
+    write_digits(digits, text, n);
+
+    char* p = buf;
+    if (negative) *p++ = '-';
+
+    int point = n + exponent;      /* Digits before the decimal point */
+    int sci = point - 1;           /* Exponent in scientific notation */
+
+    if (sci >= FIXED_MIN_EXP && sci < FIXED_MAX_EXP) {
+        if (point <= 0) {
+            *p++ = '0';
+            *p++ = '.';
+            for (int i = point; i < 0; i++) *p++ = '0';
+            memcpy(p, text, (size_t)n);
+            p += n;
+        } else if (point >= n) {
+            memcpy(p, text, (size_t)n);
+            p += n;
+            for (int i = n; i < point; i++) *p++ = '0';
+            *p++ = '.';
+            *p++ = '0';
+        } else {
+            memcpy(p, text, (size_t)point);
+            p += point;
+            *p++ = '.';
+            memcpy(p, text + point, (size_t)(n - point));
+            p += n - point;
+        }
+    } else {
+        *p++ = text[0];
+        if (n > 1) {
+            *p++ = '.';
+            memcpy(p, text + 1, (size_t)(n - 1));
+            p += n - 1;
+        }
+        *p++ = 'e';
+        *p++ = sci < 0 ? '-' : '+';
+        unsigned e = (unsigned)(sci < 0 ? -sci : sci);
+        if (e >= 100) {
+            *p++ = (char)('0' + e / 100);
+            e %= 100;
+        }
+        *p++ = digit_pairs[e * 2];
+        *p++ = digit_pairs[e * 2 + 1];
+    }
+
+    *p = '\0';
+    return (size_t)(p - buf);
+}
+
+/**
+ * @brief Write a special value (zero, infinity or NaN)
+ */
+static size_t write_special(const char* text, bool negative, char* buf) {
+    size_t len = 0;
+    if (negative) buf[len++] = '-';
+    size_t n = strlen(text);
+    memcpy(buf + len, text, n + 1);
+    return len + n;
+}
+
+/**
+ * @brief Format a double with the fewest digits that parse back to the same value
+ *
+ * NaN is written as "nan" and infinities as "inf" or "-inf".
+ *
+ * @param value Value to format
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_format_double(double value, char* buf) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    bool negative = (bits >> 63) != 0;
+    uint64_t fraction = bits & ((1ULL << DOUBLE_MANTISSA_BITS) - 1);
+    int biased = (int)((bits >> DOUBLE_MANTISSA_BITS) & 0x7FF);
+
+    if (biased == 0x7FF) return write_special(fraction ? "nan" : "inf", negative && !fraction, buf);
+    if (biased == 0 && fraction == 0) return write_special("0.0", negative, buf);
+
+    uint64_t c;
+    int q;
+    if (biased == 0) {
+        c = fraction;
+        q = 1 - DOUBLE_EXPONENT_BIAS;
+    } else {
+        c = fraction | (1ULL << DOUBLE_MANTISSA_BITS);
+        q = biased - DOUBLE_EXPONENT_BIAS;
+
+        /* Small integers are their own shortest representation */
+        if (q <= 0 && q > -DOUBLE_MANTISSA_BITS - 1 && (c & ((1ULL << -q) - 1)) == 0) {
+            return write_decimal(c >> -q, 0, negative, buf);
+        }
+    }
+
+    uint64_t digits;
+    int exponent;
+    to_decimal(c, q, fraction == 0 && biased > 1, &digits, &exponent);
+    return write_decimal(digits, exponent, negative, buf);
+}
+
+/**
+ * @brief Format a float with the fewest digits that parse back to the same value
+ *
+ * @param value Value to format
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_format_float(float value, char* buf) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    bool negative = (bits >> 31) != 0;
+    uint32_t fraction = bits & ((1u << FLOAT_MANTISSA_BITS) - 1);
+    int biased = (int)((bits >> FLOAT_MANTISSA_BITS) & 0xFF);
+
+    if (biased == 0xFF) return write_special(fraction ? "nan" : "inf", negative && !fraction, buf);
+    if (biased == 0 && fraction == 0) return write_special("0.0", negative, buf);
+
+    uint64_t c;
+    int q;
+    if (biased == 0) {
+        c = fraction;
+        q = 1 - FLOAT_EXPONENT_BIAS;
+    } else {
+        c = fraction | (1u << FLOAT_MANTISSA_BITS);
+        q = biased - FLOAT_EXPONENT_BIAS;
+
+        if (q <= 0 && q > -FLOAT_MANTISSA_BITS - 1 && (c & ((1ULL << -q) - 1)) == 0) {
+            return write_decimal(c >> -q, 0, negative, buf);
+        }
+    }
+
+    uint64_t digits;
+    int exponent;
+    to_decimal(c, q, fraction == 0 && biased > 1, &digits, &exponent);
+    return write_decimal(digits, exponent, negative, buf);
+}
+
+/**
+ * @brief Format a signed decimal integer
+ *
+ * @param value Value to format
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_format_int64(int64_t value, char* buf) {
+    size_t len = 0;
+    uint64_t magnitude = (uint64_t)value;
+    if (value < 0) {
+        buf[len++] = '-';
+        magnitude = 0 - magnitude;
+    }
+
+    int n = decimal_length(magnitude);
+    write_digits(magnitude, buf + len, n);
+    len += (size_t)n;
+    buf[len] = '\0';
+    return len;
+}
+
+/**
+ * @brief Format a signed decimal integer
+ *
+ * @param value Value to format
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_format_int32(int32_t value, char* buf) {
+    return tablr_format_int64(value, buf);
+}
+
+/**
+ * @brief Format an unsigned decimal integer
+ *
+ * @param value Value to format
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_format_uint64(uint64_t value, char* buf) {
+    int n = decimal_length(value);
+    write_digits(value, buf, n);
+    buf[n] = '\0';
+    return (size_t)n;
+}
+
+/**
+ * @brief Write the YYYY-MM-DD of a day count
+ *
+ * Years before 0 get a '-' sign and years after 9999 more digits.
+ *
+ * @return Number of characters written
+ */
+static size_t write_date(int64_t days, char* buf) {
+    int64_t year;
+    unsigned month, day;
+    calendar_civil_from_days(days, &year, &month, &day);
+
+    size_t len = 0;
+    uint64_t magnitude = (uint64_t)year;
+    if (year < 0) {
+        buf[len++] = '-';
+        magnitude = 0 - magnitude;
+    }
+    int n = decimal_length(magnitude);
+    if (n < 4) n = 4;
+    write_padded(magnitude, buf + len, n);
+    len += (size_t)n;
+
+    buf[len++] = '-';
+    write_padded(month, buf + len, 2);
+    buf[len + 2] = '-';
+    write_padded(day, buf + len + 3, 2);
+    return len + 5;
+}
+
+/**
+ * @brief Format a date as ISO-8601 YYYY-MM-DD
+ *
+ * @param days Days since 1970-01-01
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_format_date32(int32_t days, char* buf) {
+    size_t len = write_date(days, buf);
+    buf[len] = '\0';
+    return len;
+}
+
+/**
+ * @brief Format a timestamp as ISO-8601 YYYY-MM-DDTHH:MM:SS
+ *
+ * A fraction with the unit's digits (3, 6 or 9) follows the seconds unless
+ * it is zero. No zone is written; values are UTC.
+ *
+ * @param value Time since 1970-01-01T00:00:00 UTC in unit
+ * @param unit Resolution of value
+ * @param buf Output buffer of at least TABLR_FORMAT_BUFFER_SIZE bytes
+ * @return Number of characters written, excluding the NUL terminator
+ */
+size_t tablr_format_timestamp(int64_t value, TablrTimeUnit unit, char* buf) {
+    int64_t per_second = tablr_time_unit_per_second(unit);
+    int64_t seconds = calendar_floor_div(value, per_second);
+    int64_t fraction = value - seconds * per_second;
+    int64_t days = calendar_floor_div(seconds, CALENDAR_SECONDS_PER_DAY);
+    int64_t second_of_day = seconds - days * CALENDAR_SECONDS_PER_DAY;
+
+    size_t len = write_date(days, buf);
+    buf[len++] = 'T';
+    write_padded((uint64_t)(second_of_day / 3600), buf + len, 2);
+    buf[len + 2] = ':';
+    write_padded((uint64_t)(second_of_day / 60 % 60), buf + len + 3, 2);
+    buf[len + 5] = ':';
+    write_padded((uint64_t)(second_of_day % 60), buf + len + 6, 2);
+    len += 8;
+
+    if (fraction != 0) {
+        int digits = unit == TABLR_TIME_NANOSECOND ? 9 : unit == TABLR_TIME_MICROSECOND ? 6 : 3;
+        buf[len++] = '.';
+        write_padded((uint64_t)fraction, buf + len, digits);
+        len += (size_t)digits;
+    }
+    buf[len] = '\0';
+    return len;
+}
@@ -0,0 +1,2203 @@
+/**
+ * @file parquet.c
+ * @brief Implementation of Apache Parquet reading and writing
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Supports flat schemas of BOOLEAN, INT32, INT64, FLOAT, DOUBLE and
+ * BYTE_ARRAY columns, which map to the Tablr dtypes one to one (BYTE_ARRAY
+ * becomes STRING) unless their converted or logical type says otherwise:
+ * INT_8/16, UINT_8/16/32/64, DATE and TIMESTAMP annotations map to the
+ * compact integer, date and timestamp dtypes. Reading handles PLAIN, PLAIN_DICTIONARY/RLE_DICTIONARY and
+ * RLE (booleans) values, RLE definition levels, data page v1 and v2, and
+ * uncompressed, snappy and zstd pages. Nulls are marked null in the series
+ * and stored as NaN for floats, empty strings and zero/false otherwise.
+ *
+ * The file is memory-mapped and every (row group, column) chunk is decoded
+ * as an independent task straight into its slice of the output column, so
+ * row groups decode in parallel. String chunks are decoded into row lengths
+ * and characters of their own, which are stitched into the column once all
+ * tasks finish, since the character offsets are only known then. Row groups
+ * whose min/max statistics rule out the filter range are never touched.
+ *
+ * Writing encodes the columns of each row group in parallel into memory,
+ * then appends the chunks in order. Every column is OPTIONAL so nulls and NaN
+ * round-trip as nulls; strings with repeated values are dictionary-encoded.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "tablr/io/parquet.h"
+#include "tablr/core/categorical.h"
+#include "tablr/ops/bitmask.h"
+#include "tablr/core/parallel.h"
+#include "file_map.h"
+#include "thrift.h"
+#include "compress.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#define PQ_MAGIC "PAR1"                         /**< Leading and trailing file signature */
+#define PQ_MAGIC_LEN 4                          /**< Signature length */
+#define PQ_DEFAULT_ROW_GROUP_ROWS (1u << 20)    /**< Default rows per written row group */
+#define PQ_PAGE_BYTES (1u << 20)                /**< Target uncompressed size of written pages */
+#define PQ_DICT_MAX_BYTES (1u << 20)            /**< Largest dictionary the writer builds */
+#define PQ_TEXT_BYTES 4096                      /**< Initial string chunk character capacity */
+#define PQ_CREATED_BY "tablr version 0.0.1"     /**< Writer identification */
+
+/**
+ * @brief Parquet physical types
+ */
+enum {
+    PQ_BOOLEAN = 0,
+    PQ_INT32 = 1,
+    PQ_INT64 = 2,
+    PQ_INT96 = 3,
+    PQ_FLOAT = 4,
+    PQ_DOUBLE = 5,
+    PQ_BYTE_ARRAY = 6,
+    PQ_FIXED_LEN_BYTE_ARRAY = 7
+};
+
+/**
+ * @brief Field repetition types
+ */
+enum {
+    PQ_REQUIRED = 0,
+    PQ_OPTIONAL = 1,
+    PQ_REPEATED = 2
+};
+
+/**
+ * @brief Value and level encodings
+ */
+enum {
+    PQ_PLAIN = 0,
+    PQ_PLAIN_DICTIONARY = 2,
+    PQ_RLE = 3,
+    PQ_BIT_PACKED = 4,
+    PQ_RLE_DICTIONARY = 8
+};
+
+/**
+ * @brief Compression codecs
+ */
+enum {
+    PQ_CODEC_UNCOMPRESSED = 0,
+    PQ_CODEC_SNAPPY = 1,
+    PQ_CODEC_ZSTD = 6
+};
+
+/**
+ * @brief Page types
+ */
+enum {
+    PQ_DATA_PAGE = 0,
+    PQ_INDEX_PAGE = 1,
+    PQ_DICTIONARY_PAGE = 2,
+    PQ_DATA_PAGE_V2 = 3
+};
+
+/**
+ * @brief Converted types (legacy logical annotations)
+ */
+enum {
+    PQ_CONVERTED_UTF8 = 0,
+    PQ_CONVERTED_DATE = 6,
+    PQ_CONVERTED_TIMESTAMP_MILLIS = 9,
+    PQ_CONVERTED_TIMESTAMP_MICROS = 10,
+    PQ_CONVERTED_UINT_8 = 11,
+    PQ_CONVERTED_UINT_16 = 12,
+    PQ_CONVERTED_UINT_32 = 13,
+    PQ_CONVERTED_UINT_64 = 14,
+    PQ_CONVERTED_INT_8 = 15,
+    PQ_CONVERTED_INT_16 = 16
+};
+
+/**
+ * @brief Field ids of the LogicalType union and TimeUnit union used here
+ */
+enum {
+    PQ_LOGICAL_TIMESTAMP = 8,
+    PQ_TIME_MILLIS = 1,
+    PQ_TIME_MICROS = 2,
+    PQ_TIME_NANOS = 3
+};
+
+/**
+ * @brief Borrowed byte range
+ */
+typedef struct {
+    const uint8_t* data;
+    uint32_t len;
+} PqBytes;
+
+/**
+ * @brief Schema element (flat schemas only use name, type, repetition and annotations)
+ */
+typedef struct {
+    char* name;            /**< Column name */
+    int32_t type;          /**< Physical type, -1 for groups */
+    int32_t repetition;    /**< Repetition type */
+    int32_t num_children;  /**< Children of a group, 0 for leaves */
+    int32_t converted;     /**< Converted type, -1 if absent */
+    int32_t time_unit;     /**< PQ_TIME_* of a logical timestamp, 0 if absent */
+} PqSchemaElement;
+
+/**
+ * @brief Column chunk metadata
+ */
+typedef struct {
+    int32_t type;                    /**< Physical type */
+    int32_t codec;                   /**< Compression codec */
+    int64_t num_values;              /**< Values including nulls */
+    int64_t total_compressed_size;   /**< Bytes of all pages including headers */
+    int64_t data_page_offset;        /**< First data page */
+    int64_t dictionary_page_offset;  /**< Dictionary page, -1 if none */
+    PqBytes min;                     /**< Plain-encoded minimum (len 0 if absent) */
+    PqBytes max;                     /**< Plain-encoded maximum (len 0 if absent) */
+} PqColumnChunk;
+
+/**
+ * @brief Row group metadata
+ */
+typedef struct {
+    int64_t num_rows;         /**< Rows in the group */
+    PqColumnChunk* columns;   /**< One chunk per leaf column */
+    size_t ncols;             /**< Number of chunks */
+} PqRowGroup;
+
+/**
+ * @brief Decoded file footer
+ */
+typedef struct {
+    PqSchemaElement* schema;  /**< Schema in depth-first order, root first */
+    size_t nschema;           /**< Number of schema elements */
+    PqRowGroup* groups;       /**< Row groups */
+    size_t ngroups;           /**< Number of row groups */
+} PqFileMeta;
+
+/**
+ * @brief Page header fields used by the reader
+ */
+typedef struct {
+    int32_t type;               /**< Page type */
+    int32_t uncompressed_size;  /**< Page size after decompression */
+    int32_t compressed_size;    /**< Page size in the file */
+    int32_t num_values;         /**< Values including nulls */
+    int32_t encoding;           /**< Value encoding */
+    int32_t def_encoding;       /**< Definition level encoding (v1) */
+    int32_t def_length;         /**< Definition level bytes (v2) */
+    int32_t rep_length;         /**< Repetition level bytes (v2) */
+    bool is_compressed;         /**< Whether v2 values are compressed */
+} PqPageHeader;
+
+/* ===================== Shared helpers ===================== */
+
+static bool host_little_endian(void) {
+    const uint16_t probe = 1;
+    uint8_t first;
+    memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+/**
+ * @brief Copy little-endian values of the given width into host order
+ */
+static void copy_le(void* dst, const void* src, size_t count, size_t width) {
+    memcpy(dst, src, count * width);
+    if (host_little_endian()) return;
+    uint8_t* p = (uint8_t*)dst;
+    for (size_t i = 0; i < count; i++, p += width) {
+        for (size_t a = 0, b = width - 1; a < b; a++, b--) {
+            uint8_t t = p[a];
+            p[a] = p[b];
+            p[b] = t;
+        }
+    }
+}
+
+static uint32_t load_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void store_le32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief Number of bits needed to represent max_value
+ */
+static int bit_width(uint32_t max_value) {
+    int width = 0;
+    while (max_value) {
+        width++;
+        max_value >>= 1;
+    }
+    return width;
+}
+
+static bool physical_dtype(int32_t type, TablrDType* dtype) {
+    switch (type) {
+        case PQ_BOOLEAN: *dtype = TABLR_BOOL; return true;
+        case PQ_INT32: *dtype = TABLR_INT32; return true;
+        case PQ_INT64: *dtype = TABLR_INT64; return true;
+        case PQ_FLOAT: *dtype = TABLR_FLOAT32; return true;
+        case PQ_DOUBLE: *dtype = TABLR_FLOAT64; return true;
+        case PQ_BYTE_ARRAY: *dtype = TABLR_STRING; return true;
+        default: return false;
+    }
+}
+
+/**
+ * @brief Column dtype of a schema element, from its physical type and annotations
+ */
+static bool element_dtype(const PqSchemaElement* elem, TablrDType* dtype, TablrTimeUnit* unit) {
+    if (!physical_dtype(elem->type, dtype)) return false;
+    *unit = TABLR_TIME_MICROSECOND;
+
+    if (elem->type == PQ_INT64 && elem->time_unit != 0) {
+        *dtype = TABLR_TIMESTAMP64;
+        *unit = elem->time_unit == PQ_TIME_MILLIS ? TABLR_TIME_MILLISECOND
+              : elem->time_unit == PQ_TIME_NANOS ? TABLR_TIME_NANOSECOND : TABLR_TIME_MICROSECOND;
+        return true;
+    }
+    switch (elem->converted) {
+        case PQ_CONVERTED_INT_8: if (elem->type == PQ_INT32) *dtype = TABLR_INT8; break;
+        case PQ_CONVERTED_INT_16: if (elem->type == PQ_INT32) *dtype = TABLR_INT16; break;
+        case PQ_CONVERTED_UINT_8: if (elem->type == PQ_INT32) *dtype = TABLR_UINT8; break;
+        case PQ_CONVERTED_UINT_16: if (elem->type == PQ_INT32) *dtype = TABLR_UINT16; break;
+        case PQ_CONVERTED_UINT_32: if (elem->type == PQ_INT32) *dtype = TABLR_UINT32; break;
+        case PQ_CONVERTED_DATE: if (elem->type == PQ_INT32) *dtype = TABLR_DATE32; break;
+        case PQ_CONVERTED_UINT_64: if (elem->type == PQ_INT64) *dtype = TABLR_UINT64; break;
+        case PQ_CONVERTED_TIMESTAMP_MILLIS:
+        case PQ_CONVERTED_TIMESTAMP_MICROS:
+            if (elem->type == PQ_INT64) {
+                *dtype = TABLR_TIMESTAMP64;
+                *unit = elem->converted == PQ_CONVERTED_TIMESTAMP_MILLIS ? TABLR_TIME_MILLISECOND
+                                                                          : TABLR_TIME_MICROSECOND;
+            }
+            break;
+        default: break;
+    }
+    return true;
+}
+
+static int32_t dtype_physical(TablrDType dtype) {
+    switch (dtype) {
+        case TABLR_BOOL: return PQ_BOOLEAN;
+        case TABLR_INT8:
+        case TABLR_INT16:
+        case TABLR_UINT8:
+        case TABLR_UINT16:
+        case TABLR_UINT32:
+        case TABLR_DATE32:
+        case TABLR_INT32: return PQ_INT32;
+        case TABLR_UINT64:
+        case TABLR_TIMESTAMP64:
+        case TABLR_INT64: return PQ_INT64;
+        case TABLR_FLOAT32: return PQ_FLOAT;
+        case TABLR_FLOAT64: return PQ_DOUBLE;
+        default: return PQ_BYTE_ARRAY;
+    }
+}
+
+/* ===================== Footer parsing ===================== */
+
+/**
+ * @brief Check a field's wire type, skipping the value on mismatch
+ */
+static bool field_is(TablrThriftReader* r, int type, int want) {
+    bool is_int = want == TABLR_THRIFT_I32 || want == TABLR_THRIFT_I64;
+    bool got_int = type == TABLR_THRIFT_I16 || type == TABLR_THRIFT_I32 || type == TABLR_THRIFT_I64;
+    if (type == want || (is_int && got_int)) return true;
+    tablr_thrift_skip(r, type);
+    return false;
+}
+
+static void parse_statistics(TablrThriftReader* r, PqColumnChunk* chunk) {
+    PqBytes legacy_min = {NULL, 0};
+    PqBytes legacy_max = {NULL, 0};
+    int type;
+    int16_t id;
+
+    tablr_thrift_struct_begin(r);
+    while (tablr_thrift_field(r, &type, &id)) {
+        PqBytes* target = id == 1 ? &legacy_max : id == 2 ? &legacy_min : id == 5 ? &chunk->max : id == 6 ? &chunk->min : NULL;
+        if (target && field_is(r, type, TABLR_THRIFT_BINARY)) {
+            target->data = tablr_thrift_read_binary(r, &target->len);
+        } else if (!target) {
+            tablr_thrift_skip(r, type);
+        }
+    }
+    tablr_thrift_struct_end(r);
+
+    /* Legacy min/max used signed ordering, which is only right for numbers */
+    bool numeric = chunk->type == PQ_INT32 || chunk->type == PQ_INT64 || chunk->type == PQ_FLOAT || chunk->type == PQ_DOUBLE;
+    if (numeric && !chunk->min.data && !chunk->max.data) {
+        chunk->min = legacy_min;
+        chunk->max = legacy_max;
+    }
+}
+
+static void parse_column_meta(TablrThriftReader* r, PqColumnChunk* chunk) {
+    int type;
+    int16_t id;
+    bool has_stats = false;
+    TablrThriftReader stats;
+
+    tablr_thrift_struct_begin(r);
+    while (tablr_thrift_field(r, &type, &id)) {
+        switch (id) {
+            case 1: if (field_is(r, type, TABLR_THRIFT_I32)) chunk->type = tablr_thrift_read_i32(r); break;
+            case 4: if (field_is(r, type, TABLR_THRIFT_I32)) chunk->codec = tablr_thrift_read_i32(r); break;
+            case 5: if (field_is(r, type, TABLR_THRIFT_I64)) chunk->num_values = tablr_thrift_read_i64(r); break;
+            case 7: if (field_is(r, type, TABLR_THRIFT_I64)) chunk->total_compressed_size = tablr_thrift_read_i64(r); break;
+            case 9: if (field_is(r, type, TABLR_THRIFT_I64)) chunk->data_page_offset = tablr_thrift_read_i64(r); break;
+            case 11: if (field_is(r, type, TABLR_THRIFT_I64)) chunk->dictionary_page_offset = tablr_thrift_read_i64(r); break;
+            case 12:
+                if (field_is(r, type, TABLR_THRIFT_STRUCT)) {
+                    /* Statistics may precede the type field; decode them once the type is known */
+                    stats = *r;
+                    has_stats = true;
+                    tablr_thrift_skip(r, type);
+                }
+                break;
+            default: tablr_thrift_skip(r, type); break;
+        }
+    }
+    tablr_thrift_struct_end(r);
+
+    if (has_stats && !r->failed) {
+        parse_statistics(&stats, chunk);
+        if (stats.failed) r->failed = true;
+    }
+}
+
+static void parse_column_chunk(TablrThriftReader* r, PqColumnChunk* chunk) {
+    int type;
+    int16_t id;
+    bool has_meta = false;
+
+    tablr_thrift_struct_begin(r);
+    while (tablr_thrift_field(r, &type, &id)) {
+        if (id == 3 && field_is(r, type, TABLR_THRIFT_STRUCT)) {
+            parse_column_meta(r, chunk);
+            has_meta = true;
+        } else if (id != 3) {
+            tablr_thrift_skip(r, type);
+        }
+    }
+    tablr_thrift_struct_end(r);
+
+    /* Column data in external files is not supported */
+    if (!has_meta) r->failed = true;
+}
+
+static void parse_row_group(TablrThriftReader* r, PqRowGroup* group) {
+    int type;
+    int16_t id;
+
+    tablr_thrift_struct_begin(r);
+    while (tablr_thrift_field(r, &type, &id)) {
+        if (id == 1 && field_is(r, type, TABLR_THRIFT_LIST) && !group->columns) {
+            int elem_type;
+            uint32_t count;
+            tablr_thrift_list_begin(r, &elem_type, &count);
+            if (elem_type != TABLR_THRIFT_STRUCT && count > 0) {
+                r->failed = true;
+                break;
+            }
+            group->columns = (PqColumnChunk*)calloc(count ? count : 1, sizeof(PqColumnChunk));
+            if (!group->columns) {
+                r->failed = true;
+                break;
+            }
+            group->ncols = count;
+            for (uint32_t i = 0; i < count && !r->failed; i++) {
+                group->columns[i].dictionary_page_offset = -1;
+                group->columns[i].type = -1;
+                parse_column_chunk(r, &group->columns[i]);
+            }
+        } else if (id == 3 && field_is(r, type, TABLR_THRIFT_I64)) {
+            group->num_rows = tablr_thrift_read_i64(r);
+        } else if (id != 1 && id != 3) {
+            tablr_thrift_skip(r, type);
+        }
+    }
+    tablr_thrift_struct_end(r);
+}
+
+/**
+ * @brief Read the unit of a TIMESTAMP logical type; other logical types are skipped
+ */
+static void parse_logical_type(TablrThriftReader* r, PqSchemaElement* elem) {
+    int type;
+    int16_t id;
+
+    tablr_thrift_struct_begin(r);
+    while (tablr_thrift_field(r, &type, &id)) {
+        if (id != PQ_LOGICAL_TIMESTAMP || !field_is(r, type, TABLR_THRIFT_STRUCT)) {
+            if (id != PQ_LOGICAL_TIMESTAMP) tablr_thrift_skip(r, type);
+            continue;
+        }
+        tablr_thrift_struct_begin(r);
+        while (tablr_thrift_field(r, &type, &id)) {
+            if (id != 2 || !field_is(r, type, TABLR_THRIFT_STRUCT)) {
+                if (id != 2) tablr_thrift_skip(r, type);
+                continue;
+            }
+            tablr_thrift_struct_begin(r);
+            while (tablr_thrift_field(r, &type, &id)) {
+                if (type == TABLR_THRIFT_STRUCT && id >= PQ_TIME_MILLIS && id <= PQ_TIME_NANOS) elem->time_unit = id;
+                tablr_thrift_skip(r, type);
+            }
+            tablr_thrift_struct_end(r);
+        }
+        tablr_thrift_struct_end(r);
+    }
+    tablr_thrift_struct_end(r);
+}
+
+static void parse_schema_element(TablrThriftReader* r, PqSchemaElement* elem) {
+    int type;
+    int16_t id;
+
+    elem->type = -1;
+    elem->converted = -1;
+    tablr_thrift_struct_begin(r);
+    while (tablr_thrift_field(r, &type, &id)) {
+        switch (id) {
+            case 1: if (field_is(r, type, TABLR_THRIFT_I32)) elem->type = tablr_thrift_read_i32(r); break;
+            case 3: if (field_is(r, type, TABLR_THRIFT_I32)) elem->repetition = tablr_thrift_read_i32(r); break;
+            case 5: if (field_is(r, type, TABLR_THRIFT_I32)) elem->num_children = tablr_thrift_read_i32(r); break;
+            case 6: if (field_is(r, type, TABLR_THRIFT_I32)) elem->converted = tablr_thrift_read_i32(r); break;
+            case 10: if (field_is(r, type, TABLR_THRIFT_STRUCT)) parse_logical_type(r, elem); break;
+            case 4:
+                if (field_is(r, type, TABLR_THRIFT_BINARY) && !elem->name) {
+                    uint32_t len;
+                    const uint8_t* name = tablr_thrift_read_binary(r, &len);
+                    elem->name = (char*)malloc((size_t)len + 1);
+                    if (!name || !elem->name) {
+                        r->failed = true;
+                        break;
+                    }
+                    memcpy(elem->name, name, len);
+                    elem->name[len] = '\0';
+                }
+                break;
+            default: tablr_thrift_skip(r, type); break;
+        }
+    }
+    tablr_thrift_struct_end(r);
+}
+
+static void meta_free(PqFileMeta* meta) {
+    for (size_t i = 0; i < meta->nschema; i++) free(meta->schema[i].name);
+    for (size_t i = 0; i < meta->ngroups; i++) free(meta->groups[i].columns);
+    free(meta->schema);
+    free(meta->groups);
+    memset(meta, 0, sizeof(*meta));
+}
+
+/**
+ * @brief Decode FileMetaData
+ * @return true on success; meta must be freed with meta_free either way
+ */
+static bool parse_file_meta(const uint8_t* data, size_t len, PqFileMeta* meta) {
+    TablrThriftReader r;
+    int type;
+    int16_t id;
+
+    memset(meta, 0, sizeof(*meta));
+    tablr_thrift_reader_init(&r, data, len);
+
+    while (tablr_thrift_field(&r, &type, &id)) {
+        if ((id == 2 || id == 4) && field_is(&r, type, TABLR_THRIFT_LIST)) {
+            int elem_type;
+            uint32_t count;
+            tablr_thrift_list_begin(&r, &elem_type, &count);
+            if ((elem_type != TABLR_THRIFT_STRUCT && count > 0) || (id == 2 ? meta->schema != NULL : meta->groups != NULL)) {
+                r.failed = true;
+                break;
+            }
+
+            if (id == 2) {
+                meta->schema = (PqSchemaElement*)calloc(count ? count : 1, sizeof(PqSchemaElement));
+                if (!meta->schema) return false;
+                meta->nschema = count;
+                for (uint32_t i = 0; i < count && !r.failed; i++) parse_schema_element(&r, &meta->schema[i]);
+            } else {
+                meta->groups = (PqRowGroup*)calloc(count ? count : 1, sizeof(PqRowGroup));
+                if (!meta->groups) return false;
+                meta->ngroups = count;
+                for (uint32_t i = 0; i < count && !r.failed; i++) parse_row_group(&r, &meta->groups[i]);
+            }
+        } else if (id != 2 && id != 4) {
+            tablr_thrift_skip(&r, type);
+        }
+    }
+
+    return !r.failed && meta->schema;
+}
+
+/**
+ * @brief Check that the schema is a root group of primitive leaves
+ *
+ * Also checks every row group has one chunk per leaf of the leaf's type.
+ */
+static bool validate_meta(const PqFileMeta* meta) {
+    if (meta->nschema == 0) return false;
+    size_t nleaves = meta->nschema - 1;
+    if ((size_t)meta->schema[0].num_children != nleaves) return false;
+
+    for (size_t i = 1; i < meta->nschema; i++) {
+        const PqSchemaElement* elem = &meta->schema[i];
+        if (!elem->name || elem->num_children != 0 || elem->type < 0 || elem->repetition == PQ_REPEATED) return false;
+    }
+
+    for (size_t g = 0; g < meta->ngroups; g++) {
+        const PqRowGroup* group = &meta->groups[g];
+        if (group->num_rows < 0 || group->ncols != nleaves) return false;
+        for (size_t c = 0; c < nleaves; c++) {
+            if (group->columns[c].type != meta->schema[c + 1].type) return false;
+        }
+    }
+    return true;
+}
+
+/* ===================== Page decoding ===================== */
+
+/**
+ * @brief Decode values of the RLE/bit-packed hybrid encoding
+ * @param p Start of the runs
+ * @param end End of the runs
+ * @param width Bit width of each value (0-32)
+ * @param out Output values
+ * @param count Number of values to decode
+ * @return true on success, false if the runs are malformed or too short
+ */
+static bool decode_hybrid(const uint8_t* p, const uint8_t* end, int width, uint32_t* out, size_t count) {
+    if (width < 0 || width > 32) return false;
+    size_t value_bytes = (size_t)(width + 7) / 8;
+    uint64_t mask = width == 32 ? 0xFFFFFFFFu : (((uint64_t)1 << width) - 1);
+    size_t produced = 0;
+
+    while (produced < count) {
+        uint64_t header = 0;
+        for (int shift = 0;; shift += 7) {
+            if (p >= end || shift > 63) return false;
+            uint8_t byte = *p++;
+            header |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) break;
+        }
+
+        size_t left = count - produced;
+        if (header & 1) {
+            uint64_t values = (header >> 1) * 8;
+            size_t take = values < left ? (size_t)values : left;
+            size_t needed = (take * (size_t)width + 7) / 8;
+            if ((size_t)(end - p) < needed) return false;
+
+            uint64_t acc = 0;
+            int bits = 0;
+            const uint8_t* q = p;
+            for (size_t i = 0; i < take; i++) {
+                while (bits < width) {
+                    acc |= (uint64_t)*q++ << bits;
+                    bits += 8;
+                }
+                out[produced + i] = (uint32_t)(acc & mask);
+                acc >>= width;
+                bits -= width;
+            }
+            produced += take;
+
+            size_t run_bytes = (size_t)((header >> 1) * (uint64_t)width);
+            p += run_bytes < (size_t)(end - p) ? run_bytes : (size_t)(end - p);
+        } else {
+            uint64_t run = header >> 1;
+            if ((size_t)(end - p) < value_bytes) return false;
+            uint32_t value = 0;
+            for (size_t i = 0; i < value_bytes; i++) value |= (uint32_t)p[i] << (8 * i);
+            p += value_bytes;
+            if (value > mask) return false;
+
+            size_t take = run < left ? (size_t)run : left;
+            for (size_t i = 0; i < take; i++) out[produced + i] = value;
+            produced += take;
+        }
+    }
+    return true;
+}
+
+static bool decompress(int32_t codec, const uint8_t* src, size_t len, char* dst, size_t dst_len) {
+    switch (codec) {
+        case PQ_CODEC_SNAPPY: return tablr_snappy_uncompress((const char*)src, len, dst, dst_len);
+        case PQ_CODEC_ZSTD: return tablr_zstd_uncompress((const char*)src, len, dst, dst_len);
+        default: return false;
+    }
+}
+
+/**
+ * @brief Decoding state of one column chunk
+ */
+typedef struct {
+    int32_t type;          /**< Physical type */
+    int32_t codec;         /**< Compression codec */
+    TablrDType dtype;      /**< Output dtype */
+    size_t width;          /**< Output element size */
+    char* out;             /**< Output values of this row group (lengths for strings) */
+    char* text;            /**< String characters of this row group */
+    size_t text_len;       /**< Bytes used in text */
+    size_t text_cap;       /**< Bytes allocated for text */
+    uint64_t* nulls;       /**< Bitmap of null rows, NULL until one is seen */
+    size_t nrows;          /**< Rows in the row group */
+    size_t row;            /**< Rows decoded so far */
+    int max_def;           /**< 1 for OPTIONAL columns, 0 for REQUIRED */
+    void* dict;            /**< Dictionary values (PqBytes for strings) */
+    size_t dict_count;     /**< Dictionary size */
+    char* dict_page;       /**< Decompressed dictionary page, referenced by dict */
+    char* scratch;         /**< Decompression buffer */
+    size_t scratch_cap;    /**< Bytes allocated for scratch */
+    uint32_t* levels;      /**< Definition levels of the current page */
+    uint32_t* indices;     /**< Dictionary indices of the current page */
+    size_t page_cap;       /**< Entries allocated for levels and indices */
+} PqChunkDecoder;
+
+static void decoder_free(PqChunkDecoder* dec) {
+    free(dec->dict);
+    free(dec->dict_page);
+    free(dec->scratch);
+    free(dec->levels);
+    free(dec->indices);
+}
+
+static char* scratch_reserve(PqChunkDecoder* dec, size_t size) {
+    if (size > dec->scratch_cap) {
+        char* buf = (char*)realloc(dec->scratch, size);
+        if (!buf) return NULL;
+        dec->scratch = buf;
+        dec->scratch_cap = size;
+    }
+    return dec->scratch;
+}
+
+static bool page_reserve(PqChunkDecoder* dec, size_t count) {
+    if (count <= dec->page_cap) return true;
+    uint32_t* levels = (uint32_t*)realloc(dec->levels, count * sizeof(uint32_t));
+    if (levels) dec->levels = levels;
+    uint32_t* indices = (uint32_t*)realloc(dec->indices, count * sizeof(uint32_t));
+    if (indices) dec->indices = indices;
+    if (!levels || !indices) return false;
+    dec->page_cap = count;
+    return true;
+}
+
+/**
+ * @brief Append a string to the chunk's characters and store its length
+ */
+static bool append_string(PqChunkDecoder* dec, const uint8_t* data, uint32_t len, int64_t* length) {
+    if (len > dec->text_cap - dec->text_len) {
+        size_t cap = dec->text_cap ? dec->text_cap : PQ_TEXT_BYTES;
+        while (cap - dec->text_len < len) cap *= 2;
+        char* grown = (char*)realloc(dec->text, cap);
+        if (!grown) return false;
+        dec->text = grown;
+        dec->text_cap = cap;
+    }
+    if (len > 0) memcpy(dec->text + dec->text_len, data, len);
+    dec->text_len += len;
+    *length = len;
+    return true;
+}
+
+/**
+ * @brief Split count PLAIN byte arrays into borrowed ranges
+ */
+static bool plain_byte_arrays(const uint8_t* p, const uint8_t* end, size_t count, PqBytes* out) {
+    for (size_t i = 0; i < count; i++) {
+        if (end - p < 4) return false;
+        uint32_t len = load_le32(p);
+        p += 4;
+        if ((size_t)(end - p) < len) return false;
+        out[i].data = p;
+        out[i].len = len;
+        p += len;
+    }
+    return true;
+}
+
+/**
+ * @brief Decode count PLAIN values into out (host layout of the output dtype)
+ */
+static bool decode_plain(PqChunkDecoder* dec, const uint8_t* p, const uint8_t* end, size_t count, void* out) {
+    size_t avail = (size_t)(end - p);
+
+    switch (dec->type) {
+        case PQ_BOOLEAN: {
+            if (avail < (count + 7) / 8) return false;
+            bool* values = (bool*)out;
+            for (size_t i = 0; i < count; i++) values[i] = (p[i >> 3] >> (i & 7)) & 1;
+            return true;
+        }
+        case PQ_BYTE_ARRAY: {
+            int64_t* lengths = (int64_t*)out;
+            for (size_t i = 0; i < count; i++) {
+                if (end - p < 4) return false;
+                uint32_t len = load_le32(p);
+                p += 4;
+                if ((size_t)(end - p) < len || !append_string(dec, p, len, &lengths[i])) return false;
+                p += len;
+            }
+            return true;
+        }
+        default:
+            if (dec->type == PQ_INT32 && dec->width < 4) {
+                /* 8- and 16-bit columns are stored widened to INT32 */
+                if (avail / 4 < count) return false;
+                for (size_t i = 0; i < count; i++) {
+                    uint32_t v = load_le32(p + 4 * i);
+                    if (dec->width == 1) ((uint8_t*)out)[i] = (uint8_t)v;
+                    else ((uint16_t*)out)[i] = (uint16_t)v;
+                }
+                return true;
+            }
+            if (avail / dec->width < count) return false;
+            copy_le(out, p, count, dec->width);
+            return true;
+    }
+}
+
+/**
+ * @brief Decode a dictionary page body
+ */
+static bool load_dictionary(PqChunkDecoder* dec, const uint8_t* p, size_t len, size_t count) {
+    const uint8_t* end = p + len;
+    free(dec->dict);
+    dec->dict_count = 0;
+
+    if (dec->type == PQ_BYTE_ARRAY) {
+        dec->dict = malloc((count ? count : 1) * sizeof(PqBytes));
+        if (!dec->dict || !plain_byte_arrays(p, end, count, (PqBytes*)dec->dict)) return false;
+    } else {
+        dec->dict = malloc((count ? count : 1) * dec->width);
+        if (!dec->dict || !decode_plain(dec, p, end, count, dec->dict)) return false;
+    }
+    dec->dict_count = count;
+    return true;
+}
+
+/**
+ * @brief Decode count non-null values of one page into out
+ */
+static bool decode_values(PqChunkDecoder* dec, int32_t encoding, const uint8_t* p, const uint8_t* end, size_t count, char* out) {
+    if (encoding == PQ_PLAIN) return decode_plain(dec, p, end, count, out);
+
+    if (encoding == PQ_RLE && dec->type == PQ_BOOLEAN) {
+        if (end - p < 4) return false;
+        uint32_t len = load_le32(p);
+        p += 4;
+        if ((size_t)(end - p) < len || !decode_hybrid(p, p + len, 1, dec->indices, count)) return false;
+        bool* values = (bool*)out;
+        for (size_t i = 0; i < count; i++) values[i] = dec->indices[i] != 0;
+        return true;
+    }
+
+    if (encoding == PQ_PLAIN_DICTIONARY || encoding == PQ_RLE_DICTIONARY) {
+        if (!dec->dict || (count > 0 && p >= end)) return false;
+        if (count == 0) return true;
+        int width = *p++;
+        if (!decode_hybrid(p, end, width, dec->indices, count)) return false;
+
+        for (size_t i = 0; i < count; i++) {
+            uint32_t index = dec->indices[i];
+            if (index >= dec->dict_count) return false;
+            if (dec->type == PQ_BYTE_ARRAY) {
+                const PqBytes* entry = &((const PqBytes*)dec->dict)[index];
+                if (!append_string(dec, entry->data, entry->len, &((int64_t*)out)[i])) return false;
+            } else {
+                memcpy(out + i * dec->width, (const char*)dec->dict + (size_t)index * dec->width, dec->width);
+            }
+        }
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Record the null rows of the current page in the chunk's bitmap
+ */
+static bool mark_nulls(PqChunkDecoder* dec, size_t count) {
+    if (!dec->nulls) {
+        dec->nulls = (uint64_t*)calloc((dec->nrows + 63) / 64, sizeof(uint64_t));
+        if (!dec->nulls) return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        size_t row = dec->row + i;
+        if (dec->levels[i] != (uint32_t)dec->max_def) dec->nulls[row / 64] |= (uint64_t)1 << (row % 64);
+    }
+    return true;
+}
+
+/**
+ * @brief Spread dense non-null values to their rows and fill nulls, in place
+ */
+static void expand_nulls(PqChunkDecoder* dec, char* out, size_t count, size_t valid) {
+    size_t width = dec->width;
+    size_t j = valid;
+    for (size_t i = count; i-- > 0;) {
+        char* slot = out + i * width;
+        if (dec->levels[i] == (uint32_t)dec->max_def) {
+            j--;
+            if (j != i) memcpy(slot, out + j * width, width);
+        } else if (dec->dtype == TABLR_FLOAT64) {
+            double nan = NAN;
+            memcpy(slot, &nan, sizeof(nan));
+        } else if (dec->dtype == TABLR_FLOAT32) {
+            float nan = NAN;
+            memcpy(slot, &nan, sizeof(nan));
+        } else {
+            memset(slot, 0, width);
+        }
+    }
+}
+
+/**
+ * @brief Decode a data page (v1 or v2) into the next rows of the output
+ */
+static bool decode_data_page(PqChunkDecoder* dec, const PqPageHeader* header, const uint8_t* page) {
+    size_t count = (size_t)header->num_values;
+    if (header->num_values < 0 || count > dec->nrows - dec->row || !page_reserve(dec, count ? count : 1)) return false;
+
+    const uint8_t* body = page;
+    const uint8_t* end = page + header->compressed_size;
+    const uint8_t* levels = NULL;
+    const uint8_t* levels_end = NULL;
+    int level_width = bit_width((uint32_t)dec->max_def);
+
+    if (header->type == PQ_DATA_PAGE) {
+        if (dec->codec != PQ_CODEC_UNCOMPRESSED) {
+            char* buf = scratch_reserve(dec, (size_t)header->uncompressed_size);
+            if (!buf || !decompress(dec->codec, page, (size_t)header->compressed_size, buf, (size_t)header->uncompressed_size)) return false;
+            body = (const uint8_t*)buf;
+            end = body + header->uncompressed_size;
+        }
+        if (dec->max_def > 0) {
+            if (header->def_encoding != PQ_RLE || end - body < 4) return false;
+            uint32_t len = load_le32(body);
+            body += 4;
+            if ((size_t)(end - body) < len) return false;
+            levels = body;
+            levels_end = body + len;
+            body += len;
+        }
+    } else {
+        if (header->def_length < 0 || header->rep_length < 0 ||
+            (int64_t)header->def_length + header->rep_length > header->compressed_size ||
+            (int64_t)header->def_length + header->rep_length > header->uncompressed_size) {
+            return false;
+        }
+        levels = page + header->rep_length;
+        levels_end = levels + header->def_length;
+        body = levels_end;
+        if (header->is_compressed && dec->codec != PQ_CODEC_UNCOMPRESSED) {
+            size_t size = (size_t)(header->uncompressed_size - header->def_length - header->rep_length);
+            char* buf = scratch_reserve(dec, size ? size : 1);
+            if (!buf || !decompress(dec->codec, body, (size_t)(end - body), buf, size)) return false;
+            body = (const uint8_t*)buf;
+            end = body + size;
+        }
+    }
+
+    size_t valid = count;
+    if (dec->max_def > 0) {
+        if (!decode_hybrid(levels, levels_end, level_width, dec->levels, count)) return false;
+        valid = 0;
+        for (size_t i = 0; i < count; i++) valid += dec->levels[i] == (uint32_t)dec->max_def;
+    }
+
+    char* out = dec->out + dec->row * dec->width;
+    if (!decode_values(dec, header->encoding, body, end, valid, out)) return false;
+    if (valid < count) {
+        if (!mark_nulls(dec, count)) return false;
+        expand_nulls(dec, out, count, valid);
+    }
+
+    dec->row += count;
+    return true;
+}
+
+static bool parse_page_header(TablrThriftReader* r, PqPageHeader* header) {
+    int type;
+    int16_t id;
+
+    memset(header, 0, sizeof(*header));
+    header->type = -1;
+    header->is_compressed = true;
+
+    while (tablr_thrift_field(r, &type, &id)) {
+        if (id == 1 && field_is(r, type, TABLR_THRIFT_I32)) {
+            header->type = tablr_thrift_read_i32(r);
+        } else if (id == 2 && field_is(r, type, TABLR_THRIFT_I32)) {
+            header->uncompressed_size = tablr_thrift_read_i32(r);
+        } else if (id == 3 && field_is(r, type, TABLR_THRIFT_I32)) {
+            header->compressed_size = tablr_thrift_read_i32(r);
+        } else if ((id == 5 || id == 7 || id == 8) && field_is(r, type, TABLR_THRIFT_STRUCT)) {
+            int sub_type;
+            int16_t sub_id;
+            tablr_thrift_struct_begin(r);
+            while (tablr_thrift_field(r, &sub_type, &sub_id)) {
+                /* Field ids of DataPageHeader (5), DictionaryPageHeader (7) and DataPageHeaderV2 (8) */
+                int32_t* target = NULL;
+                bool is_bool = false;
+                if (sub_id == 1) target = &header->num_values;
+                else if (id == 5 || id == 7) target = sub_id == 2 ? &header->encoding : id == 5 && sub_id == 3 ? &header->def_encoding : NULL;
+                else if (sub_id == 4) target = &header->encoding;
+                else if (sub_id == 5) target = &header->def_length;
+                else if (sub_id == 6) target = &header->rep_length;
+                else if (sub_id == 7) is_bool = true;
+
+                if (target && field_is(r, sub_type, TABLR_THRIFT_I32)) {
+                    *target = tablr_thrift_read_i32(r);
+                } else if (is_bool && (sub_type == TABLR_THRIFT_TRUE || sub_type == TABLR_THRIFT_FALSE)) {
+                    header->is_compressed = tablr_thrift_read_bool(r, sub_type);
+                } else if (!target) {
+                    tablr_thrift_skip(r, sub_type);
+                }
+            }
+            tablr_thrift_struct_end(r);
+        } else if (!(id >= 1 && id <= 3) && id != 5 && id != 7 && id != 8) {
+            tablr_thrift_skip(r, type);
+        }
+    }
+
+    return !r->failed && header->uncompressed_size >= 0 && header->compressed_size >= 0;
+}
+
+/**
+ * @brief Decode one column chunk into dec->out
+ */
+static bool decode_chunk(PqChunkDecoder* dec, const PqColumnChunk* chunk, const TablrFileMap* map) {
+    int64_t start = chunk->data_page_offset;
+    if (chunk->dictionary_page_offset >= PQ_MAGIC_LEN && chunk->dictionary_page_offset < start) {
+        start = chunk->dictionary_page_offset;
+    }
+    if (start < PQ_MAGIC_LEN || chunk->total_compressed_size < 0 || (uint64_t)start > map->size ||
+        (uint64_t)chunk->total_compressed_size > map->size - (uint64_t)start) {
+        return false;
+    }
+    if (chunk->codec != PQ_CODEC_UNCOMPRESSED && chunk->codec != PQ_CODEC_SNAPPY && chunk->codec != PQ_CODEC_ZSTD) return false;
+    dec->codec = chunk->codec;
+
+    const uint8_t* p = (const uint8_t*)map->data + start;
+    const uint8_t* end = p + chunk->total_compressed_size;
+
+    while (dec->row < dec->nrows) {
+        TablrThriftReader r;
+        PqPageHeader header;
+        tablr_thrift_reader_init(&r, p, (size_t)(end - p));
+        if (!parse_page_header(&r, &header)) return false;
+
+        const uint8_t* page = r.pos;
+        if ((size_t)(end - page) < (size_t)header.compressed_size) return false;
+
+        if (header.type == PQ_DICTIONARY_PAGE) {
+            if (header.num_values < 0 || (header.encoding != PQ_PLAIN && header.encoding != PQ_PLAIN_DICTIONARY)) return false;
+            const uint8_t* body = page;
+            if (dec->codec != PQ_CODEC_UNCOMPRESSED) {
+                /* Dictionary strings point into the page, so it gets its own buffer */
+                free(dec->dict_page);
+                dec->dict_page = (char*)malloc(header.uncompressed_size ? (size_t)header.uncompressed_size : 1);
+                if (!dec->dict_page || !decompress(dec->codec, page, (size_t)header.compressed_size, dec->dict_page,
+                                                   (size_t)header.uncompressed_size)) {
+                    return false;
+                }
+                body = (const uint8_t*)dec->dict_page;
+            }
+            size_t len = dec->codec != PQ_CODEC_UNCOMPRESSED ? (size_t)header.uncompressed_size : (size_t)header.compressed_size;
+            if (!load_dictionary(dec, body, len, (size_t)header.num_values)) return false;
+        } else if (header.type == PQ_DATA_PAGE || header.type == PQ_DATA_PAGE_V2) {
+            if (!decode_data_page(dec, &header, page)) return false;
+        }
+
+        p = page + header.compressed_size;
+    }
+
+    return true;
+}
+
+/* ===================== Reading ===================== */
+
+/**
+ * @brief Decoded data of one (row group, column) chunk kept for after the tasks
+ */
+typedef struct {
+    int64_t* lengths;  /**< Byte length of each row of a string chunk */
+    char* text;        /**< Characters of a string chunk's rows back to back */
+    size_t text_len;   /**< Bytes of text */
+    uint64_t* nulls;   /**< Bitmap of null rows, NULL if none */
+} PqChunkResult;
+
+/**
+ * @brief Shared state of a parallel read
+ */
+typedef struct {
+    const PqFileMeta* meta;   /**< File footer */
+    const TablrFileMap* map;  /**< Mapped file */
+    const size_t* groups;     /**< Row groups to read */
+    const size_t* offsets;    /**< Output row of each row group to read */
+    size_t ngroups;           /**< Number of row groups to read */
+    const size_t* leaves;     /**< Leaf index of each output column */
+    size_t ncols;             /**< Number of output columns */
+    TablrSeries** series;     /**< Output columns, NULL for string columns until stitched */
+    PqChunkResult* results;   /**< Strings and nulls of each task */
+    bool* ok;                 /**< Result of each task */
+} PqReadJob;
+
+/**
+ * @brief Decode one (row group, column) chunk
+ */
+static void read_chunk_task(size_t index, void* ctx) {
+    PqReadJob* job = (PqReadJob*)ctx;
+    size_t g = job->groups[index / job->ncols];
+    size_t c = index % job->ncols;
+    size_t leaf = job->leaves[c];
+    const PqSchemaElement* elem = &job->meta->schema[leaf + 1];
+    const PqColumnChunk* chunk = &job->meta->groups[g].columns[leaf];
+
+    PqChunkResult* result = &job->results[index];
+
+    PqChunkDecoder dec;
+    memset(&dec, 0, sizeof(dec));
+    TablrTimeUnit unit;
+    dec.type = elem->type;
+    element_dtype(elem, &dec.dtype, &unit);
+    dec.width = tablr_dtype_size(dec.dtype);
+    dec.nrows = (size_t)job->meta->groups[g].num_rows;
+    dec.max_def = elem->repetition == PQ_OPTIONAL ? 1 : 0;
+    if (dec.dtype == TABLR_STRING) {
+        result->lengths = (int64_t*)malloc(dec.nrows * sizeof(int64_t));
+        dec.out = (char*)result->lengths;
+    } else {
+        dec.out = (char*)tablr_series_data(job->series[c]) + job->offsets[index / job->ncols] * dec.width;
+    }
+
+    job->ok[index] = dec.out && decode_chunk(&dec, chunk, job->map);
+    result->text = dec.text;
+    result->text_len = dec.text_len;
+    result->nulls = dec.nulls;
+    decoder_free(&dec);
+}
+
+/**
+ * @brief Build a string column from the lengths and characters of its chunks
+ * @return New series, or NULL on failure
+ */
+static TablrSeries* stitch_strings(const PqReadJob* job, size_t c, size_t nrows) {
+    size_t bytes = 0;
+    for (size_t k = 0; k < job->ngroups; k++) bytes += job->results[k * job->ncols + c].text_len;
+
+    TablrSeries* series = tablr_series_string_alloc(nrows, bytes, TABLR_CPU);
+    int64_t* offsets;
+    char* chars;
+    if (!series || !tablr_series_string_buffers(series, &offsets, &chars)) {
+        tablr_series_free(series);
+        return NULL;
+    }
+
+    int64_t pos = 0;
+    for (size_t k = 0; k < job->ngroups; k++) {
+        const PqChunkResult* result = &job->results[k * job->ncols + c];
+        size_t row = job->offsets[k];
+        size_t rows = (size_t)job->meta->groups[job->groups[k]].num_rows;
+        if (result->text_len > 0) memcpy(chars + pos, result->text, result->text_len);
+        for (size_t r = 0; r < rows; r++) {
+            pos += result->lengths[r];
+            offsets[row + r + 1] = pos;
+        }
+    }
+    return series;
+}
+
+/**
+ * @brief Mark the null rows recorded by a column's chunks on its series
+ * @return false on allocation failure
+ */
+static bool apply_nulls(const PqReadJob* job, size_t c) {
+    for (size_t k = 0; k < job->ngroups; k++) {
+        const uint64_t* nulls = job->results[k * job->ncols + c].nulls;
+        if (!nulls) continue;
+
+        /* Invert the chunk's null bits into a validity bitmap and copy it in one pass */
+        size_t rows = (size_t)job->meta->groups[job->groups[k]].num_rows;
+        size_t nbytes = (rows + 7) / 8;
+        uint8_t* valid = (uint8_t*)malloc(nbytes ? nbytes : 1);
+        if (!valid) return false;
+        for (size_t b = 0; b < nbytes; b++) valid[b] = (uint8_t)~(nulls[b / 8] >> (8 * (b % 8)));
+        bool ok = tablr_series_set_validity(job->series[c], job->offsets[k], valid, 0, rows);
+        free(valid);
+        if (!ok) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Convert a plain-encoded statistic to double
+ */
+static bool stat_value(int32_t type, PqBytes bytes, double* out) {
+    if (!bytes.data) return false;
+    if (type == PQ_INT32 && bytes.len == 4) {
+        int32_t v;
+        copy_le(&v, bytes.data, 1, 4);
+        *out = v;
+    } else if (type == PQ_INT64 && bytes.len == 8) {
+        int64_t v;
+        copy_le(&v, bytes.data, 1, 8);
+        *out = (double)v;
+    } else if (type == PQ_FLOAT && bytes.len == 4) {
+        float v;
+        copy_le(&v, bytes.data, 1, 4);
+        *out = v;
+    } else if (type == PQ_DOUBLE && bytes.len == 8) {
+        copy_le(out, bytes.data, 1, 8);
+    } else {
+        return false;
+    }
+    return !isnan(*out);
+}
+
+static size_t find_leaf(const PqFileMeta* meta, const char* name) {
+    for (size_t i = 1; i < meta->nschema; i++) {
+        if (strcmp(meta->schema[i].name, name) == 0) return i - 1;
+    }
+    return SIZE_MAX;
+}
+
+/**
+ * @brief Get default Parquet read options
+ * @return Options that read every column of every row group
+ */
+TablrParquetReadOptions tablr_parquet_read_options_default(void) {
+    TablrParquetReadOptions options;
+    options.columns = NULL;
+    options.num_columns = 0;
+    options.filter_column = NULL;
+    options.filter_min = -INFINITY;
+    options.filter_max = INFINITY;
+    return options;
+}
+
+/**
+ * @brief Read a Parquet file into a dataframe
+ *
+ * Row groups are skipped when the filter column's statistics show that no
+ * value lies in [filter_min, filter_max]; rows of the remaining groups are
+ * returned unfiltered. Columns listed in options->columns are returned in
+ * file order.
+ *
+ * @param filename Path to file
+ * @param options Read options (NULL for defaults)
+ * @return New dataframe, or NULL on failure or unsupported schema
+ */
+TablrDataFrame* tablr_read_parquet(const char* filename, const TablrParquetReadOptions* options) {
+    if (!filename) return NULL;
+
+    TablrParquetReadOptions defaults = tablr_parquet_read_options_default();
+    if (!options) options = &defaults;
+
+    TablrFileMap map;
+    if (!tablr_file_map_open(&map, filename)) return NULL;
+
+    const uint8_t* data = (const uint8_t*)map.data;
+    size_t size = map.size;
+    if (size < 2 * PQ_MAGIC_LEN + 4 || memcmp(data, PQ_MAGIC, PQ_MAGIC_LEN) != 0 ||
+        memcmp(data + size - PQ_MAGIC_LEN, PQ_MAGIC, PQ_MAGIC_LEN) != 0) {
+        tablr_file_map_close(&map);
+        return NULL;
+    }
+    uint32_t footer_len = load_le32(data + size - PQ_MAGIC_LEN - 4);
+    if (footer_len > size - 2 * PQ_MAGIC_LEN - 4) {
+        tablr_file_map_close(&map);
+        return NULL;
+    }
+
+    PqFileMeta meta;
+    TablrDataFrame* df = NULL;
+    size_t* leaves = NULL;
+    size_t* groups = NULL;
+    size_t* offsets = NULL;
+    TablrSeries** series = NULL;
+    PqChunkResult* results = NULL;
+    bool* ok = NULL;
+    size_t ncols = 0;
+    size_t nkept = 0;
+
+    if (!parse_file_meta(data + size - PQ_MAGIC_LEN - 4 - footer_len, footer_len, &meta) || !validate_meta(&meta)) goto done;
+
+    size_t nleaves = meta.nschema - 1;
+    leaves = (size_t*)malloc((nleaves ? nleaves : 1) * sizeof(size_t));
+    groups = (size_t*)malloc((meta.ngroups ? meta.ngroups : 1) * sizeof(size_t));
+    offsets = (size_t*)malloc((meta.ngroups ? meta.ngroups : 1) * sizeof(size_t));
+    if (!leaves || !groups || !offsets) goto done;
+
+    /* Projection, in file order */
+    for (size_t i = 0; i < nleaves; i++) {
+        bool selected = options->columns == NULL;
+        for (size_t k = 0; k < options->num_columns && !selected; k++) {
+            selected = options->columns[k] && strcmp(options->columns[k], meta.schema[i + 1].name) == 0;
+        }
+        if (!selected) continue;
+        TablrDType dtype;
+        TablrTimeUnit unit;
+        if (!element_dtype(&meta.schema[i + 1], &dtype, &unit)) goto done;
+        leaves[ncols++] = i;
+    }
+    for (size_t k = 0; k < options->num_columns && options->columns; k++) {
+        if (!options->columns[k] || find_leaf(&meta, options->columns[k]) == SIZE_MAX) goto done;
+    }
+
+    size_t filter_leaf = SIZE_MAX;
+    if (options->filter_column) {
+        filter_leaf = find_leaf(&meta, options->filter_column);
+        if (filter_leaf == SIZE_MAX) goto done;
+
+        /* Unsigned statistics do not order as the signed physical values they are stored in */
+        TablrDType dtype;
+        TablrTimeUnit unit;
+        if (element_dtype(&meta.schema[filter_leaf + 1], &dtype, &unit) &&
+            (dtype == TABLR_UINT32 || dtype == TABLR_UINT64)) {
+            filter_leaf = SIZE_MAX;
+        }
+    }
+
+    /* Row-group skipping */
+    size_t total_rows = 0;
+    for (size_t g = 0; g < meta.ngroups; g++) {
+        const PqRowGroup* group = &meta.groups[g];
+        if (group->num_rows == 0) continue;
+        if (filter_leaf != SIZE_MAX) {
+            const PqColumnChunk* chunk = &group->columns[filter_leaf];
+            double lo, hi;
+            if (stat_value(chunk->type, chunk->min, &lo) && stat_value(chunk->type, chunk->max, &hi) &&
+                (hi < options->filter_min || lo > options->filter_max)) {
+                continue;
+            }
+        }
+        groups[nkept] = g;
+        offsets[nkept] = total_rows;
+        nkept++;
+        total_rows += (size_t)group->num_rows;
+    }
+
+    df = tablr_dataframe_create();
+    if (!df || total_rows == 0 || ncols == 0) goto done;
+
+    series = (TablrSeries**)calloc(ncols, sizeof(TablrSeries*));
+    results = (PqChunkResult*)calloc(nkept * ncols, sizeof(PqChunkResult));
+    ok = (bool*)calloc(nkept * ncols, sizeof(bool));
+    if (!series || !results || !ok) goto fail;
+
+    for (size_t c = 0; c < ncols; c++) {
+        TablrDType dtype;
+        TablrTimeUnit unit;
+        element_dtype(&meta.schema[leaves[c] + 1], &dtype, &unit);
+        if (dtype == TABLR_STRING) continue;
+        /* Zeros are lazy: materialize here so the tasks below write to a plain buffer */
+        series[c] = tablr_series_zeros(total_rows, dtype, TABLR_CPU);
+        if (!series[c] || !tablr_series_data(series[c])) goto fail;
+        if (dtype == TABLR_TIMESTAMP64) tablr_series_set_time_unit(series[c], unit);
+    }
+
+    PqReadJob job = {&meta, &map, groups, offsets, nkept, leaves, ncols, series, results, ok};
+    tablr_parallel_for(nkept * ncols, read_chunk_task, &job);
+    for (size_t i = 0; i < nkept * ncols; i++) {
+        if (!ok[i]) goto fail;
+    }
+
+    for (size_t c = 0; c < ncols; c++) {
+        if (!series[c]) series[c] = stitch_strings(&job, c, total_rows);
+        if (!series[c] || !apply_nulls(&job, c)) goto fail;
+    }
+
+    for (size_t c = 0; c < ncols; c++) {
+        if (!tablr_dataframe_add_column(df, meta.schema[leaves[c] + 1].name, series[c])) goto fail;
+        series[c] = NULL;
+    }
+    goto done;
+
+fail:
+    tablr_dataframe_free(df);
+    df = NULL;
+
+done:
+    if (series) {
+        for (size_t c = 0; c < ncols; c++) tablr_series_free(series[c]);
+    }
+    free(series);
+    for (size_t i = 0; results && i < nkept * ncols; i++) {
+        free(results[i].lengths);
+        free(results[i].text);
+        free(results[i].nulls);
+    }
+    free(results);
+    free(ok);
+    free(leaves);
+    free(groups);
+    free(offsets);
+    meta_free(&meta);
+    tablr_file_map_close(&map);
+    return df;
+}
+
+/* ===================== Writing ===================== */
+
+/**
+ * @brief Growable byte buffer
+ */
+typedef struct {
+    uint8_t* data;
+    size_t len;
+    size_t cap;
+} PqBuffer;
+
+static bool buffer_reserve(PqBuffer* buf, size_t extra) {
+    if (buf->len + extra <= buf->cap) return true;
+    size_t cap = buf->cap ? buf->cap * 2 : 4096;
+    while (cap < buf->len + extra) cap *= 2;
+    uint8_t* data = (uint8_t*)realloc(buf->data, cap);
+    if (!data) return false;
+    buf->data = data;
+    buf->cap = cap;
+    return true;
+}
+
+static bool buffer_append(PqBuffer* buf, const void* data, size_t len) {
+    if (!buffer_reserve(buf, len)) return false;
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+    return true;
+}
+
+static bool buffer_varint(PqBuffer* buf, uint64_t value) {
+    uint8_t bytes[10];
+    size_t n = 0;
+    while (value >= 0x80) {
+        bytes[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    bytes[n++] = (uint8_t)value;
+    return buffer_append(buf, bytes, n);
+}
+
+static bool buffer_le(PqBuffer* buf, const void* values, size_t count, size_t width) {
+    if (!buffer_reserve(buf, count * width)) return false;
+    copy_le(buf->data + buf->len, values, count, width);
+    buf->len += count * width;
+    return true;
+}
+
+static size_t run_length(const uint32_t* values, size_t i, size_t count) {
+    size_t j = i + 1;
+    while (j < count && values[j] == values[i]) j++;
+    return j - i;
+}
+
+/**
+ * @brief Append values in the RLE/bit-packed hybrid encoding
+ *
+ * Runs of eight or more equal values become RLE runs; everything between
+ * them is bit-packed in groups of eight, borrowing from the next run when
+ * needed so no padding appears before the end.
+ */
+static bool encode_hybrid(PqBuffer* buf, const uint32_t* values, size_t count, int width) {
+    size_t value_bytes = (size_t)(width + 7) / 8;
+    size_t i = 0;
+
+    while (i < count) {
+        size_t run = run_length(values, i, count);
+        if (run >= 8) {
+            if (!buffer_varint(buf, (uint64_t)run << 1) || !buffer_reserve(buf, value_bytes)) return false;
+            for (size_t b = 0; b < value_bytes; b++) buf->data[buf->len++] = (uint8_t)(values[i] >> (8 * b));
+            i += run;
+            continue;
+        }
+
+        size_t j = i;
+        while (j < count) {
+            size_t r = run_length(values, j, count);
+            if (r >= 8) break;
+            j += r;
+        }
+        size_t groups = (j - i + 7) / 8;
+        size_t take = groups * 8 < count - i ? groups * 8 : count - i;
+        if (!buffer_varint(buf, ((uint64_t)groups << 1) | 1) || !buffer_reserve(buf, groups * (size_t)width)) return false;
+
+        uint64_t acc = 0;
+        int bits = 0;
+        for (size_t k = 0; k < groups * 8; k++) {
+            acc |= (uint64_t)(k < take ? values[i + k] : 0) << bits;
+            bits += width;
+            while (bits >= 8) {
+                buf->data[buf->len++] = (uint8_t)acc;
+                acc >>= 8;
+                bits -= 8;
+            }
+        }
+        i += take;
+    }
+    return true;
+}
+
+/**
+ * @brief Metadata of one encoded column chunk
+ */
+typedef struct {
+    int32_t type;                /**< Physical type */
+    int64_t num_values;          /**< Rows in the chunk */
+    int64_t null_count;          /**< Null rows */
+    int64_t uncompressed_size;   /**< Bytes of all pages before compression, with headers */
+    int64_t compressed_size;     /**< Bytes of all pages in the file, with headers */
+    int64_t data_page_offset;    /**< First data page (relative to the chunk, then absolute) */
+    int64_t dict_page_offset;    /**< Dictionary page, -1 if none */
+    bool has_stats;              /**< Whether min and max are set */
+    uint8_t min[8];              /**< Plain-encoded minimum */
+    uint8_t max[8];              /**< Plain-encoded maximum */
+    uint32_t stat_len;           /**< Bytes in min and max */
+} PqChunkMeta;
+
+/**
+ * @brief Shared state of one row group being written
+ */
+typedef struct {
+    const TablrDataFrame* df;                 /**< Source dataframe */
+    const TablrParquetWriteOptions* options;  /**< Write options */
+    size_t begin;                             /**< First row of the group */
+    size_t end;                               /**< End row of the group */
+    PqBuffer* chunks;                         /**< Encoded pages per column */
+    PqChunkMeta* metas;                       /**< Metadata per column */
+    bool* ok;                                 /**< Result per column */
+} PqWriteJob;
+
+/**
+ * @brief Compressed-page scratch buffers of one column encoder
+ */
+typedef struct {
+    PqBuffer body;         /**< Uncompressed page body */
+    PqBuffer packed;       /**< Compressed page body */
+    uint32_t* levels;      /**< Definition levels of the page */
+} PqPageScratch;
+
+/**
+ * @brief Whether row i is written as null: marked null in the series, or NaN
+ */
+static bool is_null(const TablrSeries* series, const void* data, TablrDType dtype, size_t i) {
+    switch (dtype) {
+        case TABLR_FLOAT64: if (isnan(((const double*)data)[i])) return true; break;
+        case TABLR_FLOAT32: if (isnan(((const float*)data)[i])) return true; break;
+        default: break;
+    }
+    return !tablr_series_is_valid(series, i);
+}
+
+/**
+ * @brief Compress a page body and append header and page to the chunk
+ */
+static bool emit_page(PqBuffer* chunk, PqPageScratch* s, const TablrParquetWriteOptions* options, bool dictionary_page,
+                      int32_t num_values, int32_t encoding, PqChunkMeta* meta) {
+    const uint8_t* page = s->body.data;
+    size_t page_len = s->body.len;
+
+    if (options->compression != TABLR_PARQUET_UNCOMPRESSED) {
+        size_t bound = options->compression == TABLR_PARQUET_SNAPPY ? tablr_snappy_max_length(s->body.len)
+                                                                    : tablr_zstd_max_length(s->body.len);
+        s->packed.len = 0;
+        if (bound == 0 || !buffer_reserve(&s->packed, bound)) return false;
+        if (options->compression == TABLR_PARQUET_SNAPPY) {
+            page_len = tablr_snappy_compress((const char*)s->body.data, s->body.len, (char*)s->packed.data);
+        } else if (!tablr_zstd_compress((const char*)s->body.data, s->body.len, (char*)s->packed.data, &page_len)) {
+            return false;
+        }
+        page = s->packed.data;
+    }
+    if (s->body.len > INT32_MAX || page_len > INT32_MAX) return false;
+
+    TablrThriftWriter w;
+    tablr_thrift_writer_init(&w);
+    tablr_thrift_write_i32(&w, 1, dictionary_page ? PQ_DICTIONARY_PAGE : PQ_DATA_PAGE);
+    tablr_thrift_write_i32(&w, 2, (int32_t)s->body.len);
+    tablr_thrift_write_i32(&w, 3, (int32_t)page_len);
+    tablr_thrift_write_struct_begin(&w, dictionary_page ? 7 : 5);
+    tablr_thrift_write_i32(&w, 1, num_values);
+    tablr_thrift_write_i32(&w, 2, encoding);
+    if (!dictionary_page) {
+        tablr_thrift_write_i32(&w, 3, PQ_RLE);
+        tablr_thrift_write_i32(&w, 4, PQ_RLE);
+    }
+    tablr_thrift_write_struct_end(&w);
+    tablr_thrift_write_stop(&w);
+
+    bool ok = !w.failed && buffer_append(chunk, w.data, w.len) && buffer_append(chunk, page, page_len);
+    meta->uncompressed_size += (int64_t)(w.len + s->body.len);
+    meta->compressed_size += (int64_t)(w.len + page_len);
+    tablr_thrift_writer_free(&w);
+    return ok;
+}
+
+/**
+ * @brief Open-addressing dictionary of the strings in one chunk
+ */
+typedef struct {
+    size_t* values;       /**< Row of each distinct string, in first-seen order */
+    size_t count;         /**< Number of distinct strings */
+    size_t bytes;         /**< Plain-encoded dictionary size */
+    uint32_t* slots;      /**< Hash slots holding index + 1, 0 if empty */
+    size_t mask;          /**< Slot count - 1 */
+} PqDictionary;
+
+static uint64_t hash_string(const char* s, size_t len) {
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < len; i++) h = (h ^ (uint8_t)s[i]) * 1099511628211ull;
+    return h;
+}
+
+/**
+ * @brief Check whether rows a and b of a string column hold the same string
+ */
+static bool same_string(const int64_t* offsets, const char* chars, size_t a, size_t b) {
+    int64_t len = offsets[a + 1] - offsets[a];
+    return offsets[b + 1] - offsets[b] == len && memcmp(chars + offsets[a], chars + offsets[b], (size_t)len) == 0;
+}
+
+/**
+ * @brief Build indices for rows [begin, end) of a string column
+ * @return false if the column is not worth dictionary-encoding
+ */
+static bool build_dictionary(const TablrSeries* series, size_t begin, size_t end, PqDictionary* dict, uint32_t* indices) {
+    const int64_t* offsets = tablr_series_string_offsets(series);
+    const char* chars = tablr_series_string_chars(series);
+    size_t rows = end - begin;
+    size_t limit = rows / 2 + 1;
+    size_t nslots = 16;
+    while (nslots < limit * 2) nslots *= 2;
+
+    memset(dict, 0, sizeof(*dict));
+    dict->values = (size_t*)malloc(limit * sizeof(size_t));
+    dict->slots = (uint32_t*)calloc(nslots, sizeof(uint32_t));
+    dict->mask = nslots - 1;
+    if (!dict->values || !dict->slots) return false;
+
+    size_t n = 0;
+    for (size_t i = begin; i < end; i++) {
+        if (!tablr_series_is_valid(series, i)) continue;
+        size_t len = (size_t)(offsets[i + 1] - offsets[i]);
+        size_t slot = (size_t)hash_string(chars + offsets[i], len) & dict->mask;
+        while (dict->slots[slot] && !same_string(offsets, chars, dict->values[dict->slots[slot] - 1], i)) {
+            slot = (slot + 1) & dict->mask;
+        }
+        if (!dict->slots[slot]) {
+            if (dict->count == limit) return false;
+            dict->bytes += 4 + len;
+            if (dict->bytes > PQ_DICT_MAX_BYTES) return false;
+            dict->values[dict->count++] = i;
+            dict->slots[slot] = (uint32_t)dict->count;
+        }
+        indices[n++] = dict->slots[slot] - 1;
+    }
+    return true;
+}
+
+/**
+ * @brief Track min/max of numeric and bool values for statistics
+ */
+static void update_stats(PqChunkMeta* meta, const void* data, TablrDType dtype, size_t i, double* lo, double* hi,
+                         int64_t* ilo, int64_t* ihi) {
+    switch (dtype) {
+        case TABLR_UINT32:
+        case TABLR_UINT64:
+            /* Unsigned bounds would not compare as the signed physical values */
+            return;
+        case TABLR_INT8:
+        case TABLR_INT16:
+        case TABLR_UINT8:
+        case TABLR_UINT16:
+        case TABLR_DATE32:
+        case TABLR_INT32:
+        case TABLR_TIMESTAMP64:
+        case TABLR_INT64: {
+            int64_t v;
+            switch (dtype) {
+                case TABLR_INT8: v = ((const int8_t*)data)[i]; break;
+                case TABLR_INT16: v = ((const int16_t*)data)[i]; break;
+                case TABLR_UINT8: v = ((const uint8_t*)data)[i]; break;
+                case TABLR_UINT16: v = ((const uint16_t*)data)[i]; break;
+                case TABLR_INT32:
+                case TABLR_DATE32: v = ((const int32_t*)data)[i]; break;
+                default: v = ((const int64_t*)data)[i]; break;
+            }
+            if (!meta->has_stats || v < *ilo) *ilo = v;
+            if (!meta->has_stats || v > *ihi) *ihi = v;
+            break;
+        }
+        case TABLR_BOOL: {
+            int64_t v = ((const bool*)data)[i];
+            if (!meta->has_stats || v < *ilo) *ilo = v;
+            if (!meta->has_stats || v > *ihi) *ihi = v;
+            break;
+        }
+        default: {
+            double v = dtype == TABLR_FLOAT32 ? ((const float*)data)[i] : ((const double*)data)[i];
+            if (!meta->has_stats || v < *lo) *lo = v;
+            if (!meta->has_stats || v > *hi) *hi = v;
+            break;
+        }
+    }
+    meta->has_stats = true;
+}
+
+static void store_stats(PqChunkMeta* meta, TablrDType dtype, double lo, double hi, int64_t ilo, int64_t ihi) {
+    if (!meta->has_stats || dtype == TABLR_STRING) {
+        meta->has_stats = false;
+        return;
+    }
+    if (dtype == TABLR_FLOAT32 || dtype == TABLR_FLOAT64) {
+        /* Zero bounds are written as -0.0 / +0.0 so either sign compares inside */
+        if (lo == 0.0) lo = -0.0;
+        if (hi == 0.0) hi = 0.0;
+    }
+    switch (dtype) {
+        case TABLR_INT8:
+        case TABLR_INT16:
+        case TABLR_UINT8:
+        case TABLR_UINT16:
+        case TABLR_DATE32:
+        case TABLR_INT32: {
+            int32_t a = (int32_t)ilo, b = (int32_t)ihi;
+            copy_le(meta->min, &a, 1, 4);
+            copy_le(meta->max, &b, 1, 4);
+            meta->stat_len = 4;
+            break;
+        }
+        case TABLR_TIMESTAMP64:
+        case TABLR_INT64:
+            copy_le(meta->min, &ilo, 1, 8);
+            copy_le(meta->max, &ihi, 1, 8);
+            meta->stat_len = 8;
+            break;
+        case TABLR_BOOL:
+            meta->min[0] = (uint8_t)ilo;
+            meta->max[0] = (uint8_t)ihi;
+            meta->stat_len = 1;
+            break;
+        case TABLR_FLOAT32: {
+            float a = (float)lo, b = (float)hi;
+            copy_le(meta->min, &a, 1, 4);
+            copy_le(meta->max, &b, 1, 4);
+            meta->stat_len = 4;
+            break;
+        }
+        default:
+            copy_le(meta->min, &lo, 1, 8);
+            copy_le(meta->max, &hi, 1, 8);
+            meta->stat_len = 8;
+            break;
+    }
+}
+
+/**
+ * @brief Append the non-null values of rows [begin, end) in PLAIN encoding
+ */
+static bool encode_plain(PqBuffer* buf, const TablrSeries* series, const void* data, TablrDType dtype,
+                         size_t begin, size_t end) {
+    switch (dtype) {
+        case TABLR_STRING: {
+            const int64_t* offsets = (const int64_t*)data;
+            const char* chars = tablr_series_string_chars(series);
+            for (size_t i = begin; i < end; i++) {
+                if (!tablr_series_is_valid(series, i)) continue;
+                size_t len = (size_t)(offsets[i + 1] - offsets[i]);
+                if (len > UINT32_MAX || !buffer_reserve(buf, 4 + len)) return false;
+                store_le32(buf->data + buf->len, (uint32_t)len);
+                memcpy(buf->data + buf->len + 4, chars + offsets[i], len);
+                buf->len += 4 + len;
+            }
+            return true;
+        }
+        case TABLR_BOOL: {
+            const bool* values = (const bool*)data;
+            size_t nbytes = (end - begin + 7) / 8;
+            size_t k = 0;
+            if (!buffer_reserve(buf, nbytes)) return false;
+            memset(buf->data + buf->len, 0, nbytes);
+            for (size_t i = begin; i < end; i++) {
+                if (is_null(series, data, dtype, i)) continue;
+                if (values[i]) buf->data[buf->len + k / 8] |= (uint8_t)(1u << (k & 7));
+                k++;
+            }
+            buf->len += (k + 7) / 8;
+            return true;
+        }
+        case TABLR_INT8:
+        case TABLR_INT16:
+        case TABLR_UINT8:
+        case TABLR_UINT16: {
+            /* Widened to INT32, sign- or zero-extended as the type requires */
+            for (size_t i = begin; i < end; i++) {
+                if (is_null(series, data, dtype, i)) continue;
+                int32_t v;
+                switch (dtype) {
+                    case TABLR_INT8: v = ((const int8_t*)data)[i]; break;
+                    case TABLR_INT16: v = ((const int16_t*)data)[i]; break;
+                    case TABLR_UINT8: v = ((const uint8_t*)data)[i]; break;
+                    default: v = ((const uint16_t*)data)[i]; break;
+                }
+                if (!buffer_reserve(buf, 4)) return false;
+                store_le32(buf->data + buf->len, (uint32_t)v);
+                buf->len += 4;
+            }
+            return true;
+        }
+        default: {
+            size_t width = tablr_dtype_size(dtype);
+            const char* bytes = (const char*)data;
+            size_t i = begin;
+            while (i < end) {
+                /* Copy runs of non-null values at once */
+                while (i < end && is_null(series, data, dtype, i)) i++;
+                size_t j = i;
+                while (j < end && !is_null(series, data, dtype, j)) j++;
+                if (j > i && !buffer_le(buf, bytes + i * width, j - i, width)) return false;
+                i = j;
+            }
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Encode rows [job->begin, job->end) of one column into pages
+ */
+static void write_chunk_task(size_t index, void* ctx) {
+    PqWriteJob* job = (PqWriteJob*)ctx;
+    const TablrSeries* series = tablr_dataframe_column_at(job->df, index);
+    TablrDType dtype = tablr_series_dtype(series);
+    const void* data = tablr_series_data_const(series);
+    size_t begin = job->begin;
+    size_t end = job->end;
+    size_t rows = end - begin;
+
+    PqBuffer* chunk = &job->chunks[index];
+    PqChunkMeta* meta = &job->metas[index];
+    memset(meta, 0, sizeof(*meta));
+    meta->type = dtype_physical(dtype);
+    meta->num_values = (int64_t)rows;
+    meta->dict_page_offset = -1;
+
+    PqPageScratch s;
+    PqDictionary dict;
+    memset(&s, 0, sizeof(s));
+    memset(&dict, 0, sizeof(dict));
+    uint32_t* indices = NULL;
+    bool use_dict = false;
+    bool ok = false;
+
+    s.levels = (uint32_t*)malloc(rows * sizeof(uint32_t));
+    if (!s.levels || (!data && rows > 0)) goto done;
+
+    /* Statistics and null count over the whole chunk */
+    double lo = 0, hi = 0;
+    int64_t ilo = 0, ihi = 0;
+    for (size_t i = begin; i < end; i++) {
+        if (is_null(series, data, dtype, i)) meta->null_count++;
+        else if (dtype != TABLR_STRING) update_stats(meta, data, dtype, i, &lo, &hi, &ilo, &ihi);
+    }
+    store_stats(meta, dtype, lo, hi, ilo, ihi);
+
+    if (dtype == TABLR_STRING && job->options->dictionary && rows > 0) {
+        indices = (uint32_t*)malloc(rows * sizeof(uint32_t));
+        if (!indices) goto done;
+        use_dict = build_dictionary(series, begin, end, &dict, indices);
+    }
+
+    if (use_dict) {
+        meta->dict_page_offset = 0;
+        s.body.len = 0;
+        const int64_t* offsets = (const int64_t*)data;
+        const char* chars = tablr_series_string_chars(series);
+        for (size_t k = 0; k < dict.count; k++) {
+            size_t row = dict.values[k];
+            size_t len = (size_t)(offsets[row + 1] - offsets[row]);
+            uint8_t prefix[4];
+            store_le32(prefix, (uint32_t)len);
+            if (!buffer_append(&s.body, prefix, 4) || !buffer_append(&s.body, chars + offsets[row], len)) goto done;
+        }
+        if (!emit_page(chunk, &s, job->options, true, (int32_t)dict.count, PQ_PLAIN, meta)) goto done;
+    }
+    meta->data_page_offset = (int64_t)chunk->len;
+
+    size_t width = dtype == TABLR_STRING ? 8 : meta->type == PQ_INT32 ? 4 : tablr_dtype_size(dtype);
+    size_t page_rows = PQ_PAGE_BYTES / (use_dict ? 4 : width);
+    size_t dict_width = (size_t)bit_width(dict.count > 1 ? (uint32_t)(dict.count - 1) : 1);
+    size_t next_index = 0;
+
+    for (size_t p = begin; p < end;) {
+        size_t q = p + page_rows < end ? p + page_rows : end;
+        if (dtype == TABLR_STRING && !use_dict) {
+            /* Cut string pages by bytes rather than rows */
+            const int64_t* offsets = (const int64_t*)data;
+            size_t bytes = 0;
+            q = p;
+            while (q < end && bytes < PQ_PAGE_BYTES) {
+                bytes += 4 + (size_t)(offsets[q + 1] - offsets[q]);
+                q++;
+            }
+        }
+
+        size_t valid = 0;
+        for (size_t i = p; i < q; i++) {
+            s.levels[i - p] = is_null(series, data, dtype, i) ? 0 : 1;
+            valid += s.levels[i - p];
+        }
+
+        s.body.len = 0;
+        uint8_t prefix[4] = {0, 0, 0, 0};
+        if (!buffer_append(&s.body, prefix, 4) || !encode_hybrid(&s.body, s.levels, q - p, 1)) goto done;
+        store_le32(s.body.data, (uint32_t)(s.body.len - 4));
+
+        if (use_dict) {
+            uint8_t w = (uint8_t)dict_width;
+            if (!buffer_append(&s.body, &w, 1) || !encode_hybrid(&s.body, indices + next_index, valid, (int)dict_width)) goto done;
+            next_index += valid;
+        } else if (!encode_plain(&s.body, series, data, dtype, p, q)) {
+            goto done;
+        }
+
+        if (!emit_page(chunk, &s, job->options, false, (int32_t)(q - p), use_dict ? PQ_RLE_DICTIONARY : PQ_PLAIN, meta)) goto done;
+        p = q;
+    }
+    ok = true;
+
+done:
+    if (!use_dict) meta->dict_page_offset = -1;
+    job->ok[index] = ok;
+    free(s.body.data);
+    free(s.packed.data);
+    free(s.levels);
+    free(indices);
+    free(dict.values);
+    free(dict.slots);
+}
+
+/**
+ * @brief Write the converted and logical type fields of a schema element
+ *
+ * Timestamps get a TIMESTAMP logical type, which is the only way to mark
+ * nanoseconds, and also the converted type older readers understand for
+ * milliseconds and microseconds.
+ */
+static void write_annotations(TablrThriftWriter* w, TablrDType dtype, TablrTimeUnit unit) {
+    int32_t converted = -1;
+    switch (dtype) {
+        case TABLR_STRING: converted = PQ_CONVERTED_UTF8; break;
+        case TABLR_INT8: converted = PQ_CONVERTED_INT_8; break;
+        case TABLR_INT16: converted = PQ_CONVERTED_INT_16; break;
+        case TABLR_UINT8: converted = PQ_CONVERTED_UINT_8; break;
+        case TABLR_UINT16: converted = PQ_CONVERTED_UINT_16; break;
+        case TABLR_UINT32: converted = PQ_CONVERTED_UINT_32; break;
+        case TABLR_UINT64: converted = PQ_CONVERTED_UINT_64; break;
+        case TABLR_DATE32: converted = PQ_CONVERTED_DATE; break;
+        case TABLR_TIMESTAMP64:
+            if (unit == TABLR_TIME_MILLISECOND) converted = PQ_CONVERTED_TIMESTAMP_MILLIS;
+            if (unit == TABLR_TIME_MICROSECOND) converted = PQ_CONVERTED_TIMESTAMP_MICROS;
+            break;
+        default: break;
+    }
+    if (converted >= 0) tablr_thrift_write_i32(w, 6, converted);
+    if (dtype != TABLR_TIMESTAMP64) return;
+
+    tablr_thrift_write_struct_begin(w, 10);
+    tablr_thrift_write_struct_begin(w, PQ_LOGICAL_TIMESTAMP);
+    tablr_thrift_write_bool(w, 1, true);
+    tablr_thrift_write_struct_begin(w, 2);
+    tablr_thrift_write_struct_begin(w, unit == TABLR_TIME_MILLISECOND ? PQ_TIME_MILLIS
+                                      : unit == TABLR_TIME_NANOSECOND ? PQ_TIME_NANOS : PQ_TIME_MICROS);
+    tablr_thrift_write_struct_end(w);
+    tablr_thrift_write_struct_end(w);
+    tablr_thrift_write_struct_end(w);
+    tablr_thrift_write_struct_end(w);
+}
+
+/**
+ * @brief Serialize FileMetaData for the written row groups
+ */
+static bool write_footer(FILE* f, const TablrDataFrame* df, size_t ncols, const PqChunkMeta* metas,
+                         const int64_t* group_rows, size_t ngroups, const TablrParquetWriteOptions* options) {
+    static const int32_t codecs[] = {PQ_CODEC_UNCOMPRESSED, PQ_CODEC_SNAPPY, PQ_CODEC_ZSTD};
+    TablrThriftWriter w;
+    tablr_thrift_writer_init(&w);
+
+    tablr_thrift_write_i32(&w, 1, 1);
+
+    tablr_thrift_write_list_begin(&w, 2, TABLR_THRIFT_STRUCT, (uint32_t)(ncols + 1));
+    tablr_thrift_write_elem_struct_begin(&w);
+    tablr_thrift_write_binary(&w, 4, "schema", 6);
+    tablr_thrift_write_i32(&w, 5, (int32_t)ncols);
+    tablr_thrift_write_struct_end(&w);
+    for (size_t c = 0; c < ncols; c++) {
+        const TablrSeries* series = tablr_dataframe_column_at(df, c);
+        TablrDType dtype = tablr_series_dtype(series);
+        tablr_thrift_write_elem_struct_begin(&w);
+        tablr_thrift_write_i32(&w, 1, dtype_physical(dtype));
+        tablr_thrift_write_i32(&w, 3, PQ_OPTIONAL);
+        const char* name = tablr_dataframe_column_name_at(df, c);
+        tablr_thrift_write_binary(&w, 4, name, strlen(name));
+        write_annotations(&w, dtype, tablr_series_time_unit(series));
+        tablr_thrift_write_struct_end(&w);
+    }
+
+    int64_t total_rows = 0;
+    for (size_t g = 0; g < ngroups; g++) total_rows += group_rows[g];
+    tablr_thrift_write_i64(&w, 3, total_rows);
+
+    tablr_thrift_write_list_begin(&w, 4, TABLR_THRIFT_STRUCT, (uint32_t)ngroups);
+    for (size_t g = 0; g < ngroups; g++) {
+        const PqChunkMeta* group = metas + g * ncols;
+        int64_t uncompressed = 0, compressed = 0;
+
+        tablr_thrift_write_elem_struct_begin(&w);
+        tablr_thrift_write_list_begin(&w, 1, TABLR_THRIFT_STRUCT, (uint32_t)ncols);
+        for (size_t c = 0; c < ncols; c++) {
+            const PqChunkMeta* m = &group[c];
+            int64_t first = m->dict_page_offset >= 0 ? m->dict_page_offset : m->data_page_offset;
+            uncompressed += m->uncompressed_size;
+            compressed += m->compressed_size;
+
+            tablr_thrift_write_elem_struct_begin(&w);
+            tablr_thrift_write_i64(&w, 2, first);
+            tablr_thrift_write_struct_begin(&w, 3);
+            tablr_thrift_write_i32(&w, 1, m->type);
+            if (m->dict_page_offset >= 0) {
+                tablr_thrift_write_list_begin(&w, 2, TABLR_THRIFT_I32, 3);
+                tablr_thrift_write_elem_i32(&w, PQ_PLAIN);
+                tablr_thrift_write_elem_i32(&w, PQ_RLE);
+                tablr_thrift_write_elem_i32(&w, PQ_RLE_DICTIONARY);
+            } else {
+                tablr_thrift_write_list_begin(&w, 2, TABLR_THRIFT_I32, 2);
+                tablr_thrift_write_elem_i32(&w, PQ_PLAIN);
+                tablr_thrift_write_elem_i32(&w, PQ_RLE);
+            }
+            tablr_thrift_write_list_begin(&w, 3, TABLR_THRIFT_BINARY, 1);
+            const char* name = tablr_dataframe_column_name_at(df, c);
+            tablr_thrift_write_elem_binary(&w, name, strlen(name));
+            tablr_thrift_write_i32(&w, 4, codecs[options->compression]);
+            tablr_thrift_write_i64(&w, 5, m->num_values);
+            tablr_thrift_write_i64(&w, 6, m->uncompressed_size);
+            tablr_thrift_write_i64(&w, 7, m->compressed_size);
+            tablr_thrift_write_i64(&w, 9, m->data_page_offset);
+            if (m->dict_page_offset >= 0) tablr_thrift_write_i64(&w, 11, m->dict_page_offset);
+            tablr_thrift_write_struct_begin(&w, 12);
+            tablr_thrift_write_i64(&w, 3, m->null_count);
+            if (m->has_stats) {
+                tablr_thrift_write_binary(&w, 5, m->max, m->stat_len);
+                tablr_thrift_write_binary(&w, 6, m->min, m->stat_len);
+            }
+            tablr_thrift_write_struct_end(&w);
+            tablr_thrift_write_struct_end(&w);
+            tablr_thrift_write_struct_end(&w);
+        }
+        tablr_thrift_write_i64(&w, 2, uncompressed);
+        tablr_thrift_write_i64(&w, 3, group_rows[g]);
+        if (ncols > 0) {
+            tablr_thrift_write_i64(&w, 5, group[0].dict_page_offset >= 0 ? group[0].dict_page_offset : group[0].data_page_offset);
+        }
+        tablr_thrift_write_i64(&w, 6, compressed);
+        tablr_thrift_write_struct_end(&w);
+    }
+
+    tablr_thrift_write_binary(&w, 6, PQ_CREATED_BY, strlen(PQ_CREATED_BY));
+    tablr_thrift_write_stop(&w);
+
+    uint8_t trailer[4 + PQ_MAGIC_LEN];
+    store_le32(trailer, (uint32_t)w.len);
+    memcpy(trailer + 4, PQ_MAGIC, PQ_MAGIC_LEN);
+
+    bool ok = !w.failed && w.len <= UINT32_MAX && fwrite(w.data, 1, w.len, f) == w.len &&
+              fwrite(trailer, 1, sizeof(trailer), f) == sizeof(trailer);
+    tablr_thrift_writer_free(&w);
+    return ok;
+}
+
+/**
+ * @brief Get default Parquet write options
+ * @return Options writing 1M-row groups with snappy pages and string dictionaries
+ */
+TablrParquetWriteOptions tablr_parquet_write_options_default(void) {
+    TablrParquetWriteOptions options;
+    options.row_group_rows = PQ_DEFAULT_ROW_GROUP_ROWS;
+    options.compression = TABLR_PARQUET_SNAPPY;
+    options.dictionary = true;
+    return options;
+}
+
+/**
+ * @brief Whether a column has no Parquet representation of its own
+ *
+ * Categoricals are written as strings, bitmasks as bools and second
+ * timestamps, which Parquet has no unit for, as milliseconds.
+ */
+static bool needs_conversion(const TablrSeries* series) {
+    TablrDType dtype = tablr_series_dtype(series);
+    return dtype == TABLR_CATEGORICAL || dtype == TABLR_BITMASK ||
+           (dtype == TABLR_TIMESTAMP64 && tablr_series_time_unit(series) == TABLR_TIME_SECOND);
+}
+
+/**
+ * @brief Convert a second timestamp series to milliseconds
+ * @return New series, or NULL on failure or overflow
+ */
+static TablrSeries* seconds_to_millis(const TablrSeries* series) {
+    size_t n = tablr_series_size(series);
+    const int64_t* src = (const int64_t*)tablr_series_data_const(series);
+    TablrSeries* out = tablr_series_alloc(n, TABLR_TIMESTAMP64, tablr_series_device(series));
+    int64_t* dst = (int64_t*)tablr_series_data(out);
+    bool ok = dst && (src || n == 0) && tablr_series_set_time_unit(out, TABLR_TIME_MILLISECOND);
+    for (size_t i = 0; ok && i < n; i++) {
+        if (!tablr_series_is_valid(series, i)) {
+            dst[i] = 0;
+            ok = tablr_series_set_valid(out, i, false);
+        } else if (src[i] > INT64_MAX / 1000 || src[i] < INT64_MIN / 1000) {
+            ok = false;
+        } else {
+            dst[i] = src[i] * 1000;
+        }
+    }
+    if (!ok) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+/**
+ * @brief Copy of a dataframe with every column in a form Parquet can store
+ *
+ * Converts the columns needs_conversion() picks; other columns are shared
+ * views.
+ *
+ * @param df DataFrame to convert
+ * @param plain Output copy, or NULL if no column needs converting
+ * @return false on failure
+ */
+static bool convert_columns(const TablrDataFrame* df, TablrDataFrame** plain) {
+    size_t ncols = tablr_dataframe_ncols(df);
+    bool any = false;
+    for (size_t c = 0; c < ncols; c++) {
+        if (needs_conversion(tablr_dataframe_column_at(df, c))) any = true;
+    }
+    *plain = NULL;
+    if (!any) return true;
+
+    *plain = tablr_dataframe_create();
+    for (size_t c = 0; *plain && c < ncols; c++) {
+        const TablrSeries* column = tablr_dataframe_column_at(df, c);
+        TablrDType dtype = tablr_series_dtype(column);
+        TablrSeries* series = dtype == TABLR_CATEGORICAL ? tablr_series_from_categorical(column)
+            : dtype == TABLR_BITMASK ? tablr_series_from_bitmask(column)
+            : needs_conversion(column) ? seconds_to_millis(column)
+            : tablr_series_slice(column, 0, tablr_series_size(column));
+        if (!series || !tablr_dataframe_add_column(*plain, tablr_dataframe_column_name_at(df, c), series)) {
+            tablr_series_free(series);
+            tablr_dataframe_free(*plain);
+            *plain = NULL;
+        }
+    }
+    return *plain != NULL;
+}
+
+/**
+ * @brief Write dataframe to a Parquet file
+ *
+ * Columns are encoded in parallel one row group at a time, so memory use is
+ * bounded by the encoded size of a single row group. Categorical columns are
+ * written as strings, bitmask columns as BOOLEAN, 8- and 16-bit integers as
+ * annotated INT32, and timestamps in seconds as milliseconds.
+ *
+ * @param df DataFrame to write
+ * @param filename Output file path
+ * @param options Write options (NULL for defaults)
+ * @return true on success, false on failure or if zstd is requested but unavailable
+ */
+bool tablr_write_parquet(const TablrDataFrame* df, const char* filename, const TablrParquetWriteOptions* options) {
+    if (!df || !filename) return false;
+
+    TablrParquetWriteOptions defaults = tablr_parquet_write_options_default();
+    if (!options) options = &defaults;
+    if ((unsigned)options->compression > TABLR_PARQUET_ZSTD) return false;
+    if (options->compression == TABLR_PARQUET_ZSTD && !tablr_zstd_available()) return false;
+
+    TablrDataFrame* plain;
+    if (!convert_columns(df, &plain)) return false;
+    if (plain) {
+        bool written = tablr_write_parquet(plain, filename, options);
+        tablr_dataframe_free(plain);
+        return written;
+    }
+
+    size_t nrows = tablr_dataframe_nrows(df);
+    size_t ncols = tablr_dataframe_ncols(df);
+    if (ncols == 0) nrows = 0;
+
+    size_t group_rows = options->row_group_rows ? options->row_group_rows : (nrows ? nrows : 1);
+    size_t ngroups = (nrows + group_rows - 1) / group_rows;
+
+    FILE* f = fopen(filename, "wb");
+    PqBuffer* chunks = (PqBuffer*)calloc(ncols ? ncols : 1, sizeof(PqBuffer));
+    size_t nchunks = ngroups * ncols;
+    PqChunkMeta* metas = (PqChunkMeta*)calloc(nchunks ? nchunks : 1, sizeof(PqChunkMeta));
+    int64_t* rows = (int64_t*)calloc(ngroups ? ngroups : 1, sizeof(int64_t));
+    bool* ok = (bool*)calloc(ncols ? ncols : 1, sizeof(bool));
+    bool success = f && chunks && metas && rows && ok && fwrite(PQ_MAGIC, 1, PQ_MAGIC_LEN, f) == PQ_MAGIC_LEN;
+    int64_t pos = PQ_MAGIC_LEN;
+
+    for (size_t g = 0; g < ngroups && success; g++) {
+        PqWriteJob job;
+        job.df = df;
+        job.options = options;
+        job.begin = g * group_rows;
+        job.end = job.begin + group_rows < nrows ? job.begin + group_rows : nrows;
+        job.chunks = chunks;
+        job.metas = metas + g * ncols;
+        job.ok = ok;
+        rows[g] = (int64_t)(job.end - job.begin);
+
+        for (size_t c = 0; c < ncols; c++) chunks[c].len = 0;
+        tablr_parallel_for(ncols, write_chunk_task, &job);
+
+        for (size_t c = 0; c < ncols && success; c++) {
+            PqChunkMeta* m = &job.metas[c];
+            success = ok[c] && fwrite(chunks[c].data, 1, chunks[c].len, f) == chunks[c].len;
+            m->data_page_offset += pos;
+            if (m->dict_page_offset >= 0) m->dict_page_offset += pos;
+            pos += (int64_t)chunks[c].len;
+        }
+    }
+
+    if (success) success = write_footer(f, df, ncols, metas, rows, ngroups, options);
+    if (f && fclose(f) != 0) success = false;
+
+    for (size_t c = 0; c < ncols; c++) {
+        if (chunks) free(chunks[c].data);
+    }
+    free(chunks);
+    free(metas);
+    free(rows);
+    free(ok);
+    return success;
+}
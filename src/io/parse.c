@@ -0,0 +1,689 @@
+/**
+ * @file parse.c
+ * @brief Implementation of locale-independent numeric parsing
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * This file implements integer and floating point parsing for text ingest.
+ * Digits are consumed eight at a time with SWAR (SIMD within a register)
+ * arithmetic. Doubles use the exact Clinger fast path for short inputs and
+ * the Eisel-Lemire algorithm otherwise, which is correctly rounded for up to
+ * 19 significant digits. Longer inputs that Eisel-Lemire cannot resolve fall
+ * back to strtod with the decimal point translated to the current locale.
+ * ISO-8601 dates and timestamps are read field by field at fixed positions.
+ */
+
+#include "tablr/io/parse.h"
+#include "pow5_table.h"
+#include "calendar.h"
+#include <float.h>
+#include <locale.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#define MAX_SIG_DIGITS 19                     /**< Digits that always fit in uint64 */
+#define MIN_19_DIGIT 1000000000000000000ULL  /**< Smallest 19-digit integer */
+#define MANTISSA_BITS 52                      /**< Explicit double mantissa bits */
+#define MIN_EXPONENT (-1023)                  /**< Double exponent bias */
+#define INFINITE_POWER 0x7FF                  /**< Biased exponent of infinity */
+#define ROUND_EVEN_MIN_EXP (-4)               /**< Range where halfway cases can occur */
+#define ROUND_EVEN_MAX_EXP 23
+#define CLINGER_MAX_EXP 22                    /**< Largest exact power of ten in a double */
+#define EXPONENT_LIMIT 0x10000                /**< Saturation bound for explicit exponents */
+
+/**
+ * @brief Exactly representable powers of ten for the Clinger fast path
+ */
+static const double exact_pow10[CLINGER_MAX_EXP + 1] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * @brief 128-bit unsigned product
+ */
+typedef struct {
+    uint64_t low;   /**< Low 64 bits */
+    uint64_t high;  /**< High 64 bits */
+} U128;
+
+/**
+ * @brief Binary mantissa and biased exponent of a double
+ */
+typedef struct {
+    uint64_t mantissa;  /**< Mantissa without the implicit bit */
+    int32_t power2;     /**< Biased binary exponent */
+} AdjustedMantissa;
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 uint128_native;
+#endif
+
+/**
+ * @brief Full 64x64 -> 128-bit multiplication
+ */
+static U128 full_mul(uint64_t a, uint64_t b) {
+    U128 r;
+#if defined(__SIZEOF_INT128__)
+    uint128_native p = (uint128_native)a * b;
+    r.low = (uint64_t)p;
+    r.high = (uint64_t)(p >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    r.low = _umul128(a, b, &r.high);
+#else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    r.high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    r.low = (cross << 32) | (uint32_t)lo_lo;
+#endif
+    return r;
+}
+
+/**
+ * @brief Count leading zero bits of a nonzero value
+ */
+static int leading_zeroes(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(v);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, v);
+    return 63 - (int)index;
+#else
+    int n = 0;
+    while (!(v & 0x8000000000000000ULL)) {
+        v <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/**
+ * @brief Load eight bytes as a little-endian word
+ */
+static uint64_t load8(const char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+/**
+ * @brief Check whether all eight bytes of a word are ASCII digits
+ */
+static bool is_eight_digits(uint64_t v) {
+    return !(((v + 0x4646464646464646ULL) | (v - 0x3030303030303030ULL)) & 0x8080808080808080ULL);
+}
+
+/**
+ * @brief Convert eight ASCII digits packed in a word to their value
+ */
+static uint32_t parse_eight_digits(uint64_t v) {
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 0x000F424000000064ULL;  /* 100 + (1000000 << 32) */
+    const uint64_t mul2 = 0x0000271000000001ULL;  /* 1 + (10000 << 32) */
+    v -= 0x3030303030303030ULL;
+    v = (v * 10) + (v >> 8);
+    v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+    return (uint32_t)v;
+}
+
+/**
+ * @brief Consume a run of digits, accumulating into value (wrapping)
+ * @return Pointer to the first non-digit
+ */
+static const char* scan_digits(const char* p, const char* end, uint64_t* value) {
+    uint64_t v = *value;
+
+    while (end - p >= 8) {
+        uint64_t chunk = load8(p);
+        if (!is_eight_digits(chunk)) break;
+        v = v * 100000000ULL + parse_eight_digits(chunk);
+        p += 8;
+    }
+    while (p < end && (unsigned char)(*p - '0') < 10) {
+        v = v * 10 + (uint64_t)(*p - '0');
+        p++;
+    }
+
+    *value = v;
+    return p;
+}
+
+/**
+ * @brief Strip leading and trailing blanks
+ */
+static void trim(const char** p, const char** end) {
+    while (*p < *end && (**p == ' ' || **p == '\t')) (*p)++;
+    while (*end > *p && ((*end)[-1] == ' ' || (*end)[-1] == '\t')) (*end)--;
+}
+
+/**
+ * @brief Case-insensitive match of [p, end) against a lowercase literal
+ */
+static bool match_literal(const char* p, const char* end, const char* lit) {
+    size_t n = strlen(lit);
+    if ((size_t)(end - p) != n) return false;
+    for (size_t i = 0; i < n; i++) {
+        if ((p[i] | 0x20) != lit[i]) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Parse optional sign and digits of an integer
+ */
+static bool parse_magnitude(const char* text, size_t len, bool* neg, uint64_t* mag) {
+    const char* p = text;
+    const char* end = text + len;
+    if (!text) return false;
+    trim(&p, &end);
+
+    *neg = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        *neg = *p == '-';
+        p++;
+    }
+
+    const char* digits = p;
+    while (p < end && *p == '0') p++;
+    const char* sig = p;
+
+    uint64_t v = 0;
+    p = scan_digits(p, end, &v);
+    if (p != end || p == digits || p - sig > MAX_SIG_DIGITS) return false;
+
+    *mag = v;
+    return true;
+}
+
+/**
+ * @brief Parse a decimal integer into int64
+ *
+ * Accepts an optional sign and surrounding blanks. Rejects overflow.
+ *
+ * @param text Field text
+ * @param len Field length
+ * @param out Output value
+ * @return true on success, false if the field is not a valid int64
+ */
+bool tablr_parse_int64(const char* text, size_t len, int64_t* out) {
+    bool neg;
+    uint64_t mag;
+    if (!out || !parse_magnitude(text, len, &neg, &mag)) return false;
+
+    if (neg) {
+        if (mag > (uint64_t)INT64_MAX + 1) return false;
+        *out = mag == (uint64_t)INT64_MAX + 1 ? INT64_MIN : -(int64_t)mag;
+    } else {
+        if (mag > (uint64_t)INT64_MAX) return false;
+        *out = (int64_t)mag;
+    }
+    return true;
+}
+
+/**
+ * @brief Parse a decimal integer into int32
+ *
+ * @param text Field text
+ * @param len Field length
+ * @param out Output value
+ * @return true on success, false if the field is not a valid int32
+ */
+bool tablr_parse_int32(const char* text, size_t len, int32_t* out) {
+    int64_t v;
+    if (!out || !tablr_parse_int64(text, len, &v)) return false;
+    if (v < INT32_MIN || v > INT32_MAX) return false;
+    *out = (int32_t)v;
+    return true;
+}
+
+/**
+ * @brief Parse a decimal integer into uint64
+ *
+ * Accepts an optional '+' and surrounding blanks. The first 19 significant
+ * digits go through the SWAR scanner; a 20th is checked against UINT64_MAX.
+ *
+ * @param text Field text
+ * @param len Field length
+ * @param out Output value
+ * @return true on success, false if the field is not a valid uint64
+ */
+bool tablr_parse_uint64(const char* text, size_t len, uint64_t* out) {
+    if (!text || !out) return false;
+
+    const char* p = text;
+    const char* end = text + len;
+    trim(&p, &end);
+    if (p < end && *p == '+') p++;
+
+    const char* digits = p;
+    while (p < end && *p == '0') p++;
+    const char* sig = p;
+
+    uint64_t v = 0;
+    const char* stop = end - sig > MAX_SIG_DIGITS ? sig + MAX_SIG_DIGITS : end;
+    p = scan_digits(p, stop, &v);
+    if (p == digits) return false;
+    if (p < end) {
+        unsigned d = (unsigned)(unsigned char)(*p - '0');
+        if (p != stop || end - p != 1 || d >= 10) return false;
+        if (v > UINT64_MAX / 10 || (v == UINT64_MAX / 10 && d > UINT64_MAX % 10)) return false;
+        v = v * 10 + d;
+    }
+
+    *out = v;
+    return true;
+}
+
+/**
+ * @brief Read exactly n ASCII digits
+ */
+static bool fixed_digits(const char* p, int n, unsigned* out) {
+    unsigned v = 0;
+    for (int i = 0; i < n; i++) {
+        unsigned d = (unsigned)(unsigned char)(p[i] - '0');
+        if (d >= 10) return false;
+        v = v * 10 + d;
+    }
+    *out = v;
+    return true;
+}
+
+/**
+ * @brief Parse the YYYY-MM-DD at the start of [p, end)
+ * @return Pointer past the date, or NULL if there is no valid date
+ */
+static const char* parse_date_part(const char* p, const char* end, int64_t* days) {
+    unsigned year, month, day;
+    if (end - p < 10 || p[4] != '-' || p[7] != '-') return NULL;
+    if (!fixed_digits(p, 4, &year) || !fixed_digits(p + 5, 2, &month) || !fixed_digits(p + 8, 2, &day)) return NULL;
+    if (month < 1 || month > 12 || day < 1 || day > calendar_days_in_month(year, month)) return NULL;
+
+    *days = calendar_days_from_civil(year, month, day);
+    return p + 10;
+}
+
+/**
+ * @brief Parse an ISO-8601 calendar date
+ *
+ * Accepts YYYY-MM-DD with surrounding blanks. Fields are read at fixed
+ * positions, so no scanning or library calls are involved.
+ *
+ * @param text Field text
+ * @param len Field length
+ * @param out Output days since 1970-01-01
+ * @return true on success, false if the field is not a valid date
+ */
+bool tablr_parse_date32(const char* text, size_t len, int32_t* out) {
+    if (!text || !out) return false;
+
+    const char* p = text;
+    const char* end = text + len;
+    trim(&p, &end);
+
+    int64_t days;
+    p = parse_date_part(p, end, &days);
+    if (!p || p != end) return false;
+    *out = (int32_t)days;
+    return true;
+}
+
+/**
+ * @brief Parse an ISO-8601 date and time
+ *
+ * Accepts YYYY-MM-DD, optionally followed by 'T' or a space and HH:MM,
+ * HH:MM:SS or HH:MM:SS.fffffffff (up to nine fraction digits, '.' or ','),
+ * and an optional zone: Z, +HH, +HHMM or +HH:MM. Times with a zone are
+ * converted to UTC; times without one are taken as UTC. Fraction digits
+ * finer than unit are truncated.
+ *
+ * @param text Field text
+ * @param len Field length
+ * @param unit Resolution of the result
+ * @param out Output time since 1970-01-01T00:00:00 UTC in unit
+ * @return true on success, false if the field is not a valid timestamp or
+ *         does not fit in int64 at unit
+ */
+bool tablr_parse_timestamp(const char* text, size_t len, TablrTimeUnit unit, int64_t* out) {
+    if (!text || !out) return false;
+
+    const char* p = text;
+    const char* end = text + len;
+    trim(&p, &end);
+
+    int64_t days;
+    p = parse_date_part(p, end, &days);
+    if (!p) return false;
+
+    unsigned hour = 0, minute = 0, second = 0;
+    uint64_t fraction = 0;
+    int fraction_digits = 0;
+    int64_t offset = 0;
+    if (p < end) {
+        if ((*p != 'T' && *p != 't' && *p != ' ') || end - p < 6 || p[3] != ':') return false;
+        if (!fixed_digits(p + 1, 2, &hour) || !fixed_digits(p + 4, 2, &minute)) return false;
+        p += 6;
+        if (p < end && *p == ':') {
+            if (end - p < 3 || !fixed_digits(p + 1, 2, &second)) return false;
+            p += 3;
+            if (p < end && (*p == '.' || *p == ',')) {
+                p++;
+                while (p < end && (unsigned char)(*p - '0') < 10) {
+                    if (fraction_digits == 9) return false;
+                    fraction = fraction * 10 + (uint64_t)(*p - '0');
+                    fraction_digits++;
+                    p++;
+                }
+                if (fraction_digits == 0) return false;
+            }
+        }
+        if (hour > 23 || minute > 59 || second > 59) return false;
+
+        if (p < end && (*p == 'Z' || *p == 'z')) {
+            p++;
+        } else if (p < end && (*p == '+' || *p == '-')) {
+            bool behind = *p == '-';
+            unsigned zone_hour, zone_minute = 0;
+            p++;
+            if (end - p < 2 || !fixed_digits(p, 2, &zone_hour)) return false;
+            p += 2;
+            if (p < end && *p == ':') p++;
+            if (p < end) {
+                if (end - p < 2 || !fixed_digits(p, 2, &zone_minute)) return false;
+                p += 2;
+            }
+            if (zone_hour > 23 || zone_minute > 59) return false;
+            offset = (int64_t)zone_hour * 3600 + zone_minute * 60;
+            if (behind) offset = -offset;
+        }
+        if (p != end) return false;
+    }
+
+    int64_t seconds = days * CALENDAR_SECONDS_PER_DAY + hour * 3600 + minute * 60 + second - offset;
+    int64_t per_second = tablr_time_unit_per_second(unit);
+    int unit_digits = unit == TABLR_TIME_NANOSECOND ? 9 : unit == TABLR_TIME_MICROSECOND ? 6
+                    : unit == TABLR_TIME_MILLISECOND ? 3 : 0;
+    for (; fraction_digits > unit_digits; fraction_digits--) fraction /= 10;
+    for (; fraction_digits < unit_digits; fraction_digits++) fraction *= 10;
+
+    int64_t sub = (int64_t)fraction;
+    if (seconds >= 0 ? seconds > (INT64_MAX - sub) / per_second : seconds < INT64_MIN / per_second) return false;
+    *out = seconds * per_second + sub;
+    return true;
+}
+
+/**
+ * @brief 128-bit approximation of w * 5^q
+ *
+ * The second table word is only needed when the bits below the required
+ * precision are all ones.
+ */
+static U128 product_approximation(int64_t q, uint64_t w) {
+    const uint64_t precision_mask = 0xFFFFFFFFFFFFFFFFULL >> (MANTISSA_BITS + 3);
+    size_t index = (size_t)(2 * (q - POW5_MIN_EXP));
+
+    U128 first = full_mul(w, pow5_table[index]);
+    if ((first.high & precision_mask) == precision_mask) {
+        U128 second = full_mul(w, pow5_table[index + 1]);
+        first.low += second.high;
+        if (second.high > first.low) first.high++;
+    }
+    return first;
+}
+
+/**
+ * @brief Eisel-Lemire conversion of w * 10^q to a double
+ *
+ * Correctly rounded for any w < 2^64 (Mushtak and Lemire, "Fast Number
+ * Parsing Without Fallback").
+ */
+static AdjustedMantissa compute_float(int64_t q, uint64_t w) {
+    AdjustedMantissa am;
+
+    if (w == 0 || q < POW5_MIN_EXP) {
+        am.mantissa = 0;
+        am.power2 = 0;
+        return am;
+    }
+    if (q > POW5_MAX_EXP) {
+        am.mantissa = 0;
+        am.power2 = INFINITE_POWER;
+        return am;
+    }
+
+    int lz = leading_zeroes(w);
+    w <<= lz;
+
+    U128 product = product_approximation(q, w);
+    int upperbit = (int)(product.high >> 63);
+    int shift = upperbit + 64 - MANTISSA_BITS - 3;
+
+    am.mantissa = product.high >> shift;
+    am.power2 = (int32_t)((((152170 + 65536) * (int32_t)q) >> 16) + 63 + upperbit - lz - MIN_EXPONENT);
+
+    if (am.power2 <= 0) {
+        /* Subnormal or zero */
+        if (-am.power2 + 1 >= 64) {
+            am.mantissa = 0;
+            am.power2 = 0;
+            return am;
+        }
+        am.mantissa >>= -am.power2 + 1;
+        am.mantissa += am.mantissa & 1;
+        am.mantissa >>= 1;
+        am.power2 = am.mantissa < (1ULL << MANTISSA_BITS) ? 0 : 1;
+        return am;
+    }
+
+    /* Exactly halfway between two doubles: round to even */
+    if (product.low <= 1 && q >= ROUND_EVEN_MIN_EXP && q <= ROUND_EVEN_MAX_EXP &&
+        (am.mantissa & 3) == 1) {
+        if ((am.mantissa << shift) == product.high) {
+            am.mantissa &= ~1ULL;
+        }
+    }
+
+    am.mantissa += am.mantissa & 1;
+    am.mantissa >>= 1;
+    if (am.mantissa >= (2ULL << MANTISSA_BITS)) {
+        am.mantissa = 1ULL << MANTISSA_BITS;
+        am.power2++;
+    }
+
+    am.mantissa &= ~(1ULL << MANTISSA_BITS);
+    if (am.power2 >= INFINITE_POWER) {
+        am.mantissa = 0;
+        am.power2 = INFINITE_POWER;
+    }
+    return am;
+}
+
+/**
+ * @brief Assemble a double from its parts
+ */
+static double to_double(AdjustedMantissa am, bool neg) {
+    uint64_t bits = am.mantissa | ((uint64_t)am.power2 << MANTISSA_BITS);
+    if (neg) bits |= 1ULL << 63;
+
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+/**
+ * @brief Slow path through strtod for inputs Eisel-Lemire cannot resolve
+ *
+ * Translates '.' to the locale decimal point so the result does not depend
+ * on the current locale.
+ */
+static bool parse_double_fallback(const char* p, const char* end, double* out) {
+    size_t len = (size_t)(end - p);
+    const char* point = localeconv()->decimal_point;
+    size_t point_len = point && point[0] ? strlen(point) : 1;
+
+    char* buf = (char*)malloc(len * point_len + 1);
+    if (!buf) return false;
+
+    size_t n = 0;
+    for (const char* q = p; q < end; q++) {
+        if (*q == '.' && point && point[0]) {
+            memcpy(buf + n, point, point_len);
+            n += point_len;
+        } else {
+            buf[n++] = *q;
+        }
+    }
+    buf[n] = '\0';
+
+    char* endp;
+    *out = strtod(buf, &endp);
+    bool ok = endp == buf + n;
+    free(buf);
+    return ok;
+}
+
+/**
+ * @brief Parse a decimal floating point number
+ *
+ * Accepts an optional sign, digits with an optional '.' fraction, an optional
+ * exponent, and the literals nan/inf/infinity in any letter case. Surrounding
+ * blanks are ignored. The result is correctly rounded and does not depend on
+ * the current locale.
+ *
+ * @param text Field text
+ * @param len Field length
+ * @param out Output value
+ * @return true on success, false if the field is not a valid number
+ */
+bool tablr_parse_double(const char* text, size_t len, double* out) {
+    if (!text || !out) return false;
+
+    const char* p = text;
+    const char* end = text + len;
+    trim(&p, &end);
+    const char* start = p;
+    if (p == end) return false;
+
+    bool neg = false;
+    if (*p == '-' || *p == '+') {
+        neg = *p == '-';
+        p++;
+    }
+
+    if (p < end && ((*p | 0x20) == 'n' || (*p | 0x20) == 'i')) {
+        if (match_literal(p, end, "nan")) {
+            *out = neg ? -NAN : NAN;
+            return true;
+        }
+        if (match_literal(p, end, "inf") || match_literal(p, end, "infinity")) {
+            *out = neg ? -INFINITY : INFINITY;
+            return true;
+        }
+        return false;
+    }
+
+    uint64_t mant = 0;
+    const char* int_start = p;
+    p = scan_digits(p, end, &mant);
+    const char* int_end = p;
+
+    const char* frac_start = p;
+    const char* frac_end = p;
+    if (p < end && *p == '.') {
+        p++;
+        frac_start = p;
+        p = scan_digits(p, end, &mant);
+        frac_end = p;
+    }
+
+    size_t digit_count = (size_t)(int_end - int_start) + (size_t)(frac_end - frac_start);
+    if (digit_count == 0) return false;
+
+    int64_t exp_number = 0;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool exp_neg = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            exp_neg = *p == '-';
+            p++;
+        }
+        if (p == end) return false;
+        while (p < end && (unsigned char)(*p - '0') < 10) {
+            if (exp_number < EXPONENT_LIMIT) exp_number = exp_number * 10 + (*p - '0');
+            p++;
+        }
+        if (exp_neg) exp_number = -exp_number;
+    }
+    if (p != end) return false;
+
+    int64_t exponent = exp_number - (int64_t)(frac_end - frac_start);
+
+    /* Keep only the first 19 significant digits if there are more */
+    bool truncated = false;
+    if (digit_count > MAX_SIG_DIGITS) {
+        const char* s = int_start;
+        while (s < int_end && *s == '0') {
+            s++;
+            digit_count--;
+        }
+        if (s == int_end) {
+            for (const char* f = frac_start; f < frac_end && *f == '0'; f++) digit_count--;
+        }
+
+        if (digit_count > MAX_SIG_DIGITS) {
+            truncated = true;
+            mant = 0;
+            const char* q = int_start;
+            while (mant < MIN_19_DIGIT && q < int_end) {
+                mant = mant * 10 + (uint64_t)(*q++ - '0');
+            }
+            if (mant >= MIN_19_DIGIT) {
+                exponent = (int64_t)(int_end - q) + exp_number;
+            } else {
+                q = frac_start;
+                while (mant < MIN_19_DIGIT && q < frac_end) {
+                    mant = mant * 10 + (uint64_t)(*q++ - '0');
+                }
+                exponent = (int64_t)(frac_start - q) + exp_number;
+            }
+        }
+    }
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    /* Clinger: both operands exact, so one IEEE operation rounds correctly */
+    if (!truncated && mant <= (1ULL << 53) &&
+        exponent >= -CLINGER_MAX_EXP && exponent <= CLINGER_MAX_EXP) {
+        double d = (double)mant;
+        d = exponent < 0 ? d / exact_pow10[-exponent] : d * exact_pow10[exponent];
+        *out = neg ? -d : d;
+        return true;
+    }
+#else
+    (void)exact_pow10;
+#endif
+
+    AdjustedMantissa am = compute_float(exponent, mant);
+    if (truncated) {
+        AdjustedMantissa up = compute_float(exponent, mant + 1);
+        if (up.mantissa != am.mantissa || up.power2 != am.power2) {
+            return parse_double_fallback(start, end, out);
+        }
+    }
+
+    *out = to_double(am, neg);
+    return true;
+}
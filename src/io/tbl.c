@@ -0,0 +1,749 @@
+/**
+ * @file tbl.c
+ * @brief Implementation of the native columnar file format
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * A .tbl file is a fixed header, a column directory, the column names and
+ * then one 64-byte aligned section per column holding the values exactly as
+ * they are laid out in memory, followed by optional per-block min/max
+ * statistics. Reading maps the file copy-on-write and creates series that
+ * point straight into the mapping, so opening costs no I/O beyond the
+ * directory; pages are faulted in as columns are used. The mapping stays
+ * alive until the last series that uses it is freed.
+ *
+ * String columns store nrows + 1 int64 offsets starting at 0, followed by
+ * the characters of every row back to back, which is the in-memory layout, so
+ * they are loaded in place too. Bitmask columns store their 64-bit words
+ * and have no statistics. Columns with nulls add a validity bitmap
+ * section after their data.
+ *
+ * Values are stored in host byte order; files record a byte order marker and
+ * are rejected on hosts with a different one.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "tablr/io/tbl.h"
+#include "tablr/core/categorical.h"
+#include "tablr/ops/bitmask.h"
+#include "file_map.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <stdatomic.h>
+#endif
+
+#define TBL_MAGIC "TABLRTBL"            /**< File signature */
+#define TBL_VERSION 2                   /**< Format version */
+#define TBL_BYTE_ORDER 0x01020304u      /**< Byte order marker */
+#define TBL_ALIGNMENT 64                /**< Alignment of column sections */
+#define TBL_DEFAULT_BLOCK_ROWS 65536    /**< Default rows per statistics block */
+#define TBL_WRITE_CHUNK 4096            /**< String offsets written per fwrite */
+#define TBL_COLUMN_NULLS 1u             /**< Column flag: a validity bitmap follows the data */
+
+/**
+ * @brief On-disk type codes, independent of the TablrDType enum order
+ */
+enum {
+    TBL_TYPE_INT32 = 1,
+    TBL_TYPE_INT64 = 2,
+    TBL_TYPE_FLOAT32 = 3,
+    TBL_TYPE_FLOAT64 = 4,
+    TBL_TYPE_STRING = 5,
+    TBL_TYPE_BOOL = 6,
+    TBL_TYPE_INT8 = 7,
+    TBL_TYPE_INT16 = 8,
+    TBL_TYPE_UINT8 = 9,
+    TBL_TYPE_UINT16 = 10,
+    TBL_TYPE_UINT32 = 11,
+    TBL_TYPE_UINT64 = 12,
+    TBL_TYPE_DATE32 = 13,
+    TBL_TYPE_TIMESTAMP_S = 14,
+    TBL_TYPE_TIMESTAMP_MS = 15,
+    TBL_TYPE_TIMESTAMP_US = 16,
+    TBL_TYPE_TIMESTAMP_NS = 17,
+    TBL_TYPE_BITMASK = 18
+};
+
+/**
+ * @brief File header (64 bytes)
+ */
+typedef struct {
+    char magic[8];         /**< TBL_MAGIC */
+    uint32_t version;      /**< TBL_VERSION */
+    uint32_t byte_order;   /**< TBL_BYTE_ORDER as written by the host */
+    uint64_t nrows;        /**< Number of rows */
+    uint64_t ncols;        /**< Number of columns */
+    uint64_t block_rows;   /**< Rows per statistics block, 0 if none */
+    uint64_t reserved[3];  /**< Zero */
+} TblHeader;
+
+/**
+ * @brief Column directory entry (64 bytes)
+ *
+ * Offsets are absolute file offsets.
+ */
+typedef struct {
+    uint64_t name_offset;   /**< Column name (NUL-terminated) */
+    uint64_t name_length;   /**< Name length excluding the NUL */
+    uint32_t type;          /**< On-disk type code */
+    uint32_t flags;         /**< TBL_COLUMN_* flags */
+    uint64_t data_offset;   /**< Values, or string offsets */
+    uint64_t data_size;     /**< Bytes of data */
+    uint64_t chars_offset;  /**< String characters, 0 for other types */
+    uint64_t chars_size;    /**< Bytes of string characters */
+    uint64_t stats_offset;  /**< Per-block min, max pairs, 0 if none */
+} TblColumn;
+
+/**
+ * @brief Reference-counted file mapping shared by every series of a file
+ */
+typedef struct {
+    TablrFileMap map;       /**< Copy-on-write mapping */
+#ifdef _WIN32
+    volatile LONG refs;     /**< Number of users */
+#else
+    atomic_size_t refs;     /**< Number of users */
+#endif
+} TblMapping;
+
+/**
+ * @brief Open Tablr binary file
+ */
+struct TablrTblFile {
+    TblMapping* mapping;        /**< Shared mapping */
+    const TblHeader* header;    /**< Header inside the mapping */
+    const TblColumn* columns;   /**< Directory inside the mapping */
+};
+
+/**
+ * @brief Add a user to a mapping
+ */
+static void mapping_retain(TblMapping* mapping) {
+#ifdef _WIN32
+    InterlockedIncrement(&mapping->refs);
+#else
+    atomic_fetch_add(&mapping->refs, 1);
+#endif
+}
+
+/**
+ * @brief Drop a user of a mapping, unmapping it after the last one
+ */
+static void mapping_release(void* ctx) {
+    TblMapping* mapping = (TblMapping*)ctx;
+#ifdef _WIN32
+    bool last = InterlockedDecrement(&mapping->refs) == 0;
+#else
+    bool last = atomic_fetch_sub(&mapping->refs, 1) == 1;
+#endif
+    if (last) {
+        tablr_file_map_close(&mapping->map);
+        free(mapping);
+    }
+}
+
+/**
+ * @brief On-disk type code of a dtype
+ *
+ * Each timestamp unit has its own code.
+ *
+ * @return Type code, or 0 if the dtype cannot be stored
+ */
+static uint32_t type_code(TablrDType dtype, TablrTimeUnit unit) {
+    switch (dtype) {
+        case TABLR_INT8: return TBL_TYPE_INT8;
+        case TABLR_INT16: return TBL_TYPE_INT16;
+        case TABLR_UINT8: return TBL_TYPE_UINT8;
+        case TABLR_UINT16: return TBL_TYPE_UINT16;
+        case TABLR_UINT32: return TBL_TYPE_UINT32;
+        case TABLR_UINT64: return TBL_TYPE_UINT64;
+        case TABLR_DATE32: return TBL_TYPE_DATE32;
+        case TABLR_TIMESTAMP64: return TBL_TYPE_TIMESTAMP_S + (uint32_t)unit;
+        case TABLR_INT32: return TBL_TYPE_INT32;
+        case TABLR_INT64: return TBL_TYPE_INT64;
+        case TABLR_FLOAT32: return TBL_TYPE_FLOAT32;
+        case TABLR_FLOAT64: return TBL_TYPE_FLOAT64;
+        case TABLR_STRING: return TBL_TYPE_STRING;
+        case TABLR_BOOL: return TBL_TYPE_BOOL;
+        case TABLR_BITMASK: return TBL_TYPE_BITMASK;
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Dtype and time unit of an on-disk type code
+ * @return false for unknown codes
+ */
+static bool code_type(uint32_t code, TablrDType* dtype, TablrTimeUnit* unit) {
+    *unit = TABLR_TIME_MICROSECOND;
+    if (code >= TBL_TYPE_TIMESTAMP_S && code <= TBL_TYPE_TIMESTAMP_NS) {
+        *dtype = TABLR_TIMESTAMP64;
+        *unit = (TablrTimeUnit)(code - TBL_TYPE_TIMESTAMP_S);
+        return true;
+    }
+    switch (code) {
+        case TBL_TYPE_INT8: *dtype = TABLR_INT8; return true;
+        case TBL_TYPE_INT16: *dtype = TABLR_INT16; return true;
+        case TBL_TYPE_UINT8: *dtype = TABLR_UINT8; return true;
+        case TBL_TYPE_UINT16: *dtype = TABLR_UINT16; return true;
+        case TBL_TYPE_UINT32: *dtype = TABLR_UINT32; return true;
+        case TBL_TYPE_UINT64: *dtype = TABLR_UINT64; return true;
+        case TBL_TYPE_DATE32: *dtype = TABLR_DATE32; return true;
+        case TBL_TYPE_INT32: *dtype = TABLR_INT32; return true;
+        case TBL_TYPE_INT64: *dtype = TABLR_INT64; return true;
+        case TBL_TYPE_FLOAT32: *dtype = TABLR_FLOAT32; return true;
+        case TBL_TYPE_FLOAT64: *dtype = TABLR_FLOAT64; return true;
+        case TBL_TYPE_STRING: *dtype = TABLR_STRING; return true;
+        case TBL_TYPE_BOOL: *dtype = TABLR_BOOL; return true;
+        case TBL_TYPE_BITMASK: *dtype = TABLR_BITMASK; return true;
+        default: return false;
+    }
+}
+
+/**
+ * @brief Round an offset up to the section alignment
+ */
+static uint64_t align_offset(uint64_t offset) {
+    return (offset + TBL_ALIGNMENT - 1) & ~(uint64_t)(TBL_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Check that [offset, offset + length) lies within size bytes
+ */
+static bool range_ok(uint64_t offset, uint64_t length, uint64_t size) {
+    return offset <= size && length <= size - offset;
+}
+
+/**
+ * @brief Offset of a column's validity bitmap, after its values and characters
+ */
+static uint64_t validity_offset(const TblColumn* col) {
+    uint64_t end = col->chars_offset ? col->chars_offset + col->chars_size : col->data_offset + col->data_size;
+    return align_offset(end);
+}
+
+/**
+ * @brief Bytes of a validity bitmap for nrows rows
+ */
+static uint64_t validity_size(uint64_t nrows) {
+    return (nrows + 63) / 64 * sizeof(uint64_t);
+}
+
+/**
+ * @brief Compute min and max of rows [begin, end) of a column
+ *
+ * NaN values are ignored; a block of only NaN has NaN bounds.
+ */
+static void block_minmax(const void* data, TablrDType dtype, size_t begin, size_t end, void* min, void* max) {
+#define TBL_NEVER_NAN(x) false
+#define TBL_MINMAX(T, IS_NAN)                                          \
+    do {                                                               \
+        const T* v = (const T*)data;                                   \
+        T lo = v[begin], hi = v[begin];                                \
+        for (size_t i = begin + 1; i < end; i++) {                     \
+            if (v[i] < lo || IS_NAN(lo)) lo = v[i];                    \
+            if (v[i] > hi || IS_NAN(hi)) hi = v[i];                    \
+        }                                                              \
+        memcpy(min, &lo, sizeof(T));                                   \
+        memcpy(max, &hi, sizeof(T));                                   \
+    } while (0)
+
+    switch (dtype) {
+        case TABLR_INT8: TBL_MINMAX(int8_t, TBL_NEVER_NAN); break;
+        case TABLR_INT16: TBL_MINMAX(int16_t, TBL_NEVER_NAN); break;
+        case TABLR_INT32:
+        case TABLR_DATE32: TBL_MINMAX(int32_t, TBL_NEVER_NAN); break;
+        case TABLR_INT64:
+        case TABLR_TIMESTAMP64: TBL_MINMAX(int64_t, TBL_NEVER_NAN); break;
+        case TABLR_UINT8: TBL_MINMAX(uint8_t, TBL_NEVER_NAN); break;
+        case TABLR_UINT16: TBL_MINMAX(uint16_t, TBL_NEVER_NAN); break;
+        case TABLR_UINT32: TBL_MINMAX(uint32_t, TBL_NEVER_NAN); break;
+        case TABLR_UINT64: TBL_MINMAX(uint64_t, TBL_NEVER_NAN); break;
+        case TABLR_FLOAT32: TBL_MINMAX(float, isnan); break;
+        case TABLR_FLOAT64: TBL_MINMAX(double, isnan); break;
+        case TABLR_BOOL: TBL_MINMAX(bool, TBL_NEVER_NAN); break;
+        default: break;
+    }
+
+#undef TBL_MINMAX
+#undef TBL_NEVER_NAN
+}
+
+/**
+ * @brief Write zero bytes until the file position reaches target
+ */
+static bool write_padding(FILE* f, uint64_t* pos, uint64_t target) {
+    static const char zeros[TBL_ALIGNMENT] = { 0 };
+    while (*pos < target) {
+        size_t n = target - *pos < TBL_ALIGNMENT ? (size_t)(target - *pos) : TBL_ALIGNMENT;
+        if (fwrite(zeros, 1, n, f) != n) return false;
+        *pos += n;
+    }
+    return true;
+}
+
+/**
+ * @brief Write bytes and advance the tracked file position
+ */
+static bool write_bytes(FILE* f, uint64_t* pos, const void* data, size_t len) {
+    if (len > 0 && fwrite(data, 1, len, f) != len) return false;
+    *pos += len;
+    return true;
+}
+
+/**
+ * @brief Write the offsets, rebased to start at 0, and characters of a string column
+ */
+static bool write_strings(FILE* f, uint64_t* pos, const TblColumn* col, const TablrSeries* series, size_t nrows) {
+    const int64_t* offsets = tablr_series_string_offsets(series);
+    const char* chars = tablr_series_string_chars(series);
+    int64_t rebased[TBL_WRITE_CHUNK];
+
+    if (!offsets || !chars || !write_padding(f, pos, col->data_offset)) return false;
+    for (size_t i = 0; i <= nrows; i += TBL_WRITE_CHUNK) {
+        size_t n = nrows + 1 - i < TBL_WRITE_CHUNK ? nrows + 1 - i : TBL_WRITE_CHUNK;
+        for (size_t j = 0; j < n; j++) rebased[j] = offsets[i + j] - offsets[0];
+        if (!write_bytes(f, pos, rebased, n * sizeof(int64_t))) return false;
+    }
+
+    return write_padding(f, pos, col->chars_offset) &&
+           write_bytes(f, pos, chars + offsets[0], (size_t)col->chars_size);
+}
+
+/**
+ * @brief Write the words of a bitmask column, clearing bits past the last row
+ */
+static bool write_bits(FILE* f, uint64_t* pos, const TblColumn* col, const TablrSeries* series, size_t nrows) {
+    size_t nwords = (size_t)(validity_size(nrows) / sizeof(uint64_t));
+    if (nwords == 0) return write_padding(f, pos, col->data_offset);
+    const uint64_t* words = (const uint64_t*)tablr_series_data_const(series);
+    uint64_t last = tablr_bitmask_word(series, nwords - 1);
+    return words && write_padding(f, pos, col->data_offset) &&
+           write_bytes(f, pos, words, (nwords - 1) * sizeof(uint64_t)) &&
+           write_bytes(f, pos, &last, sizeof(last));
+}
+
+/**
+ * @brief Write the validity bitmap of a column with nulls
+ */
+static bool write_validity(FILE* f, uint64_t* pos, const TblColumn* col, const TablrSeries* series, size_t nrows) {
+    uint64_t words[TBL_WRITE_CHUNK];
+    size_t nwords = (size_t)(validity_size(nrows) / sizeof(uint64_t));
+
+    if (!write_padding(f, pos, validity_offset(col))) return false;
+    for (size_t i = 0; i < nwords; i += TBL_WRITE_CHUNK) {
+        size_t n = nwords - i < TBL_WRITE_CHUNK ? nwords - i : TBL_WRITE_CHUNK;
+        for (size_t j = 0; j < n; j++) words[j] = tablr_series_validity_word(series, i + j);
+        if (!write_bytes(f, pos, words, n * sizeof(uint64_t))) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Get default Tablr binary write options
+ *
+ * @return Options structure with default values
+ */
+TablrTblOptions tablr_tbl_options_default(void) {
+    TablrTblOptions options;
+    options.block_rows = TBL_DEFAULT_BLOCK_ROWS;
+    return options;
+}
+
+/**
+ * @brief Write dataframe to a Tablr binary file
+ *
+ * Column values are written exactly as stored in memory, each in its own
+ * 64-byte aligned section, so tablr_read_tbl() can use them in place. Nulls
+ * are kept in a validity bitmap section per column that has them. With
+ * options->block_rows set, the min and max of every block of that many rows
+ * are stored for numeric and bool columns. Categorical columns are stored
+ * as their decoded strings.
+ *
+ * @param df DataFrame to write
+ * @param filename Output file path
+ * @param options Write options (NULL for defaults)
+ * @return true on success, false on failure
+ */
+bool tablr_to_tbl(const TablrDataFrame* df, const char* filename, const TablrTblOptions* options) {
+    if (!df || !filename) return false;
+
+    TablrTblOptions defaults = tablr_tbl_options_default();
+    if (!options) options = &defaults;
+
+    size_t ncols = tablr_dataframe_ncols(df);
+    size_t nrows = tablr_dataframe_nrows(df);
+
+    size_t block_rows = nrows > 0 ? options->block_rows : 0;
+    size_t nblocks = block_rows ? (nrows + block_rows - 1) / block_rows : 0;
+
+    TblHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TBL_MAGIC, sizeof(header.magic));
+    header.version = TBL_VERSION;
+    header.byte_order = TBL_BYTE_ORDER;
+    header.nrows = nrows;
+    header.ncols = ncols;
+    header.block_rows = block_rows;
+
+    TblColumn* dir = (TblColumn*)calloc(ncols ? ncols : 1, sizeof(TblColumn));
+    TablrSeries** series = (TablrSeries**)calloc(ncols ? ncols : 1, sizeof(TablrSeries*));
+    TablrSeries** decoded = (TablrSeries**)calloc(ncols ? ncols : 1, sizeof(TablrSeries*));
+    char* stats = NULL;
+    bool ok = dir && series && decoded;
+
+    /* Lay out names, then each column's sections */
+    uint64_t offset = sizeof(TblHeader) + (uint64_t)ncols * sizeof(TblColumn);
+    for (size_t c = 0; ok && c < ncols; c++) {
+        dir[c].name_offset = offset;
+        dir[c].name_length = strlen(tablr_dataframe_column_name_at(df, c));
+        offset += dir[c].name_length + 1;
+    }
+    for (size_t c = 0; ok && c < ncols; c++) {
+        series[c] = tablr_dataframe_column_at(df, c);
+        if (tablr_series_dtype(series[c]) == TABLR_CATEGORICAL) {
+            decoded[c] = tablr_series_from_categorical(series[c]);
+            series[c] = decoded[c];
+        }
+        TablrDType dtype = tablr_series_dtype(series[c]);
+        dir[c].type = type_code(dtype, tablr_series_time_unit(series[c]));
+        if (!series[c] || dir[c].type == 0) {
+            ok = false;
+            break;
+        }
+
+        offset = align_offset(offset);
+        dir[c].data_offset = offset;
+        if (dtype == TABLR_STRING) {
+            const int64_t* offsets = tablr_series_string_offsets(series[c]);
+            dir[c].data_size = ((uint64_t)nrows + 1) * sizeof(int64_t);
+            dir[c].chars_offset = align_offset(offset + dir[c].data_size);
+            dir[c].chars_size = (uint64_t)(offsets[nrows] - offsets[0]);
+            offset = dir[c].chars_offset + dir[c].chars_size;
+        } else if (dtype == TABLR_BITMASK) {
+            dir[c].data_size = validity_size(nrows);
+            offset += dir[c].data_size;
+        } else {
+            dir[c].data_size = (uint64_t)nrows * tablr_dtype_size(dtype);
+            offset += dir[c].data_size;
+        }
+        if (tablr_series_null_count(series[c]) > 0) {
+            dir[c].flags |= TBL_COLUMN_NULLS;
+            offset = validity_offset(&dir[c]) + validity_size(nrows);
+        }
+        if (dtype != TABLR_STRING && dtype != TABLR_BITMASK && nblocks > 0) {
+            dir[c].stats_offset = align_offset(offset);
+            offset = dir[c].stats_offset + 2 * nblocks * tablr_dtype_size(dtype);
+        }
+    }
+
+    FILE* f = ok ? fopen(filename, "wb") : NULL;
+    uint64_t pos = 0;
+    ok = f && write_bytes(f, &pos, &header, sizeof(header)) &&
+         write_bytes(f, &pos, dir, ncols * sizeof(TblColumn));
+    for (size_t c = 0; ok && c < ncols; c++) {
+        ok = write_bytes(f, &pos, tablr_dataframe_column_name_at(df, c), (size_t)dir[c].name_length + 1);
+    }
+
+    for (size_t c = 0; ok && c < ncols; c++) {
+        TablrDType dtype = tablr_series_dtype(series[c]);
+        const void* data = tablr_series_data_const(series[c]);
+        if (dtype == TABLR_STRING) {
+            ok = write_strings(f, &pos, &dir[c], series[c], nrows);
+        } else if (dtype == TABLR_BITMASK) {
+            ok = write_bits(f, &pos, &dir[c], series[c], nrows);
+        } else {
+            ok = (data || nrows == 0) && write_padding(f, &pos, dir[c].data_offset) &&
+                 write_bytes(f, &pos, data, (size_t)dir[c].data_size);
+        }
+        if (ok && (dir[c].flags & TBL_COLUMN_NULLS)) ok = write_validity(f, &pos, &dir[c], series[c], nrows);
+        if (!ok || dtype == TABLR_STRING || dtype == TABLR_BITMASK || nblocks == 0) continue;
+
+        size_t elem_size = tablr_dtype_size(dtype);
+        char* grown = (char*)realloc(stats, 2 * nblocks * elem_size);
+        if (!grown) {
+            ok = false;
+            break;
+        }
+        stats = grown;
+        for (size_t b = 0; b < nblocks; b++) {
+            size_t begin = b * block_rows;
+            size_t end = begin + block_rows < nrows ? begin + block_rows : nrows;
+            block_minmax(data, dtype, begin, end, stats + 2 * b * elem_size, stats + (2 * b + 1) * elem_size);
+        }
+        ok = write_padding(f, &pos, dir[c].stats_offset) && write_bytes(f, &pos, stats, 2 * nblocks * elem_size);
+    }
+
+    if (f && fclose(f) != 0) ok = false;
+    if (!ok && f) remove(filename);
+
+    for (size_t c = 0; decoded && c < ncols; c++) {
+        tablr_series_free(decoded[c]);
+    }
+    free(decoded);
+    free(stats);
+    free(series);
+    free(dir);
+    return ok;
+}
+
+/**
+ * @brief Validate header and directory against the mapped file size
+ */
+static bool validate(const TablrFileMap* map) {
+    if (map->size < sizeof(TblHeader)) return false;
+
+    const TblHeader* header = (const TblHeader*)map->data;
+    if (memcmp(header->magic, TBL_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != TBL_VERSION || header->byte_order != TBL_BYTE_ORDER) {
+        return false;
+    }
+    if (header->ncols > (map->size - sizeof(TblHeader)) / sizeof(TblColumn)) return false;
+
+    uint64_t size = map->size;
+    uint64_t nrows = header->nrows;
+    uint64_t nblocks = header->block_rows ? (nrows + header->block_rows - 1) / header->block_rows : 0;
+    const TblColumn* columns = (const TblColumn*)(map->data + sizeof(TblHeader));
+
+    for (uint64_t c = 0; c < header->ncols; c++) {
+        const TblColumn* col = &columns[c];
+        TablrDType dtype;
+        TablrTimeUnit unit;
+        if (!code_type(col->type, &dtype, &unit)) return false;
+
+        if (!range_ok(col->name_offset, col->name_length + 1, size) ||
+            map->data[col->name_offset + col->name_length] != '\0') {
+            return false;
+        }
+
+        /* String offsets themselves are checked when the column is loaded */
+        uint64_t elem_size = tablr_dtype_size(dtype);
+        uint64_t nvalues = dtype == TABLR_STRING ? nrows + 1 : nrows;
+        uint64_t data_size = dtype == TABLR_BITMASK ? validity_size(nrows) : nvalues * elem_size;
+        if (nrows >= UINT64_MAX / 8 || col->data_size != data_size ||
+            col->data_offset % TBL_ALIGNMENT != 0 || !range_ok(col->data_offset, col->data_size, size)) {
+            return false;
+        }
+        if ((col->flags & ~TBL_COLUMN_NULLS) != 0 ||
+            ((col->flags & TBL_COLUMN_NULLS) && !range_ok(validity_offset(col), validity_size(nrows), size))) {
+            return false;
+        }
+
+        if (dtype == TABLR_STRING) {
+            if (col->chars_offset == 0 || !range_ok(col->chars_offset, col->chars_size, size)) return false;
+        } else if (dtype == TABLR_BITMASK) {
+            if (col->stats_offset != 0) return false;
+        } else if (col->stats_offset != 0) {
+            if (nblocks > UINT64_MAX / (2 * elem_size) ||
+                !range_ok(col->stats_offset, 2 * nblocks * elem_size, size)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Open a Tablr binary file
+ *
+ * Maps the file and checks its header and directory. Column data is not read.
+ *
+ * @param filename Path to file
+ * @return New file handle, or NULL on failure or if the file is not valid
+ */
+TablrTblFile* tablr_tbl_open(const char* filename) {
+    if (!filename) return NULL;
+
+    TablrTblFile* file = (TablrTblFile*)calloc(1, sizeof(TablrTblFile));
+    TblMapping* mapping = (TblMapping*)calloc(1, sizeof(TblMapping));
+    if (!file || !mapping) {
+        free(file);
+        free(mapping);
+        return NULL;
+    }
+
+    if (!tablr_file_map_open_private(&mapping->map, filename) || !validate(&mapping->map)) {
+        tablr_file_map_close(&mapping->map);
+        free(mapping);
+        free(file);
+        return NULL;
+    }
+
+#ifdef _WIN32
+    mapping->refs = 1;
+#else
+    atomic_init(&mapping->refs, 1);
+#endif
+
+    file->mapping = mapping;
+    file->header = (const TblHeader*)mapping->map.data;
+    file->columns = (const TblColumn*)(mapping->map.data + sizeof(TblHeader));
+    return file;
+}
+
+/**
+ * @brief Close a Tablr binary file
+ *
+ * The mapping itself is released once every series created from it is freed.
+ *
+ * @param file File handle (may be NULL)
+ */
+void tablr_tbl_close(TablrTblFile* file) {
+    if (!file) return;
+    mapping_release(file->mapping);
+    free(file);
+}
+
+/**
+ * @brief Get number of rows in a Tablr binary file
+ *
+ * @param file File handle
+ * @return Number of rows, or 0 if file is NULL
+ */
+size_t tablr_tbl_nrows(const TablrTblFile* file) {
+    return file ? (size_t)file->header->nrows : 0;
+}
+
+/**
+ * @brief Get rows per statistics block
+ *
+ * @param file File handle
+ * @return Rows per block, or 0 if the file has no statistics
+ */
+size_t tablr_tbl_block_rows(const TablrTblFile* file) {
+    return file ? (size_t)file->header->block_rows : 0;
+}
+
+/**
+ * @brief Get minimum and maximum of a column within one block
+ *
+ * Block b covers rows [b * block_rows, (b + 1) * block_rows). Lets a scan
+ * skip blocks that cannot match a predicate without touching their values.
+ *
+ * @param file File handle
+ * @param column Column name
+ * @param block Block index
+ * @param min Output minimum, one value of the column's type
+ * @param max Output maximum, one value of the column's type
+ * @return true on success, false if there are no statistics for the column or block
+ */
+bool tablr_tbl_block_minmax(const TablrTblFile* file, const char* column, size_t block, void* min, void* max) {
+    if (!file || !column || !min || !max || file->header->block_rows == 0) return false;
+
+    uint64_t nblocks = (file->header->nrows + file->header->block_rows - 1) / file->header->block_rows;
+    if (block >= nblocks) return false;
+
+    const char* base = file->mapping->map.data;
+    for (uint64_t c = 0; c < file->header->ncols; c++) {
+        const TblColumn* col = &file->columns[c];
+        if (strcmp(base + col->name_offset, column) != 0) continue;
+        if (col->stats_offset == 0) return false;
+
+        TablrDType dtype;
+        TablrTimeUnit unit;
+        code_type(col->type, &dtype, &unit);
+        size_t elem_size = tablr_dtype_size(dtype);
+        const char* stats = base + col->stats_offset + 2 * block * elem_size;
+        memcpy(min, stats, elem_size);
+        memcpy(max, stats + elem_size, elem_size);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Create a string column over the mapped offsets and characters
+ * @return New series, or NULL on failure or if the offsets are out of order or range
+ */
+static TablrSeries* string_series(TblMapping* mapping, const TblColumn* col, size_t nrows) {
+    const char* base = mapping->map.data;
+    const int64_t* offsets = (const int64_t*)(base + col->data_offset);
+
+    if (offsets[0] != 0 || (uint64_t)offsets[nrows] != col->chars_size) return NULL;
+    for (size_t r = 0; r < nrows; r++) {
+        if (offsets[r + 1] < offsets[r]) return NULL;
+    }
+    return tablr_series_string_wrap(offsets, base + col->chars_offset, nrows, TABLR_CPU, mapping_release, mapping);
+}
+
+/**
+ * @brief Mark the rows a column's validity bitmap records as null
+ * @return false on allocation failure
+ */
+static bool load_nulls(TablrSeries* series, const char* base, const TblColumn* col, size_t nrows) {
+    const uint8_t* bits = (const uint8_t*)(base + validity_offset(col));
+    return tablr_series_set_validity(series, 0, bits, 0, nrows);
+}
+
+/**
+ * @brief Create a dataframe whose columns point into the file mapping
+ *
+ * Every column uses the mapped values in place. Pages are private
+ * copy-on-write, so writing to a column never changes the file.
+ *
+ * @param file File handle
+ * @return New dataframe, or NULL on failure
+ */
+TablrDataFrame* tablr_tbl_dataframe(const TablrTblFile* file) {
+    if (!file) return NULL;
+
+    TablrDataFrame* df = tablr_dataframe_create();
+    if (!df) return NULL;
+
+    TblMapping* mapping = file->mapping;
+    char* base = (char*)mapping->map.data;
+    size_t nrows = (size_t)file->header->nrows;
+    if (nrows == 0) return df;
+
+    for (uint64_t c = 0; c < file->header->ncols; c++) {
+        const TblColumn* col = &file->columns[c];
+        TablrDType dtype;
+        TablrTimeUnit unit;
+        code_type(col->type, &dtype, &unit);
+
+        TablrSeries* series = dtype == TABLR_STRING
+            ? string_series(mapping, col, nrows)
+            : tablr_series_external(base + col->data_offset, nrows, dtype, TABLR_CPU, mapping_release, mapping);
+        if (!series) {
+            tablr_dataframe_free(df);
+            return NULL;
+        }
+        if (dtype == TABLR_TIMESTAMP64) tablr_series_set_time_unit(series, unit);
+
+        mapping_retain(mapping);
+        if (((col->flags & TBL_COLUMN_NULLS) && !load_nulls(series, base, col, nrows)) ||
+            !tablr_dataframe_add_column(df, base + col->name_offset, series)) {
+            tablr_series_free(series);
+            tablr_dataframe_free(df);
+            return NULL;
+        }
+    }
+
+    return df;
+}
+
+/**
+ * @brief Read a Tablr binary file into a dataframe
+ *
+ * Opens the file, creates zero-copy columns and closes the handle. The
+ * mapping lives until the dataframe's columns are freed.
+ *
+ * @param filename Path to file
+ * @return New dataframe, or NULL on failure
+ */
+TablrDataFrame* tablr_read_tbl(const char* filename) {
+    TablrTblFile* file = tablr_tbl_open(filename);
+    if (!file) return NULL;
+
+    TablrDataFrame* df = tablr_tbl_dataframe(file);
+    tablr_tbl_close(file);
+    return df;
+}
@@ -0,0 +1,320 @@
+/**
+ * @file thrift.c
+ * @brief Implementation of the Thrift compact protocol subset
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Integers are zigzag varints, field headers pack the id delta and the wire
+ * type into one byte, and booleans in fields live in the header's type nibble.
+ */
+
+#include "thrift.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define THRIFT_MAX_VARINT 10  /**< Longest 64-bit varint in bytes */
+
+void tablr_thrift_reader_init(TablrThriftReader* r, const void* data, size_t len) {
+    r->pos = (const uint8_t*)data;
+    r->end = r->pos + len;
+    r->last_id[0] = 0;
+    r->depth = 0;
+    r->failed = false;
+}
+
+static uint64_t read_varint(TablrThriftReader* r) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 7 * THRIFT_MAX_VARINT; shift += 7) {
+        if (r->failed || r->pos >= r->end) break;
+        uint8_t byte = *r->pos++;
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    r->failed = true;
+    return 0;
+}
+
+static int64_t unzigzag(uint64_t n) {
+    return (int64_t)(n >> 1) ^ -(int64_t)(n & 1);
+}
+
+void tablr_thrift_struct_begin(TablrThriftReader* r) {
+    if (r->depth + 1 >= TABLR_THRIFT_MAX_DEPTH) {
+        r->failed = true;
+        return;
+    }
+    r->last_id[++r->depth] = 0;
+}
+
+void tablr_thrift_struct_end(TablrThriftReader* r) {
+    if (r->depth > 0) r->depth--;
+}
+
+bool tablr_thrift_field(TablrThriftReader* r, int* type, int16_t* id) {
+    *type = TABLR_THRIFT_STOP;
+    *id = 0;
+    if (r->failed || r->pos >= r->end) {
+        r->failed = true;
+        return false;
+    }
+
+    uint8_t byte = *r->pos++;
+    if (byte == TABLR_THRIFT_STOP) return false;
+
+    int delta = byte >> 4;
+    *type = byte & 0x0F;
+    if (delta) {
+        *id = (int16_t)(r->last_id[r->depth] + delta);
+    } else {
+        *id = (int16_t)unzigzag(read_varint(r));
+    }
+    r->last_id[r->depth] = *id;
+    return !r->failed;
+}
+
+void tablr_thrift_list_begin(TablrThriftReader* r, int* elem_type, uint32_t* count) {
+    *elem_type = TABLR_THRIFT_STOP;
+    *count = 0;
+    if (r->failed || r->pos >= r->end) {
+        r->failed = true;
+        return;
+    }
+
+    uint8_t byte = *r->pos++;
+    *elem_type = byte & 0x0F;
+    uint64_t n = byte >> 4;
+    if (n == 15) n = read_varint(r);
+    if (n > (uint64_t)(r->end - r->pos)) {
+        /* Every element takes at least one byte */
+        r->failed = true;
+        return;
+    }
+    *count = (uint32_t)n;
+}
+
+int32_t tablr_thrift_read_i32(TablrThriftReader* r) {
+    return (int32_t)unzigzag(read_varint(r));
+}
+
+int64_t tablr_thrift_read_i64(TablrThriftReader* r) {
+    return unzigzag(read_varint(r));
+}
+
+double tablr_thrift_read_double(TablrThriftReader* r) {
+    double value = 0.0;
+    if (r->failed || r->end - r->pos < 8) {
+        r->failed = true;
+        return value;
+    }
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; i++) bits |= (uint64_t)r->pos[i] << (8 * i);
+    memcpy(&value, &bits, sizeof(value));
+    r->pos += 8;
+    return value;
+}
+
+bool tablr_thrift_read_bool(TablrThriftReader* r, int type) {
+    if (type == TABLR_THRIFT_TRUE) return true;
+    if (type == TABLR_THRIFT_FALSE) return false;
+    if (r->failed || r->pos >= r->end) {
+        r->failed = true;
+        return false;
+    }
+    return *r->pos++ == TABLR_THRIFT_TRUE;
+}
+
+const uint8_t* tablr_thrift_read_binary(TablrThriftReader* r, uint32_t* len) {
+    *len = 0;
+    uint64_t n = read_varint(r);
+    if (r->failed || n > (uint64_t)(r->end - r->pos)) {
+        r->failed = true;
+        return NULL;
+    }
+    const uint8_t* data = r->pos;
+    r->pos += n;
+    *len = (uint32_t)n;
+    return data;
+}
+
+void tablr_thrift_skip(TablrThriftReader* r, int type) {
+    if (r->failed) return;
+
+    switch (type) {
+        case TABLR_THRIFT_TRUE:
+        case TABLR_THRIFT_FALSE:
+            break;
+        case TABLR_THRIFT_BYTE:
+            if (r->pos >= r->end) r->failed = true;
+            else r->pos++;
+            break;
+        case TABLR_THRIFT_I16:
+        case TABLR_THRIFT_I32:
+        case TABLR_THRIFT_I64:
+            read_varint(r);
+            break;
+        case TABLR_THRIFT_DOUBLE:
+            tablr_thrift_read_double(r);
+            break;
+        case TABLR_THRIFT_BINARY: {
+            uint32_t len;
+            tablr_thrift_read_binary(r, &len);
+            break;
+        }
+        case TABLR_THRIFT_LIST:
+        case TABLR_THRIFT_SET: {
+            int elem_type;
+            uint32_t count;
+            tablr_thrift_list_begin(r, &elem_type, &count);
+            /* List booleans are one byte each rather than a header nibble */
+            if (elem_type == TABLR_THRIFT_TRUE || elem_type == TABLR_THRIFT_FALSE) elem_type = TABLR_THRIFT_BYTE;
+            for (uint32_t i = 0; i < count && !r->failed; i++) tablr_thrift_skip(r, elem_type);
+            break;
+        }
+        case TABLR_THRIFT_MAP: {
+            uint64_t count = read_varint(r);
+            if (count == 0) break;
+            if (r->failed || r->pos >= r->end) {
+                r->failed = true;
+                break;
+            }
+            uint8_t types = *r->pos++;
+            int key_type = types >> 4;
+            int value_type = types & 0x0F;
+            if (key_type == TABLR_THRIFT_TRUE || key_type == TABLR_THRIFT_FALSE) key_type = TABLR_THRIFT_BYTE;
+            if (value_type == TABLR_THRIFT_TRUE || value_type == TABLR_THRIFT_FALSE) value_type = TABLR_THRIFT_BYTE;
+            for (uint64_t i = 0; i < count && !r->failed; i++) {
+                tablr_thrift_skip(r, key_type);
+                tablr_thrift_skip(r, value_type);
+            }
+            break;
+        }
+        case TABLR_THRIFT_STRUCT: {
+            int field_type;
+            int16_t id;
+            tablr_thrift_struct_begin(r);
+            while (tablr_thrift_field(r, &field_type, &id)) tablr_thrift_skip(r, field_type);
+            tablr_thrift_struct_end(r);
+            break;
+        }
+        default:
+            r->failed = true;
+            break;
+    }
+}
+
+void tablr_thrift_writer_init(TablrThriftWriter* w) {
+    memset(w, 0, sizeof(*w));
+}
+
+void tablr_thrift_writer_free(TablrThriftWriter* w) {
+    free(w->data);
+    w->data = NULL;
+    w->len = w->cap = 0;
+}
+
+static bool writer_reserve(TablrThriftWriter* w, size_t extra) {
+    if (w->failed) return false;
+    if (w->len + extra <= w->cap) return true;
+
+    size_t cap = w->cap ? w->cap * 2 : 256;
+    while (cap < w->len + extra) cap *= 2;
+    uint8_t* data = (uint8_t*)realloc(w->data, cap);
+    if (!data) {
+        w->failed = true;
+        return false;
+    }
+    w->data = data;
+    w->cap = cap;
+    return true;
+}
+
+static void write_byte(TablrThriftWriter* w, uint8_t byte) {
+    if (writer_reserve(w, 1)) w->data[w->len++] = byte;
+}
+
+static void write_varint(TablrThriftWriter* w, uint64_t value) {
+    if (!writer_reserve(w, THRIFT_MAX_VARINT)) return;
+    while (value >= 0x80) {
+        w->data[w->len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    w->data[w->len++] = (uint8_t)value;
+}
+
+static uint64_t zigzag(int64_t n) {
+    return ((uint64_t)n << 1) ^ (uint64_t)(n >> 63);
+}
+
+static void write_field_header(TablrThriftWriter* w, int16_t id, int type) {
+    int delta = id - w->last_id[w->depth];
+    if (delta > 0 && delta <= 15) {
+        write_byte(w, (uint8_t)((delta << 4) | type));
+    } else {
+        write_byte(w, (uint8_t)type);
+        write_varint(w, zigzag(id));
+    }
+    w->last_id[w->depth] = id;
+}
+
+void tablr_thrift_write_struct_begin(TablrThriftWriter* w, int16_t id) {
+    write_field_header(w, id, TABLR_THRIFT_STRUCT);
+    tablr_thrift_write_elem_struct_begin(w);
+}
+
+void tablr_thrift_write_elem_struct_begin(TablrThriftWriter* w) {
+    if (w->depth + 1 >= TABLR_THRIFT_MAX_DEPTH) {
+        w->failed = true;
+        return;
+    }
+    w->last_id[++w->depth] = 0;
+}
+
+void tablr_thrift_write_struct_end(TablrThriftWriter* w) {
+    write_byte(w, TABLR_THRIFT_STOP);
+    if (w->depth > 0) w->depth--;
+}
+
+void tablr_thrift_write_stop(TablrThriftWriter* w) {
+    write_byte(w, TABLR_THRIFT_STOP);
+}
+
+void tablr_thrift_write_i32(TablrThriftWriter* w, int16_t id, int32_t value) {
+    write_field_header(w, id, TABLR_THRIFT_I32);
+    write_varint(w, zigzag(value));
+}
+
+void tablr_thrift_write_i64(TablrThriftWriter* w, int16_t id, int64_t value) {
+    write_field_header(w, id, TABLR_THRIFT_I64);
+    write_varint(w, zigzag(value));
+}
+
+void tablr_thrift_write_bool(TablrThriftWriter* w, int16_t id, bool value) {
+    write_field_header(w, id, value ? TABLR_THRIFT_TRUE : TABLR_THRIFT_FALSE);
+}
+
+void tablr_thrift_write_binary(TablrThriftWriter* w, int16_t id, const void* data, size_t len) {
+    write_field_header(w, id, TABLR_THRIFT_BINARY);
+    tablr_thrift_write_elem_binary(w, data, len);
+}
+
+void tablr_thrift_write_list_begin(TablrThriftWriter* w, int16_t id, int elem_type, uint32_t count) {
+    write_field_header(w, id, TABLR_THRIFT_LIST);
+    if (count < 15) {
+        write_byte(w, (uint8_t)((count << 4) | (uint32_t)elem_type));
+    } else {
+        write_byte(w, (uint8_t)(0xF0 | elem_type));
+        write_varint(w, count);
+    }
+}
+
+void tablr_thrift_write_elem_i32(TablrThriftWriter* w, int32_t value) {
+    write_varint(w, zigzag(value));
+}
+
+void tablr_thrift_write_elem_binary(TablrThriftWriter* w, const void* data, size_t len) {
+    write_varint(w, len);
+    if (len && writer_reserve(w, len)) {
+        memcpy(w->data + w->len, data, len);
+        w->len += len;
+    }
+}
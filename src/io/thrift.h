@@ -0,0 +1,202 @@
+/**
+ * @file thrift.h
+ * @brief Internal Thrift compact protocol reader and writer
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Not part of the public API. Used by the Parquet reader and writer for page
+ * headers and file metadata. Only the subset of the protocol that Parquet
+ * uses is supported: structs, lists, integers, doubles, booleans and
+ * binary; maps and sets can be skipped but not written.
+ */
+
+#ifndef TABLR_IO_THRIFT_H
+#define TABLR_IO_THRIFT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TABLR_THRIFT_MAX_DEPTH 32  /**< Deepest struct nesting accepted */
+
+/**
+ * @brief Compact protocol wire types
+ */
+typedef enum {
+    TABLR_THRIFT_STOP = 0,
+    TABLR_THRIFT_TRUE = 1,
+    TABLR_THRIFT_FALSE = 2,
+    TABLR_THRIFT_BYTE = 3,
+    TABLR_THRIFT_I16 = 4,
+    TABLR_THRIFT_I32 = 5,
+    TABLR_THRIFT_I64 = 6,
+    TABLR_THRIFT_DOUBLE = 7,
+    TABLR_THRIFT_BINARY = 8,
+    TABLR_THRIFT_LIST = 9,
+    TABLR_THRIFT_SET = 10,
+    TABLR_THRIFT_MAP = 11,
+    TABLR_THRIFT_STRUCT = 12
+} TablrThriftType;
+
+/**
+ * @brief Decoder over a byte range
+ *
+ * Errors are sticky: after the first malformed or truncated value every
+ * call returns zero values and failed stays set.
+ */
+typedef struct {
+    const uint8_t* pos;                       /**< Next unread byte */
+    const uint8_t* end;                       /**< End of input */
+    int16_t last_id[TABLR_THRIFT_MAX_DEPTH];  /**< Previous field id per open struct */
+    int depth;                                /**< Open struct count */
+    bool failed;                              /**< Set on malformed input */
+} TablrThriftReader;
+
+/**
+ * @brief Encoder into a growable buffer
+ */
+typedef struct {
+    uint8_t* data;                            /**< Encoded bytes */
+    size_t len;                               /**< Bytes used */
+    size_t cap;                               /**< Bytes allocated */
+    int16_t last_id[TABLR_THRIFT_MAX_DEPTH];  /**< Previous field id per open struct */
+    int depth;                                /**< Open struct count */
+    bool failed;                              /**< Set on allocation failure */
+} TablrThriftWriter;
+
+/**
+ * @brief Start decoding a byte range as the fields of a top-level struct
+ */
+void tablr_thrift_reader_init(TablrThriftReader* r, const void* data, size_t len);
+
+/**
+ * @brief Enter a nested struct value whose field header was just read
+ */
+void tablr_thrift_struct_begin(TablrThriftReader* r);
+
+/**
+ * @brief Leave a nested struct after tablr_thrift_field returned false
+ */
+void tablr_thrift_struct_end(TablrThriftReader* r);
+
+/**
+ * @brief Read the next field header of the current struct
+ * @param r Reader
+ * @param type Output wire type (TABLR_THRIFT_STOP at the end of the struct)
+ * @param id Output field id
+ * @return false at the end of the struct or on error
+ */
+bool tablr_thrift_field(TablrThriftReader* r, int* type, int16_t* id);
+
+/**
+ * @brief Read a list or set header; the elements follow
+ */
+void tablr_thrift_list_begin(TablrThriftReader* r, int* elem_type, uint32_t* count);
+
+/**
+ * @brief Read an i16 or i32 value
+ */
+int32_t tablr_thrift_read_i32(TablrThriftReader* r);
+
+/**
+ * @brief Read an i64 value
+ */
+int64_t tablr_thrift_read_i64(TablrThriftReader* r);
+
+/**
+ * @brief Read a double value
+ */
+double tablr_thrift_read_double(TablrThriftReader* r);
+
+/**
+ * @brief Read a bool from a field header type, or from the next byte for list elements
+ */
+bool tablr_thrift_read_bool(TablrThriftReader* r, int type);
+
+/**
+ * @brief Read a binary or string value without copying
+ * @param r Reader
+ * @param len Output length in bytes
+ * @return Pointer into the input, or NULL on error
+ */
+const uint8_t* tablr_thrift_read_binary(TablrThriftReader* r, uint32_t* len);
+
+/**
+ * @brief Skip a value of any type, including nested structs and containers
+ * @param r Reader
+ * @param type Wire type of the value
+ */
+void tablr_thrift_skip(TablrThriftReader* r, int type);
+
+/**
+ * @brief Start encoding a top-level struct into an empty buffer
+ */
+void tablr_thrift_writer_init(TablrThriftWriter* w);
+
+/**
+ * @brief Release the encoded buffer
+ */
+void tablr_thrift_writer_free(TablrThriftWriter* w);
+
+/**
+ * @brief Start a struct field; close it with tablr_thrift_write_struct_end
+ */
+void tablr_thrift_write_struct_begin(TablrThriftWriter* w, int16_t id);
+
+/**
+ * @brief Terminate the innermost open struct
+ */
+void tablr_thrift_write_struct_end(TablrThriftWriter* w);
+
+/**
+ * @brief Write an i32 field
+ */
+void tablr_thrift_write_i32(TablrThriftWriter* w, int16_t id, int32_t value);
+
+/**
+ * @brief Write an i64 field
+ */
+void tablr_thrift_write_i64(TablrThriftWriter* w, int16_t id, int64_t value);
+
+/**
+ * @brief Write a bool field
+ */
+void tablr_thrift_write_bool(TablrThriftWriter* w, int16_t id, bool value);
+
+/**
+ * @brief Write a binary or string field
+ */
+void tablr_thrift_write_binary(TablrThriftWriter* w, int16_t id, const void* data, size_t len);
+
+/**
+ * @brief Start a list field; elements follow with the write_elem functions
+ * @param w Writer
+ * @param id Field id
+ * @param elem_type Element wire type
+ * @param count Number of elements
+ */
+void tablr_thrift_write_list_begin(TablrThriftWriter* w, int16_t id, int elem_type, uint32_t count);
+
+/**
+ * @brief Write an i32 list element
+ */
+void tablr_thrift_write_elem_i32(TablrThriftWriter* w, int32_t value);
+
+/**
+ * @brief Write a binary list element
+ */
+void tablr_thrift_write_elem_binary(TablrThriftWriter* w, const void* data, size_t len);
+
+/**
+ * @brief Start a struct list element; close it with tablr_thrift_write_struct_end
+ * @param w Writer
+ */
+void tablr_thrift_write_elem_struct_begin(TablrThriftWriter* w);
+
+/**
+ * @brief Terminate the top-level struct
+ * @param w Writer
+ */
+void tablr_thrift_write_stop(TablrThriftWriter* w);
+
+#endif /* TABLR_IO_THRIFT_H */
@@ -0,0 +1,513 @@
+/**
+ * @file arith.c
+ * @brief Implementation of element-wise arithmetic, comparison and casts
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Operands are processed ARITH_BLOCK rows at a time by the kernels in
+ * kernels.c. A plain series already of the kernel type is read in place;
+ * compressed and chunked series are read a block at a time with
+ * tablr_series_read(), and other types are converted into a scratch
+ * block. A broadcast operand fills one block once and reuses it, so
+ * scalars and lazy constants are never expanded to the full length.
+ */
+
+#include "tablr/ops/arith.h"
+#include "tablr/core/encoding.h"
+#include "tablr/core/chunked.h"
+#include "kernels.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define ARITH_BLOCK 1024  /**< Rows per kernel call */
+
+/* Range of each kernel type; floats are unbounded */
+static const int64_t type_min[TABLR_KERNEL_TYPES] = {
+    INT8_MIN, INT16_MIN, INT32_MIN, INT64_MIN, 0, 0, 0, 0, 0, 0
+};
+static const uint64_t type_max[TABLR_KERNEL_TYPES] = {
+    INT8_MAX, INT16_MAX, INT32_MAX, INT64_MAX, UINT8_MAX, UINT16_MAX, UINT32_MAX, UINT64_MAX, 0, 0
+};
+
+/**
+ * @brief Get the kernel type that holds the values of a dtype
+ *
+ * Bools are uint8 0 or 1, dates int32 and timestamps int64.
+ *
+ * @return true on success, false for strings, categoricals and bitmasks
+ */
+static bool kernel_type(TablrDType dtype, TablrKernelType* type) {
+    switch (dtype) {
+        case TABLR_INT8: *type = TABLR_KERNEL_I8; return true;
+        case TABLR_INT16: *type = TABLR_KERNEL_I16; return true;
+        case TABLR_INT32:
+        case TABLR_DATE32: *type = TABLR_KERNEL_I32; return true;
+        case TABLR_INT64:
+        case TABLR_TIMESTAMP64: *type = TABLR_KERNEL_I64; return true;
+        case TABLR_BOOL:
+        case TABLR_UINT8: *type = TABLR_KERNEL_U8; return true;
+        case TABLR_UINT16: *type = TABLR_KERNEL_U16; return true;
+        case TABLR_UINT32: *type = TABLR_KERNEL_U32; return true;
+        case TABLR_UINT64: *type = TABLR_KERNEL_U64; return true;
+        case TABLR_FLOAT32: *type = TABLR_KERNEL_F32; return true;
+        case TABLR_FLOAT64: *type = TABLR_KERNEL_F64; return true;
+        default: return false;
+    }
+}
+
+static size_t kernel_size(TablrKernelType type) {
+    static const size_t sizes[TABLR_KERNEL_TYPES] = { 1, 2, 4, 8, 1, 2, 4, 8, 4, 8 };
+    return sizes[type];
+}
+
+static bool is_float(TablrKernelType type) {
+    return type == TABLR_KERNEL_F32 || type == TABLR_KERNEL_F64;
+}
+
+static bool is_temporal(TablrDType dtype) {
+    return dtype == TABLR_DATE32 || dtype == TABLR_TIMESTAMP64;
+}
+
+/**
+ * @brief Whether two series have the same date or timestamp type and unit
+ */
+static bool same_temporal(const TablrSeries* a, const TablrSeries* b) {
+    TablrDType dtype = tablr_series_dtype(a);
+    return dtype == tablr_series_dtype(b) &&
+           (dtype != TABLR_TIMESTAMP64 || tablr_series_time_unit(a) == tablr_series_time_unit(b));
+}
+
+/**
+ * @brief Get the length of two operands broadcast against each other
+ * @return true on success, false if neither size matches nor is 1
+ */
+static bool broadcast_size(const TablrSeries* a, const TablrSeries* b, size_t* n) {
+    size_t sa = tablr_series_size(a), sb = tablr_series_size(b);
+    if (sa != sb && sa != 1 && sb != 1) return false;
+    *n = sa == 1 ? sb : sa;
+    return true;
+}
+
+/* ===================== Operands ===================== */
+
+/**
+ * @brief One operand of a kernel call, read a block at a time
+ */
+typedef struct {
+    const TablrSeries* series;  /**< Source series */
+    TablrSeries* view;          /**< Plain view of the series' only chunk, or NULL */
+    const char* values;         /**< Stored values to read in place, or NULL */
+    TablrKernelType from;       /**< Type the series stores */
+    TablrKernelType to;         /**< Type the kernels take */
+    bool broadcast;             /**< block holds one value, repeated */
+    bool valid;                 /**< Whether a broadcast value is valid */
+    char* native;               /**< Scratch block in the stored type */
+    char* block;                /**< Scratch block in the kernel type */
+} Operand;
+
+/**
+ * @brief Prepare to read a series as the kernel type to
+ *
+ * A series of one element, or a constant series without nulls, is
+ * broadcast unless it is the only operand (n == 0).
+ *
+ * @return true on success, false on failure
+ */
+static bool operand_open(Operand* op, const TablrSeries* s, TablrKernelType to, size_t n) {
+    memset(op, 0, sizeof(*op));
+    op->series = s;
+    op->to = to;
+    kernel_type(tablr_series_dtype(s), &op->from);
+    op->native = (char*)malloc(ARITH_BLOCK * sizeof(uint64_t));
+    op->block = (char*)malloc(ARITH_BLOCK * sizeof(uint64_t));
+    if (!op->native || !op->block) return false;
+
+    size_t size = tablr_series_size(s);
+    op->broadcast = n > 0 && (size == 1 || (tablr_series_null_count(s) == 0 && tablr_series_is_constant(s)));
+    if (op->broadcast) {
+        /* Convert the value once, then double it up to a full block */
+        size_t width = kernel_size(to);
+        op->valid = tablr_series_is_valid(s, 0);
+        tablr_series_read(s, 0, 1, op->native);
+        tablr_kernel_cast(op->from, to, op->native, op->block, 1);
+        for (size_t filled = 1; filled < ARITH_BLOCK; filled *= 2) {
+            memcpy(op->block + filled * width, op->block, filled * width);
+        }
+        return true;
+    }
+
+    if (tablr_series_num_chunks(s) == 1) {
+        op->view = tablr_series_chunk(s, 0);
+        if (!op->view) return false;
+        if (tablr_series_encoding(op->view) == TABLR_ENCODING_PLAIN) {
+            op->values = (const char*)tablr_series_data_const(op->view);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Read rows start to start + count - 1 in the stored type
+ */
+static const void* operand_native(Operand* op, size_t start, size_t count) {
+    if (op->values) return op->values + start * kernel_size(op->from);
+    tablr_series_read(op->series, start, count, op->native);
+    return op->native;
+}
+
+/**
+ * @brief Read rows start to start + count - 1 in the kernel type
+ */
+static const void* operand_block(Operand* op, size_t start, size_t count) {
+    if (op->broadcast) return op->block;
+    const void* values = operand_native(op, start, count);
+    if (op->from == op->to) return values;
+    tablr_kernel_cast(op->from, op->to, values, op->block, count);
+    return op->block;
+}
+
+static void operand_close(Operand* op) {
+    tablr_series_free(op->view);
+    free(op->native);
+    free(op->block);
+}
+
+/**
+ * @brief Get the validity of elements word * 64 to word * 64 + 63 of an operand
+ */
+static uint64_t operand_valid(const Operand* op, size_t word) {
+    if (op->broadcast) return op->valid ? ~(uint64_t)0 : 0;
+    if (tablr_series_null_count(op->series) == 0) return ~(uint64_t)0;
+    return tablr_series_validity_word(op->series, word);
+}
+
+/**
+ * @brief Mark the result null where either operand is null
+ *
+ * @param b Second operand, or NULL for one
+ * @return true on success, false if marking failed
+ */
+static bool apply_nulls(TablrSeries* out, const Operand* a, const Operand* b, size_t n) {
+    bool nulls = (a->broadcast ? !a->valid : tablr_series_null_count(a->series) > 0) ||
+                 (b && (b->broadcast ? !b->valid : tablr_series_null_count(b->series) > 0));
+    for (size_t w = 0; nulls && w * 64 < n; w++) {
+        uint64_t valid = operand_valid(a, w) & (b ? operand_valid(b, w) : ~(uint64_t)0);
+        size_t m = n - w * 64 < 64 ? n - w * 64 : 64;
+        for (size_t j = 0; j < m; j++) {
+            if (!((valid >> j) & 1) && !tablr_series_set_valid(out, w * 64 + j, false)) return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Pack 0/1 bytes into bitmask words, eight bytes per multiply
+ */
+static void pack_bytes(const uint8_t* bytes, size_t n, uint64_t* words) {
+    for (size_t w = 0; w * 64 < n; w++) {
+        const uint8_t* p = bytes + w * 64;
+        size_t m = n - w * 64 < 64 ? n - w * 64 : 64;
+        uint64_t word = 0;
+        size_t j = 0;
+        for (; j + 8 <= m; j += 8) {
+            uint64_t x;
+            memcpy(&x, p + j, sizeof(x));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            x = __builtin_bswap64(x);
+#endif
+            /* Byte k (0 or 1) lands in bit 56 + k */
+            word |= ((x * 0x0102040810204080ULL) >> 56) << j;
+        }
+        for (; j < m; j++) word |= (uint64_t)p[j] << j;
+        words[w] = word;
+    }
+}
+
+/* ===================== Arithmetic ===================== */
+
+/**
+ * @brief Get the result type of an operator
+ * @return true on success, false if op does not apply to the two types
+ */
+static bool arith_type(const TablrSeries* a, TablrArithOp op, const TablrSeries* b, TablrDType* out) {
+    TablrDType at = tablr_series_dtype(a), bt = tablr_series_dtype(b);
+    if (is_temporal(at) || is_temporal(bt)) {
+        if (same_temporal(a, b)) {
+            if (op == TABLR_ARITH_MIN || op == TABLR_ARITH_MAX) *out = at;
+            else if (op == TABLR_ARITH_SUB) *out = TABLR_INT64;
+            else return false;
+            return true;
+        }
+        TablrDType other = is_temporal(at) ? bt : at;
+        bool integer = other == TABLR_BOOL || (tablr_dtype_is_integer(other) && !is_temporal(other));
+        if (!integer || !(op == TABLR_ARITH_ADD || (op == TABLR_ARITH_SUB && is_temporal(at)))) return false;
+        *out = is_temporal(at) ? at : bt;
+        return true;
+    }
+
+    if (!tablr_dtype_promote(at, bt, out)) return false;
+    if (op == TABLR_ARITH_DIV && *out != TABLR_FLOAT32 && *out != TABLR_FLOAT64) *out = TABLR_FLOAT64;
+    else if (*out == TABLR_BOOL && op != TABLR_ARITH_MIN && op != TABLR_ARITH_MAX) *out = TABLR_UINT8;
+    return true;
+}
+
+/**
+ * @brief Apply an operator to two series element by element
+ *
+ * @param a First operand
+ * @param op Operator
+ * @param b Second operand
+ * @return New series, or NULL on failure or unsupported types
+ */
+TablrSeries* tablr_series_arith(const TablrSeries* a, TablrArithOp op, const TablrSeries* b) {
+    TablrDType dtype;
+    size_t n;
+    if (!a || !b || op < TABLR_ARITH_ADD || op > TABLR_ARITH_MAX || !arith_type(a, op, b, &dtype) ||
+        !broadcast_size(a, b, &n)) {
+        return NULL;
+    }
+
+    TablrKernelType type;
+    kernel_type(dtype, &type);
+    size_t width = kernel_size(type);
+    TablrDevice device = tablr_series_device(a);
+    const TablrSeries* temporal = is_temporal(tablr_series_dtype(a)) ? a : b;
+
+    Operand x, y;
+    bool ok = operand_open(&x, a, type, n);
+    ok = operand_open(&y, b, type, n) && ok;
+    TablrSeries* out = NULL;
+    if (ok && x.broadcast && y.broadcast && x.valid && y.valid) {
+        /* Both constant: compute one element and broadcast it */
+        uint64_t value;
+        tablr_kernel_arith(op, type, x.block, y.block, &value, 1);
+        TablrSeries* one = tablr_series_create(&value, 1, dtype, device);
+        if (one && dtype == TABLR_TIMESTAMP64) tablr_series_set_time_unit(one, tablr_series_time_unit(temporal));
+        out = one ? tablr_series_broadcast(one, n) : NULL;
+        tablr_series_free(one);
+        operand_close(&x);
+        operand_close(&y);
+        return out;
+    }
+
+    out = ok ? tablr_series_alloc(n, dtype, device) : NULL;
+    char* data = (char*)tablr_series_data(out);
+    if (data && dtype == TABLR_TIMESTAMP64) tablr_series_set_time_unit(out, tablr_series_time_unit(temporal));
+    for (size_t start = 0; data && start < n; start += ARITH_BLOCK) {
+        size_t count = n - start < ARITH_BLOCK ? n - start : ARITH_BLOCK;
+        tablr_kernel_arith(op, type, operand_block(&x, start, count), operand_block(&y, start, count),
+                           data + start * width, count);
+    }
+    if (!data || !apply_nulls(out, &x, &y, n)) {
+        tablr_series_free(out);
+        out = NULL;
+    }
+    operand_close(&x);
+    operand_close(&y);
+    return out;
+}
+
+/**
+ * @brief Get the type a value takes beside a series
+ * @return true on success, false if the value cannot be used with the series
+ */
+static bool scalar_type(const TablrSeries* series, TablrArithOp op, double value, TablrDType* out) {
+    TablrDType dtype = tablr_series_dtype(series);
+    TablrKernelType type;
+    if (!kernel_type(dtype, &type)) return false;
+
+    bool whole = value == trunc(value);
+    if (is_float(type)) {
+        *out = dtype;
+    } else if (is_temporal(dtype)) {
+        /* A count of days or units; 2^63 is the first double past int64 */
+        if (!whole || value < -9223372036854775808.0 || value >= 9223372036854775808.0) return false;
+        *out = op == TABLR_ARITH_ADD || op == TABLR_ARITH_SUB ? TABLR_INT64 : dtype;
+    } else {
+        double hi = dtype == TABLR_BOOL ? 1.0 : (double)type_max[type];
+        bool fits = whole && value >= (double)type_min[type] && value <= hi && value < 18446744073709551616.0;
+        *out = fits ? dtype : TABLR_FLOAT64;
+    }
+    return true;
+}
+
+/**
+ * @brief Apply an operator to every element of a series and a value
+ *
+ * @param series First operand
+ * @param op Operator
+ * @param value Second operand
+ * @return New series, or NULL on failure or unsupported types
+ */
+TablrSeries* tablr_series_arith_scalar(const TablrSeries* series, TablrArithOp op, double value) {
+    TablrDType dtype;
+    if (!series || !scalar_type(series, op, value, &dtype)) return NULL;
+
+    TablrSeries* scalar = tablr_series_full(1, dtype, value, tablr_series_device(series));
+    if (!scalar) return NULL;
+    if (dtype == TABLR_TIMESTAMP64) tablr_series_set_time_unit(scalar, tablr_series_time_unit(series));
+    TablrSeries* out = tablr_series_arith(series, op, scalar);
+    tablr_series_free(scalar);
+    return out;
+}
+
+/* ===================== Comparison ===================== */
+
+/**
+ * @brief Compare two series element by element
+ *
+ * @param a First operand
+ * @param op Comparison
+ * @param b Second operand
+ * @return New bitmask series, or NULL on failure or unsupported types
+ */
+TablrSeries* tablr_series_compare_series(const TablrSeries* a, TablrCompareOp op, const TablrSeries* b) {
+    if (!a || !b || op < TABLR_CMP_EQ || op > TABLR_CMP_GE) return NULL;
+
+    TablrDType dtype = tablr_series_dtype(a);
+    bool temporal = is_temporal(dtype) || is_temporal(tablr_series_dtype(b));
+    size_t n;
+    if ((temporal ? !same_temporal(a, b) : !tablr_dtype_promote(dtype, tablr_series_dtype(b), &dtype)) ||
+        !broadcast_size(a, b, &n)) {
+        return NULL;
+    }
+
+    TablrKernelType type;
+    kernel_type(dtype, &type);
+    Operand x, y;
+    bool ok = operand_open(&x, a, type, n);
+    ok = operand_open(&y, b, type, n) && ok;
+    TablrSeries* out = ok ? tablr_series_alloc(n, TABLR_BITMASK, tablr_series_device(a)) : NULL;
+    uint64_t* words = (uint64_t*)tablr_series_data(out);
+    uint8_t bytes[ARITH_BLOCK];
+    for (size_t start = 0; words && start < n; start += ARITH_BLOCK) {
+        size_t count = n - start < ARITH_BLOCK ? n - start : ARITH_BLOCK;
+        tablr_kernel_compare(op, type, operand_block(&x, start, count), operand_block(&y, start, count),
+                             bytes, count);
+        pack_bytes(bytes, count, words + start / 64);
+    }
+    if (!words || !apply_nulls(out, &x, &y, n)) {
+        tablr_series_free(out);
+        out = NULL;
+    }
+    operand_close(&x);
+    operand_close(&y);
+    return out;
+}
+
+/* ===================== Casts ===================== */
+
+/**
+ * @brief Whether some value of type from falls outside type to
+ */
+static bool may_overflow(TablrKernelType from, TablrKernelType to) {
+    if (is_float(to)) return false;
+    if (is_float(from)) return true;
+    return type_min[from] < type_min[to] || type_max[from] > type_max[to];
+}
+
+/**
+ * @brief Whether element i of a block of type from fits type to
+ */
+static bool fits(const void* block, size_t i, TablrKernelType from, TablrKernelType to) {
+    switch (from) {
+        case TABLR_KERNEL_F32:
+        case TABLR_KERNEL_F64: {
+            double v = from == TABLR_KERNEL_F32 ? (double)((const float*)block)[i] : ((const double*)block)[i];
+            /* Limits are powers of two, so exact as doubles; NaN fails both tests */
+            double t = trunc(v);
+            return t >= (double)type_min[to] && t < (double)type_max[to] + 1.0;
+        }
+        case TABLR_KERNEL_U8: return ((const uint8_t*)block)[i] <= type_max[to];
+        case TABLR_KERNEL_U16: return ((const uint16_t*)block)[i] <= type_max[to];
+        case TABLR_KERNEL_U32: return ((const uint32_t*)block)[i] <= type_max[to];
+        case TABLR_KERNEL_U64: return ((const uint64_t*)block)[i] <= type_max[to];
+        default: {
+            int64_t v = from == TABLR_KERNEL_I8 ? ((const int8_t*)block)[i]
+                      : from == TABLR_KERNEL_I16 ? ((const int16_t*)block)[i]
+                      : from == TABLR_KERNEL_I32 ? ((const int32_t*)block)[i]
+                      : ((const int64_t*)block)[i];
+            return v >= type_min[to] && (v < 0 || (uint64_t)v <= type_max[to]);
+        }
+    }
+}
+
+/**
+ * @brief Convert a series to another type
+ *
+ * @param series Series to convert
+ * @param dtype New type
+ * @return New series, or NULL on failure or unsupported types
+ */
+TablrSeries* tablr_series_cast(const TablrSeries* series, TablrDType dtype) {
+    if (!series) return NULL;
+    TablrDType from_dtype = tablr_series_dtype(series);
+    size_t n = tablr_series_size(series);
+    if (from_dtype == dtype) return tablr_series_slice(series, 0, n);
+
+    TablrKernelType from, to;
+    if (!kernel_type(from_dtype, &from) || !kernel_type(dtype, &to)) return NULL;
+    /* Dates and timestamps convert to and from integers only */
+    if ((is_temporal(from_dtype) || is_temporal(dtype)) &&
+        (is_float(from) || is_float(to) || from_dtype == TABLR_BOOL || dtype == TABLR_BOOL ||
+         (is_temporal(from_dtype) && is_temporal(dtype)))) {
+        return NULL;
+    }
+
+    if (n > 1 && tablr_series_null_count(series) == 0 && tablr_series_is_constant(series)) {
+        /* Convert the one value; it may still become null */
+        TablrSeries* first = tablr_series_slice(series, 0, 1);
+        TablrSeries* one = tablr_series_cast(first, dtype);
+        TablrSeries* out = one ? tablr_series_broadcast(one, n) : NULL;
+        tablr_series_free(one);
+        tablr_series_free(first);
+        return out;
+    }
+
+    Operand x;
+    bool ok = operand_open(&x, series, from, 0);
+    TablrSeries* out = ok ? tablr_series_alloc(n, dtype, tablr_series_device(series)) : NULL;
+    char* data = (char*)tablr_series_data(out);
+    uint64_t* zeros = dtype == TABLR_BOOL ? (uint64_t*)calloc(ARITH_BLOCK, sizeof(uint64_t)) : NULL;
+    ok = data && (dtype != TABLR_BOOL || zeros);
+
+    bool check = dtype != TABLR_BOOL && may_overflow(from, to);
+    size_t width = kernel_size(to);
+    for (size_t start = 0; ok && start < n; start += ARITH_BLOCK) {
+        size_t count = n - start < ARITH_BLOCK ? n - start : ARITH_BLOCK;
+        const void* values = operand_native(&x, start, count);
+        if (dtype == TABLR_BOOL) {
+            tablr_kernel_compare(TABLR_CMP_NE, from, values, zeros, (uint8_t*)data + start, count);
+            continue;
+        }
+
+        for (size_t i = 0; check && i < count; i++) {
+            if (fits(values, i, from, to)) continue;
+            /* Zero the element, whose conversion is undefined, and null it */
+            if (values != x.native) values = memcpy(x.native, values, count * kernel_size(from));
+            memset(x.native + i * kernel_size(from), 0, kernel_size(from));
+            ok = tablr_series_set_valid(out, start + i, false);
+            if (!ok) break;
+        }
+        tablr_kernel_cast(from, to, values, data + start * width, count);
+    }
+
+    ok = ok && apply_nulls(out, &x, NULL, n);
+    free(zeros);
+    operand_close(&x);
+    if (!ok) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+/**
+ * @brief Get the instruction set the arithmetic kernels run on
+ *
+ * @return SIMD level chosen for this CPU
+ */
+TablrSimdLevel tablr_arith_simd_level(void) {
+    return tablr_kernel_level();
+}
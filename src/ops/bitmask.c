@@ -0,0 +1,301 @@
+/**
+ * @file bitmask.c
+ * @brief Implementation of bit-packed boolean columns
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * This file implements packing and unpacking bool columns and the mask
+ * kernels, which combine, count and enumerate 64 rows per word operation.
+ */
+
+#include "tablr/ops/bitmask.h"
+#include "bits.h"
+#include <stdlib.h>
+
+/**
+ * @brief Mark the null elements of src null in dst
+ *
+ * Walks the validity words of src, so only the null rows are visited.
+ *
+ * @return true on success, false if marking failed
+ */
+static bool copy_nulls(const TablrSeries* src, TablrSeries* dst) {
+    if (tablr_series_null_count(src) == 0) return true;
+
+    size_t size = tablr_series_size(src);
+    for (size_t w = 0; w < bits_words(size); w++) {
+        size_t n = size - w * 64;
+        uint64_t all = n >= 64 ? BITS_ALL_VALID : ((uint64_t)1 << n) - 1;
+        for (uint64_t nulls = ~tablr_series_validity_word(src, w) & all; nulls; nulls &= nulls - 1) {
+            if (!tablr_series_set_valid(dst, w * 64 + bits_ctz(nulls), false)) return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Pack a bool series into a bitmask series
+ *
+ * Each word is assembled from 64 bytes in a register and stored once.
+ *
+ * @param series Bool or bitmask series
+ * @return New bitmask series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_series_to_bitmask(const TablrSeries* series) {
+    TablrDType dtype = tablr_series_dtype(series);
+    if (!series || (dtype != TABLR_BOOL && dtype != TABLR_BITMASK)) return NULL;
+    if (dtype == TABLR_BITMASK) return tablr_series_slice(series, 0, tablr_series_size(series));
+
+    size_t size = tablr_series_size(series);
+    const bool* values = (const bool*)tablr_series_data_const(series);
+    TablrSeries* out = tablr_series_alloc(size, TABLR_BITMASK, tablr_series_device(series));
+    uint64_t* bits = (uint64_t*)tablr_series_data(out);
+    if (!bits || (!values && size > 0)) {
+        tablr_series_free(out);
+        return NULL;
+    }
+
+    for (size_t base = 0; base < size; base += 64) {
+        size_t n = size - base < 64 ? size - base : 64;
+        uint64_t word = 0;
+        for (size_t j = 0; j < n; j++) word |= (uint64_t)(values[base + j] != 0) << j;
+        bits[base / 64] = word;
+    }
+
+    if (!copy_nulls(series, out)) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+/**
+ * @brief Unpack a bitmask series into a bool series
+ *
+ * @param series Bitmask series
+ * @return New bool series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_series_from_bitmask(const TablrSeries* series) {
+    if (!series || tablr_series_dtype(series) != TABLR_BITMASK) return NULL;
+
+    size_t size = tablr_series_size(series);
+    const uint64_t* bits = (const uint64_t*)tablr_series_data_const(series);
+    TablrSeries* out = tablr_series_alloc(size, TABLR_BOOL, tablr_series_device(series));
+    bool* values = (bool*)tablr_series_data(out);
+    if (!values || (!bits && size > 0)) {
+        tablr_series_free(out);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        values[i] = (bits[i / 64] >> (i % 64)) & 1;
+    }
+
+    if (!copy_nulls(series, out)) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+/**
+ * @brief Get one element of a bitmask series
+ *
+ * @param mask Bitmask series
+ * @param index Element index
+ * @return Value of the element; false if out of range, not a bitmask or
+ *         the series could not be decoded
+ */
+bool tablr_bitmask_get(const TablrSeries* mask, size_t index) {
+    if (tablr_series_dtype(mask) != TABLR_BITMASK || index >= tablr_series_size(mask)) return false;
+
+    const uint64_t* bits = (const uint64_t*)tablr_series_data_const(mask);
+    return bits && ((bits[index / 64] >> (index % 64)) & 1);
+}
+
+/**
+ * @brief Set one element of a bitmask series
+ *
+ * @param mask Bitmask series
+ * @param index Element index
+ * @param value New value
+ * @return true on success, false if out of range, not a bitmask or a copy failed
+ */
+bool tablr_bitmask_set(TablrSeries* mask, size_t index, bool value) {
+    if (tablr_series_dtype(mask) != TABLR_BITMASK || index >= tablr_series_size(mask)) return false;
+
+    uint64_t* bits = (uint64_t*)tablr_series_data(mask);
+    if (!bits) return false;
+
+    uint64_t bit = (uint64_t)1 << (index % 64);
+    if (value) bits[index / 64] |= bit;
+    else bits[index / 64] &= ~bit;
+    return true;
+}
+
+/**
+ * @brief Get elements word * 64 to word * 64 + 63 of a bitmask series
+ *
+ * Views may leave stale bits after their last element, so the last word
+ * is masked to the series' length.
+ *
+ * @param mask Bitmask series
+ * @param word Block index
+ * @return Element bits, or 0 if out of range, not a bitmask or the series
+ *         could not be decoded
+ */
+uint64_t tablr_bitmask_word(const TablrSeries* mask, size_t word) {
+    size_t size = tablr_series_size(mask);
+    if (tablr_series_dtype(mask) != TABLR_BITMASK || word >= bits_words(size)) return 0;
+
+    const uint64_t* data = (const uint64_t*)tablr_series_data_const(mask);
+    if (!data) return 0;
+    uint64_t bits = data[word];
+    size_t n = size - word * 64;
+    return n >= 64 ? bits : bits & (((uint64_t)1 << n) - 1);
+}
+
+/**
+ * @brief Operation applied by combine()
+ */
+typedef enum {
+    MASK_AND,
+    MASK_OR
+} MaskOp;
+
+/**
+ * @brief Combine two bitmasks word by word
+ *
+ * @return New bitmask series, or NULL on failure or mismatched inputs
+ */
+static TablrSeries* combine(const TablrSeries* a, const TablrSeries* b, MaskOp op) {
+    size_t size = tablr_series_size(a);
+    if (tablr_series_dtype(a) != TABLR_BITMASK || tablr_series_dtype(b) != TABLR_BITMASK ||
+        size == 0 || tablr_series_size(b) != size) {
+        return NULL;
+    }
+
+    const uint64_t* x = (const uint64_t*)tablr_series_data_const(a);
+    const uint64_t* y = (const uint64_t*)tablr_series_data_const(b);
+    TablrSeries* out = tablr_series_alloc(size, TABLR_BITMASK, tablr_series_device(a));
+    uint64_t* bits = (uint64_t*)tablr_series_data(out);
+    if (!bits || !x || !y) {
+        tablr_series_free(out);
+        return NULL;
+    }
+
+    size_t nwords = bits_words(size);
+    if (op == MASK_AND) {
+        for (size_t w = 0; w < nwords; w++) bits[w] = x[w] & y[w];
+    } else {
+        for (size_t w = 0; w < nwords; w++) bits[w] = x[w] | y[w];
+    }
+    if (size % 64) bits[nwords - 1] &= ((uint64_t)1 << (size % 64)) - 1;
+
+    if (!copy_nulls(a, out) || !copy_nulls(b, out)) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+/**
+ * @brief Element-wise AND of two bitmasks of the same length
+ *
+ * @param a First bitmask
+ * @param b Second bitmask
+ * @return New bitmask series, or NULL on failure or mismatched inputs
+ */
+TablrSeries* tablr_bitmask_and(const TablrSeries* a, const TablrSeries* b) {
+    return combine(a, b, MASK_AND);
+}
+
+/**
+ * @brief Element-wise OR of two bitmasks of the same length
+ *
+ * @param a First bitmask
+ * @param b Second bitmask
+ * @return New bitmask series, or NULL on failure or mismatched inputs
+ */
+TablrSeries* tablr_bitmask_or(const TablrSeries* a, const TablrSeries* b) {
+    return combine(a, b, MASK_OR);
+}
+
+/**
+ * @brief Element-wise NOT of a bitmask
+ *
+ * @param mask Bitmask series
+ * @return New bitmask series, or NULL on failure or for other types
+ */
+TablrSeries* tablr_bitmask_not(const TablrSeries* mask) {
+    size_t size = tablr_series_size(mask);
+    if (tablr_series_dtype(mask) != TABLR_BITMASK || size == 0) return NULL;
+
+    const uint64_t* x = (const uint64_t*)tablr_series_data_const(mask);
+    TablrSeries* out = tablr_series_alloc(size, TABLR_BITMASK, tablr_series_device(mask));
+    uint64_t* bits = (uint64_t*)tablr_series_data(out);
+    if (!bits || !x) {
+        tablr_series_free(out);
+        return NULL;
+    }
+
+    size_t nwords = bits_words(size);
+    for (size_t w = 0; w < nwords; w++) bits[w] = ~x[w];
+    if (size % 64) bits[nwords - 1] &= ((uint64_t)1 << (size % 64)) - 1;
+
+    if (!copy_nulls(mask, out)) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+/**
+ * @brief Count the set, valid elements of a bitmask
+ *
+ * One popcount per 64 rows.
+ *
+ * @param mask Bitmask series
+ * @return Number of true elements; 0 for NULL or other types
+ */
+size_t tablr_bitmask_count(const TablrSeries* mask) {
+    size_t count = 0;
+    size_t nwords = bits_words(tablr_series_size(mask));
+    for (size_t w = 0; w < nwords; w++) {
+        count += bits_popcount(tablr_bitmask_word(mask, w) & tablr_series_validity_word(mask, w));
+    }
+    return count;
+}
+
+/**
+ * @brief Get the indices of the set, valid elements of a bitmask
+ *
+ * Sizes the output with a popcount pass, then emits each word's set bits
+ * lowest first; full words are written without bit scans.
+ *
+ * @param mask Bitmask series
+ * @param count Output number of indices
+ * @return Array to free with free(), or NULL on failure or for other types
+ */
+size_t* tablr_bitmask_indices(const TablrSeries* mask, size_t* count) {
+    if (tablr_series_dtype(mask) != TABLR_BITMASK || !count) return NULL;
+
+    size_t total = tablr_bitmask_count(mask);
+    size_t* indices = (size_t*)malloc((total ? total : 1) * sizeof(size_t));
+    if (!indices) return NULL;
+
+    size_t idx = 0;
+    size_t nwords = bits_words(tablr_series_size(mask));
+    for (size_t w = 0; w < nwords; w++) {
+        uint64_t bits = tablr_bitmask_word(mask, w) & tablr_series_validity_word(mask, w);
+        size_t base = w * 64;
+        if (bits == BITS_ALL_VALID) {
+            for (size_t j = 0; j < 64; j++) indices[idx++] = base + j;
+            continue;
+        }
+        for (; bits; bits &= bits - 1) indices[idx++] = base + bits_ctz(bits);
+    }
+
+    *count = total;
+    return indices;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file bits.h
+ * @brief Bit counting helpers for validity bitmap kernels
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ */
+
+#ifndef TABLR_OPS_BITS_H
+#define TABLR_OPS_BITS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define BITS_ALL_VALID (~(uint64_t)0)  /**< Validity word of 64 valid rows */
+
+/**
+ * @brief Count the set bits of a word
+ */
+static inline size_t bits_popcount(uint64_t word) {
+#ifdef _MSC_VER
+    return (size_t)__popcnt64(word);
+#else
+    return (size_t)__builtin_popcountll(word);
+#endif
+}
+
+/**
+ * @brief Index of the lowest set bit of a non-zero word
+ */
+static inline unsigned bits_ctz(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctzll(word);
+#endif
+}
+
+/**
+ * @brief Number of 64-row blocks covering n rows
+ */
+static inline size_t bits_words(size_t n) {
+    return (n + 63) / 64;
+}
+
+#endif /* TABLR_OPS_BITS_H */
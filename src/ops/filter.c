@@ -9,6 +9,10 @@
  */
 
 #include "tablr/ops/filter.h"
+#include "tablr/ops/bitmask.h"
+#include "tablr/core/encoding.h"
+#include "bits.h"
+#include "gather.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -16,7 +20,8 @@
  * @brief Filter dataframe rows using predicate function
  * 
  * Applies a predicate function to each row and keeps only rows where
- * the predicate returns true. Creates a new dataframe with filtered rows.
+ * the predicate returns true. The results are packed into a bitmask, one
+ * bit per row, which is then turned into row indices a word at a time.
  * 
  * @param df Source dataframe to filter
  * @param predicate Function that returns true for rows to keep
@@ -27,29 +32,158 @@ TablrDataFrame* tablr_dataframe_filter(const TablrDataFrame* df, TablrFilterFunc
     if (!df || !predicate) return NULL;
     
     size_t nrows = tablr_dataframe_nrows(df);
+    if (nrows == 0) return tablr_dataframe_copy(df);
     
     /* Evaluate predicate for each row */
-    bool* keep = (bool*)malloc(nrows * sizeof(bool));
-    size_t keep_count = 0;
-    
-    for (size_t i = 0; i < nrows; i++) {
-        keep[i] = predicate(i, ctx);
-        if (keep[i]) keep_count++;
+    TablrSeries* keep = tablr_series_alloc(nrows, TABLR_BITMASK, TABLR_CPU);
+    uint64_t* bits = (uint64_t*)tablr_series_data(keep);
+    if (!bits) {
+        tablr_series_free(keep);
+        return NULL;
     }
-    
-    /* Build array of indices to keep */
-    size_t* indices = (size_t*)malloc(keep_count * sizeof(size_t));
-    size_t idx = 0;
-    for (size_t i = 0; i < nrows; i++) {
-        if (keep[i]) indices[idx++] = i;
+    for (size_t base = 0; base < nrows; base += 64) {
+        size_t n = nrows - base < 64 ? nrows - base : 64;
+        uint64_t word = 0;
+        for (size_t j = 0; j < n; j++) {
+            if (predicate(base + j, ctx)) word |= (uint64_t)1 << j;
+        }
+        bits[base / 64] = word;
     }
     
-    /* Select rows by indices */
-    TablrDataFrame* result = tablr_dataframe_select_rows(df, indices, keep_count);
+    TablrDataFrame* result = tablr_dataframe_filter_mask(df, keep);
+    tablr_series_free(keep);
+    return result;
+}
+
+/**
+ * @brief Keep the rows where a mask is true
+ * 
+ * A bool mask is packed first. The set bits are then turned into row
+ * indices, skipping whole words of dropped rows, and the columns are
+ * gathered once.
+ * 
+ * @param df Source dataframe
+ * @param mask Bitmask or bool series with one element per row
+ * @return New dataframe with the selected rows, or NULL on error
+ */
+TablrDataFrame* tablr_dataframe_filter_mask(const TablrDataFrame* df, const TablrSeries* mask) {
+    if (!df || !mask || tablr_series_size(mask) != tablr_dataframe_nrows(df)) return NULL;
     
-    free(keep);
+    TablrSeries* bits = tablr_series_to_bitmask(mask);
+    size_t count = 0;
+    size_t* indices = tablr_bitmask_indices(bits, &count);
+    tablr_series_free(bits);
+    if (!indices) return NULL;
+    
+    TablrDataFrame* result = tablr_dataframe_select_rows(df, indices, count);
     free(indices);
+    return result;
+}
+
+/**
+ * @brief Filter rows by comparing a numeric column with a value
+ * 
+ * @param df Source dataframe
+ * @param column Column to compare
+ * @param op Comparison
+ * @param value Value to compare with
+ * @return New dataframe with the matching rows, or NULL on error
+ */
+TablrDataFrame* tablr_dataframe_filter_compare(const TablrDataFrame* df, const char* column,
+                                               TablrCompareOp op, double value) {
+    if (!df || !column) return NULL;
     
+    TablrSeries* mask = tablr_series_compare(tablr_dataframe_get_column(df, column), op, value);
+    if (!mask) return NULL;
+    
+    TablrDataFrame* result = tablr_dataframe_filter_mask(df, mask);
+    tablr_series_free(mask);
+    return result;
+}
+
+/**
+ * @brief Find the code of a value in a categorical column
+ * @return Code, or -1 if the value is not a category
+ */
+static int32_t find_category(const TablrSeries* s, const char* value, size_t len) {
+    const TablrSeries* categories = tablr_series_categories(s);
+    size_t ncategories = tablr_series_size(categories);
+    for (size_t c = 0; c < ncategories; c++) {
+        size_t clen;
+        const char* chars = tablr_series_string_at(categories, c, &clen);
+        if (clen == len && memcmp(chars, value, len) == 0) return (int32_t)c;
+    }
+    return -1;
+}
+
+/**
+ * @brief Rows of one 64-row block whose code equals code
+ */
+static uint64_t match_codes(const int32_t* codes, size_t base, size_t n, int32_t code) {
+    uint64_t bits = 0;
+    for (size_t j = 0; j < n; j++) {
+        bits |= (uint64_t)(codes[base + j] == code) << j;
+    }
+    return bits;
+}
+
+/**
+ * @brief Rows of one 64-row block of a string column equal to value
+ */
+static uint64_t match_strings(const TablrSeries* s, size_t base, size_t n, const char* value, size_t len) {
+    const int64_t* offsets = tablr_series_string_offsets(s);
+    const char* chars = tablr_series_string_chars(s);
+    uint64_t bits = 0;
+    for (size_t j = 0; j < n; j++) {
+        size_t i = base + j;
+        if ((size_t)(offsets[i + 1] - offsets[i]) == len && memcmp(chars + offsets[i], value, len) == 0) {
+            bits |= (uint64_t)1 << j;
+        }
+    }
+    return bits;
+}
+
+/**
+ * @brief Keep the rows whose column value equals a string
+ * 
+ * For a categorical column the value is looked up among the categories
+ * once, and rows are matched by comparing int32 codes, 64 at a time; a
+ * string column compares each row's characters. Null rows never match.
+ * 
+ * @param df Source dataframe
+ * @param column Name of a string or categorical column
+ * @param value Value to match
+ * @return New dataframe with matching rows, or NULL on error or for other column types
+ */
+TablrDataFrame* tablr_dataframe_filter_equals(const TablrDataFrame* df, const char* column, const char* value) {
+    if (!df || !column || !value) return NULL;
+    
+    TablrSeries* s = tablr_dataframe_get_column(df, column);
+    TablrDType dtype = tablr_series_dtype(s);
+    if (!s || (dtype != TABLR_STRING && dtype != TABLR_CATEGORICAL)) return NULL;
+    
+    size_t nrows = tablr_series_size(s);
+    size_t len = strlen(value);
+    int32_t code = dtype == TABLR_CATEGORICAL ? find_category(s, value, len) : 0;
+    const int32_t* codes = dtype == TABLR_CATEGORICAL ? (const int32_t*)tablr_series_data_const(s) : NULL;
+    if (dtype == TABLR_CATEGORICAL && !codes && nrows > 0) return NULL;
+    
+    size_t* indices = (size_t*)malloc((nrows ? nrows : 1) * sizeof(size_t));
+    if (!indices) return NULL;
+    
+    size_t count = 0;
+    for (size_t w = 0; code >= 0 && w < bits_words(nrows); w++) {
+        size_t base = w * 64;
+        size_t n = nrows - base < 64 ? nrows - base : 64;
+        uint64_t bits = dtype == TABLR_CATEGORICAL ? match_codes(codes, base, n, code)
+                                                   : match_strings(s, base, n, value, len);
+        for (bits &= tablr_series_validity_word(s, w); bits; bits &= bits - 1) {
+            indices[count++] = base + bits_ctz(bits);
+        }
+    }
+    
+    TablrDataFrame* result = tablr_dataframe_select_rows(df, indices, count);
+    free(indices);
     return result;
 }
 
@@ -57,7 +191,8 @@ TablrDataFrame* tablr_dataframe_filter(const TablrDataFrame* df, TablrFilterFunc
  * @brief Select specific rows by index array
  * 
  * Creates a new dataframe containing only the rows at the specified indices.
- * Preserves all columns and maintains the order of indices provided.
+ * Preserves all columns and maintains the order of indices provided. Null
+ * rows stay null.
  * 
  * @param df Source dataframe
  * @param indices Array of row indices to select
@@ -70,30 +205,12 @@ TablrDataFrame* tablr_dataframe_select_rows(const TablrDataFrame* df, const size
     TablrDataFrame* result = tablr_dataframe_create();
     size_t ncols = tablr_dataframe_ncols(df);
     
-    /* Process each column */
+    /* Gather selected rows straight into the new columns */
     for (size_t col = 0; col < ncols; col++) {
-        size_t name_count;
-        char** names = tablr_dataframe_columns(df, &name_count);
-        TablrSeries* s = tablr_dataframe_get_column(df, names[col]);
-        
-        void* data = tablr_series_data(s);
-        TablrDType dtype = tablr_series_dtype(s);
-        TablrDevice device = tablr_series_device(s);
-        size_t elem_size = tablr_dtype_size(dtype);
-        
-        /* Copy selected rows */
-        void* new_data = malloc(count * elem_size);
-        for (size_t i = 0; i < count; i++) {
-            memcpy((char*)new_data + i * elem_size, 
-                   (char*)data + indices[i] * elem_size, elem_size);
+        TablrSeries* new_series = tablr_gather_series(tablr_dataframe_column_at(df, col), indices, count);
+        if (!tablr_dataframe_add_column(result, tablr_dataframe_column_name_at(df, col), new_series)) {
+            tablr_series_free(new_series);
         }
-        
-        TablrSeries* new_series = tablr_series_create(new_data, count, dtype, device);
-        tablr_dataframe_add_column(result, names[col], new_series);
-        
-        free(new_data);
-        for (size_t i = 0; i < name_count; i++) free(names[i]);
-        free(names);
     }
     
     return result;
@@ -104,6 +221,7 @@ TablrDataFrame* tablr_dataframe_select_rows(const TablrDataFrame* df, const size
  * 
  * Creates a new dataframe containing only the specified columns.
  * Preserves all rows and maintains the order of columns provided.
+ * The columns share their data with df; nothing is copied.
  * 
  * @param df Source dataframe
  * @param columns Array of column names to select
@@ -115,16 +233,11 @@ TablrDataFrame* tablr_dataframe_select_columns(const TablrDataFrame* df, const c
     
     TablrDataFrame* result = tablr_dataframe_create();
     
-    /* Copy each requested column */
+    /* Share each requested column */
     for (size_t i = 0; i < count; i++) {
         TablrSeries* s = tablr_dataframe_get_column(df, columns[i]);
         if (s) {
-            void* data = tablr_series_data(s);
-            TablrDType dtype = tablr_series_dtype(s);
-            TablrDevice device = tablr_series_device(s);
-            size_t size = tablr_series_size(s);
-            
-            TablrSeries* new_series = tablr_series_create(data, size, dtype, device);
+            TablrSeries* new_series = tablr_series_slice(s, 0, tablr_series_size(s));
             tablr_dataframe_add_column(result, columns[i], new_series);
         }
     }
@@ -135,22 +248,49 @@ TablrDataFrame* tablr_dataframe_select_columns(const TablrDataFrame* df, const c
 /**
  * @brief Check if value is NaN for float types
  */
-static bool is_nan_value(void* ptr, TablrDType dtype) {
+static bool is_nan_value(const void* ptr, TablrDType dtype) {
     if (dtype == TABLR_FLOAT32) {
-        float val = *(float*)ptr;
+        float val = *(const float*)ptr;
         return val != val;
     } else if (dtype == TABLR_FLOAT64) {
-        double val = *(double*)ptr;
+        double val = *(const double*)ptr;
         return val != val;
     }
     return false;
 }
 
+/**
+ * @brief Clear the bits of NaN rows in one 64-row block of a float column
+ * @param data Column values
+ * @param dtype Column type
+ * @param base Index of the first row of the block
+ * @param bits Rows of the block still kept
+ * @return bits without the NaN rows
+ */
+static uint64_t clear_nans(const void* data, TablrDType dtype, size_t base, uint64_t bits) {
+    size_t elem_size = tablr_dtype_size(dtype);
+    const char* block = (const char*)data + base * elem_size;
+    
+    if (bits == BITS_ALL_VALID) {
+        for (unsigned j = 0; j < 64; j++) {
+            if (is_nan_value(block + j * elem_size, dtype)) bits &= ~((uint64_t)1 << j);
+        }
+        return bits;
+    }
+    for (uint64_t pending = bits; pending; pending &= pending - 1) {
+        unsigned j = bits_ctz(pending);
+        if (is_nan_value(block + j * elem_size, dtype)) bits &= ~((uint64_t)1 << j);
+    }
+    return bits;
+}
+
 /**
  * @brief Drop rows with missing values
  * 
- * Creates a new dataframe with rows containing missing (NaN) values removed.
- * Checks all columns for NaN values in float types.
+ * Creates a new dataframe without the rows that are null in any column or
+ * NaN in a float column. Rows are tested 64 at a time against each
+ * column's validity bits, so columns without nulls cost one AND per block
+ * and only rows still kept are checked for NaN.
  * 
  * @param df Source dataframe
  * @return New dataframe without missing values, or NULL on error
@@ -165,40 +305,60 @@ TablrDataFrame* tablr_dataframe_dropna(const TablrDataFrame* df) {
         return tablr_dataframe_copy(df);
     }
     
-    /* Mark rows with missing values */
-    bool* keep = (bool*)malloc(nrows * sizeof(bool));
-    for (size_t i = 0; i < nrows; i++) {
-        keep[i] = true;
+    /* One bit per row, cleared once the row has a missing value */
+    size_t nwords = bits_words(nrows);
+    uint64_t* keep = (uint64_t*)malloc(nwords * sizeof(uint64_t));
+    if (!keep) return NULL;
+    for (size_t w = 0; w < nwords; w++) {
+        size_t n = nrows - w * 64;
+        keep[w] = n >= 64 ? BITS_ALL_VALID : ((uint64_t)1 << n) - 1;
     }
     
-    size_t name_count;
-    char** names = tablr_dataframe_columns(df, &name_count);
-    
-    /* Check each column for NaN values */
     for (size_t col = 0; col < ncols; col++) {
-        TablrSeries* s = tablr_dataframe_get_column(df, names[col]);
-        void* data = tablr_series_data(s);
+        TablrSeries* s = tablr_dataframe_column_at(df, col);
         TablrDType dtype = tablr_series_dtype(s);
-        size_t elem_size = tablr_dtype_size(dtype);
+        bool floating = dtype == TABLR_FLOAT32 || dtype == TABLR_FLOAT64;
+        const void* data = floating ? tablr_series_data_const(s) : NULL;
+        if (floating && !data) {
+            free(keep);
+            return NULL;
+        }
         
-        for (size_t row = 0; row < nrows; row++) {
-            void* ptr = (char*)data + row * elem_size;
-            if (is_nan_value(ptr, dtype)) {
-                keep[row] = false;
-            }
+        for (size_t w = 0; w < nwords; w++) {
+            uint64_t bits = keep[w];
+            if (!bits) continue;
+            bits &= tablr_series_validity_word(s, w);
+            if (floating && bits) bits = clear_nans(data, dtype, w * 64, bits);
+            keep[w] = bits;
         }
     }
     
-    /* Build indices of rows to keep */
     size_t keep_count = 0;
-    for (size_t i = 0; i < nrows; i++) {
-        if (keep[i]) keep_count++;
+    for (size_t w = 0; w < nwords; w++) {
+        keep_count += bits_popcount(keep[w]);
     }
     
-    size_t* indices = (size_t*)malloc(keep_count * sizeof(size_t));
+    /* Nothing to drop: share the columns instead of gathering them */
+    if (keep_count == nrows) {
+        free(keep);
+        return tablr_dataframe_copy(df);
+    }
+    
+    size_t* indices = (size_t*)malloc((keep_count ? keep_count : 1) * sizeof(size_t));
+    if (!indices) {
+        free(keep);
+        return NULL;
+    }
     size_t idx = 0;
-    for (size_t i = 0; i < nrows; i++) {
-        if (keep[i]) indices[idx++] = i;
+    for (size_t w = 0; w < nwords; w++) {
+        size_t base = w * 64;
+        if (keep[w] == BITS_ALL_VALID) {
+            for (size_t j = 0; j < 64; j++) indices[idx++] = base + j;
+            continue;
+        }
+        for (uint64_t bits = keep[w]; bits; bits &= bits - 1) {
+            indices[idx++] = base + bits_ctz(bits);
+        }
     }
     
     /* Select rows without missing values */
@@ -206,8 +366,6 @@ TablrDataFrame* tablr_dataframe_dropna(const TablrDataFrame* df) {
     
     free(keep);
     free(indices);
-    for (size_t i = 0; i < name_count; i++) free(names[i]);
-    free(names);
     
     return result;
 }
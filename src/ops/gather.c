@@ -0,0 +1,279 @@
+/**
+ * @file gather.c
+ * @brief Implementation of the internal row gather
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * This file implements gathering series elements by row index, which row
+ * selection, sorting, grouping and joins all reduce to. Chunked series are
+ * read chunk by chunk through a cursor rather than flattened.
+ */
+
+#include "gather.h"
+#include "tablr/core/encoding.h"
+#include "tablr/core/chunked.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief The chunks of a source series and the last one read
+ * 
+ * A plain series is a single chunk. Indices from sorts and filters tend to
+ * stay in one chunk for a while, so the last chunk is tried before a
+ * binary search.
+ */
+typedef struct {
+    TablrSeries** parts;    /**< Chunk views, or NULL for a plain series */
+    const TablrSeries* one; /**< The series itself when it is plain */
+    size_t* ends;           /**< Row one past the last element of each chunk */
+    size_t one_end;         /**< Size of a plain series */
+    size_t count;           /**< Number of chunks */
+    size_t current;         /**< Chunk of the last row found */
+} Cursor;
+
+/**
+ * @brief Open a cursor over the chunks of a series
+ * @return true on success, false on failure
+ */
+static bool cursor_open(Cursor* c, const TablrSeries* s) {
+    memset(c, 0, sizeof(*c));
+    c->count = tablr_series_num_chunks(s);
+    if (c->count <= 1) {
+        c->one = s;
+        c->one_end = tablr_series_size(s);
+        c->ends = &c->one_end;
+        c->count = 1;
+        return true;
+    }
+    
+    c->parts = (TablrSeries**)calloc(c->count, sizeof(TablrSeries*));
+    c->ends = (size_t*)malloc(c->count * sizeof(size_t));
+    if (!c->parts || !c->ends) return false;
+    size_t end = 0;
+    for (size_t k = 0; k < c->count; k++) {
+        c->parts[k] = tablr_series_chunk(s, k);
+        if (!c->parts[k]) return false;
+        end += tablr_series_size(c->parts[k]);
+        c->ends[k] = end;
+    }
+    return true;
+}
+
+/**
+ * @brief Free the chunk views of a cursor
+ */
+static void cursor_close(Cursor* c) {
+    if (c->ends == &c->one_end) return;
+    for (size_t k = 0; c->parts && k < c->count; k++) tablr_series_free(c->parts[k]);
+    free(c->parts);
+    free(c->ends);
+}
+
+/**
+ * @brief Get a chunk of a cursor
+ */
+static const TablrSeries* cursor_part(const Cursor* c, size_t k) {
+    return c->parts ? c->parts[k] : c->one;
+}
+
+/**
+ * @brief Find the chunk holding a row
+ * 
+ * @param row Row of the series; set to the row within the chunk
+ * @return Chunk index
+ */
+static size_t cursor_find(Cursor* c, size_t* row) {
+    size_t k = c->current;
+    size_t begin = k ? c->ends[k - 1] : 0;
+    if (*row < begin || *row >= c->ends[k]) {
+        size_t lo = 0, hi = c->count - 1;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (c->ends[mid] > *row) hi = mid;
+            else lo = mid + 1;
+        }
+        k = c->current = lo;
+        begin = k ? c->ends[k - 1] : 0;
+    }
+    *row -= begin;
+    return k;
+}
+
+/**
+ * @brief Gather string elements into a new series
+ * 
+ * Sizes the character buffer exactly in a first pass, then copies each
+ * selected element with a single memcpy.
+ * 
+ * @return New series, or NULL on failure
+ */
+static TablrSeries* gather_strings(const TablrSeries* s, Cursor* c, const size_t* indices, size_t count) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (indices[i] == TABLR_GATHER_NULL) continue;
+        size_t row = indices[i];
+        const int64_t* offsets = tablr_series_string_offsets(cursor_part(c, cursor_find(c, &row)));
+        if (!offsets) return NULL;
+        total += (size_t)(offsets[row + 1] - offsets[row]);
+    }
+    
+    TablrSeries* out = tablr_series_string_alloc(count, total, tablr_series_device(s));
+    int64_t* out_offsets;
+    char* out_chars;
+    if (!out || !tablr_series_string_buffers(out, &out_offsets, &out_chars)) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    
+    int64_t pos = 0;
+    size_t last = SIZE_MAX;
+    const int64_t* offsets = NULL;
+    const char* chars = NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (indices[i] != TABLR_GATHER_NULL) {
+            size_t row = indices[i];
+            size_t k = cursor_find(c, &row);
+            if (k != last) {
+                offsets = tablr_series_string_offsets(cursor_part(c, k));
+                chars = tablr_series_string_chars(cursor_part(c, k));
+                if (!chars) {
+                    tablr_series_free(out);
+                    return NULL;
+                }
+                last = k;
+            }
+            int64_t begin = offsets[row];
+            int64_t len = offsets[row + 1] - begin;
+            memcpy(out_chars + pos, chars + begin, (size_t)len);
+            pos += len;
+        }
+        out_offsets[i + 1] = pos;
+    }
+    return out;
+}
+
+/**
+ * @brief Gather bitmask elements into a new series
+ * 
+ * Builds each output word in a register and stores it once. Missing rows
+ * are false.
+ * 
+ * @return New series, or NULL on failure
+ */
+static TablrSeries* gather_bits(const TablrSeries* s, Cursor* c, const size_t* indices, size_t count) {
+    TablrSeries* out = tablr_series_alloc(count, TABLR_BITMASK, tablr_series_device(s));
+    uint64_t* out_bits = (uint64_t*)tablr_series_data(out);
+    if (!out_bits) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    
+    size_t last = SIZE_MAX;
+    const uint64_t* bits = NULL;
+    for (size_t base = 0; base < count; base += 64) {
+        size_t n = count - base < 64 ? count - base : 64;
+        uint64_t word = 0;
+        for (size_t j = 0; j < n; j++) {
+            size_t row = indices[base + j];
+            if (row == TABLR_GATHER_NULL) continue;
+            size_t k = cursor_find(c, &row);
+            if (k != last) {
+                bits = (const uint64_t*)tablr_series_data_const(cursor_part(c, k));
+                if (!bits) {
+                    tablr_series_free(out);
+                    return NULL;
+                }
+                last = k;
+            }
+            word |= ((bits[row / 64] >> (row % 64)) & 1) << j;
+        }
+        out_bits[base / 64] = word;
+    }
+    return out;
+}
+
+/**
+ * @brief Gather fixed-width elements into a new series
+ * 
+ * Missing rows are zeroed; categorical codes of missing rows are -1.
+ * 
+ * @return New series, or NULL on failure
+ */
+static TablrSeries* gather_values(const TablrSeries* s, Cursor* c, const size_t* indices, size_t count) {
+    TablrDType dtype = tablr_series_dtype(s);
+    TablrDevice device = tablr_series_device(s);
+    size_t elem_size = tablr_dtype_size(dtype);
+    
+    TablrSeries* out = dtype == TABLR_CATEGORICAL
+        ? tablr_series_categorical_alloc(count, tablr_series_categories(s), device)
+        : tablr_series_alloc(count, dtype, device);
+    char* out_data = (char*)tablr_series_data(out);
+    if (!out_data) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    if (dtype == TABLR_TIMESTAMP64) tablr_series_set_time_unit(out, tablr_series_time_unit(s));
+    
+    size_t last = SIZE_MAX;
+    const char* data = NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (indices[i] != TABLR_GATHER_NULL) {
+            size_t row = indices[i];
+            size_t k = cursor_find(c, &row);
+            if (k != last) {
+                data = (const char*)tablr_series_data_const(cursor_part(c, k));
+                if (!data) {
+                    tablr_series_free(out);
+                    return NULL;
+                }
+                last = k;
+            }
+            memcpy(out_data + i * elem_size, data + row * elem_size, elem_size);
+        } else {
+            memset(out_data + i * elem_size, dtype == TABLR_CATEGORICAL ? 0xFF : 0, elem_size);
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Gather elements of a series into a new series
+ * 
+ * @param s Source series
+ * @param indices Row indices, or TABLR_GATHER_NULL for a null row
+ * @param count Number of indices
+ * @return New series, or NULL on failure
+ */
+TablrSeries* tablr_gather_series(const TablrSeries* s, const size_t* indices, size_t count) {
+    if (!s || !indices || count == 0) return NULL;
+    
+    /* Any selection of a constant series without nulls is the same constant */
+    bool nulls = tablr_series_null_count(s) > 0;
+    if (!nulls && tablr_series_is_constant(s)) {
+        bool missing = false;
+        for (size_t i = 0; i < count && !missing; i++) missing = indices[i] == TABLR_GATHER_NULL;
+        if (!missing) return tablr_series_broadcast(s, count);
+    }
+    
+    Cursor c;
+    TablrSeries* out = NULL;
+    if (cursor_open(&c, s)) {
+        switch (tablr_series_dtype(s)) {
+            case TABLR_STRING: out = gather_strings(s, &c, indices, count); break;
+            case TABLR_BITMASK: out = gather_bits(s, &c, indices, count); break;
+            default: out = gather_values(s, &c, indices, count); break;
+        }
+    }
+    cursor_close(&c);
+    if (!out) return NULL;
+    
+    for (size_t i = 0; i < count; i++) {
+        bool missing = indices[i] == TABLR_GATHER_NULL;
+        if ((missing || (nulls && !tablr_series_is_valid(s, indices[i]))) &&
+            !tablr_series_set_valid(out, i, false)) {
+            tablr_series_free(out);
+            return NULL;
+        }
+    }
+    return out;
+}
@@ -0,0 +1,33 @@
+/**
+ * @file gather.h
+ * @brief Internal row gather shared by the dataframe operations
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Not part of the public API. Used by the operations in src/ops.
+ */
+
+#ifndef TABLR_OPS_GATHER_H
+#define TABLR_OPS_GATHER_H
+
+#include "tablr/core/series.h"
+#include <stdint.h>
+
+#define TABLR_GATHER_NULL SIZE_MAX  /**< Index that gathers a null element */
+
+/**
+ * @brief Gather elements of a series into a new series
+ *
+ * Element i of the result is element indices[i] of s, or null if
+ * indices[i] is TABLR_GATHER_NULL. Null elements stay null, and a
+ * categorical result shares the dictionary of s. A constant s without
+ * nulls gives a lazy constant result.
+ *
+ * @param s Source series
+ * @param indices Row indices
+ * @param count Number of indices
+ * @return New series, or NULL on failure or if count is 0
+ */
+TablrSeries* tablr_gather_series(const TablrSeries* s, const size_t* indices, size_t count);
+
+#endif /* TABLR_OPS_GATHER_H */
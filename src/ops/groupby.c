@@ -9,15 +9,25 @@
  */
 
 #include "tablr/ops/groupby.h"
+#include "tablr/ops/filter.h"
+#include "tablr/core/encoding.h"
+#include "tablr/core/stats.h"
+#include "tablr/core/chunked.h"
+#include "bits.h"
+#include "keys.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <stdint.h>
 
 /**
  * @brief Group dataframe by column
  * 
- * Groups rows by unique values in the specified column.
- * Currently returns a copy; full grouping implementation pending.
+ * Reorders the rows so that rows with equal keys are contiguous. Groups
+ * appear in order of first appearance, rows keep their order within a
+ * group, and rows with a null key come last. Keys are reduced to dense ids,
+ * straight from the codes of a categorical column or by hashing other
+ * columns, and the rows are placed by a counting sort on those ids.
  * 
  * @param df Source dataframe
  * @param column Column name to group by
@@ -25,13 +35,216 @@
  */
 TablrDataFrame* tablr_dataframe_groupby(const TablrDataFrame* df, const char* column) {
     if (!df || !column) return NULL;
-    return tablr_dataframe_copy(df);
+    
+    TablrSeries* key = tablr_dataframe_get_column(df, column);
+    if (!key) return NULL;
+    
+    size_t nrows = tablr_series_size(key);
+    size_t nkeys = 0;
+    int32_t* ids = tablr_keys_encode(key, &nkeys);
+    size_t* starts = ids ? (size_t*)calloc(nkeys + 1, sizeof(size_t)) : NULL;
+    size_t* indices = (size_t*)malloc((nrows ? nrows : 1) * sizeof(size_t));
+    if (!ids || !starts || !indices) {
+        free(ids);
+        free(starts);
+        free(indices);
+        return NULL;
+    }
+    
+    /* Null keys (id -1) count towards the last slot */
+    for (size_t i = 0; i < nrows; i++) {
+        starts[ids[i] < 0 ? nkeys : (size_t)ids[i]]++;
+    }
+    size_t pos = 0;
+    for (size_t k = 0; k <= nkeys; k++) {
+        size_t count = starts[k];
+        starts[k] = pos;
+        pos += count;
+    }
+    for (size_t i = 0; i < nrows; i++) {
+        indices[starts[ids[i] < 0 ? nkeys : (size_t)ids[i]]++] = i;
+    }
+    
+    TablrDataFrame* result = tablr_dataframe_select_rows(df, indices, nrows);
+    
+    free(ids);
+    free(starts);
+    free(indices);
+    return result;
+}
+
+/**
+ * @brief Running statistics of the valid values of a column
+ */
+typedef struct {
+    size_t count;  /**< Number of valid values */
+    double sum;    /**< Sum of values */
+    double sq;     /**< Sum of squared deviations from the center */
+    double min;    /**< Smallest value */
+    double max;    /**< Largest value */
+} ColumnStats;
+
+static inline void stats_add(ColumnStats* st, double val, double center) {
+    st->sum += val;
+    st->sq += (val - center) * (val - center);
+    if (val < st->min) st->min = val;
+    if (val > st->max) st->max = val;
+}
+
+/**
+ * @brief Define a statistics kernel for one element type
+ * 
+ * Walks the validity bitmap 64 rows at a time: the count comes from a
+ * popcount, blocks without nulls are summed without testing bits, and
+ * other blocks visit only their set bits. Each kernel reads its elements
+ * directly, so the type is resolved once per column rather than per row.
+ * values holds rows first to first + count - 1, where first is a multiple
+ * of 64 and the range is either a multiple of 64 long or ends the series.
+ */
+#define STATS_KERNEL(name, ctype)                                                           \
+    static void name(const TablrSeries* s, const void* values, size_t first, size_t count,  \
+                     double center, ColumnStats* st) {                                      \
+        const ctype* data = (const ctype*)values;                                           \
+        size_t nwords = bits_words(count);                                                  \
+        for (size_t w = 0; w < nwords; w++) {                                               \
+            uint64_t bits = tablr_series_validity_word(s, first / 64 + w);                  \
+            size_t base = w * 64;                                                           \
+            st->count += bits_popcount(bits);                                               \
+            if (bits == BITS_ALL_VALID) {                                                   \
+                for (size_t j = 0; j < 64; j++) stats_add(st, (double)data[base + j], center); \
+                continue;                                                                   \
+            }                                                                               \
+            for (; bits; bits &= bits - 1) {                                                \
+                stats_add(st, (double)data[base + bits_ctz(bits)], center);                 \
+            }                                                                               \
+        }                                                                                   \
+    }
+
+STATS_KERNEL(stats_int8, int8_t)
+STATS_KERNEL(stats_int16, int16_t)
+STATS_KERNEL(stats_int32, int32_t)
+STATS_KERNEL(stats_int64, int64_t)
+STATS_KERNEL(stats_uint8, uint8_t)
+STATS_KERNEL(stats_uint16, uint16_t)
+STATS_KERNEL(stats_uint32, uint32_t)
+STATS_KERNEL(stats_uint64, uint64_t)
+STATS_KERNEL(stats_float32, float)
+STATS_KERNEL(stats_float64, double)
+STATS_KERNEL(stats_bool, bool)
+
+/**
+ * @brief Statistics kernel for bitmask columns
+ * 
+ * Every value is 0 or 1, so two popcounts per 64-row block give the count
+ * of valid rows and of ones, and the sums follow from those counts. A
+ * column whose words cannot be decoded or flattened contributes no rows.
+ */
+static void stats_bitmask(const TablrSeries* s, double center, ColumnStats* st) {
+    const uint64_t* data = (const uint64_t*)tablr_series_data_const(s);
+    size_t nwords = data ? bits_words(tablr_series_size(s)) : 0;
+    size_t valid = 0;
+    size_t ones = 0;
+    for (size_t w = 0; w < nwords; w++) {
+        uint64_t bits = tablr_series_validity_word(s, w);
+        valid += bits_popcount(bits);
+        ones += bits_popcount(bits & data[w]);
+    }
+    
+    size_t zeros = valid - ones;
+    st->count += valid;
+    st->sum += (double)ones;
+    st->sq += (double)ones * (1.0 - center) * (1.0 - center) + (double)zeros * center * center;
+    if (zeros) st->min = 0.0;
+    else if (ones) st->min = 1.0;
+    if (ones) st->max = 1.0;
+    else if (zeros) st->max = 0.0;
+}
+
+#define STATS_BLOCK_ROWS 1024  /**< Rows of a compressed column decoded per step */
+
+/**
+ * @brief Accumulate statistics over rows first to first + count - 1 of a series
+ */
+static void values_stats(const TablrSeries* s, const void* values, size_t first, size_t count,
+                         double center, ColumnStats* st) {
+    switch (tablr_series_dtype(s)) {
+        case TABLR_INT8: stats_int8(s, values, first, count, center, st); break;
+        case TABLR_INT16: stats_int16(s, values, first, count, center, st); break;
+        case TABLR_INT32:
+        case TABLR_DATE32: stats_int32(s, values, first, count, center, st); break;
+        case TABLR_INT64:
+        case TABLR_TIMESTAMP64: stats_int64(s, values, first, count, center, st); break;
+        case TABLR_UINT8: stats_uint8(s, values, first, count, center, st); break;
+        case TABLR_UINT16: stats_uint16(s, values, first, count, center, st); break;
+        case TABLR_UINT32: stats_uint32(s, values, first, count, center, st); break;
+        case TABLR_UINT64: stats_uint64(s, values, first, count, center, st); break;
+        case TABLR_FLOAT32: stats_float32(s, values, first, count, center, st); break;
+        case TABLR_FLOAT64: stats_float64(s, values, first, count, center, st); break;
+        case TABLR_BOOL: stats_bool(s, values, first, count, center, st); break;
+        default: break;
+    }
+}
+
+/**
+ * @brief Accumulate statistics over the valid elements of a series
+ * 
+ * Strings and categoricals have no numeric value and contribute zeros.
+ * Compressed columns are decoded a block at a time into a buffer that
+ * stays in cache, rather than all at once.
+ * 
+ * @param s Series to scan
+ * @param center Value squared deviations are measured from
+ * @return Statistics of the valid elements
+ */
+static ColumnStats column_stats(const TablrSeries* s, double center) {
+    ColumnStats st = { 0, 0.0, 0.0, INFINITY, -INFINITY };
+    TablrDType dtype = tablr_series_dtype(s);
+    size_t size = tablr_series_size(s);
+    if (dtype == TABLR_BITMASK) {
+        stats_bitmask(s, center, &st);
+    } else if (dtype == TABLR_STRING || dtype == TABLR_CATEGORICAL) {
+        for (size_t i = 0; i < size; i++) {
+            if (!tablr_series_is_valid(s, i)) continue;
+            st.count++;
+            stats_add(&st, 0.0, center);
+        }
+    } else {
+        const void* values = NULL;
+        if (tablr_series_encoding(s) == TABLR_ENCODING_PLAIN && tablr_series_num_chunks(s) == 1) {
+            values = tablr_series_data_const(s);
+        }
+        if (values) {
+            values_stats(s, values, 0, size, center, &st);
+            return st;
+        }
+        uint64_t block[STATS_BLOCK_ROWS];
+        for (size_t first = 0; first < size; first += STATS_BLOCK_ROWS) {
+            size_t count = size - first < STATS_BLOCK_ROWS ? size - first : STATS_BLOCK_ROWS;
+            tablr_series_read(s, first, count, block);
+            values_stats(s, block, first, count, center, &st);
+        }
+    }
+    return st;
+}
+
+/**
+ * @brief Count and sum of a compressed column
+ * 
+ * The sum is computed on the encoded form, a run or a block at a time.
+ */
+static ColumnStats encoded_stats(const TablrSeries* s) {
+    ColumnStats st = { 0, 0.0, 0.0, INFINITY, -INFINITY };
+    st.count = tablr_series_size(s) - tablr_series_null_count(s);
+    tablr_series_sum(s, &st.sum);
+    return st;
 }
 
 /**
  * @brief Aggregate column using function
  * 
- * Applies an aggregation function (sum, mean, etc.) to a column.
+ * Applies an aggregation function (sum, mean, etc.) to a column. Null
+ * elements are skipped; STD and VAR are population statistics. COUNT, MIN
+ * and MAX read the column's statistics, which are computed once and cached.
  * 
  * @param df Source dataframe
  * @param agg_column Column to aggregate
@@ -44,19 +257,32 @@ TablrDataFrame* tablr_dataframe_aggregate(const TablrDataFrame* df, const char*
     TablrSeries* s = tablr_dataframe_get_column(df, agg_column);
     if (!s) return NULL;
     
-    void* data = tablr_series_data(s);
-    size_t size = tablr_series_size(s);
+    /* Counts, and the bounds of numeric columns, come from the cached statistics */
     TablrDType dtype = tablr_series_dtype(s);
-    
+    bool numeric = dtype != TABLR_STRING && dtype != TABLR_CATEGORICAL;
+    bool bounds = func == TABLR_AGG_MIN || func == TABLR_AGG_MAX;
+    TablrSeriesStats stats;
     double result_val = 0.0;
-    
-    if (func == TABLR_AGG_SUM || func == TABLR_AGG_MEAN) {
-        for (size_t i = 0; i < size; i++) {
-            if (dtype == TABLR_INT32) result_val += ((int*)data)[i];
-            else if (dtype == TABLR_FLOAT32) result_val += ((float*)data)[i];
-            else if (dtype == TABLR_FLOAT64) result_val += ((double*)data)[i];
+    if ((func == TABLR_AGG_COUNT || (numeric && bounds)) && tablr_series_stats(s, &stats)) {
+        if (func == TABLR_AGG_MIN) result_val = stats.min;
+        else if (func == TABLR_AGG_MAX) result_val = stats.max;
+        else result_val = (double)(tablr_series_size(s) - stats.null_count);
+    } else {
+        bool spread = func == TABLR_AGG_STD || func == TABLR_AGG_VAR;
+        ColumnStats st = !spread && tablr_series_encoding(s) != TABLR_ENCODING_PLAIN ? encoded_stats(s)
+                                                                                    : column_stats(s, 0.0);
+        double mean = st.sum / (double)st.count;
+        if (spread) st = column_stats(s, mean);
+        
+        switch (func) {
+            case TABLR_AGG_SUM: result_val = st.sum; break;
+            case TABLR_AGG_MEAN: result_val = mean; break;
+            case TABLR_AGG_MIN: result_val = st.min; break;
+            case TABLR_AGG_MAX: result_val = st.max; break;
+            case TABLR_AGG_COUNT: result_val = (double)st.count; break;
+            case TABLR_AGG_VAR: result_val = st.sq / (double)st.count; break;
+            case TABLR_AGG_STD: result_val = sqrt(st.sq / (double)st.count); break;
         }
-        if (func == TABLR_AGG_MEAN) result_val /= size;
     }
     
     TablrDataFrame* result = tablr_dataframe_create();
@@ -69,7 +295,8 @@ TablrDataFrame* tablr_dataframe_aggregate(const TablrDataFrame* df, const char*
 /**
  * @brief Get descriptive statistics
  * 
- * Computes count, mean, std, min, and max for all numeric columns.
+ * Computes count, mean, std, min, and max for all numeric columns, over
+ * the valid (non-null) elements.
  * 
  * @param df Source dataframe
  * @return New dataframe with statistics, or NULL on failure
@@ -84,44 +311,16 @@ TablrDataFrame* tablr_dataframe_describe(const TablrDataFrame* df) {
     double* stat_data = (double*)calloc(5, sizeof(double));
     
     for (size_t col = 0; col < ncols; col++) {
-        size_t name_count;
-        char** names = tablr_dataframe_columns(df, &name_count);
-        TablrSeries* s = tablr_dataframe_get_column(df, names[col]);
+        TablrSeries* s = tablr_dataframe_column_at(df, col);
         
-        void* data = tablr_series_data(s);
-        size_t size = tablr_series_size(s);
-        TablrDType dtype = tablr_series_dtype(s);
-        
-        stat_data[0] = (double)size;
-        
-        double sum = 0.0, min_val = INFINITY, max_val = -INFINITY;
-        for (size_t i = 0; i < size; i++) {
-            double val = 0.0;
-            if (dtype == TABLR_INT32) val = ((int*)data)[i];
-            else if (dtype == TABLR_FLOAT32) val = ((float*)data)[i];
-            else if (dtype == TABLR_FLOAT64) val = ((double*)data)[i];
-            
-            sum += val;
-            if (val < min_val) min_val = val;
-            if (val > max_val) max_val = val;
-        }
-        
-        stat_data[1] = sum / size;
-        stat_data[3] = min_val;
-        stat_data[4] = max_val;
-        
-        double var = 0.0;
-        for (size_t i = 0; i < size; i++) {
-            double val = 0.0;
-            if (dtype == TABLR_INT32) val = ((int*)data)[i];
-            else if (dtype == TABLR_FLOAT32) val = ((float*)data)[i];
-            else if (dtype == TABLR_FLOAT64) val = ((double*)data)[i];
-            var += (val - stat_data[1]) * (val - stat_data[1]);
-        }
-        stat_data[2] = sqrt(var / size);
+        ColumnStats st = column_stats(s, 0.0);
+        double mean = st.sum / (double)st.count;
         
-        for (size_t i = 0; i < name_count; i++) free(names[i]);
-        free(names);
+        stat_data[0] = (double)st.count;
+        stat_data[1] = mean;
+        stat_data[3] = st.min;
+        stat_data[4] = st.max;
+        stat_data[2] = sqrt(column_stats(s, mean).sq / (double)st.count);
     }
     
     for (size_t i = 0; i < 5; i++) {
@@ -0,0 +1,404 @@
+/**
+ * @file kernels.c
+ * @brief Implementation of the SIMD element-wise kernels
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Kernels are written once with GCC/Clang vector extensions and expanded
+ * for each instruction set: 16-byte vectors for SSE4.2 and NEON, 32 for
+ * AVX2 and 64 for AVX-512. Vector code is generated for the target named
+ * on each function, so one binary carries every set and picks the best at
+ * runtime. Each kernel handles whole vectors first and the remaining
+ * elements one at a time. The scalar set, also used by compilers without
+ * vector extensions, is the element-at-a-time loop alone.
+ *
+ * Compares write one byte per element, so that callers can pack them into
+ * bitmasks a word at a time.
+ */
+
+#include "kernels.h"
+#include <stddef.h>
+
+#ifndef _WIN32
+#include <stdatomic.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define HAVE_VECTORS
+#if defined(__x86_64__) || defined(__i386__)
+#define HAVE_X86_VECTORS
+#define TARGET_SSE42 __attribute__((target("sse4.2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl")))
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#define HAVE_NEON_VECTORS
+#endif
+#endif
+
+#define TARGET_NONE
+
+/* ===================== Vector types ===================== */
+
+/*
+ * name##x##lanes holds lanes elements of one type. Vectors are loaded and
+ * stored through unaligned, aliasing pointers, so any element array can be
+ * read in place. One-lane "vectors" are the plain type, for the scalar set.
+ */
+#define VEC(name, lanes) VEC_(name, lanes)
+#define VEC_(name, lanes) name##x##lanes
+
+#define DEFINE_SCALAR(name, T) typedef T name##x1;
+
+DEFINE_SCALAR(i8, int8_t)
+DEFINE_SCALAR(i16, int16_t)
+DEFINE_SCALAR(i32, int32_t)
+DEFINE_SCALAR(i64, int64_t)
+DEFINE_SCALAR(u8, uint8_t)
+DEFINE_SCALAR(u16, uint16_t)
+DEFINE_SCALAR(u32, uint32_t)
+DEFINE_SCALAR(u64, uint64_t)
+DEFINE_SCALAR(f32, float)
+DEFINE_SCALAR(f64, double)
+
+#ifdef HAVE_VECTORS
+#define DEFINE_VECTOR(name, T, lanes) \
+    typedef T name##x##lanes __attribute__((vector_size(sizeof(T) * (lanes)), aligned(1), may_alias));
+#define DEFINE_VECTORS_8(name, T) \
+    DEFINE_VECTOR(name, T, 2) DEFINE_VECTOR(name, T, 4) DEFINE_VECTOR(name, T, 8)
+#define DEFINE_VECTORS_4(name, T) DEFINE_VECTORS_8(name, T) DEFINE_VECTOR(name, T, 16)
+#define DEFINE_VECTORS_2(name, T) DEFINE_VECTORS_4(name, T) DEFINE_VECTOR(name, T, 32)
+#define DEFINE_VECTORS_1(name, T) DEFINE_VECTORS_2(name, T) DEFINE_VECTOR(name, T, 64)
+
+/* Up to 64 bytes per vector, and at least 2 lanes of the widest type */
+DEFINE_VECTORS_1(i8, int8_t)
+DEFINE_VECTORS_2(i16, int16_t)
+DEFINE_VECTORS_4(i32, int32_t)
+DEFINE_VECTORS_8(i64, int64_t)
+DEFINE_VECTORS_1(u8, uint8_t)
+DEFINE_VECTORS_2(u16, uint16_t)
+DEFINE_VECTORS_4(u32, uint32_t)
+DEFINE_VECTORS_8(u64, uint64_t)
+DEFINE_VECTORS_4(f32, float)
+DEFINE_VECTORS_8(f64, double)
+#endif
+
+/* ===================== Operators ===================== */
+
+/*
+ * Each operator has a vector form (_v) and a scalar form (_s). Vector
+ * comparisons give lanes of all ones or zeros, so min and max select with
+ * masks over the integer type of the same width (bits).
+ */
+#define ADD_v(x, y, bits) ((x) + (y))
+#define ADD_s(x, y, bits) ((x) + (y))
+#define SUB_v(x, y, bits) ((x) - (y))
+#define SUB_s(x, y, bits) ((x) - (y))
+#define MUL_v(x, y, bits) ((x) * (y))
+#define MUL_s(x, y, bits) (1u * (x) * (y)) /* keeps uint16 products unsigned */
+#define DIV_v(x, y, bits) ((x) / (y))
+#define DIV_s(x, y, bits) ((x) / (y))
+
+#define SELECT_v(mask, x, y, bits) \
+    ((__typeof__(x))(((bits)(x) & (bits)(mask)) | ((bits)(y) & ~(bits)(mask))))
+#define MIN_v(x, y, bits) SELECT_v((x) < (y), x, y, bits)
+#define MIN_s(x, y, bits) ((x) < (y) ? (x) : (y))
+#define MAX_v(x, y, bits) SELECT_v((x) > (y), x, y, bits)
+#define MAX_s(x, y, bits) ((x) > (y) ? (x) : (y))
+/* NaN in x is kept; NaN in y fails the comparison and is selected */
+#define FMIN_v(x, y, bits) SELECT_v(((x) < (y)) | ((x) != (x)), x, y, bits)
+#define FMIN_s(x, y, bits) ((x) < (y) || (x) != (x) ? (x) : (y))
+#define FMAX_v(x, y, bits) SELECT_v(((x) > (y)) | ((x) != (x)), x, y, bits)
+#define FMAX_s(x, y, bits) ((x) > (y) || (x) != (x) ? (x) : (y))
+
+#define EQ(x, y) ((x) == (y))
+#define NE(x, y) ((x) != (y))
+#define LT(x, y) ((x) < (y))
+#define LE(x, y) ((x) <= (y))
+#define GT(x, y) ((x) > (y))
+#define GE(x, y) ((x) >= (y))
+
+/* Store the 0/1 bytes of a comparison */
+#define STORE_MASK_v(p, lanes, mask) (*(VEC(i8, lanes)*)(p) = __builtin_convertvector((mask), VEC(i8, lanes)) & 1)
+#define STORE_MASK_s(p, lanes, mask) (*(p) = (uint8_t)(mask))
+
+#define CONVERT_v(in, out, from, to, lanes) \
+    (*(VEC(to, lanes)*)(out) = __builtin_convertvector(*(const VEC(from, lanes)*)(in), VEC(to, lanes)))
+#define CONVERT_s(in, out, from, to, lanes) (*(out) = *(in))
+
+/* ===================== Kernel templates ===================== */
+
+#define BINARY_KERNEL(isa, target, mode, op, OP, name, T, lanes, bits) \
+    target static void op##_##name##_##isa(const void* pa, const void* pb, void* pout, size_t n) { \
+        const T* a = (const T*)pa; \
+        const T* b = (const T*)pb; \
+        T* out = (T*)pout; \
+        size_t i = 0; \
+        for (; i + (lanes) <= n; i += (lanes)) { \
+            VEC(name, lanes) x = *(const VEC(name, lanes)*)(a + i); \
+            VEC(name, lanes) y = *(const VEC(name, lanes)*)(b + i); \
+            *(VEC(name, lanes)*)(out + i) = OP##_##mode(x, y, bits); \
+        } \
+        for (; i < n; i++) { \
+            T x = a[i], y = b[i]; \
+            out[i] = (T)(OP##_s(x, y, T)); \
+        } \
+    }
+
+#define COMPARE_KERNEL(isa, target, mode, op, OP, name, T, lanes) \
+    target static void op##_##name##_##isa(const void* pa, const void* pb, uint8_t* out, size_t n) { \
+        const T* a = (const T*)pa; \
+        const T* b = (const T*)pb; \
+        size_t i = 0; \
+        for (; i + (lanes) <= n; i += (lanes)) { \
+            VEC(name, lanes) x = *(const VEC(name, lanes)*)(a + i); \
+            VEC(name, lanes) y = *(const VEC(name, lanes)*)(b + i); \
+            STORE_MASK_##mode(out + i, lanes, OP(x, y)); \
+        } \
+        for (; i < n; i++) out[i] = (uint8_t)OP(a[i], b[i]); \
+    }
+
+#define CAST_KERNEL(isa, target, mode, from, FT, to, TT, lanes) \
+    target static void cast_##from##_##to##_##isa(const void* pin, void* pout, size_t n) { \
+        const FT* in = (const FT*)pin; \
+        TT* out = (TT*)pout; \
+        size_t i = 0; \
+        for (; i + (lanes) <= n; i += (lanes)) CONVERT_##mode(in + i, out + i, from, to, lanes); \
+        for (; i < n; i++) out[i] = (TT)in[i]; \
+    }
+
+/* Operators that wrap share one kernel per width: signed types use the unsigned one */
+#define WRAPPING_KERNELS(isa, target, mode, name, T, lanes) \
+    BINARY_KERNEL(isa, target, mode, add, ADD, name, T, lanes, T) \
+    BINARY_KERNEL(isa, target, mode, sub, SUB, name, T, lanes, T) \
+    BINARY_KERNEL(isa, target, mode, mul, MUL, name, T, lanes, T)
+
+#define FLOAT_KERNELS(isa, target, mode, name, T, lanes, bits) \
+    BINARY_KERNEL(isa, target, mode, add, ADD, name, T, lanes, bits) \
+    BINARY_KERNEL(isa, target, mode, sub, SUB, name, T, lanes, bits) \
+    BINARY_KERNEL(isa, target, mode, mul, MUL, name, T, lanes, bits) \
+    BINARY_KERNEL(isa, target, mode, div, DIV, name, T, lanes, bits) \
+    BINARY_KERNEL(isa, target, mode, min, FMIN, name, T, lanes, bits) \
+    BINARY_KERNEL(isa, target, mode, max, FMAX, name, T, lanes, bits)
+
+#define COMPARE_KERNELS(isa, target, mode, name, T, lanes) \
+    COMPARE_KERNEL(isa, target, mode, eq, EQ, name, T, lanes) \
+    COMPARE_KERNEL(isa, target, mode, ne, NE, name, T, lanes) \
+    COMPARE_KERNEL(isa, target, mode, lt, LT, name, T, lanes) \
+    COMPARE_KERNEL(isa, target, mode, le, LE, name, T, lanes) \
+    COMPARE_KERNEL(isa, target, mode, gt, GT, name, T, lanes) \
+    COMPARE_KERNEL(isa, target, mode, ge, GE, name, T, lanes)
+
+#define INTEGER_KERNELS(isa, target, mode, name, T, lanes, bits) \
+    BINARY_KERNEL(isa, target, mode, min, MIN, name, T, lanes, bits) \
+    BINARY_KERNEL(isa, target, mode, max, MAX, name, T, lanes, bits) \
+    COMPARE_KERNELS(isa, target, mode, name, T, lanes)
+
+/*
+ * A cast works on as many lanes as fit the wider of its two types. Widths
+ * are 1, 2, 4 or 8 bytes; l1 to l8 are the lanes per vector at each width.
+ */
+#define WIDER(a, b) WIDER_##a##_##b
+#define WIDER_1_1 1
+#define WIDER_1_2 2
+#define WIDER_1_4 4
+#define WIDER_1_8 8
+#define WIDER_2_1 2
+#define WIDER_2_2 2
+#define WIDER_2_4 4
+#define WIDER_2_8 8
+#define WIDER_4_1 4
+#define WIDER_4_2 4
+#define WIDER_4_4 4
+#define WIDER_4_8 8
+#define WIDER_8_1 8
+#define WIDER_8_2 8
+#define WIDER_8_4 8
+#define WIDER_8_8 8
+#define LANES(width, l1, l2, l4, l8) LANES_(width, l1, l2, l4, l8)
+#define LANES_(width, l1, l2, l4, l8) PICK_##width(l1, l2, l4, l8)
+#define PICK_1(l1, l2, l4, l8) l1
+#define PICK_2(l1, l2, l4, l8) l2
+#define PICK_4(l1, l2, l4, l8) l4
+#define PICK_8(l1, l2, l4, l8) l8
+
+#define CAST_TO(isa, target, mode, from, FT, fw, to, TT, tw, l1, l2, l4, l8) \
+    CAST_KERNEL(isa, target, mode, from, FT, to, TT, LANES(WIDER(fw, tw), l1, l2, l4, l8))
+
+#define CAST_FROM(isa, target, mode, from, FT, fw, l1, l2, l4, l8) \
+    CAST_TO(isa, target, mode, from, FT, fw, i8, int8_t, 1, l1, l2, l4, l8) \
+    CAST_TO(isa, target, mode, from, FT, fw, i16, int16_t, 2, l1, l2, l4, l8) \
+    CAST_TO(isa, target, mode, from, FT, fw, i32, int32_t, 4, l1, l2, l4, l8) \
+    CAST_TO(isa, target, mode, from, FT, fw, i64, int64_t, 8, l1, l2, l4, l8) \
+    CAST_TO(isa, target, mode, from, FT, fw, u8, uint8_t, 1, l1, l2, l4, l8) \
+    CAST_TO(isa, target, mode, from, FT, fw, u16, uint16_t, 2, l1, l2, l4, l8) \
+    CAST_TO(isa, target, mode, from, FT, fw, u32, uint32_t, 4, l1, l2, l4, l8) \
+    CAST_TO(isa, target, mode, from, FT, fw, u64, uint64_t, 8, l1, l2, l4, l8) \
+    CAST_TO(isa, target, mode, from, FT, fw, f32, float, 4, l1, l2, l4, l8) \
+    CAST_TO(isa, target, mode, from, FT, fw, f64, double, 8, l1, l2, l4, l8)
+
+#define CAST_KERNELS(isa, target, mode, l1, l2, l4, l8) \
+    CAST_FROM(isa, target, mode, i8, int8_t, 1, l1, l2, l4, l8) \
+    CAST_FROM(isa, target, mode, i16, int16_t, 2, l1, l2, l4, l8) \
+    CAST_FROM(isa, target, mode, i32, int32_t, 4, l1, l2, l4, l8) \
+    CAST_FROM(isa, target, mode, i64, int64_t, 8, l1, l2, l4, l8) \
+    CAST_FROM(isa, target, mode, u8, uint8_t, 1, l1, l2, l4, l8) \
+    CAST_FROM(isa, target, mode, u16, uint16_t, 2, l1, l2, l4, l8) \
+    CAST_FROM(isa, target, mode, u32, uint32_t, 4, l1, l2, l4, l8) \
+    CAST_FROM(isa, target, mode, u64, uint64_t, 8, l1, l2, l4, l8) \
+    CAST_FROM(isa, target, mode, f32, float, 4, l1, l2, l4, l8) \
+    CAST_FROM(isa, target, mode, f64, double, 8, l1, l2, l4, l8)
+
+/* ===================== Kernel tables ===================== */
+
+typedef void (*BinaryKernel)(const void* a, const void* b, void* out, size_t n);
+typedef void (*CompareKernel)(const void* a, const void* b, uint8_t* out, size_t n);
+typedef void (*CastKernel)(const void* in, void* out, size_t n);
+
+/**
+ * @brief Every kernel compiled for one instruction set
+ */
+typedef struct {
+    TablrSimdLevel level;                                          /**< Instruction set */
+    BinaryKernel arith[TABLR_ARITH_MAX + 1][TABLR_KERNEL_TYPES];   /**< By operator and type */
+    CompareKernel compare[TABLR_CMP_GE + 1][TABLR_KERNEL_TYPES];   /**< By comparison and type */
+    CastKernel cast[TABLR_KERNEL_TYPES][TABLR_KERNEL_TYPES];       /**< By source and target type */
+} KernelTable;
+
+/* Rows in TablrKernelType order */
+#define WRAPPING_ROW(op, isa) \
+    { op##_u8_##isa, op##_u16_##isa, op##_u32_##isa, op##_u64_##isa, \
+      op##_u8_##isa, op##_u16_##isa, op##_u32_##isa, op##_u64_##isa, op##_f32_##isa, op##_f64_##isa }
+#define FLOAT_ROW(op, isa) \
+    { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, op##_f32_##isa, op##_f64_##isa }
+#define TYPED_ROW(op, isa) \
+    { op##_i8_##isa, op##_i16_##isa, op##_i32_##isa, op##_i64_##isa, \
+      op##_u8_##isa, op##_u16_##isa, op##_u32_##isa, op##_u64_##isa, op##_f32_##isa, op##_f64_##isa }
+#define CAST_ROW(from, isa) \
+    { cast_##from##_i8_##isa, cast_##from##_i16_##isa, cast_##from##_i32_##isa, cast_##from##_i64_##isa, \
+      cast_##from##_u8_##isa, cast_##from##_u16_##isa, cast_##from##_u32_##isa, cast_##from##_u64_##isa, \
+      cast_##from##_f32_##isa, cast_##from##_f64_##isa }
+
+/**
+ * @brief Define every kernel for one instruction set, and its table
+ *
+ * @param isa Suffix of the kernel names
+ * @param target Function attribute enabling the instruction set
+ * @param mode v for vector code, s for the scalar set
+ * @param l1 Lanes per vector of 1-byte elements (l2, l4, l8 likewise)
+ */
+#define DEFINE_KERNELS(isa, target, mode, lvl, l1, l2, l4, l8) \
+    WRAPPING_KERNELS(isa, target, mode, u8, uint8_t, l1) \
+    WRAPPING_KERNELS(isa, target, mode, u16, uint16_t, l2) \
+    WRAPPING_KERNELS(isa, target, mode, u32, uint32_t, l4) \
+    WRAPPING_KERNELS(isa, target, mode, u64, uint64_t, l8) \
+    FLOAT_KERNELS(isa, target, mode, f32, float, l4, VEC(i32, l4)) \
+    FLOAT_KERNELS(isa, target, mode, f64, double, l8, VEC(i64, l8)) \
+    INTEGER_KERNELS(isa, target, mode, i8, int8_t, l1, VEC(i8, l1)) \
+    INTEGER_KERNELS(isa, target, mode, i16, int16_t, l2, VEC(i16, l2)) \
+    INTEGER_KERNELS(isa, target, mode, i32, int32_t, l4, VEC(i32, l4)) \
+    INTEGER_KERNELS(isa, target, mode, i64, int64_t, l8, VEC(i64, l8)) \
+    INTEGER_KERNELS(isa, target, mode, u8, uint8_t, l1, VEC(u8, l1)) \
+    INTEGER_KERNELS(isa, target, mode, u16, uint16_t, l2, VEC(u16, l2)) \
+    INTEGER_KERNELS(isa, target, mode, u32, uint32_t, l4, VEC(u32, l4)) \
+    INTEGER_KERNELS(isa, target, mode, u64, uint64_t, l8, VEC(u64, l8)) \
+    COMPARE_KERNELS(isa, target, mode, f32, float, l4) \
+    COMPARE_KERNELS(isa, target, mode, f64, double, l8) \
+    CAST_KERNELS(isa, target, mode, l1, l2, l4, l8) \
+    static const KernelTable kernels_##isa = { \
+        lvl, \
+        { WRAPPING_ROW(add, isa), WRAPPING_ROW(sub, isa), WRAPPING_ROW(mul, isa), \
+          FLOAT_ROW(div, isa), TYPED_ROW(min, isa), TYPED_ROW(max, isa) }, \
+        { TYPED_ROW(eq, isa), TYPED_ROW(ne, isa), TYPED_ROW(lt, isa), \
+          TYPED_ROW(le, isa), TYPED_ROW(gt, isa), TYPED_ROW(ge, isa) }, \
+        { CAST_ROW(i8, isa), CAST_ROW(i16, isa), CAST_ROW(i32, isa), CAST_ROW(i64, isa), \
+          CAST_ROW(u8, isa), CAST_ROW(u16, isa), CAST_ROW(u32, isa), CAST_ROW(u64, isa), \
+          CAST_ROW(f32, isa), CAST_ROW(f64, isa) } \
+    };
+
+DEFINE_KERNELS(scalar, TARGET_NONE, s, TABLR_SIMD_SCALAR, 1, 1, 1, 1)
+
+#if defined(HAVE_X86_VECTORS)
+DEFINE_KERNELS(sse42, TARGET_SSE42, v, TABLR_SIMD_SSE42, 16, 8, 4, 2)
+DEFINE_KERNELS(avx2, TARGET_AVX2, v, TABLR_SIMD_AVX2, 32, 16, 8, 4)
+DEFINE_KERNELS(avx512, TARGET_AVX512, v, TABLR_SIMD_AVX512, 64, 32, 16, 8)
+#elif defined(HAVE_NEON_VECTORS)
+DEFINE_KERNELS(neon, TARGET_NONE, v, TABLR_SIMD_NEON, 16, 8, 4, 2)
+#endif
+
+/* ===================== Dispatch ===================== */
+
+/**
+ * @brief Pick the kernels for the best instruction set of this CPU
+ */
+static const KernelTable* select_kernels(void) {
+    TablrSimdLevel level = tablr_cpu_simd_level();
+#if defined(HAVE_X86_VECTORS)
+    if (level == TABLR_SIMD_AVX512) return &kernels_avx512;
+    if (level == TABLR_SIMD_AVX2) return &kernels_avx2;
+    if (level == TABLR_SIMD_SSE42) return &kernels_sse42;
+#elif defined(HAVE_NEON_VECTORS)
+    if (level == TABLR_SIMD_NEON) return &kernels_neon;
+#endif
+    (void)level;
+    return &kernels_scalar;
+}
+
+#ifdef _WIN32
+static const KernelTable* volatile table = NULL;
+#else
+static _Atomic(const KernelTable*) table = NULL;
+#endif
+
+/**
+ * @brief Get the kernel table, selecting it on first use
+ *
+ * Concurrent first calls select and store the same table, which is
+ * static, so the pointer only needs to be atomic, not ordered.
+ */
+static const KernelTable* kernels(void) {
+#ifdef _WIN32
+    const KernelTable* selected = table;
+    if (!selected) table = selected = select_kernels();
+#else
+    const KernelTable* selected = atomic_load_explicit(&table, memory_order_relaxed);
+    if (!selected) {
+        selected = select_kernels();
+        atomic_store_explicit(&table, selected, memory_order_relaxed);
+    }
+#endif
+    return selected;
+}
+
+/**
+ * @brief Apply an operator to n pairs of elements
+ *
+ * @return true on success, false if op is not defined for type
+ */
+bool tablr_kernel_arith(TablrArithOp op, TablrKernelType type, const void* a, const void* b, void* out, size_t n) {
+    BinaryKernel kernel = kernels()->arith[op][type];
+    if (!kernel) return false;
+    kernel(a, b, out, n);
+    return true;
+}
+
+/**
+ * @brief Compare n pairs of elements into 0/1 bytes
+ */
+void tablr_kernel_compare(TablrCompareOp op, TablrKernelType type, const void* a, const void* b,
+                          uint8_t* out, size_t n) {
+    kernels()->compare[op][type](a, b, out, n);
+}
+
+/**
+ * @brief Convert n elements from one type to another
+ */
+void tablr_kernel_cast(TablrKernelType from, TablrKernelType to, const void* in, void* out, size_t n) {
+    kernels()->cast[from][to](in, out, n);
+}
+
+/**
+ * @brief Get the instruction set of the kernels in use
+ */
+TablrSimdLevel tablr_kernel_level(void) {
+    return kernels()->level;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file kernels.h
+ * @brief Internal SIMD element-wise kernels
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Not part of the public API. Each kernel works on plain arrays of one
+ * element type and is compiled once per instruction set; the best set for
+ * the running CPU is picked on first use. Used by arith.c.
+ */
+
+#ifndef TABLR_OPS_KERNELS_H
+#define TABLR_OPS_KERNELS_H
+
+#include "tablr/ops/arith.h"
+#include "tablr/core/cpu.h"
+#include <stdint.h>
+
+/**
+ * @brief Element types the kernels work on
+ */
+typedef enum {
+    TABLR_KERNEL_I8,
+    TABLR_KERNEL_I16,
+    TABLR_KERNEL_I32,
+    TABLR_KERNEL_I64,
+    TABLR_KERNEL_U8,
+    TABLR_KERNEL_U16,
+    TABLR_KERNEL_U32,
+    TABLR_KERNEL_U64,
+    TABLR_KERNEL_F32,
+    TABLR_KERNEL_F64,
+    TABLR_KERNEL_TYPES
+} TablrKernelType;
+
+/**
+ * @brief Apply an operator to n pairs of elements
+ *
+ * Integers wrap on overflow. Division is only defined for float types.
+ * Min and max return NaN if either element is NaN.
+ *
+ * @param op Operator
+ * @param type Type of a, b and out
+ * @param a First operands
+ * @param b Second operands
+ * @param out Results (may alias a or b)
+ * @param n Number of elements
+ * @return true on success, false if op is not defined for type
+ */
+bool tablr_kernel_arith(TablrArithOp op, TablrKernelType type, const void* a, const void* b, void* out, size_t n);
+
+/**
+ * @brief Compare n pairs of elements
+ *
+ * @param op Comparison
+ * @param type Type of a and b
+ * @param a First operands
+ * @param b Second operands
+ * @param out One byte per pair, 1 if the comparison holds and 0 otherwise
+ * @param n Number of elements
+ */
+void tablr_kernel_compare(TablrCompareOp op, TablrKernelType type, const void* a, const void* b,
+                          uint8_t* out, size_t n);
+
+/**
+ * @brief Convert n elements from one type to another
+ *
+ * Integers are truncated to narrower types as C conversions do and floats
+ * are truncated toward zero; float elements outside the range of an
+ * integer type give unspecified results, so callers check them first.
+ *
+ * @param from Type of in
+ * @param to Type of out
+ * @param in Source elements
+ * @param out Converted elements (must not overlap in)
+ * @param n Number of elements
+ */
+void tablr_kernel_cast(TablrKernelType from, TablrKernelType to, const void* in, void* out, size_t n);
+
+/**
+ * @brief Get the instruction set of the kernels in use
+ * @return SIMD level the kernels were compiled for
+ */
+TablrSimdLevel tablr_kernel_level(void);
+
+#endif /* TABLR_OPS_KERNELS_H */
@@ -0,0 +1,469 @@
+/**
+ * @file keys.c
+ * @brief Implementation of key encoding for grouping and joins
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * This file reduces key columns of any type to dense int32 ids, so the
+ * grouping and join kernels only ever compare and index integers.
+ * Categorical keys already are integers and are translated through their
+ * dictionaries; strings go through a category index, 8- and 16-bit values
+ * through a table with a slot per value, and wider numbers through a hash
+ * table of their 64-bit values. Chunked columns are read one chunk at a
+ * time, in place.
+ */
+
+#include "keys.h"
+#include "walk.h"
+#include "tablr/core/categorical.h"
+#include "tablr/core/stats.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define KEYS_INITIAL_SLOTS 64  /**< Initial hash table size */
+#define KEYS_EMPTY (-1)        /**< Unused hash table slot */
+
+/**
+ * @brief Hash table of distinct 64-bit key values
+ */
+typedef struct {
+    uint64_t* values;  /**< Value of each id */
+    size_t count;      /**< Number of ids */
+    size_t cap;        /**< Values that fit in values */
+    int32_t* slots;    /**< Open-addressing table of ids */
+    size_t mask;       /**< Number of slots minus one */
+} ValueTable;
+
+/**
+ * @brief Scramble a 64-bit value for use as a hash (splitmix64 finalizer)
+ */
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Bits of a float key, with -0.0 equal to 0.0 and all NaNs equal
+ */
+static uint64_t float_bits(double d) {
+    if (d == 0.0) d = 0.0;
+    if (isnan(d)) d = NAN;
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @brief Read one element of a numeric key column as a 64-bit value
+ */
+static uint64_t key_value(const void* data, TablrDType dtype, size_t i) {
+    switch (dtype) {
+        case TABLR_INT32:
+        case TABLR_DATE32: return (uint64_t)(int64_t)((const int32_t*)data)[i];
+        case TABLR_INT64:
+        case TABLR_TIMESTAMP64: return (uint64_t)((const int64_t*)data)[i];
+        case TABLR_UINT32: return ((const uint32_t*)data)[i];
+        case TABLR_UINT64: return ((const uint64_t*)data)[i];
+        case TABLR_FLOAT32: return float_bits(((const float*)data)[i]);
+        case TABLR_FLOAT64: return float_bits(((const double*)data)[i]);
+        case TABLR_BOOL: return ((const bool*)data)[i] ? 1 : 0;
+        case TABLR_BITMASK: return (((const uint64_t*)data)[i / 64] >> (i % 64)) & 1;
+        default: return 0;
+    }
+}
+
+static void table_free(ValueTable* table) {
+    free(table->values);
+    free(table->slots);
+}
+
+/**
+ * @brief Create a table with room for an expected number of values
+ *
+ * Slots are twice the room, so the table stays at most half full.
+ */
+static bool table_init(ValueTable* table, size_t expected) {
+    memset(table, 0, sizeof(*table));
+    size_t nslots = KEYS_INITIAL_SLOTS;
+    while (nslots / 2 < expected && nslots < ((size_t)1 << 31)) nslots *= 2;
+    table->cap = nslots / 2;
+    table->mask = nslots - 1;
+    table->values = (uint64_t*)malloc(table->cap * sizeof(uint64_t));
+    table->slots = (int32_t*)malloc(nslots * sizeof(int32_t));
+    if (!table->values || !table->slots) {
+        table_free(table);
+        return false;
+    }
+    for (size_t i = 0; i < nslots; i++) table->slots[i] = KEYS_EMPTY;
+    return true;
+}
+
+/**
+ * @brief Distinct estimate of a key column if its statistics are cached, else 0
+ */
+static size_t expected_keys(const TablrSeries* key) {
+    TablrSeriesStats stats;
+    return tablr_series_stats_cached(key, &stats) ? stats.distinct : 0;
+}
+
+/**
+ * @brief Find the slot holding a value, or the empty slot where it belongs
+ */
+static size_t table_slot(const ValueTable* table, uint64_t value) {
+    size_t slot = (size_t)mix64(value) & table->mask;
+    while (table->slots[slot] != KEYS_EMPTY && table->values[table->slots[slot]] != value) {
+        slot = (slot + 1) & table->mask;
+    }
+    return slot;
+}
+
+/**
+ * @brief Double the table and reinsert every id
+ */
+static bool table_grow(ValueTable* table) {
+    size_t cap = table->cap * 2;
+    uint64_t* values = (uint64_t*)realloc(table->values, cap * sizeof(uint64_t));
+    if (!values) return false;
+    table->values = values;
+
+    size_t nslots = cap * 2;
+    int32_t* slots = (int32_t*)malloc(nslots * sizeof(int32_t));
+    if (!slots) return false;
+    for (size_t i = 0; i < nslots; i++) slots[i] = KEYS_EMPTY;
+    for (size_t id = 0; id < table->count; id++) {
+        size_t slot = (size_t)mix64(values[id]) & (nslots - 1);
+        while (slots[slot] != KEYS_EMPTY) slot = (slot + 1) & (nslots - 1);
+        slots[slot] = (int32_t)id;
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->mask = nslots - 1;
+    table->cap = cap;
+    return true;
+}
+
+/**
+ * @brief Get the id of a value, adding it if it is new
+ * @return Id, or -1 on allocation failure
+ */
+static int32_t table_add(ValueTable* table, uint64_t value) {
+    size_t slot = table_slot(table, value);
+    if (table->slots[slot] != KEYS_EMPTY) return table->slots[slot];
+
+    if (table->count == table->cap) {
+        if (table->count >= INT32_MAX || !table_grow(table)) return -1;
+        slot = table_slot(table, value);
+    }
+    table->values[table->count] = value;
+    table->slots[slot] = (int32_t)table->count;
+    return (int32_t)table->count++;
+}
+
+/**
+ * @brief Encode numeric keys through a hash table of their values
+ */
+static bool encode_values(const TablrSeries* left, const TablrSeries* right, int32_t* left_ids,
+                          int32_t* right_ids, size_t* nkeys) {
+    ValueTable table;
+    if (!table_init(&table, expected_keys(left))) return false;
+
+    TablrDType dtype = tablr_series_dtype(left);
+    bool ok = true;
+    ChunkWalk walk;
+    walk_open(&walk, left);
+    while (ok && walk_next(&walk)) {
+        int32_t* ids = left_ids + walk.base;
+        for (size_t i = 0; ok && i < walk.size; i++) {
+            if (!tablr_series_is_valid(left, walk.base + i)) {
+                ids[i] = -1;
+                continue;
+            }
+            ids[i] = table_add(&table, key_value(walk.data, dtype, i));
+            ok = ids[i] >= 0;
+        }
+    }
+    ok = ok && !walk.failed;
+    walk_close(&walk);
+
+    walk_open(&walk, right);
+    while (ok && walk_next(&walk)) {
+        int32_t* ids = right_ids + walk.base;
+        for (size_t i = 0; i < walk.size; i++) {
+            ids[i] = tablr_series_is_valid(right, walk.base + i)
+                ? table.slots[table_slot(&table, key_value(walk.data, dtype, i))] : -1;
+        }
+    }
+    ok = ok && !walk.failed;
+    walk_close(&walk);
+
+    *nkeys = table.count;
+    table_free(&table);
+    return ok;
+}
+
+/**
+ * @brief Read one element of a 1- or 2-byte key column as its bit pattern
+ */
+static uint16_t small_value(const void* data, size_t width, size_t i) {
+    return width == 1 ? ((const uint8_t*)data)[i] : ((const uint16_t*)data)[i];
+}
+
+/**
+ * @brief Encode 8- and 16-bit keys through a table indexed by value
+ *
+ * Every possible value has a slot, so there is no hashing or probing.
+ */
+static bool encode_small(const TablrSeries* left, const TablrSeries* right, int32_t* left_ids,
+                         int32_t* right_ids, size_t* nkeys) {
+    size_t width = tablr_dtype_size(tablr_series_dtype(left));
+    size_t nslots = (size_t)1 << (8 * width);
+    int32_t* slots = (int32_t*)malloc(nslots * sizeof(int32_t));
+    if (!slots) return false;
+    for (size_t v = 0; v < nslots; v++) slots[v] = KEYS_EMPTY;
+
+    int32_t next = 0;
+    ChunkWalk walk;
+    walk_open(&walk, left);
+    while (walk_next(&walk)) {
+        int32_t* ids = left_ids + walk.base;
+        for (size_t i = 0; i < walk.size; i++) {
+            if (!tablr_series_is_valid(left, walk.base + i)) {
+                ids[i] = -1;
+                continue;
+            }
+            int32_t* slot = &slots[small_value(walk.data, width, i)];
+            if (*slot == KEYS_EMPTY) *slot = next++;
+            ids[i] = *slot;
+        }
+    }
+    bool ok = !walk.failed;
+
+    walk_open(&walk, right);
+    while (ok && walk_next(&walk)) {
+        int32_t* ids = right_ids + walk.base;
+        for (size_t i = 0; i < walk.size; i++) {
+            ids[i] = tablr_series_is_valid(right, walk.base + i) ? slots[small_value(walk.data, width, i)] : -1;
+        }
+    }
+    ok = ok && !walk.failed;
+    walk_close(&walk);
+
+    *nkeys = (size_t)next;
+    free(slots);
+    return ok;
+}
+
+/**
+ * @brief Encode string keys through a category index
+ */
+static bool encode_strings(const TablrSeries* left, const TablrSeries* right, int32_t* left_ids,
+                           int32_t* right_ids, size_t* nkeys) {
+    TablrCategoryIndex* index = tablr_category_index_create_sized(expected_keys(left));
+    if (!index) return false;
+
+    bool ok = true;
+    ChunkWalk walk;
+    walk_open(&walk, left);
+    while (ok && walk_next(&walk)) {
+        const int64_t* offsets = tablr_series_string_offsets(walk.chunk);
+        const char* chars = tablr_series_string_chars(walk.chunk);
+        int32_t* ids = left_ids + walk.base;
+        ok = offsets && chars;
+        for (size_t i = 0; ok && i < walk.size; i++) {
+            if (!tablr_series_is_valid(left, walk.base + i)) {
+                ids[i] = -1;
+                continue;
+            }
+            ids[i] = tablr_category_index_add(index, chars + offsets[i], (size_t)(offsets[i + 1] - offsets[i]));
+            ok = ids[i] >= 0;
+        }
+    }
+    ok = ok && !walk.failed;
+    walk_close(&walk);
+
+    walk_open(&walk, right);
+    while (ok && walk_next(&walk)) {
+        const int64_t* offsets = tablr_series_string_offsets(walk.chunk);
+        const char* chars = tablr_series_string_chars(walk.chunk);
+        int32_t* ids = right_ids + walk.base;
+        ok = offsets && chars;
+        for (size_t i = 0; ok && i < walk.size; i++) {
+            ids[i] = tablr_series_is_valid(right, walk.base + i)
+                ? tablr_category_index_find(index, chars + offsets[i], (size_t)(offsets[i + 1] - offsets[i])) : -1;
+        }
+    }
+    ok = ok && !walk.failed;
+    walk_close(&walk);
+
+    *nkeys = tablr_category_index_size(index);
+    tablr_category_index_free(index);
+    return ok;
+}
+
+/**
+ * @brief Check whether two dictionaries are the same shared buffer
+ *
+ * @param a Dictionary (may be NULL)
+ * @param b Dictionary (may be NULL)
+ * @return true if both view the same strings
+ */
+bool tablr_keys_same_categories(const TablrSeries* a, const TablrSeries* b) {
+    return tablr_series_size(a) == tablr_series_size(b) &&
+           tablr_series_string_offsets(a) == tablr_series_string_offsets(b) &&
+           tablr_series_string_chars(a) == tablr_series_string_chars(b);
+}
+
+/**
+ * @brief Translate each category of right to the code of the equal left category
+ * @param map Output left code per right code, or -1
+ */
+static bool translate_categories(const TablrSeries* left, const TablrSeries* right, int32_t* map) {
+    size_t nright = tablr_series_size(right);
+    if (tablr_keys_same_categories(left, right)) {
+        for (size_t c = 0; c < nright; c++) map[c] = (int32_t)c;
+        return true;
+    }
+
+    TablrCategoryIndex* index = tablr_category_index_create();
+    if (!index) return false;
+    size_t nleft = tablr_series_size(left);
+    bool ok = true;
+    for (size_t c = 0; ok && c < nleft; c++) {
+        size_t len;
+        const char* chars = tablr_series_string_at(left, c, &len);
+        ok = tablr_category_index_add(index, chars, len) == (int32_t)c;
+    }
+    for (size_t c = 0; ok && c < nright; c++) {
+        size_t len;
+        const char* chars = tablr_series_string_at(right, c, &len);
+        map[c] = tablr_category_index_find(index, chars, len);
+    }
+    tablr_category_index_free(index);
+    return ok;
+}
+
+/**
+ * @brief Encode categorical keys from their codes
+ *
+ * Left codes are renumbered in order of first appearance with one lookup
+ * per row. Right codes are translated to left codes through the
+ * dictionaries, costing one string lookup per category rather than per row.
+ */
+static bool encode_categories(const TablrSeries* left, const TablrSeries* right, int32_t* left_ids,
+                              int32_t* right_ids, size_t* nkeys) {
+    const TablrSeries* left_categories = tablr_series_categories(left);
+    const TablrSeries* right_categories = right ? tablr_series_categories(right) : NULL;
+    size_t nleft = tablr_series_size(left_categories);
+    size_t nright = tablr_series_size(right_categories);
+
+    int32_t* renumber = (int32_t*)malloc((nleft ? nleft : 1) * sizeof(int32_t));
+    int32_t* map = (int32_t*)malloc((nright ? nright : 1) * sizeof(int32_t));
+    bool ok = renumber && map && (!right || translate_categories(left_categories, right_categories, map));
+    if (!ok) {
+        free(renumber);
+        free(map);
+        return false;
+    }
+
+    for (size_t c = 0; c < nleft; c++) renumber[c] = -1;
+    int32_t next = 0;
+    ChunkWalk walk;
+    walk_open(&walk, left);
+    while (walk_next(&walk)) {
+        const int32_t* codes = (const int32_t*)walk.data;
+        int32_t* ids = left_ids + walk.base;
+        for (size_t i = 0; i < walk.size; i++) {
+            if (!tablr_series_is_valid(left, walk.base + i)) {
+                ids[i] = -1;
+                continue;
+            }
+            if (renumber[codes[i]] < 0) renumber[codes[i]] = next++;
+            ids[i] = renumber[codes[i]];
+        }
+    }
+    ok = !walk.failed;
+
+    walk_open(&walk, right);
+    while (ok && walk_next(&walk)) {
+        const int32_t* codes = (const int32_t*)walk.data;
+        int32_t* ids = right_ids + walk.base;
+        for (size_t i = 0; i < walk.size; i++) {
+            int32_t code = tablr_series_is_valid(right, walk.base + i) ? map[codes[i]] : -1;
+            ids[i] = code >= 0 ? renumber[code] : -1;
+        }
+    }
+    ok = ok && !walk.failed;
+    walk_close(&walk);
+
+    *nkeys = (size_t)next;
+    free(renumber);
+    free(map);
+    return ok;
+}
+
+/**
+ * @brief Encode left and, if given, right key columns of the same type
+ */
+static bool encode(const TablrSeries* left, const TablrSeries* right, int32_t* left_ids, int32_t* right_ids,
+                   size_t* nkeys) {
+    switch (tablr_series_dtype(left)) {
+        case TABLR_CATEGORICAL: return encode_categories(left, right, left_ids, right_ids, nkeys);
+        case TABLR_STRING: return encode_strings(left, right, left_ids, right_ids, nkeys);
+        case TABLR_BOOL:
+        case TABLR_INT8:
+        case TABLR_INT16:
+        case TABLR_UINT8:
+        case TABLR_UINT16: return encode_small(left, right, left_ids, right_ids, nkeys);
+        default: return encode_values(left, right, left_ids, right_ids, nkeys);
+    }
+}
+
+/**
+ * @brief Map each row of a key column to a dense key id
+ *
+ * @param key Key column
+ * @param nkeys Output number of distinct ids
+ * @return Id of each row, or NULL on failure
+ */
+int32_t* tablr_keys_encode(const TablrSeries* key, size_t* nkeys) {
+    if (!key || !nkeys) return NULL;
+
+    int32_t* ids = (int32_t*)malloc(tablr_series_size(key) * sizeof(int32_t));
+    if (ids && !encode(key, NULL, ids, NULL, nkeys)) {
+        free(ids);
+        return NULL;
+    }
+    return ids;
+}
+
+/**
+ * @brief Map the rows of two key columns to shared key ids
+ *
+ * @param left Left key column
+ * @param right Right key column
+ * @param left_ids Output id of each left row
+ * @param right_ids Output id of each right row
+ * @param nkeys Output number of distinct left ids
+ * @return true on success, false on failure or if the types differ
+ */
+bool tablr_keys_encode_pair(const TablrSeries* left, const TablrSeries* right,
+                            int32_t** left_ids, int32_t** right_ids, size_t* nkeys) {
+    if (!left || !right || !left_ids || !right_ids || !nkeys) return false;
+    if (tablr_series_dtype(left) != tablr_series_dtype(right)) return false;
+    if (tablr_series_time_unit(left) != tablr_series_time_unit(right)) return false;
+
+    int32_t* lids = (int32_t*)malloc(tablr_series_size(left) * sizeof(int32_t));
+    int32_t* rids = (int32_t*)malloc(tablr_series_size(right) * sizeof(int32_t));
+    if (!lids || !rids || !encode(left, right, lids, rids, nkeys)) {
+        free(lids);
+        free(rids);
+        return false;
+    }
+    *left_ids = lids;
+    *right_ids = rids;
+    return true;
+}
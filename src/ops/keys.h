@@ -0,0 +1,60 @@
+/**
+ * @file keys.h
+ * @brief Internal key encoding for grouping and joins
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Not part of the public API. Used by the operations in src/ops.
+ */
+
+#ifndef TABLR_OPS_KEYS_H
+#define TABLR_OPS_KEYS_H
+
+#include "tablr/core/series.h"
+#include <stdint.h>
+
+/**
+ * @brief Map each row of a key column to a dense key id
+ *
+ * Rows with equal values get the same id, and ids are numbered 0, 1, 2, ...
+ * in order of first appearance. Null rows get -1. Categorical columns are
+ * encoded from their codes without looking at the strings; other columns
+ * are hashed.
+ *
+ * @param key Key column
+ * @param nkeys Output number of distinct ids
+ * @return Id of each row (free with free()), or NULL on failure
+ */
+int32_t* tablr_keys_encode(const TablrSeries* key, size_t* nkeys);
+
+/**
+ * @brief Map the rows of two key columns of the same type to shared key ids
+ *
+ * Left rows are encoded as by tablr_keys_encode(). A right row gets the id
+ * of the equal left value, or -1 if it is null or has no equal left value.
+ * Two categorical columns are matched by translating the right dictionary
+ * once, so rows are never compared as strings.
+ *
+ * @param left Left key column
+ * @param right Right key column, of the same type as left
+ * @param left_ids Output id of each left row (free with free())
+ * @param right_ids Output id of each right row (free with free())
+ * @param nkeys Output number of distinct left ids
+ * @return true on success, false on failure or if the types or time units differ
+ */
+bool tablr_keys_encode_pair(const TablrSeries* left, const TablrSeries* right,
+                            int32_t** left_ids, int32_t** right_ids, size_t* nkeys);
+
+/**
+ * @brief Check whether two categorical dictionaries are the same shared buffer
+ *
+ * Series gathered or sliced from one categorical series share its
+ * dictionary, so their codes can be compared or copied directly.
+ *
+ * @param a Dictionary (may be NULL)
+ * @param b Dictionary (may be NULL)
+ * @return true if both view the same strings
+ */
+bool tablr_keys_same_categories(const TablrSeries* a, const TablrSeries* b);
+
+#endif /* TABLR_OPS_KEYS_H */
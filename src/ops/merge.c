@@ -9,58 +9,367 @@
  */
 
 #include "tablr/ops/merge.h"
+#include "tablr/core/categorical.h"
+#include "tablr/core/encoding.h"
+#include "bits.h"
+#include "gather.h"
+#include "keys.h"
 #include <stdlib.h>
 #include <string.h>
 
+/**
+ * @brief Row pairs produced by a join
+ */
+typedef struct {
+    size_t* left;   /**< Left row of each output row, or TABLR_GATHER_NULL */
+    size_t* right;  /**< Right row of each output row, or TABLR_GATHER_NULL */
+    size_t count;   /**< Number of output rows */
+    size_t matched; /**< Output rows before the right-only rows */
+} JoinRows;
+
+/**
+ * @brief Pair up the rows of two key columns
+ * 
+ * Both keys are reduced to shared dense ids, the right rows are bucketed
+ * by id with a counting sort, and each left row then reads its matches
+ * from its bucket. No key is compared after encoding.
+ * 
+ * @return false on allocation failure or if the key types differ
+ */
+static bool join_rows(const TablrSeries* lkey, const TablrSeries* rkey, TablrJoinType join_type, JoinRows* rows) {
+    bool keep_left = join_type == TABLR_JOIN_LEFT || join_type == TABLR_JOIN_OUTER;
+    bool keep_right = join_type == TABLR_JOIN_RIGHT || join_type == TABLR_JOIN_OUTER;
+    size_t nleft = tablr_series_size(lkey);
+    size_t nright = tablr_series_size(rkey);
+    
+    int32_t* lids = NULL;
+    int32_t* rids = NULL;
+    size_t nkeys = 0;
+    if (!tablr_keys_encode_pair(lkey, rkey, &lids, &rids, &nkeys)) return false;
+    
+    size_t* starts = (size_t*)calloc(nkeys + 1, sizeof(size_t));
+    size_t* bucket = (size_t*)malloc((nright ? nright : 1) * sizeof(size_t));
+    bool ok = starts && bucket;
+    
+    /* starts[id]..starts[id + 1] are the right rows with key id */
+    for (size_t r = 0; ok && r < nright; r++) {
+        if (rids[r] >= 0) starts[rids[r] + 1]++;
+    }
+    for (size_t k = 0; ok && k < nkeys; k++) starts[k + 1] += starts[k];
+    for (size_t r = 0; ok && r < nright; r++) {
+        if (rids[r] >= 0) bucket[starts[rids[r]]++] = r;
+    }
+    for (size_t k = nkeys; ok && k > 0; k--) starts[k] = starts[k - 1];
+    if (ok) starts[0] = 0;
+    
+    size_t count = 0;
+    for (size_t l = 0; ok && l < nleft; l++) {
+        size_t matches = lids[l] >= 0 ? starts[lids[l] + 1] - starts[lids[l]] : 0;
+        count += matches ? matches : keep_left;
+    }
+    size_t matched = count;
+    for (size_t r = 0; ok && keep_right && r < nright; r++) {
+        if (rids[r] < 0) count++;
+    }
+    
+    rows->left = ok ? (size_t*)malloc((count ? count : 1) * sizeof(size_t)) : NULL;
+    rows->right = ok ? (size_t*)malloc((count ? count : 1) * sizeof(size_t)) : NULL;
+    ok = rows->left && rows->right;
+    
+    size_t out = 0;
+    for (size_t l = 0; ok && l < nleft; l++) {
+        size_t begin = lids[l] >= 0 ? starts[lids[l]] : 0;
+        size_t end = lids[l] >= 0 ? starts[lids[l] + 1] : 0;
+        for (size_t j = begin; j < end; j++) {
+            rows->left[out] = l;
+            rows->right[out++] = bucket[j];
+        }
+        if (begin == end && keep_left) {
+            rows->left[out] = l;
+            rows->right[out++] = TABLR_GATHER_NULL;
+        }
+    }
+    for (size_t r = 0; ok && keep_right && r < nright; r++) {
+        if (rids[r] >= 0) continue;
+        rows->left[out] = TABLR_GATHER_NULL;
+        rows->right[out++] = r;
+    }
+    rows->count = count;
+    rows->matched = matched;
+    
+    if (!ok) {
+        free(rows->left);
+        free(rows->right);
+    }
+    free(lids);
+    free(rids);
+    free(starts);
+    free(bucket);
+    return ok;
+}
+
+/**
+ * @brief Build the join key column of the output
+ * 
+ * Matched and left-only rows take the left key; right-only rows, which
+ * come last, take the right key.
+ * 
+ * @return New series, or NULL on failure or if there are no rows
+ */
+static TablrSeries* join_key(const TablrSeries* lkey, const TablrSeries* rkey, const JoinRows* rows, const char* on) {
+    if (rows->matched == rows->count) return tablr_gather_series(lkey, rows->left, rows->count);
+    if (rows->matched == 0) return tablr_gather_series(rkey, rows->right, rows->count);
+    
+    /* Stack the two parts with concat, which also unifies categorical dictionaries */
+    TablrDataFrame* parts[2] = { tablr_dataframe_create(), tablr_dataframe_create() };
+    TablrSeries* head = tablr_gather_series(lkey, rows->left, rows->matched);
+    TablrSeries* tail = tablr_gather_series(rkey, rows->right + rows->matched, rows->count - rows->matched);
+    if (!tablr_dataframe_add_column(parts[0], on, head)) tablr_series_free(head);
+    if (!tablr_dataframe_add_column(parts[1], on, tail)) tablr_series_free(tail);
+    
+    TablrSeries* key = NULL;
+    if (tablr_dataframe_ncols(parts[0]) == 1 && tablr_dataframe_ncols(parts[1]) == 1) {
+        TablrDataFrame* stacked = tablr_dataframe_concat((const TablrDataFrame**)parts, 2);
+        TablrSeries* column = tablr_dataframe_column_at(stacked, 0);
+        key = tablr_series_slice(column, 0, tablr_series_size(column));
+        tablr_dataframe_free(stacked);
+    }
+    tablr_dataframe_free(parts[0]);
+    tablr_dataframe_free(parts[1]);
+    return key;
+}
+
 /**
  * @brief Merge two dataframes on a column
  * 
- * Performs a join operation between two dataframes on a common column.
+ * Performs a hash join on a common column. The output has the left
+ * columns followed by the right columns other than on. Rows come in left
+ * order, each left row once per matching right row in right order; rows
+ * a left or outer join keeps without a match get nulls on the right, and
+ * right rows a right or outer join keeps without a match are appended at
+ * the end with nulls on the left. Null keys never match.
+ * 
+ * Categorical keys are joined on their codes: the right dictionary is
+ * translated to left codes once, so no row is compared as a string.
  * 
  * @param left Left dataframe
  * @param right Right dataframe
  * @param on Column name to join on
  * @param join_type Type of join (TABLR_JOIN_INNER, TABLR_JOIN_LEFT, etc.)
- * @return New merged dataframe, or NULL on failure
+ * @return New merged dataframe, or NULL on failure or if the key columns
+ *         are missing or of different types
  */
 TablrDataFrame* tablr_dataframe_merge(const TablrDataFrame* left, const TablrDataFrame* right, 
                                        const char* on, TablrJoinType join_type) {
     if (!left || !right || !on) return NULL;
     
-    (void)join_type;
+    TablrSeries* lkey = tablr_dataframe_get_column(left, on);
+    TablrSeries* rkey = tablr_dataframe_get_column(right, on);
+    JoinRows rows;
+    if (!lkey || !rkey || !join_rows(lkey, rkey, join_type, &rows)) return NULL;
     
-    TablrDataFrame* result = tablr_dataframe_copy(left);
+    TablrDataFrame* result = tablr_dataframe_create();
+    size_t left_ncols = tablr_dataframe_ncols(left);
+    for (size_t i = 0; result && i < left_ncols; i++) {
+        TablrSeries* s = tablr_dataframe_column_at(left, i);
+        TablrSeries* new_series = s == lkey ? join_key(lkey, rkey, &rows, on)
+                                            : tablr_gather_series(s, rows.left, rows.count);
+        if (!tablr_dataframe_add_column(result, tablr_dataframe_column_name_at(left, i), new_series)) {
+            tablr_series_free(new_series);
+        }
+    }
     
     size_t right_ncols = tablr_dataframe_ncols(right);
-    size_t name_count;
-    char** names = tablr_dataframe_columns(right, &name_count);
-    
-    for (size_t i = 0; i < right_ncols; i++) {
-        if (strcmp(names[i], on) != 0) {
-            TablrSeries* s = tablr_dataframe_get_column(right, names[i]);
-            if (s) {
-                void* data = tablr_series_data(s);
-                TablrDType dtype = tablr_series_dtype(s);
-                TablrDevice device = tablr_series_device(s);
-                size_t size = tablr_series_size(s);
-                
-                TablrSeries* new_series = tablr_series_create(data, size, dtype, device);
-                tablr_dataframe_add_column(result, names[i], new_series);
+    for (size_t i = 0; result && i < right_ncols; i++) {
+        const char* name = tablr_dataframe_column_name_at(right, i);
+        if (strcmp(name, on) != 0) {
+            TablrSeries* new_series = tablr_gather_series(tablr_dataframe_column_at(right, i), rows.right, rows.count);
+            if (!tablr_dataframe_add_column(result, name, new_series)) {
+                tablr_series_free(new_series);
             }
         }
     }
     
-    for (size_t i = 0; i < name_count; i++) free(names[i]);
-    free(names);
-    
+    free(rows.left);
+    free(rows.right);
     return result;
 }
 
+/**
+ * @brief Concatenate one string column of several dataframes
+ * 
+ * Each input contributes one memcpy of its character range; its offsets
+ * are rebased onto the end of the output so far.
+ * 
+ * @return New series, or NULL on failure
+ */
+static TablrSeries* concat_strings(const TablrDataFrame** dfs, size_t count, const char* name,
+                                   size_t total_rows, TablrDevice device) {
+    size_t total_bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        TablrSeries* s = tablr_dataframe_get_column(dfs[i], name);
+        const int64_t* offsets = tablr_series_string_offsets(s);
+        total_bytes += (size_t)(offsets[tablr_series_size(s)] - offsets[0]);
+    }
+    
+    TablrSeries* out = tablr_series_string_alloc(total_rows, total_bytes, device);
+    int64_t* out_offsets;
+    char* out_chars;
+    if (!out || !tablr_series_string_buffers(out, &out_offsets, &out_chars)) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    
+    size_t row = 0;
+    int64_t pos = 0;
+    for (size_t i = 0; i < count; i++) {
+        TablrSeries* s = tablr_dataframe_get_column(dfs[i], name);
+        const int64_t* offsets = tablr_series_string_offsets(s);
+        size_t size = tablr_series_size(s);
+        int64_t shift = pos - offsets[0];
+        
+        memcpy(out_chars + pos, tablr_series_string_chars(s) + offsets[0], 
+               (size_t)(offsets[size] - offsets[0]));
+        for (size_t r = 1; r <= size; r++) out_offsets[row + r] = offsets[r] + shift;
+        row += size;
+        pos = out_offsets[row];
+    }
+    return out;
+}
+
+/**
+ * @brief Concatenate one bitmask column of several dataframes
+ * 
+ * Each input word is shifted to the output's current bit position and
+ * ORed into at most two output words, so the copy moves 64 rows per step.
+ * 
+ * @return New series, or NULL on failure
+ */
+static TablrSeries* concat_bits(const TablrDataFrame** dfs, size_t count, const char* name,
+                                size_t total_rows, TablrDevice device) {
+    TablrSeries* out = tablr_series_zeros(total_rows, TABLR_BITMASK, device);
+    uint64_t* out_bits = (uint64_t*)tablr_series_data(out);
+    if (!out_bits) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    
+    size_t row = 0;
+    for (size_t i = 0; i < count; i++) {
+        TablrSeries* s = tablr_dataframe_get_column(dfs[i], name);
+        const uint64_t* bits = (const uint64_t*)tablr_series_data_const(s);
+        size_t size = tablr_series_size(s);
+        if (!bits && size > 0) {
+            tablr_series_free(out);
+            return NULL;
+        }
+        unsigned shift = (unsigned)(row % 64);
+        for (size_t w = 0; w < bits_words(size); w++) {
+            uint64_t word = bits[w];
+            if (size - w * 64 < 64) word &= ((uint64_t)1 << (size - w * 64)) - 1;
+            size_t at = row / 64 + w;
+            out_bits[at] |= word << shift;
+            if (shift && at + 1 < bits_words(total_rows)) out_bits[at + 1] |= word >> (64 - shift);
+        }
+        row += size;
+    }
+    return out;
+}
+
+/**
+ * @brief Concatenate one categorical column of several dataframes
+ * 
+ * Inputs that share one dictionary keep their codes. Otherwise the
+ * dictionaries are merged in input order, so the first input keeps its
+ * codes, and every input's codes are translated through a per-category map.
+ * 
+ * @return New series, or NULL on failure
+ */
+static TablrSeries* concat_categories(const TablrDataFrame** dfs, size_t count, const char* name,
+                                      size_t total_rows, TablrDevice device) {
+    const TablrSeries* first = tablr_series_categories(tablr_dataframe_get_column(dfs[0], name));
+    bool shared = true;
+    for (size_t i = 1; i < count; i++) {
+        shared = shared && tablr_keys_same_categories(first, tablr_series_categories(tablr_dataframe_get_column(dfs[i], name)));
+    }
+    
+    TablrCategoryIndex* index = shared ? NULL : tablr_category_index_create();
+    int32_t** maps = shared ? NULL : (int32_t**)calloc(count, sizeof(int32_t*));
+    bool ok = shared || (index && maps);
+    for (size_t i = 0; ok && !shared && i < count; i++) {
+        const TablrSeries* categories = tablr_series_categories(tablr_dataframe_get_column(dfs[i], name));
+        size_t ncategories = tablr_series_size(categories);
+        maps[i] = (int32_t*)malloc((ncategories ? ncategories : 1) * sizeof(int32_t));
+        ok = maps[i] != NULL;
+        for (size_t c = 0; ok && c < ncategories; c++) {
+            size_t len;
+            const char* chars = tablr_series_string_at(categories, c, &len);
+            maps[i][c] = tablr_category_index_add(index, chars, len);
+            ok = maps[i][c] >= 0;
+        }
+    }
+    
+    TablrSeries* merged = ok && !shared ? tablr_category_index_categories(index, device) : NULL;
+    TablrSeries* out = ok ? tablr_series_categorical_alloc(total_rows, shared ? first : merged, device) : NULL;
+    int32_t* codes = (int32_t*)tablr_series_data(out);
+    
+    size_t row = 0;
+    for (size_t i = 0; codes && i < count; i++) {
+        TablrSeries* s = tablr_dataframe_get_column(dfs[i], name);
+        const int32_t* src = (const int32_t*)tablr_series_data_const(s);
+        size_t size = tablr_series_size(s);
+        if (!src && size > 0) {
+            codes = NULL;
+            break;
+        }
+        if (shared) {
+            memcpy(codes + row, src, size * sizeof(int32_t));
+        } else {
+            for (size_t r = 0; r < size; r++) {
+                codes[row + r] = tablr_series_is_valid(s, r) ? maps[i][src[r]] : -1;
+            }
+        }
+        row += size;
+    }
+    
+    for (size_t i = 0; maps && i < count; i++) free(maps[i]);
+    free(maps);
+    tablr_series_free(merged);
+    tablr_category_index_free(index);
+    if (!codes) {
+        tablr_series_free(out);
+        return NULL;
+    }
+    return out;
+}
+
+/**
+ * @brief Convert timestamps from one time unit to another in place
+ * 
+ * Coarser units round toward negative infinity, so each value stays within
+ * the second, millisecond or microsecond it fell in.
+ */
+static void rescale_timestamps(int64_t* values, size_t count, TablrTimeUnit from, TablrTimeUnit to) {
+    int64_t from_per_second = tablr_time_unit_per_second(from);
+    int64_t to_per_second = tablr_time_unit_per_second(to);
+    for (size_t i = 0; i < count; i++) {
+        if (to_per_second > from_per_second) {
+            values[i] *= to_per_second / from_per_second;
+        } else {
+            int64_t factor = from_per_second / to_per_second;
+            int64_t q = values[i] / factor;
+            values[i] = values[i] % factor < 0 ? q - 1 : q;
+        }
+    }
+}
+
 /**
  * @brief Concatenate dataframes vertically
  * 
  * Stacks multiple dataframes vertically, combining rows.
- * All dataframes must have the same columns.
+ * All dataframes must have the same columns. Null rows stay null.
+ * Categorical columns with different dictionaries get a merged one.
+ * Timestamp columns take the time unit of the first dataframe.
  * 
  * @param dfs Array of dataframes to concatenate
  * @param count Number of dataframes
@@ -78,32 +387,51 @@ TablrDataFrame* tablr_dataframe_concat(const TablrDataFrame** dfs, size_t count)
     size_t ncols = tablr_dataframe_ncols(dfs[0]);
     
     for (size_t col = 0; col < ncols; col++) {
-        size_t name_count;
-        char** names = tablr_dataframe_columns(dfs[0], &name_count);
-        
-        TablrSeries* first_series = tablr_dataframe_get_column(dfs[0], names[col]);
+        const char* name = tablr_dataframe_column_name_at(dfs[0], col);
+        TablrSeries* first_series = tablr_dataframe_column_at(dfs[0], col);
         TablrDType dtype = tablr_series_dtype(first_series);
         TablrDevice device = tablr_series_device(first_series);
         size_t elem_size = tablr_dtype_size(dtype);
         
-        void* concat_data = malloc(total_rows * elem_size);
-        size_t offset = 0;
+        TablrSeries* new_series;
+        if (dtype == TABLR_STRING) {
+            new_series = concat_strings(dfs, count, name, total_rows, device);
+        } else if (dtype == TABLR_CATEGORICAL) {
+            new_series = concat_categories(dfs, count, name, total_rows, device);
+        } else if (dtype == TABLR_BITMASK) {
+            new_series = concat_bits(dfs, count, name, total_rows, device);
+        } else {
+            new_series = tablr_series_alloc(total_rows, dtype, device);
+            void* concat_data = tablr_series_data(new_series);
+            TablrTimeUnit unit = tablr_series_time_unit(first_series);
+            tablr_series_set_time_unit(new_series, unit);
+            size_t offset = 0;
+            for (size_t i = 0; concat_data && i < count; i++) {
+                TablrSeries* s = tablr_dataframe_get_column(dfs[i], name);
+                size_t size = tablr_series_size(s);
+                tablr_series_read(s, 0, size, (char*)concat_data + offset);
+                if (dtype == TABLR_TIMESTAMP64 && tablr_series_time_unit(s) != unit) {
+                    rescale_timestamps((int64_t*)((char*)concat_data + offset), size, tablr_series_time_unit(s), unit);
+                }
+                offset += size * elem_size;
+            }
+        }
         
-        for (size_t i = 0; i < count; i++) {
-            TablrSeries* s = tablr_dataframe_get_column(dfs[i], names[col]);
-            void* data = tablr_series_data(s);
+        size_t row = 0;
+        for (size_t i = 0; new_series && i < count; i++) {
+            TablrSeries* s = tablr_dataframe_get_column(dfs[i], name);
             size_t size = tablr_series_size(s);
-            
-            memcpy((char*)concat_data + offset, data, size * elem_size);
-            offset += size * elem_size;
+            if (tablr_series_null_count(s) > 0) {
+                for (size_t r = 0; r < size; r++) {
+                    if (!tablr_series_is_valid(s, r)) tablr_series_set_valid(new_series, row + r, false);
+                }
+            }
+            row += size;
         }
         
-        TablrSeries* new_series = tablr_series_create(concat_data, total_rows, dtype, device);
-        tablr_dataframe_add_column(result, names[col], new_series);
-        
-        free(concat_data);
-        for (size_t i = 0; i < name_count; i++) free(names[i]);
-        free(names);
+        if (!tablr_dataframe_add_column(result, name, new_series)) {
+            tablr_series_free(new_series);
+        }
     }
     
     return result;
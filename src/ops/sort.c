@@ -5,13 +5,19 @@
  * @license Apache-2.0
  * 
  * This file implements dataframe sorting operations including single-column
- * and multi-column sorting with ascending/descending order support.
+ * and multi-column sorting with ascending/descending order support. Sort
+ * keys are read one chunk at a time, so chunked columns are not flattened.
  */
 
 #include "tablr/ops/sort.h"
 #include "tablr/ops/filter.h"
+#include "tablr/core/stats.h"
+#include "bits.h"
+#include "walk.h"
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <math.h>
 
 /**
  * @brief Internal structure for sorting
@@ -25,13 +31,18 @@ typedef struct {
 
 /**
  * @brief Comparison function for ascending sort
+ * 
+ * Equal keys keep their original order, which makes the sort stable.
+ * 
  * @param a First element
  * @param b Second element
  * @return Comparison result
  */
 static int compare_asc(const void* a, const void* b) {
-    double diff = ((SortPair*)a)->value - ((SortPair*)b)->value;
-    return (diff > 0) - (diff < 0);
+    const SortPair* pa = (const SortPair*)a;
+    const SortPair* pb = (const SortPair*)b;
+    if (pa->value != pb->value) return (pa->value > pb->value) - (pa->value < pb->value);
+    return (pa->index > pb->index) - (pa->index < pb->index);
 }
 
 /**
@@ -41,14 +52,251 @@ static int compare_asc(const void* a, const void* b) {
  * @return Comparison result
  */
 static int compare_desc(const void* a, const void* b) {
-    double diff = ((SortPair*)b)->value - ((SortPair*)a)->value;
-    return (diff > 0) - (diff < 0);
+    const SortPair* pa = (const SortPair*)a;
+    const SortPair* pb = (const SortPair*)b;
+    if (pa->value != pb->value) return (pa->value < pb->value) - (pa->value > pb->value);
+    return (pa->index > pb->index) - (pa->index < pb->index);
+}
+
+/**
+ * @brief Read one element of a float sort column as its key
+ */
+static double sort_key(const void* data, TablrDType dtype, size_t i) {
+    switch (dtype) {
+        case TABLR_FLOAT32: return (double)((const float*)data)[i];
+        case TABLR_FLOAT64: return ((const double*)data)[i];
+        default: return 0.0;
+    }
+}
+
+/**
+ * @brief Read one element of an integer or bool column as an unsigned key
+ *
+ * Flipping the sign bit of signed values makes unsigned order match signed
+ * order, so every integer type sorts exactly, without going through double.
+ */
+static uint64_t radix_key(const void* data, TablrDType dtype, size_t i) {
+    switch (dtype) {
+        case TABLR_BOOL: return ((const bool*)data)[i] ? 1 : 0;
+        case TABLR_BITMASK: return (((const uint64_t*)data)[i / 64] >> (i % 64)) & 1;
+        case TABLR_INT8: return (uint8_t)((const int8_t*)data)[i] ^ 0x80u;
+        case TABLR_INT16: return (uint16_t)((const int16_t*)data)[i] ^ 0x8000u;
+        case TABLR_INT32:
+        case TABLR_DATE32: return (uint32_t)((const int32_t*)data)[i] ^ 0x80000000u;
+        case TABLR_INT64:
+        case TABLR_TIMESTAMP64: return (uint64_t)((const int64_t*)data)[i] ^ 0x8000000000000000ull;
+        case TABLR_UINT8: return ((const uint8_t*)data)[i];
+        case TABLR_UINT16: return ((const uint16_t*)data)[i];
+        case TABLR_UINT32: return ((const uint32_t*)data)[i];
+        case TABLR_UINT64: return ((const uint64_t*)data)[i];
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Order the rows of an integer, bool or temporal column
+ * 
+ * A stable least-significant-digit radix sort over the key bytes that
+ * differ between rows, one counting pass per byte, so 8- and 16-bit columns
+ * take one or two passes whatever their length. Descending order sorts the
+ * complemented keys, which keeps ties in their original order. Null rows go
+ * last; validity is read a word per 64 rows, and not at all without nulls.
+ * 
+ * @param col Sort column
+ * @param ascending Sort order
+ * @param indices Output row order (size of col entries)
+ * @return false on allocation failure
+ */
+static bool sort_integers(const TablrSeries* col, bool ascending, size_t* indices) {
+    size_t nrows = tablr_series_size(col);
+    size_t n = nrows ? nrows : 1;
+    uint64_t* keys = (uint64_t*)malloc(n * sizeof(uint64_t));
+    uint64_t* keys_tmp = (uint64_t*)malloc(n * sizeof(uint64_t));
+    size_t* rows_tmp = (size_t*)malloc(n * sizeof(size_t));
+    if (!keys || !keys_tmp || !rows_tmp) {
+        free(keys);
+        free(keys_tmp);
+        free(rows_tmp);
+        return false;
+    }
+    
+    TablrDType dtype = tablr_series_dtype(col);
+    uint64_t flip = ascending ? 0 : ~(uint64_t)0;
+    
+    /* Valid rows go to the front of indices, null rows to rows_tmp */
+    size_t nvalid = 0;
+    size_t nnull = 0;
+    bool nulls = tablr_series_null_count(col) > 0;
+    ChunkWalk walk;
+    walk_open(&walk, col);
+    while (walk_next(&walk)) {
+        uint64_t bits = BITS_ALL_VALID;
+        for (size_t i = 0; i < walk.size; i++) {
+            size_t row = walk.base + i;
+            if (nulls && (i == 0 || row % 64 == 0)) bits = tablr_series_validity_word(col, row / 64);
+            if (!((bits >> (row % 64)) & 1)) {
+                rows_tmp[nnull++] = row;
+                continue;
+            }
+            keys[nvalid] = radix_key(walk.data, dtype, i) ^ flip;
+            indices[nvalid++] = row;
+        }
+    }
+    if (walk.failed) {
+        free(keys);
+        free(keys_tmp);
+        free(rows_tmp);
+        return false;
+    }
+    memcpy(indices + nvalid, rows_tmp, nnull * sizeof(size_t));
+    
+    uint64_t differ = 0;
+    for (size_t i = 1; i < nvalid; i++) differ |= keys[i] ^ keys[0];
+    
+    size_t* rows = indices;
+    for (unsigned shift = 0; shift < 64 && (differ >> shift) != 0; shift += 8) {
+        if (((differ >> shift) & 0xFF) == 0) continue;
+        
+        size_t starts[256] = {0};
+        for (size_t i = 0; i < nvalid; i++) starts[(keys[i] >> shift) & 0xFF]++;
+        size_t pos = 0;
+        for (size_t b = 0; b < 256; b++) {
+            size_t count = starts[b];
+            starts[b] = pos;
+            pos += count;
+        }
+        for (size_t i = 0; i < nvalid; i++) {
+            size_t dst = starts[(keys[i] >> shift) & 0xFF]++;
+            keys_tmp[dst] = keys[i];
+            rows_tmp[dst] = rows[i];
+        }
+        
+        uint64_t* swap_keys = keys;
+        keys = keys_tmp;
+        keys_tmp = swap_keys;
+        size_t* swap_rows = rows;
+        rows = rows_tmp;
+        rows_tmp = swap_rows;
+    }
+    
+    /* After an odd number of passes the order is in the scratch buffer */
+    if (rows != indices) {
+        memcpy(indices, rows, nvalid * sizeof(size_t));
+        rows_tmp = rows;
+    }
+    
+    free(keys);
+    free(keys_tmp);
+    free(rows_tmp);
+    return true;
+}
+
+/**
+ * @brief One category of a categorical sort column
+ */
+typedef struct {
+    const char* chars;  /**< Characters of the category */
+    size_t len;         /**< Length in bytes */
+    int32_t code;       /**< Code of the category */
+} CategoryKey;
+
+/**
+ * @brief Order categories by their bytes, shorter prefixes first
+ */
+static int compare_categories(const void* a, const void* b) {
+    const CategoryKey* ka = (const CategoryKey*)a;
+    const CategoryKey* kb = (const CategoryKey*)b;
+    int cmp = memcmp(ka->chars, kb->chars, ka->len < kb->len ? ka->len : kb->len);
+    if (cmp != 0) return cmp;
+    return (ka->len > kb->len) - (ka->len < kb->len);
+}
+
+/**
+ * @brief Order the rows of a categorical column
+ * 
+ * Only the k categories are compared as strings; the rows are then placed
+ * by a stable counting sort on the rank of their code, which takes O(n + k)
+ * time. Null rows go last, found a validity word at a time.
+ * 
+ * @param col Categorical sort column
+ * @param ascending Sort order
+ * @param indices Output row order (size of col entries)
+ * @return false on allocation failure
+ */
+static bool sort_categorical(const TablrSeries* col, bool ascending, size_t* indices) {
+    const TablrSeries* categories = tablr_series_categories(col);
+    size_t ncategories = tablr_series_size(categories);
+    CategoryKey* keys = (CategoryKey*)malloc((ncategories ? ncategories : 1) * sizeof(CategoryKey));
+    size_t* starts = (size_t*)calloc(ncategories + 1, sizeof(size_t));
+    if (!keys || !starts) {
+        free(keys);
+        free(starts);
+        return false;
+    }
+    
+    for (size_t c = 0; c < ncategories; c++) {
+        keys[c].chars = tablr_series_string_at(categories, c, &keys[c].len);
+        keys[c].code = (int32_t)c;
+    }
+    qsort(keys, ncategories, sizeof(CategoryKey), compare_categories);
+    
+    /* starts[code] becomes the first output position of the code's rows */
+    size_t nvalid = 0;
+    bool nulls = tablr_series_null_count(col) > 0;
+    ChunkWalk walk;
+    walk_open(&walk, col);
+    while (walk_next(&walk)) {
+        const int32_t* codes = (const int32_t*)walk.data;
+        uint64_t bits = BITS_ALL_VALID;
+        for (size_t i = 0; i < walk.size; i++) {
+            size_t row = walk.base + i;
+            if (nulls && (i == 0 || row % 64 == 0)) bits = tablr_series_validity_word(col, row / 64);
+            if ((bits >> (row % 64)) & 1) {
+                starts[codes[i]]++;
+                nvalid++;
+            }
+        }
+    }
+    size_t pos = 0;
+    for (size_t r = 0; r < ncategories; r++) {
+        int32_t code = keys[ascending ? r : ncategories - 1 - r].code;
+        size_t count = starts[code];
+        starts[code] = pos;
+        pos += count;
+    }
+    
+    size_t nnull = 0;
+    bool ok = !walk.failed;
+    walk_open(&walk, col);
+    while (ok && walk_next(&walk)) {
+        const int32_t* codes = (const int32_t*)walk.data;
+        uint64_t bits = BITS_ALL_VALID;
+        for (size_t i = 0; i < walk.size; i++) {
+            size_t row = walk.base + i;
+            if (nulls && (i == 0 || row % 64 == 0)) bits = tablr_series_validity_word(col, row / 64);
+            if ((bits >> (row % 64)) & 1) indices[starts[codes[i]]++] = row;
+            else indices[nvalid + nnull++] = row;
+        }
+    }
+    ok = ok && !walk.failed;
+    walk_close(&walk);
+    
+    free(keys);
+    free(starts);
+    return ok;
 }
 
 /**
  * @brief Sort dataframe by column
  * 
- * Creates a new dataframe with rows sorted by the specified column.
+ * Creates a new dataframe with rows sorted by the specified column. Null
+ * rows, and NaN rows of float columns, are placed last in either order,
+ * keeping their original order.
+ * Categorical columns sort by the byte order of their categories, comparing
+ * codes rather than strings. Integer, bool, date and timestamp columns are
+ * radix sorted on their exact values; float columns are compared as doubles.
+ * A column whose statistics show it already in order is not sorted: the
+ * result is a copy of the dataframe, made of views.
  * 
  * @param df Source dataframe
  * @param column Column name to sort by
@@ -61,27 +309,64 @@ TablrDataFrame* tablr_dataframe_sort(const TablrDataFrame* df, const char* colum
     TablrSeries* sort_col = tablr_dataframe_get_column(df, column);
     if (!sort_col) return NULL;
     
+    TablrSeriesStats stats;
+    if (tablr_series_stats(sort_col, &stats) && (ascending ? stats.sorted : stats.reverse_sorted)) {
+        return tablr_dataframe_copy(df);
+    }
+    
     size_t nrows = tablr_series_size(sort_col);
-    SortPair* pairs = (SortPair*)malloc(nrows * sizeof(SortPair));
+    TablrDType col_dtype = tablr_series_dtype(sort_col);
+    if (col_dtype == TABLR_CATEGORICAL || col_dtype == TABLR_BOOL || col_dtype == TABLR_BITMASK ||
+        tablr_dtype_is_integer(col_dtype)) {
+        size_t* order = (size_t*)malloc((nrows ? nrows : 1) * sizeof(size_t));
+        bool ok = order && (col_dtype == TABLR_CATEGORICAL
+            ? sort_categorical(sort_col, ascending, order)
+            : sort_integers(sort_col, ascending, order));
+        TablrDataFrame* sorted = ok ? tablr_dataframe_select_rows(df, order, nrows) : NULL;
+        free(order);
+        return sorted;
+    }
+    
+    SortPair* pairs = (SortPair*)malloc((nrows ? nrows : 1) * sizeof(SortPair));
+    size_t* indices = (size_t*)malloc((nrows ? nrows : 1) * sizeof(size_t));
+    if (!pairs || !indices) {
+        free(pairs);
+        free(indices);
+        return NULL;
+    }
     
-    void* data = tablr_series_data(sort_col);
     TablrDType dtype = tablr_series_dtype(sort_col);
     
-    for (size_t i = 0; i < nrows; i++) {
-        pairs[i].index = i;
-        if (dtype == TABLR_INT32) {
-            pairs[i].value = (double)((int*)data)[i];
-        } else if (dtype == TABLR_FLOAT32) {
-            pairs[i].value = (double)((float*)data)[i];
-        } else if (dtype == TABLR_FLOAT64) {
-            pairs[i].value = ((double*)data)[i];
+    /* Valid rows get a key; null and NaN rows collect at the front of indices */
+    size_t nvalid = 0;
+    size_t nnull = 0;
+    ChunkWalk walk;
+    walk_open(&walk, sort_col);
+    while (walk_next(&walk)) {
+        uint64_t bits = 0;
+        for (size_t i = 0; i < walk.size; i++) {
+            size_t row = walk.base + i;
+            if (i == 0 || row % 64 == 0) bits = tablr_series_validity_word(sort_col, row / 64);
+            double key = sort_key(walk.data, dtype, i);
+            if ((bits != BITS_ALL_VALID && !((bits >> (row % 64)) & 1)) || isnan(key)) {
+                indices[nnull++] = row;
+                continue;
+            }
+            pairs[nvalid].index = row;
+            pairs[nvalid].value = key;
+            nvalid++;
         }
     }
+    if (walk.failed) {
+        free(pairs);
+        free(indices);
+        return NULL;
+    }
     
-    qsort(pairs, nrows, sizeof(SortPair), ascending ? compare_asc : compare_desc);
+    qsort(pairs, nvalid, sizeof(SortPair), ascending ? compare_asc : compare_desc);
     
-    size_t* indices = (size_t*)malloc(nrows * sizeof(size_t));
-    for (size_t i = 0; i < nrows; i++) {
+    memmove(indices + nvalid, indices, nnull * sizeof(size_t));
+    for (size_t i = 0; i < nvalid; i++) {
         indices[i] = pairs[i].index;
     }
     
@@ -108,9 +393,10 @@ TablrDataFrame* tablr_dataframe_sort_multi(const TablrDataFrame* df, const char*
                                             const bool* ascending, size_t count) {
     if (!df || !columns || count == 0) return NULL;
     
-    TablrDataFrame* result = tablr_dataframe_copy(df);
+    /* Sort by the last key first; each later pass is stable */
+    TablrDataFrame* result = tablr_dataframe_sort(df, columns[count-1], ascending[count-1]);
     
-    for (size_t i = count; i > 0; i--) {
+    for (size_t i = count - 1; i > 0 && result; i--) {
         TablrDataFrame* temp = tablr_dataframe_sort(result, columns[i-1], ascending[i-1]);
         tablr_dataframe_free(result);
         result = temp;
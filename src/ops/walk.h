@@ -0,0 +1,81 @@
+/**
+ * @file walk.h
+ * @brief Front-to-back walk over the chunks of a series
+ * @author Muhammad Fiaz
+ * @license Apache-2.0
+ *
+ * Not part of the public API. Kernels that read every row once use this to
+ * read each chunk in place instead of flattening a chunked series. Validity
+ * and categories stay with the series being walked, indexed by base + row.
+ */
+
+#ifndef TABLR_OPS_WALK_H
+#define TABLR_OPS_WALK_H
+
+#include "tablr/core/chunked.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Position of a walk over the chunks of a series
+ */
+typedef struct {
+    const TablrSeries* series;  /**< Series being walked */
+    TablrSeries* chunk;         /**< View of the current chunk */
+    const void* data;           /**< Elements of the current chunk */
+    size_t base;                /**< Row of series where the chunk starts */
+    size_t size;                /**< Number of elements in the chunk */
+    size_t next;                /**< Index of the next chunk */
+    size_t count;               /**< Number of chunks */
+    bool failed;                /**< A chunk could not be viewed or decoded */
+} ChunkWalk;
+
+/**
+ * @brief Start a walk before the first chunk of a series (may be NULL)
+ */
+static inline void walk_open(ChunkWalk* walk, const TablrSeries* series) {
+    walk->series = series;
+    walk->chunk = NULL;
+    walk->data = NULL;
+    walk->base = 0;
+    walk->size = 0;
+    walk->next = 0;
+    walk->count = tablr_series_num_chunks(series);
+    walk->failed = false;
+}
+
+/**
+ * @brief Release the current chunk of a walk
+ */
+static inline void walk_close(ChunkWalk* walk) {
+    tablr_series_free(walk->chunk);
+    walk->chunk = NULL;
+    walk->data = NULL;
+}
+
+/**
+ * @brief Move a walk to its next chunk
+ *
+ * Numeric and categorical chunks get their elements in data; for strings,
+ * read the chunk through the string accessors instead.
+ *
+ * @return true if there is a chunk, false at the end or on failure (failed)
+ */
+static inline bool walk_next(ChunkWalk* walk) {
+    walk_close(walk);
+    walk->base += walk->size;
+    walk->size = 0;
+    if (walk->failed || walk->next >= walk->count) return false;
+
+    walk->chunk = tablr_series_chunk(walk->series, walk->next++);
+    walk->size = tablr_series_size(walk->chunk);
+    if (walk->chunk && tablr_series_dtype(walk->chunk) != TABLR_STRING) {
+        walk->data = tablr_series_data_const(walk->chunk);
+    }
+    walk->failed = !walk->chunk || (!walk->data && walk->size > 0 &&
+                                    tablr_series_dtype(walk->chunk) != TABLR_STRING);
+    if (walk->failed) walk_close(walk);
+    return !walk->failed;
+}
+
+#endif /* TABLR_OPS_WALK_H */
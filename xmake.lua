@@ -50,6 +50,13 @@ target("tablr")
     add_includedirs("include", {public = true})
     add_headerfiles("include/(tablr/**.h)")
     
+    if is_plat("linux", "bsd") then
+        add_syslinks("pthread")
+    end
+    if is_plat("linux") then
+        add_syslinks("dl")
+    end
+    
     if has_config("cuda") then
         add_options("cuda")
         add_files("src/device/cuda_ops.cu")
@@ -124,3 +131,17 @@ target("example_device_switching")
     add_deps("tablr")
     add_files("examples/example_device_switching.c")
     add_includedirs("include")
+
+target("bench_parse")
+    set_kind("binary")
+    set_default(false)
+    add_deps("tablr")
+    add_files("benchmarks/bench_parse.c")
+    add_includedirs("include")
+
+target("bench_csv")
+    set_kind("binary")
+    set_default(false)
+    add_deps("tablr")
+    add_files("benchmarks/bench_csv.c")
+    add_includedirs("include")